@@ -0,0 +1,71 @@
+//===--- JSONParse.swift --------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This benchmark parses a JSON document describing a few hundred user
+// records, walks the result, and serializes it back to text. The parser,
+// document model and writer live in separate files so that the benchmark
+// measures how well generic and enum-heavy code optimizes across files,
+// with and without whole-module optimization.
+import TestsUtils
+
+let recordCount = 200
+
+func makeDocument() -> String {
+  let tags = ["admin", "editor", "viewer", "guest", "owner"]
+  var records: [String] = []
+  for i in 0..<recordCount {
+    var record = "{"
+    record += "\"id\": \(i), "
+    record += "\"name\": \"User \\\"\(i)\\\"\", "
+    record += "\"active\": \(i % 3 == 0 ? "true" : "false"), "
+    record += "\"score\": \(Double(i) * 1.5), "
+    record += "\"manager\": \(i % 7 == 0 ? "null" : String(i / 7)), "
+    record += "\"tags\": [\"\(tags[i % tags.count])\", "
+    record += "\"\(tags[(i + 2) % tags.count])\"], "
+    record += "\"address\": {\"street\": \"\(i) Main St\", "
+    record += "\"city\": \"Cupertino\", \"zip\": \"95014\"}"
+    record += "}"
+    records.append(record)
+  }
+  return "{\"users\": [\n  " + records.joined(separator: ",\n  ") + "\n]}"
+}
+
+func countActiveUsers(_ document: JSONValue) -> Int {
+  guard case let .array(users)? = document["users"] else {
+    return 0
+  }
+  var active = 0
+  for user in users {
+    if case .bool(true)? = user["active"] {
+      active += 1
+    }
+  }
+  return active
+}
+
+@inline(never)
+public func run_JSONParse(_ N: Int) {
+  let text = makeDocument()
+  for _ in 1...N {
+    do {
+      let document = try JSONParser.parse(text)
+      CheckResults(countActiveUsers(document) == (recordCount + 2) / 3,
+                   "Incorrect results in JSONParse: wrong active user count")
+
+      let reparsed = try JSONParser.parse(JSONWriter.write(document))
+      CheckResults(reparsed == document,
+                   "Incorrect results in JSONParse: round trip mismatch")
+    } catch {
+      CheckResults(false, "Incorrect results in JSONParse: \(error)")
+    }
+  }
+}
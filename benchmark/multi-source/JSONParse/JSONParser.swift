@@ -0,0 +1,214 @@
+//===--- JSONParser.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+enum JSONError : Error {
+  case unexpectedEnd
+  case unexpectedCharacter(UInt8, Int)
+  case unsupportedEscape(Int)
+  case invalidNumber(Int)
+}
+
+/// A recursive descent parser over the UTF-8 encoding of a JSON document.
+///
+/// Strings may only contain ASCII; `\u` escapes are not supported.
+struct JSONParser {
+  let input: [UInt8]
+  var position = 0
+
+  init(_ text: String) {
+    input = Array(text.utf8)
+  }
+
+  static func parse(_ text: String) throws -> JSONValue {
+    var parser = JSONParser(text)
+    let value = try parser.parseValue()
+    parser.skipWhitespace()
+    if parser.position != parser.input.count {
+      throw JSONError.unexpectedCharacter(parser.input[parser.position],
+                                          parser.position)
+    }
+    return value
+  }
+
+  mutating func skipWhitespace() {
+    while position < input.count {
+      switch input[position] {
+      case 0x20, 0x09, 0x0A, 0x0D:
+        position += 1
+      default:
+        return
+      }
+    }
+  }
+
+  mutating func peek() throws -> UInt8 {
+    skipWhitespace()
+    if position == input.count {
+      throw JSONError.unexpectedEnd
+    }
+    return input[position]
+  }
+
+  mutating func expect(_ c: UInt8) throws {
+    let next = try peek()
+    if next != c {
+      throw JSONError.unexpectedCharacter(next, position)
+    }
+    position += 1
+  }
+
+  mutating func expectKeyword(_ keyword: String) throws {
+    for c in keyword.utf8 {
+      if position == input.count {
+        throw JSONError.unexpectedEnd
+      }
+      if input[position] != c {
+        throw JSONError.unexpectedCharacter(input[position], position)
+      }
+      position += 1
+    }
+  }
+
+  mutating func parseValue() throws -> JSONValue {
+    switch try peek() {
+    case UInt8(ascii: "{"):
+      return try parseObject()
+    case UInt8(ascii: "["):
+      return try parseArray()
+    case UInt8(ascii: "\""):
+      return .string(try parseString())
+    case UInt8(ascii: "t"):
+      try expectKeyword("true")
+      return .bool(true)
+    case UInt8(ascii: "f"):
+      try expectKeyword("false")
+      return .bool(false)
+    case UInt8(ascii: "n"):
+      try expectKeyword("null")
+      return .null
+    default:
+      return .number(try parseNumber())
+    }
+  }
+
+  mutating func parseObject() throws -> JSONValue {
+    try expect(UInt8(ascii: "{"))
+    var members: [String : JSONValue] = [:]
+    if try peek() == UInt8(ascii: "}") {
+      position += 1
+      return .object(members)
+    }
+    while true {
+      skipWhitespace()
+      let key = try parseString()
+      try expect(UInt8(ascii: ":"))
+      members[key] = try parseValue()
+      let next = try peek()
+      position += 1
+      if next == UInt8(ascii: "}") {
+        return .object(members)
+      }
+      if next != UInt8(ascii: ",") {
+        throw JSONError.unexpectedCharacter(next, position - 1)
+      }
+    }
+  }
+
+  mutating func parseArray() throws -> JSONValue {
+    try expect(UInt8(ascii: "["))
+    var elements: [JSONValue] = []
+    if try peek() == UInt8(ascii: "]") {
+      position += 1
+      return .array(elements)
+    }
+    while true {
+      elements.append(try parseValue())
+      let next = try peek()
+      position += 1
+      if next == UInt8(ascii: "]") {
+        return .array(elements)
+      }
+      if next != UInt8(ascii: ",") {
+        throw JSONError.unexpectedCharacter(next, position - 1)
+      }
+    }
+  }
+
+  mutating func parseString() throws -> String {
+    try expect(UInt8(ascii: "\""))
+    var result = String.UnicodeScalarView()
+    while true {
+      if position == input.count {
+        throw JSONError.unexpectedEnd
+      }
+      var c = input[position]
+      position += 1
+      switch c {
+      case UInt8(ascii: "\""):
+        return String(result)
+      case UInt8(ascii: "\\"):
+        if position == input.count {
+          throw JSONError.unexpectedEnd
+        }
+        let escape = input[position]
+        position += 1
+        switch escape {
+        case UInt8(ascii: "\""), UInt8(ascii: "\\"), UInt8(ascii: "/"):
+          c = escape
+        case UInt8(ascii: "n"):
+          c = 0x0A
+        case UInt8(ascii: "t"):
+          c = 0x09
+        case UInt8(ascii: "r"):
+          c = 0x0D
+        case UInt8(ascii: "b"):
+          c = 0x08
+        case UInt8(ascii: "f"):
+          c = 0x0C
+        default:
+          throw JSONError.unsupportedEscape(position - 1)
+        }
+      default:
+        if c >= 0x80 {
+          throw JSONError.unexpectedCharacter(c, position - 1)
+        }
+      }
+      result.append(UnicodeScalar(c))
+    }
+  }
+
+  static func isNumberCharacter(_ c: UInt8) -> Bool {
+    switch c {
+    case UInt8(ascii: "0")...UInt8(ascii: "9"), UInt8(ascii: "-"),
+         UInt8(ascii: "+"), UInt8(ascii: "."), UInt8(ascii: "e"),
+         UInt8(ascii: "E"):
+      return true
+    default:
+      return false
+    }
+  }
+
+  mutating func parseNumber() throws -> Double {
+    skipWhitespace()
+    let start = position
+    var text = String.UnicodeScalarView()
+    while position < input.count &&
+          JSONParser.isNumberCharacter(input[position]) {
+      text.append(UnicodeScalar(input[position]))
+      position += 1
+    }
+    guard let value = Double(String(text)) else {
+      throw JSONError.invalidNumber(start)
+    }
+    return value
+  }
+}
@@ -0,0 +1,62 @@
+//===--- JSONValue.swift --------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// A parsed JSON document.
+enum JSONValue {
+  case null
+  case bool(Bool)
+  case number(Double)
+  case string(String)
+  case array([JSONValue])
+  case object([String : JSONValue])
+}
+
+extension JSONValue : Equatable {}
+
+func ==(lhs: JSONValue, rhs: JSONValue) -> Bool {
+  switch (lhs, rhs) {
+  case (.null, .null):
+    return true
+  case let (.bool(l), .bool(r)):
+    return l == r
+  case let (.number(l), .number(r)):
+    return l == r
+  case let (.string(l), .string(r)):
+    return l == r
+  case let (.array(l), .array(r)):
+    return l == r
+  case let (.object(l), .object(r)):
+    return l == r
+  default:
+    return false
+  }
+}
+
+extension JSONValue {
+  subscript(key: String) -> JSONValue? {
+    if case let .object(members) = self {
+      return members[key]
+    }
+    return nil
+  }
+
+  var count: Int {
+    switch self {
+    case let .array(elements):
+      return elements.count
+    case let .object(members):
+      return members.count
+    default:
+      return 0
+    }
+  }
+}
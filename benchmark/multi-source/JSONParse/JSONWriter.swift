@@ -0,0 +1,85 @@
+//===--- JSONWriter.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// Serializes a JSON document without any whitespace.
+struct JSONWriter {
+  var output = ""
+
+  static func write(_ value: JSONValue) -> String {
+    var writer = JSONWriter()
+    writer.write(value)
+    return writer.output
+  }
+
+  mutating func write(_ value: JSONValue) {
+    switch value {
+    case .null:
+      output += "null"
+    case let .bool(b):
+      output += b ? "true" : "false"
+    case let .number(n):
+      // Print integral values without a fraction so they read back exactly.
+      if n == n.rounded() && abs(n) < 1e15 {
+        output += String(Int(n))
+      } else {
+        output += String(n)
+      }
+    case let .string(s):
+      writeString(s)
+    case let .array(elements):
+      output += "["
+      var first = true
+      for element in elements {
+        if !first {
+          output += ","
+        }
+        first = false
+        write(element)
+      }
+      output += "]"
+    case let .object(members):
+      output += "{"
+      var first = true
+      for (key, member) in members {
+        if !first {
+          output += ","
+        }
+        first = false
+        writeString(key)
+        output += ":"
+        write(member)
+      }
+      output += "}"
+    }
+  }
+
+  mutating func writeString(_ s: String) {
+    output += "\""
+    for c in s.unicodeScalars {
+      switch c {
+      case "\"":
+        output += "\\\""
+      case "\\":
+        output += "\\\\"
+      case "\n":
+        output += "\\n"
+      case "\t":
+        output += "\\t"
+      case "\r":
+        output += "\\r"
+      default:
+        output.unicodeScalars.append(c)
+      }
+    }
+    output += "\""
+  }
+}
@@ -15,6 +15,7 @@
 
 import argparse
 import csv
+import json
 import sys
 
 TESTNAME = 1
@@ -96,7 +97,7 @@ def main():
                         help='New performance test suite (csv file)',
                         required=True)
     parser.add_argument('--format',
-                        help='Supported format git, html and markdown',
+                        help='Supported format git, html, json and markdown',
                         default="markdown")
     parser.add_argument('--output', help='Output file name')
     parser.add_argument('--changes-only',
@@ -165,6 +166,17 @@ def main():
      decreased_perf_list,
      normal_perf_list) = sort_ratio_list(ratio_list, args.changes_only)
 
+    if args.format and args.format.lower() == "json":
+        json_data = convert_to_json(ratio_list, old_results, new_results,
+                                    old_max_results, new_max_results,
+                                    delta_list, unknown_list,
+                                    args.changes_only)
+        if args.output:
+            write_to_file(args.output, json_data)
+        else:
+            print(json_data)
+        return
+
     """
     Create markdown formatted table
     """
@@ -307,6 +319,41 @@ def convert_to_html(ratio_list, old_results, new_results, delta_list,
     return html_data
 
 
+def convert_to_json(ratio_list, old_results, new_results, old_max_results,
+                    new_max_results, delta_list, unknown_list, changes_only):
+    """
+    Return the comparison as a JSON document, one entry per test.
+
+    A change is "uncertain" when the new minimum falls within the old
+    [min, max] range or vice versa, i.e. it may be noise.
+    """
+    (complete_perf_list,
+     increased_perf_list,
+     decreased_perf_list,
+     normal_perf_list) = sort_ratio_list(ratio_list, changes_only)
+
+    tests = []
+    for key in complete_perf_list:
+        if key in decreased_perf_list:
+            status = "regression"
+        elif key in increased_perf_list:
+            status = "improvement"
+        else:
+            status = "unchanged"
+        tests.append({
+            "name": key,
+            "status": status,
+            "uncertain": unknown_list[key] != "",
+            "old_min": old_results[key],
+            "old_max": old_max_results[key],
+            "new_min": new_results[key],
+            "new_max": new_max_results[key],
+            "delta_percent": delta_list[key],
+            "speedup": ratio_list[key],
+        })
+    return json.dumps({"tests": tests}, indent=2, sort_keys=True)
+
+
 def write_to_file(file_name, data):
     """
     Write data to given file
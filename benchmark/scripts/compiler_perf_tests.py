@@ -0,0 +1,235 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# ===--- compiler_perf_tests.py ------------------------------------------===//
+#
+#  This source file is part of the Swift.org open source project
+#
+#  Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+#  Licensed under Apache License v2.0 with Runtime Library Exception
+#
+#  See http://swift.org/LICENSE.txt for license information
+#  See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+# ===---------------------------------------------------------------------===//
+
+# Measure how long the compiler takes, and how much memory it uses, to
+# compile sources with known type checker and optimizer pathologies.
+#
+# Each test source is generated at a size controlled by --scale and compiled
+# with a single frontend invocation under each configuration. For every
+# compile we record the wall time, the peak resident set size, the time spent
+# in each phase (from -emit-phase-timings-path) and, with an asserts build of
+# the compiler, the constraint solver statistics printed by -print-stats.
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+CONFIGS = [
+    ('Onone', ['-Onone'], True),
+    ('O', ['-O'], True),
+    # Without -primary-file the frontend compiles the whole module at once.
+    ('O-wmo', ['-O'], False),
+]
+
+
+def array_literal(scale):
+    """An unannotated array literal mixing integer and float literals."""
+    elements = ['1', '2.5', '-3', '0x10', '4e2']
+    return 'let values = [\n  %s\n]\n' % ',\n  '.join(
+        elements[i % len(elements)] for i in range(scale * 20))
+
+
+def dictionary_literal(scale):
+    """An unannotated dictionary literal mixing value literal kinds."""
+    value_kinds = ['%d', '%d.5', '-%d']
+    return 'let table = [\n  %s\n]\n' % ',\n  '.join(
+        '"key%d": %s' % (i, value_kinds[i % len(value_kinds)] % i)
+        for i in range(scale * 20))
+
+
+def operator_chain(scale):
+    """A long chain of overloaded operators over untyped literals."""
+    ops = ['+', '*', '-', '/']
+    terms = ['1']
+    for i in range(scale):
+        terms.append(ops[i % len(ops)])
+        terms.append('%d.0' % (i + 2) if i % 2 else str(i + 2))
+    return 'let result: Double = %s\n' % ' '.join(terms)
+
+
+def generic_nesting(scale):
+    """Deeply nested generic types and calls to generic functions."""
+    depth = scale * 2
+    source = ['struct Box<T> { var value: T }',
+              'func wrap<T>(_ value: T) -> Box<T> {',
+              '  return Box(value: value)',
+              '}',
+              'func unwrap<T>(_ box: Box<T>) -> T { return box.value }',
+              '']
+    source.append('let nested = %s1%s' % ('wrap(' * depth, ')' * depth))
+    source.append('let value = %snested%s' % ('unwrap(' * depth, ')' * depth))
+    return '\n'.join(source) + '\n'
+
+
+def protocol_extensions(scale):
+    """A refinement hierarchy where every protocol extension adds defaults."""
+    count = scale * 4
+    source = ['protocol P0 { var base: Int { get } }']
+    for i in range(1, count + 1):
+        source.append('protocol P%d : P%d {}' % (i, i - 1))
+        source.append('extension P%d {' % i)
+        source.append('  func method%d() -> Int { return base + %d }' % (i, i))
+        source.append('  func combined%d<T : P%d>(_ other: T) -> Int {' %
+                      (i, i))
+        source.append('    return method%d() + other.method%d()' % (i, i))
+        source.append('  }')
+        source.append('}')
+    source.append('struct S : P%d { var base: Int }' % count)
+    source.append('let s = S(base: 1)')
+    source.append('let total = %s' % ' + '.join(
+        's.combined%d(s)' % i for i in range(1, count + 1)))
+    return '\n'.join(source) + '\n'
+
+
+TESTS = [
+    ('ArrayLiteral', array_literal),
+    ('DictionaryLiteral', dictionary_literal),
+    ('OperatorChain', operator_chain),
+    ('GenericNesting', generic_nesting),
+    ('ProtocolExtensions', protocol_extensions),
+]
+
+
+def parse_phase_timings(path):
+    """Return a map from phase name to total seconds spent in it."""
+    phases = {}
+    if not os.path.exists(path):
+        return phases
+    line_re = re.compile(r'^- \["(.*)", (\d+), (\d+)\]$')
+    for line in open(path):
+        m = line_re.match(line.strip())
+        if not m:
+            continue
+        name = m.group(1)
+        elapsed = (int(m.group(3)) - int(m.group(2))) / 1000000.0
+        phases[name] = phases.get(name, 0) + elapsed
+    return phases
+
+
+def parse_stats(output):
+    """Return the LLVM statistics in a -print-stats dump, keyed by
+    "<component> - <description>"."""
+    stats = {}
+    stat_re = re.compile(r'^\s*(\d+)\s+(\S.* - .*\S)\s*$')
+    for line in output.splitlines():
+        m = stat_re.match(line)
+        if m:
+            stats[m.group(2)] = int(m.group(1))
+    return stats
+
+
+def run_compile(args, source_path, flags, primary, temp_dir):
+    timings_path = os.path.join(temp_dir, 'phases.yaml')
+    if os.path.exists(timings_path):
+        os.remove(timings_path)
+
+    command = [args.swiftc, '-frontend', '-c']
+    command += ['-primary-file', source_path] if primary else [source_path]
+    command += flags
+    command += ['-module-name', 'main',
+                '-o', os.path.join(temp_dir, 'main.o'),
+                '-emit-phase-timings-path', timings_path,
+                '-print-stats']
+    command += args.extra_args
+
+    start = time.time()
+    process = subprocess.Popen(command, stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT)
+    output = process.stdout.read().decode('utf-8', 'replace')
+    # Reap the compiler ourselves to get its resource usage on its own.
+    (_, status, usage) = os.wait4(process.pid, 0)
+    wall_time = time.time() - start
+    max_rss = usage.ru_maxrss
+    if sys.platform != 'darwin':
+        # Linux reports kilobytes; Darwin reports bytes.
+        max_rss *= 1024
+
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        print('error: compile failed:\n  ' + ' '.join(command) + '\n' + output,
+              file=sys.stderr)
+        sys.exit(1)
+
+    return {
+        'wall_time': wall_time,
+        'max_rss': max_rss,
+        'phases': parse_phase_timings(timings_path),
+        'stats': parse_stats(output),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Measure compile time and memory use of the compiler.')
+    parser.add_argument('--swiftc', default='swiftc',
+                        help='The swiftc executable to measure')
+    parser.add_argument('--scale', type=int, default=10,
+                        help='The size of the generated test sources')
+    parser.add_argument('--num-samples', type=int, default=3,
+                        help='The number of times to compile each test; '
+                             'the fastest compile is reported')
+    parser.add_argument('--output', help='Write the results as JSON to this '
+                                         'file')
+    parser.add_argument('--keep-sources',
+                        help='Write the generated sources to this directory')
+    parser.add_argument('filters', nargs='*',
+                        help='Only run tests with these names')
+    parser.add_argument('--extra-args', nargs=argparse.REMAINDER, default=[],
+                        help='Additional arguments for the frontend')
+    args = parser.parse_args()
+
+    temp_dir = tempfile.mkdtemp()
+    results = []
+    try:
+        print('TEST,CONFIG,WALL(s),MAX_RSS(B)')
+        for (name, generate) in TESTS:
+            if args.filters and name not in args.filters:
+                continue
+            source_dir = args.keep_sources or temp_dir
+            if not os.path.isdir(source_dir):
+                os.makedirs(source_dir)
+            source_path = os.path.join(source_dir, name + '.swift')
+            with open(source_path, 'w') as f:
+                f.write(generate(args.scale))
+
+            for (config, flags, primary) in CONFIGS:
+                samples = [run_compile(args, source_path, flags, primary,
+                                       temp_dir)
+                           for _ in range(args.num_samples)]
+                best = min(samples, key=lambda s: s['wall_time'])
+                result = {'test': name, 'config': config,
+                          'scale': args.scale}
+                result.update(best)
+                results.append(result)
+                print('%s,%s,%.3f,%s' % (name, config, best['wall_time'],
+                                         best['max_rss']))
+                sys.stdout.flush()
+    finally:
+        shutil.rmtree(temp_dir)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
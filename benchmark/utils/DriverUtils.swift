@@ -20,6 +20,9 @@ struct BenchResults {
   var mean: UInt64 = 0
   var sd: UInt64 = 0
   var median: UInt64 = 0
+  /// How much the process's peak resident set size grew while the test ran,
+  /// if memory reporting was requested.
+  var maxRSSDelta: UInt64? = nil
   init() {}
   init(delim: String, sampleCount: UInt64, min: UInt64, max: UInt64, mean: UInt64, sd: UInt64, median: UInt64) {
     self.delim = delim
@@ -41,7 +44,11 @@ struct BenchResults {
 
 extension BenchResults : CustomStringConvertible {
   var description: String {
-     return "\(sampleCount)\(delim)\(min)\(delim)\(max)\(delim)\(mean)\(delim)\(sd)\(delim)\(median)"
+     var result = "\(sampleCount)\(delim)\(min)\(delim)\(max)\(delim)\(mean)\(delim)\(sd)\(delim)\(median)"
+     if let maxRSSDelta = maxRSSDelta {
+       result += "\(delim)\(maxRSSDelta)"
+     }
+     return result
   }
 }
 
@@ -88,9 +95,16 @@ struct TestConfig {
   /// The number of samples we should take of each test.
   var numSamples: Int = 1
 
+  /// The number of samples to run and discard before taking measurements, so
+  /// that caches, lazily initialized globals and page mappings are warm.
+  var numWarmups: Int = 0
+
   /// Is verbose output enabled?
   var verbose: Bool = false
 
+  /// Should we report how much each test grows the peak resident set size?
+  var reportMemory: Bool = false
+
   /// Should we only run the "pre-commit" tests?
   var onlyPrecommit: Bool = true
 
@@ -103,8 +117,8 @@ struct TestConfig {
 
   mutating func processArguments() -> TestAction {
     let validOptions = [
-      "--iter-scale", "--num-samples", "--num-iters",
-      "--verbose", "--delim", "--run-all", "--list", "--sleep"
+      "--iter-scale", "--num-samples", "--num-warmups", "--num-iters",
+      "--verbose", "--memory", "--delim", "--run-all", "--list", "--sleep"
     ]
     let maybeBenchArgs: Arguments? = parseArgs(validOptions)
     if maybeBenchArgs == nil {
@@ -131,11 +145,20 @@ struct TestConfig {
       numSamples = Int(x)!
     }
 
+    if let x = benchArgs.optionalArgsMap["--num-warmups"] {
+      if x.isEmpty { return .Fail("--num-warmups requires a value") }
+      numWarmups = Int(x)!
+    }
+
     if let _ = benchArgs.optionalArgsMap["--verbose"] {
       verbose = true
       print("Verbose")
     }
 
+    if let _ = benchArgs.optionalArgsMap["--memory"] {
+      reportMemory = true
+    }
+
     if let x = benchArgs.optionalArgsMap["--delim"] {
       if x.isEmpty { return .Fail("--delim requires a value") }
       delim = x
@@ -226,6 +249,13 @@ func stopTrackingObjects(_: UnsafeMutableRawPointer) -> Int
 
 #endif
 
+/// The peak resident set size of this process so far, in bytes.
+func getMaxRSS() -> UInt64 {
+  var usage = rusage()
+  getrusage(RUSAGE_SELF, &usage)
+  return UInt64(usage.ru_maxrss)
+}
+
 class SampleRunner {
   var info = mach_timebase_info_data_t(numer: 0, denom: 0)
   init() {
@@ -261,28 +291,31 @@ func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResu
   }
 
   let sampler = SampleRunner()
-  for s in 0..<c.numSamples {
+  let maxRSSBefore = c.reportMemory ? getMaxRSS() : 0
+
+  // Pick the number of iterations once, so that every sample measures the
+  // same amount of work. The calibration run doubles as a warmup.
+  var scale: UInt
+  if c.fixedNumIters == 0 {
     let time_per_sample: UInt64 = 1_000_000_000 * UInt64(c.iterationScale)
+    let elapsed_time = sampler.run(name, fn: fn, num_iters: 1)
+    scale = UInt(time_per_sample / Swift.max(elapsed_time, 1))
+  } else {
+    scale = c.fixedNumIters
+  }
+  if scale < 1 {
+    scale = 1
+  }
+  if c.verbose {
+    print("    Measuring with scale \(scale).")
+  }
 
-    var scale : UInt
-    var elapsed_time : UInt64 = 0
-    if c.fixedNumIters == 0 {
-      elapsed_time = sampler.run(name, fn: fn, num_iters: 1)
-      scale = UInt(time_per_sample / elapsed_time)
-    } else {
-      // Compute the scaling factor if a fixed c.fixedNumIters is not specified.
-      scale = c.fixedNumIters
-    }
+  for _ in 0..<c.numWarmups {
+    _ = sampler.run(name, fn: fn, num_iters: scale)
+  }
 
-    // Rerun the test with the computed scale factor.
-    if scale > 1 {
-      if c.verbose {
-        print("    Measuring with scale \(scale).")
-      }
-      elapsed_time = sampler.run(name, fn: fn, num_iters: scale)
-    } else {
-      scale = 1
-    }
+  for s in 0..<c.numSamples {
+    let elapsed_time = sampler.run(name, fn: fn, num_iters: scale)
     // save result in microseconds or k-ticks
     samples[s] = elapsed_time / UInt64(scale) / 1000
     if c.verbose {
@@ -293,16 +326,22 @@ func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResu
   let (mean, sd) = internalMeanSD(samples)
 
   // Return our benchmark results.
-  return BenchResults(delim: c.delim, sampleCount: UInt64(samples.count),
-                      min: samples.min()!, max: samples.max()!,
-                      mean: mean, sd: sd, median: internalMedian(samples))
+  var results = BenchResults(delim: c.delim, sampleCount: UInt64(samples.count),
+                             min: samples.min()!, max: samples.max()!,
+                             mean: mean, sd: sd, median: internalMedian(samples))
+  if c.reportMemory {
+    results.maxRSSDelta = getMaxRSS() - maxRSSBefore
+  }
+  return results
 }
 
 func printRunInfo(_ c: TestConfig) {
   if c.verbose {
     print("--- CONFIG ---")
     print("NumSamples: \(c.numSamples)")
+    print("NumWarmups: \(c.numWarmups)")
     print("Verbose: \(c.verbose)")
+    print("ReportMemory: \(c.reportMemory)")
     print("IterScale: \(c.iterationScale)")
     if c.fixedNumIters != 0 {
       print("FixedIters: \(c.fixedNumIters)")
@@ -322,9 +361,13 @@ func printRunInfo(_ c: TestConfig) {
 
 func runBenchmarks(_ c: TestConfig) {
   let units = "us"
-  print("#\(c.delim)TEST\(c.delim)SAMPLES\(c.delim)MIN(\(units))\(c.delim)MAX(\(units))\(c.delim)MEAN(\(units))\(c.delim)SD(\(units))\(c.delim)MEDIAN(\(units))")
+  print("#\(c.delim)TEST\(c.delim)SAMPLES\(c.delim)MIN(\(units))\(c.delim)MAX(\(units))\(c.delim)MEAN(\(units))\(c.delim)SD(\(units))\(c.delim)MEDIAN(\(units))", terminator: "")
+  print(c.reportMemory ? "\(c.delim)MAX_RSS_DELTA(B)" : "")
   var SumBenchResults = BenchResults()
   SumBenchResults.sampleCount = 0
+  if c.reportMemory {
+    SumBenchResults.maxRSSDelta = 0
+  }
 
   for t in c.tests {
     if !t.run {
@@ -341,6 +384,9 @@ func runBenchmarks(_ c: TestConfig) {
     SumBenchResults.max += results.max
     SumBenchResults.mean += results.mean
     SumBenchResults.sampleCount += 1
+    if let maxRSSDelta = results.maxRSSDelta {
+      SumBenchResults.maxRSSDelta! += maxRSSDelta
+    }
     // Don't accumulate SD and Median, as simple sum isn't valid for them.
     // TODO: Compute SD and Median for total results as well.
     // SumBenchResults.sd += results.sd
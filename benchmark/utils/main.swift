@@ -54,6 +54,7 @@ import Hash
 import Histogram
 import Integrate
 import IterateData
+import JSONParse
 import Join
 import LinkedList
 import MapReduce
@@ -143,6 +144,7 @@ precommitTests = [
   "Histogram": run_Histogram,
   "Integrate": run_Integrate,
   "IterateData": run_IterateData,
+  "JSONParse": run_JSONParse,
   "Join": run_Join,
   "LinkedList": run_LinkedList,
   "MapReduce": run_MapReduce,
@@ -409,6 +409,16 @@ namespace swift {
     /// \brief Emit all warnings as errors
     bool warningsAsErrors = false;
 
+    /// \brief The number of warnings to emit before ignoring the rest, or 0
+    /// for no limit.
+    unsigned warningLimit = 0;
+
+    /// \brief The number of warnings emitted so far.
+    unsigned numWarningsEmitted = 0;
+
+    /// \brief The number of warnings ignored because of warningLimit.
+    unsigned numWarningsOverLimit = 0;
+
     /// \brief Whether a fatal error has occurred
     bool fatalErrorOccurred = false;
 
@@ -443,6 +453,11 @@ namespace swift {
     void setWarningsAsErrors(bool val) { warningsAsErrors = val; }
     bool getWarningsAsErrors() const { return warningsAsErrors; }
 
+    /// \brief Ignore warnings once \p limit of them have been emitted
+    void setWarningLimit(unsigned limit) { warningLimit = limit; }
+    unsigned getWarningLimit() const { return warningLimit; }
+    unsigned getNumWarningsOverLimit() const { return numWarningsOverLimit; }
+
     void resetHadAnyError() {
       anyErrorOccurred = false;
       fatalErrorOccurred = false;
@@ -522,6 +537,17 @@ namespace swift {
       return state.getWarningsAsErrors();
     }
 
+    /// \brief Ignore warnings once \p limit of them have been emitted, or
+    /// never if \p limit is 0. Ignored warnings are never formatted.
+    void setWarningLimit(unsigned limit) { state.setWarningLimit(limit); }
+    unsigned getWarningLimit() const { return state.getWarningLimit(); }
+
+    /// \brief The number of warnings that were ignored because of the
+    /// warning limit.
+    unsigned getNumWarningsOverLimit() const {
+      return state.getNumWarningsOverLimit();
+    }
+
     void ignoreDiagnostic(DiagID id) {
       state.setDiagnosticBehavior(id, DiagnosticState::Behavior::Ignore);
     }
@@ -93,6 +93,9 @@ public:
   /// Whether or not to run optimization passes.
   unsigned Optimize : 1;
 
+  /// Whether the optimization passes should favor code size over speed.
+  unsigned OptimizeForSize : 1;
+
   /// Which sanitizer is turned on.
   SanitizerKind Sanitize : 2;
 
@@ -121,6 +124,23 @@ public:
   /// objects.
   unsigned EmitStackPromotionChecks : 1;
 
+  /// Keep out-of-line value buffer payloads in shared copy-on-write boxes.
+  /// This must match the runtime's SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS.
+  unsigned UseCOWExistentials : 1;
+
+  /// Copy and destroy loadable structs and tuples with several non-trivial
+  /// fields through shared outlined functions instead of inline code.
+  unsigned OutlineValueOperations : 1;
+
+  /// Reference the metadata of non-generic classes that need no runtime
+  /// initialization directly, instead of through a cached accessor.
+  /// Only has an effect without Objective-C interop.
+  unsigned StaticClassMetadata : 1;
+
+  /// Mark non-aliasable inout parameters as noalias, relying on the program
+  /// not accessing the same variable through two inouts at once.
+  unsigned InoutNoAlias : 1;
+
   /// The maximum number of bytes used on a stack frame for stack promotion
   /// (includes alloc_stack allocations).
   unsigned StackPromotionSizeLimit = 1024;
@@ -169,11 +189,15 @@ public:
 
   IRGenOptions()
       : DWARFVersion(2), OutputKind(IRGenOutputKind::LLVMAssembly),
-        Verify(true), Optimize(false), Sanitize(SanitizerKind::None),
+        Verify(true), Optimize(false), OptimizeForSize(false),
+        Sanitize(SanitizerKind::None),
         DebugInfoKind(IRGenDebugInfoKind::None), UseJIT(false),
         DisableLLVMOptzns(false), DisableLLVMARCOpts(false),
         DisableLLVMSLPVectorizer(false), DisableFPElim(true), Playground(false),
-        EmitStackPromotionChecks(false), GenerateProfile(false),
+        EmitStackPromotionChecks(false), UseCOWExistentials(false),
+        OutlineValueOperations(false), StaticClassMetadata(false),
+        InoutNoAlias(false),
+        GenerateProfile(false),
         PrintInlineTree(false), EmbedMode(IRGenEmbedMode::None),
         HasValueNamesSetting(false), ValueNames(false),
         EnableReflectionMetadata(true), EnableReflectionNames(true),
@@ -193,6 +217,7 @@ public:
   unsigned getLLVMCodeGenOptionsHash() {
     unsigned Hash = 0;
     Hash = (Hash << 1) | Optimize;
+    Hash = (Hash << 1) | OptimizeForSize;
     Hash = (Hash << 1) | DisableLLVMOptzns;
     Hash = (Hash << 1) | DisableLLVMARCOpts;
     return Hash;
@@ -17,8 +17,11 @@
 #ifndef SWIFT_AST_LAZYRESOLVER_H
 #define SWIFT_AST_LAZYRESOLVER_H
 
+#include "swift/AST/Identifier.h"
 #include "swift/AST/TypeLoc.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerEmbeddedInt.h"
+#include "llvm/ADT/TinyPtrVector.h"
 
 namespace swift {
 
@@ -189,6 +192,16 @@ public:
     llvm_unreachable("unimplemented");
   }
 
+  /// Loads only the members of \p D whose base name is \p N.
+  ///
+  /// The members are \em not added to D; a later call to loadAllMembers
+  /// must still produce them. Returns None if the loader cannot look up
+  /// members by name, in which case the caller should load all members.
+  virtual Optional<TinyPtrVector<ValueDecl *>>
+  loadNamedMembers(const Decl *D, Identifier N, uint64_t contextData) {
+    return None;
+  }
+
   /// Populates the given vector with all conformances for \p D.
   ///
   /// The implementation should \em not call setConformances on \p D.
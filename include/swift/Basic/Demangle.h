@@ -101,6 +101,7 @@ enum class SpecializationPass : uint8_t {
   CapturePropagation,
   FunctionSignatureOpts,
   GenericSpecializer,
+  ConstantArgumentPropagation,
 };
 
 static inline char encodeSpecializationPass(SpecializationPass Pass) {
@@ -352,21 +353,29 @@ std::string nodeToString(NodePointer Root,
 
 struct NodeFactory {
   static NodePointer create(Node::Kind K) {
-    return NodePointer(new Node(K));
+    return std::make_shared<SharedNode>(K);
   }
   static NodePointer create(Node::Kind K, Node::IndexType Index) {
-    return NodePointer(new Node(K, Index));
+    return std::make_shared<SharedNode>(K, Index);
   }
   static NodePointer create(Node::Kind K, llvm::StringRef Text) {
-    return NodePointer(new Node(K, Text));
+    return std::make_shared<SharedNode>(K, Text.str());
   }
   static NodePointer create(Node::Kind K, std::string &&Text) {
-    return NodePointer(new Node(K, std::move(Text)));
+    return std::make_shared<SharedNode>(K, std::move(Text));
   }
   template <size_t N>
   static NodePointer create(Node::Kind K, const char (&Text)[N]) {
-    return NodePointer(new Node(K, llvm::StringRef(Text)));
+    return std::make_shared<SharedNode>(K, std::string(Text));
   }
+
+private:
+  /// Exposes Node's private constructors to std::make_shared, which puts the
+  /// node and its reference counts in a single allocation.
+  struct SharedNode : Node {
+    template <typename... Args>
+    SharedNode(Args &&... args) : Node(std::forward<Args>(args)...) {}
+  };
 };
 
   /// A class for printing to a std::string.
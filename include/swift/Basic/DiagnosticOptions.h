@@ -41,6 +41,9 @@ public:
 
   /// Treat all warnings as errors
   bool WarningsAsErrors = false;
+
+  /// Stop emitting warnings after this many, or 0 for no limit.
+  unsigned WarningLimit = 0;
 };
 
 } // end namespace swift
@@ -26,6 +26,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/raw_ostream.h"
+#include <vector>
 
 namespace swift {
 namespace json {
@@ -533,6 +534,14 @@ struct ScalarTraits<double> {
   static bool mustQuote(StringRef) { return false; }
 };
 
+/// A std::vector is written as an array of its elements.
+template <typename T> struct ArrayTraits<std::vector<T>> {
+  static size_t size(Output &out, std::vector<T> &seq) { return seq.size(); }
+  static T &element(Output &out, std::vector<T> &seq, size_t index) {
+    return seq[index];
+  }
+};
+
 template<typename T>
 typename std::enable_if<has_ScalarEnumerationTraits<T>::value,void>::type
 jsonize(Output &out, T &Val, bool) {
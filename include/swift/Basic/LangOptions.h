@@ -133,6 +133,20 @@ namespace swift {
     /// allocated by the constraint solver.
     unsigned SolverMemoryThreshold = 33554432; /* 32 * 1024 * 1024 */
 
+    /// \brief If non-zero, give up on an expression once the constraint solver
+    /// has spent this many milliseconds on it and report it as too complex.
+    unsigned SolverExpressionTimeThreshold = 0;
+
+    /// \brief If non-zero, warn when an expression takes longer than this many
+    /// milliseconds to type-check.
+    ///
+    /// Intended for debugging purposes only.
+    unsigned WarnLongExpressionTypeChecking = 0;
+
+    /// \brief If non-empty, append the constraint solver statistics of every
+    /// type-checked expression to this file, one JSON object per line.
+    std::string ExpressionTypeCheckingStatsPath;
+
     /// \brief Perform all dynamic allocations using malloc/free instead of
     /// optimized custom allocator, so that memory debugging tools can be used.
     bool UseMalloc = false;
@@ -146,6 +160,10 @@ namespace swift {
     /// \brief Enable generalized collection casting.
     bool EnableExperimentalCollectionCasts = true;
 
+    /// \brief Look up members of serialized types by name, without
+    /// deserializing every member of the type and its extensions.
+    bool EnableNamedLazyMemberLoading = false;
+
     /// Should we check the target OSs of serialized modules to see that they're
     /// new enough?
     bool EnableTargetOSChecking = true;
@@ -15,7 +15,9 @@
 
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/Support/TimeValue.h"
 #include "llvm/Support/Timer.h"
+#include <string>
 
 namespace swift {
   /// A convenience class for declaring a timer that's part of the Swift
@@ -28,22 +30,53 @@ namespace swift {
     };
     static State CompilationTimersEnabled;
 
+    static bool PhaseRecordingEnabled;
+
     Optional<llvm::NamedRegionTimer> Timer;
+    StringRef Name;
+    llvm::sys::TimeValue StartTime = llvm::sys::TimeValue::ZeroTime();
 
   public:
-    explicit SharedTimer(StringRef name) {
+    /// A single timed phase, as recorded when phase recording is enabled.
+    struct PhaseRecord {
+      std::string Name;
+      llvm::sys::TimeValue Start;
+      llvm::sys::TimeValue End;
+    };
+
+    /// \p name must outlive the timer; in practice it is always a string
+    /// literal.
+    explicit SharedTimer(StringRef name) : Name(name) {
       if (CompilationTimersEnabled == State::Enabled)
         Timer.emplace(name, StringRef("Swift compilation"));
       else
         CompilationTimersEnabled = State::Skipped;
+
+      if (PhaseRecordingEnabled)
+        StartTime = llvm::sys::TimeValue::now();
     }
 
+    ~SharedTimer();
+
     /// Must be called before any SharedTimers have been created.
     static void enableCompilationTimers() {
       assert(CompilationTimersEnabled != State::Skipped &&
              "a timer has already been created");
       CompilationTimersEnabled = State::Enabled;
     }
+
+    /// Starts recording the wall-clock start and end time of every
+    /// SharedTimer created from now on.
+    ///
+    /// Unlike the compilation timers, this can be turned on at any time.
+    static void enablePhaseRecording() {
+      PhaseRecordingEnabled = true;
+    }
+
+    /// Returns the phases recorded so far, in the order they finished.
+    ///
+    /// Must not be called while other threads may still be timing phases.
+    static ArrayRef<PhaseRecord> getRecordedPhases();
   };
 } // end namespace swift
 
@@ -137,6 +137,10 @@ public:
     Status status = UpToDate;
     llvm::sys::TimeValue previousModTime;
 
+    /// How long the input took to compile the last time it was built, or
+    /// zero if that isn't known.
+    llvm::sys::TimeValue previousDuration;
+
     InputInfo() = default;
     InputInfo(Status stat, llvm::sys::TimeValue time)
         : status(stat), previousModTime(time) {}
@@ -132,6 +132,15 @@ private:
   /// rebuilt.
   bool ShowIncrementalBuildDecisions = false;
 
+  /// When non-empty, a Chrome trace of every job that ran, and of the
+  /// compilation phases within each frontend job, is written to this path.
+  std::string TimeTracePath;
+
+  /// When non-empty, the outputs of compile jobs are stored in this directory,
+  /// keyed by everything that could affect them, and later jobs with the same
+  /// key copy them from there instead of running.
+  std::string CompilationCachePath;
+
   static const Job *unwrap(const std::unique_ptr<const Job> &p) {
     return p.get();
   }
@@ -189,6 +198,14 @@ public:
     ShowIncrementalBuildDecisions = value;
   }
 
+  void setTimeTracePath(StringRef path) {
+    TimeTracePath = path;
+  }
+
+  void setCompilationCachePath(StringRef path) {
+    CompilationCachePath = path;
+  }
+
   void setCompilationRecordPath(StringRef path) {
     assert(CompilationRecordPath.empty() && "already set");
     CompilationRecordPath = path;
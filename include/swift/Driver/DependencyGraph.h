@@ -129,7 +129,76 @@ private:
   /// \sa SourceFile::getInterfaceHash
   llvm::DenseMap<const void *, std::string> InterfaceHashes;
 
+  /// Per-declaration fingerprints, keyed by top-level name or by mangled
+  /// nominal type name.
+  struct FingerprintsTy {
+    llvm::StringMap<std::string> TopLevel;
+    llvm::StringMap<std::string> Nominal;
+  };
+
+  /// The declaration fingerprints for each node, if its dependency file had
+  /// any.
+  llvm::DenseMap<const void *, FingerprintsTy> Fingerprints;
+
+  /// The provided names whose fingerprints did not change when a node's
+  /// interface hash last changed.
+  ///
+  /// A node with no entry here must be treated as if every name it provides
+  /// has changed.
+  struct UnchangedNamesTy {
+    llvm::StringSet<> TopLevel;
+    llvm::StringSet<> Nominal;
+  };
+  llvm::DenseMap<const void *, UnchangedNamesTy> UnchangedNames;
+
+  /// Nodes that have been marked, but whose dependents were only traversed
+  /// for the names that changed.
+  ///
+  /// If such a node is reached again by a cascading edge, all of its
+  /// dependents need to be traversed after all.
+  llvm::SmallPtrSet<const void *, 16> PartiallyMarked;
+
+  static bool isAffectedByChange(const ProvidesEntryTy &provided,
+                                 const UnchangedNamesTy &unchanged);
+
+  /// The contents of the dependency file each node was most recently loaded
+  /// from, so that the whole graph can be cached in a single file.
+  ///
+  /// \sa writeCache
+  struct NodeRecordTy {
+    struct Entry {
+      /// Indexes into \c Strings.
+      uint32_t Name;
+      uint32_t Value;
+      uint8_t Kind;
+      uint8_t DepKind;
+      bool IsCascading;
+    };
+
+    /// The dependency file and the MD5 hash of its contents when it was
+    /// loaded. A record without a path is never cached.
+    std::string Path;
+    std::string ContentHash;
+
+    std::vector<Entry> Entries;
+  };
+  llvm::DenseMap<const void *, NodeRecordTy> Records;
+
+  /// The strings used by \c Records, uniqued.
+  llvm::StringMap<uint32_t> StringIDs;
+  std::vector<StringRef> Strings;
+
+  uint32_t internString(StringRef str);
+  static bool isValidRecordEntry(const NodeRecordTy::Entry &entry);
+
+  /// The callbacks through which a parser feeds a node's dependency data to
+  /// the graph.
+  struct LoadCallbacks;
+
   LoadResult loadFromBuffer(const void *node, llvm::MemoryBuffer &buffer);
+  LoadResult loadFromParser(
+      const void *node,
+      llvm::function_ref<LoadResult(const LoadCallbacks &)> parse);
 
   // FIXME: We should be able to use llvm::mapped_iterator for this, but
   // StringMapConstIterator isn't quite an InputIterator (no ->).
@@ -161,6 +230,13 @@ private:
 protected:
   LoadResult loadFromString(const void *node, StringRef data);
   LoadResult loadFromPath(const void *node, StringRef path);
+  bool loadFromCache(StringRef path,
+                     llvm::function_ref<const void *(StringRef)> getNodeForPath,
+                     SmallVectorImpl<const void *> &loaded);
+
+  void discardCachedRecord(const void *node) {
+    Records.erase(node);
+  }
 
   void addIndependentNode(const void *node) {
     bool newlyInserted = Provides.insert({node, {}}).second;
@@ -169,7 +245,8 @@ protected:
   }
 
   void markTransitive(SmallVectorImpl<const void *> &visited,
-                      const void *node, MarkTracerImpl *tracer = nullptr);
+                      const void *node, MarkTracerImpl *tracer = nullptr,
+                      bool onlyChangedDecls = false);
   bool markIntransitive(const void *node) {
     assert(Provides.count(node) && "node is not in the graph");
     return Marked.insert(node).second;
@@ -182,7 +259,20 @@ protected:
     return Marked.count(node);
   }
 
+  /// Returns true if \p node has been marked and all of its dependents have
+  /// already been traversed.
+  bool isMarkedThrough(const void *node) const {
+    return isMarked(node) && !PartiallyMarked.count(node);
+  }
+
 public:
+  /// Writes the dependency data of every node that was loaded from a file to
+  /// a single binary cache at \p path, which can be loaded much faster than
+  /// the individual dependency files.
+  ///
+  /// \returns true on error.
+  bool writeCache(StringRef path) const;
+
   llvm::iterator_range<StringSetIterator> getExternalDependencies() const {
     return llvm::make_range(StringSetIterator(ExternalDependencies.begin()),
                             StringSetIterator(ExternalDependencies.end()));
@@ -258,6 +348,36 @@ public:
                                                data);
   }
 
+  /// Load "depends" and "provides" data from a cache written by #writeCache.
+  ///
+  /// Each cached node is looked up by the path of its dependency file using
+  /// \p getNodeForPath. Only nodes whose dependency files have not changed
+  /// since they were cached are loaded, and are added to \p loaded; the rest
+  /// must be loaded with #loadFromPath as usual.
+  ///
+  /// \returns true if the cache could not be read, in which case the graph
+  /// is left unchanged.
+  template <unsigned N>
+  bool loadFromCache(StringRef path,
+                     llvm::function_ref<Optional<T>(StringRef)> getNodeForPath,
+                     SmallVector<T, N> &loaded) {
+    SmallVector<const void *, N> rawLoaded;
+    bool hadError = DependencyGraphImpl::loadFromCache(path,
+                                        [&](StringRef nodePath) -> const void * {
+      if (auto node = getNodeForPath(nodePath))
+        return Traits::getAsVoidPointer(node.getValue());
+      return nullptr;
+    }, rawLoaded);
+    copyBack(loaded, rawLoaded);
+    return hadError;
+  }
+
+  /// Keeps \p node out of the cache written by #writeCache, for when its
+  /// dependency file may have changed without being reloaded.
+  void discardCachedRecord(T node) {
+    DependencyGraphImpl::discardCachedRecord(Traits::getAsVoidPointer(node));
+  }
+
   /// Adds \p node to the dependency graph without any connections.
   ///
   /// This can be used for new nodes that may be updated later.
@@ -279,13 +399,19 @@ public:
   ///
   /// If you want to see how each node gets added to \p visited, pass a local
   /// MarkTracer instance to \p tracer.
+  ///
+  /// If \p onlyChangedDecls is true and the last load of \p node recorded
+  /// which of its declarations' fingerprints changed, only nodes that depend
+  /// on those declarations are traversed from \p node. This is only correct
+  /// when \p node itself was not affected by a cascading change.
   template <unsigned N>
   void markTransitive(SmallVector<T, N> &visited, T node,
-                      MarkTracer *tracer = nullptr) {
+                      MarkTracer *tracer = nullptr,
+                      bool onlyChangedDecls = false) {
     SmallVector<const void *, N> rawMarked;
     DependencyGraphImpl::markTransitive(rawMarked,
                                         Traits::getAsVoidPointer(node),
-                                        tracer);
+                                        tracer, onlyChangedDecls);
     // FIXME: How can we avoid this copy?
     copyBack(visited, rawMarked);
   }
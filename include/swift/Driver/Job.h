@@ -75,6 +75,11 @@ public:
 
   const std::string &getAnyOutputForType(types::ID type) const;
 
+  const llvm::SmallDenseMap<types::ID, std::string, 4> &
+  getAdditionalOutputs() const {
+    return AdditionalOutputsMap;
+  }
+
   StringRef getBaseInput(int Index) const { return BaseInputs[Index]; }
 };
 
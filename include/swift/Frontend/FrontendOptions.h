@@ -115,9 +115,23 @@ public:
   /// The path to which we should output fixits as source edits.
   std::string FixitsOutputPath;
 
+  /// The path to which we should output the start and end time of each
+  /// compilation phase.
+  ///
+  /// \sa swift::SharedTimer
+  std::string PhaseTimingsFilePath;
+
+  /// The directory in which to write a JSON file of counters and phase times
+  /// for this frontend job.
+  std::string StatsOutputDir;
+
   /// Arguments which should be passed in immediate mode.
   std::vector<std::string> ImmediateArgv;
 
+  /// The directory in which immediate mode caches the machine code generated
+  /// for a script, or empty if it should always be generated from scratch.
+  std::string ImmediateObjectCachePath;
+
   /// \brief A list of arguments to forward to LLVM's option processing; this
   /// should only be used for debugging and experimental features.
   std::vector<std::string> LLVMArgs;
@@ -185,6 +199,13 @@ public:
   /// until the end of all files.
   bool DelayedFunctionBodyParsing = false;
 
+  /// Indicates whether function bodies in files other than the primary file
+  /// should be skipped, so that only their declarations are parsed.
+  ///
+  /// @_transparent bodies are still parsed, since their callers may need
+  /// them. Has no effect when there is no primary file.
+  bool SkipSecondaryFunctionBodies = false;
+
   /// Indicates whether or not an import statement can pick up a Swift source
   /// file (as opposed to a module file).
   bool EnableSourceImport = false;
@@ -220,6 +241,10 @@ public:
   /// termination.
   bool PrintStats = false;
 
+  /// Indicates whether or not the frontend should print how much memory the
+  /// compiler's main data structures use after each phase.
+  bool PrintMemoryStats = false;
+
   /// Indicates whether or not the Clang importer should print statistics upon
   /// termination.
   bool PrintClangStats = false;
@@ -18,6 +18,7 @@
 #ifndef SWIFT_IMMEDIATE_IMMEDIATE_H
 #define SWIFT_IMMEDIATE_IMMEDIATE_H
 
+#include "swift/Basic/LLVM.h"
 #include <string>
 #include <vector>
 
@@ -35,9 +36,13 @@ namespace swift {
 
   /// Attempt to run the script identified by the given compiler instance.
   ///
+  /// \param ObjectCachePath If non-empty, a directory in which to cache the
+  /// generated machine code across runs.
+  ///
   /// \return the result returned from main(), if execution succeeded
   int RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
-                     IRGenOptions &IRGenOpts, const SILOptions &SILOpts);
+                     IRGenOptions &IRGenOpts, const SILOptions &SILOpts,
+                     StringRef ObjectCachePath = StringRef());
 
   void runREPL(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
                bool ParseStdlib);
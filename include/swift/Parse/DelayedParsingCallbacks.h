@@ -44,6 +44,18 @@ class AlwaysDelayedCallbacks : public DelayedParsingCallbacks {
   }
 };
 
+/// \brief Skips every function body except those marked @_transparent, which
+/// are delayed instead.
+///
+/// Used when only the declarations in a file are needed, such as for
+/// secondary files in a single-file compilation.
+class SkipNonTransparentFunctions : public DelayedParsingCallbacks {
+  bool shouldDelayFunctionBodyParsing(Parser &TheParser,
+                                      AbstractFunctionDecl *AFD,
+                                      const DeclAttributes &Attrs,
+                                      SourceRange BodyRange) override;
+};
+
 /// \brief Implementation of callbacks that guide the parser in delayed
 /// parsing for code completion.
 class CodeCompleteDelayedCallbacks : public DelayedParsingCallbacks {
@@ -293,6 +293,23 @@ private:
 
   std::vector<ReflectionInfo> ReflectionInfos;
 
+  /// Descriptors from ReflectionInfos, by mangled type name or remote
+  /// address. Built on first lookup and extended when more images are added.
+  /// The first descriptor registered for a name wins, as with a linear scan.
+  std::unordered_map<std::string, const FieldDescriptor *> FieldTypeInfoIndex;
+  std::unordered_map<std::string, const BuiltinTypeDescriptor *>
+    BuiltinTypeInfoIndex;
+  std::unordered_map<std::string,
+                     std::vector<const AssociatedTypeDescriptor *>>
+    AssociatedTypeIndex;
+  std::unordered_map<uintptr_t, const CaptureDescriptor *> CaptureIndex;
+
+  /// The number of entries of ReflectionInfos covered by the indexes above.
+  size_t NumIndexedReflectionInfos = 0;
+
+  /// Add any images registered since the last lookup to the indexes.
+  void updateReflectionInfoIndexes();
+
   const AssociatedTypeDescriptor *
   lookupAssociatedTypes(const std::string &MangledTypeName,
                         const DependentMemberTypeRef *DependentMember);
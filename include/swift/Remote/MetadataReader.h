@@ -528,7 +528,14 @@ public:
   }
 
   /// Get the remote process's swift_isaMask.
+  ///
+  /// The mask is a constant of the remote runtime, so it is only looked up
+  /// once; this keeps readMetadataFromInstance down to a single read when
+  /// classifying many heap objects.
   std::pair<bool, StoredPointer> readIsaMask() {
+    if (hasIsaMask)
+      return {true, isaMask};
+
     auto address = Reader->getSymbolAddress("swift_isaMask");
     if (!address)
       return {false, 0};
@@ -624,16 +631,18 @@ public:
       std::vector<BuiltType> elementTypes;
       elementTypes.reserve(tupleMeta->NumElements);
 
+      // Read all of the elements at once.
       StoredPointer elementAddress = MetadataAddress +
         sizeof(TargetTupleTypeMetadata<Runtime>);
       using Element = typename TargetTupleTypeMetadata<Runtime>::Element;
-      for (StoredPointer i = 0; i < tupleMeta->NumElements; ++i,
-           elementAddress += sizeof(Element)) {
-        Element element;
-        if (!Reader->readBytes(RemoteAddress(elementAddress),
-                               (uint8_t*)&element, sizeof(Element)))
-          return BuiltType();
+      std::vector<Element> elements(tupleMeta->NumElements);
+      if (!elements.empty() &&
+          !Reader->readBytes(RemoteAddress(elementAddress),
+                             (uint8_t*)elements.data(),
+                             elements.size() * sizeof(Element)))
+        return BuiltType();
 
+      for (auto &element : elements) {
         if (auto elementType = readTypeFromMetadata(element.Type))
           elementTypes.push_back(elementType);
         else
@@ -656,15 +665,20 @@ public:
 
       std::vector<BuiltType> Arguments;
       std::vector<bool> ArgumentIsInOut;
+
+      // Read all of the argument type pointers at once.
       StoredPointer ArgumentAddress = MetadataAddress +
         sizeof(TargetFunctionTypeMetadata<Runtime>);
-      for (StoredPointer i = 0; i < Function->getNumArguments(); ++i,
-           ArgumentAddress += sizeof(StoredPointer)) {
-        StoredPointer FlaggedArgumentAddress;
-        if (!Reader->readInteger(RemoteAddress(ArgumentAddress),
-                                 &FlaggedArgumentAddress))
-          return BuiltType();
+      std::vector<StoredPointer> FlaggedArgumentAddresses(
+        Function->getNumArguments());
+      if (!FlaggedArgumentAddresses.empty() &&
+          !Reader->readBytes(RemoteAddress(ArgumentAddress),
+                             (uint8_t*)FlaggedArgumentAddresses.data(),
+                             FlaggedArgumentAddresses.size() *
+                               sizeof(StoredPointer)))
+        return BuiltType();
 
+      for (auto FlaggedArgumentAddress : FlaggedArgumentAddresses) {
         // TODO: Use target-agnostic FlaggedPointer to mask this!
         const auto InOutMask = (StoredPointer) 1;
         ArgumentIsInOut.push_back((FlaggedArgumentAddress & InOutMask) != 0);
@@ -1140,13 +1154,15 @@ private:
     auto addressOfGenericArgAddress =
       metadata.getAddress() + offsetToGenericArgs;
 
-    using ArgIndex = decltype(descriptor->GenericParams.NumPrimaryParams);
-    for (ArgIndex i = 0; i < numGenericParams;
-         ++i, addressOfGenericArgAddress += sizeof(StoredPointer)) {
-      StoredPointer genericArgAddress;
-      if (!Reader->readInteger(RemoteAddress(addressOfGenericArgAddress),
-                               &genericArgAddress))
-        return {};
+    // Read all of the generic argument pointers at once.
+    std::vector<StoredPointer> genericArgAddresses(numGenericParams);
+    if (!genericArgAddresses.empty() &&
+        !Reader->readBytes(RemoteAddress(addressOfGenericArgAddress),
+                           (uint8_t*)genericArgAddresses.data(),
+                           genericArgAddresses.size() * sizeof(StoredPointer)))
+      return {};
+
+    for (auto genericArgAddress : genericArgAddresses) {
       if (auto genericArg = readTypeFromMetadata(genericArgAddress))
         substitutions.push_back(genericArg);
       else
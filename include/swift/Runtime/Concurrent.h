@@ -14,6 +14,7 @@
 #include <iterator>
 #include <atomic>
 #include <stdint.h>
+#include "swift/Runtime/Mutex.h"
 
 #if defined(__FreeBSD__)
 #include <stdio.h>
@@ -313,4 +314,203 @@ public:
   }
 };
 
+/// A concurrent map that is implemented using an open-addressed hash table.
+/// It supports concurrent insertions but does not support removals.
+///
+/// Lookups never block: they load the current table and probe it linearly.
+/// Insertions that miss are serialized by a lock. When the table becomes
+/// more than three-quarters full, it is replaced by a table twice as large.
+/// Replaced tables are kept alive until the map is destroyed, because
+/// readers may still be probing them.
+///
+/// Entries are allocated separately from the table and never move, so a
+/// pointer returned by find or getOrInsert remains valid for the lifetime
+/// of the map.
+///
+/// The entry type must provide the following operations:
+///
+///   /// Hash a key.  KeyTy is the type of the key provided to find or
+///   /// getOrInsert.
+///   static size_t getKeyHash(const KeyTy &key);
+///
+///   /// A ternary comparison.  Only equality is significant to this map,
+///   /// so entry types can be shared with ConcurrentMap.
+///   int compareWithKey(KeyTy key) const;
+///
+///   /// Return the amount of extra trailing space required by an entry,
+///   /// where KeyTy is the type of the first argument to getOrInsert and
+///   /// ArgTys is the type of the remaining arguments.
+///   static size_t getExtraAllocationSize(KeyTy key, ArgTys...)
+template <class EntryTy> class ConcurrentHashMap {
+  struct Node {
+    /// The hash of the entry's key, cached so that probes and rehashing
+    /// don't need to touch the payload.
+    size_t Hash;
+    EntryTy Payload;
+
+    template <class... Args>
+    Node(size_t hash, Args &&... args)
+      : Hash(hash), Payload(std::forward<Args>(args)...) {}
+
+    Node(const Node &) = delete;
+    Node &operator=(const Node &) = delete;
+  };
+
+  struct Table {
+    /// The smaller table that this table replaced, if any.
+    Table *Previous;
+
+    /// The number of slots. Always a power of two.
+    size_t Capacity;
+
+    /// The number of occupied slots. Only accessed with the lock held.
+    size_t Count;
+
+    /// The slots, which are allocated in trailing storage.
+    std::atomic<Node*> *getSlots() {
+      return reinterpret_cast<std::atomic<Node*> *>(this + 1);
+    }
+
+    static Table *allocate(size_t capacity, Table *previous) {
+      void *memory = ::operator new(sizeof(Table) +
+                                    capacity * sizeof(std::atomic<Node*>));
+      auto table = ::new (memory) Table;
+      table->Previous = previous;
+      table->Capacity = capacity;
+      table->Count = 0;
+      auto slots = table->getSlots();
+      for (size_t i = 0; i != capacity; ++i)
+        ::new (&slots[i]) std::atomic<Node*>(nullptr);
+      return table;
+    }
+  };
+
+  /// The number of slots in the first table allocated by the map.
+  static constexpr size_t InitialCapacity = 16;
+
+  /// The current table, or null if nothing has been inserted yet.
+  std::atomic<Table*> Storage;
+
+  /// Serializes insertions and resizing.
+  swift::Mutex WriterLock;
+
+  template <class KeyTy>
+  static Node *findInTable(Table *table, size_t hash, const KeyTy &key) {
+    size_t mask = table->Capacity - 1;
+    auto slots = table->getSlots();
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+      Node *node = slots[i].load(std::memory_order_acquire);
+      // The load factor guarantees that every probe sequence terminates.
+      if (!node)
+        return nullptr;
+      if (node->Hash == hash && node->Payload.compareWithKey(key) == 0)
+        return node;
+    }
+  }
+
+  /// Add a node to a table that is known not to contain it and to have
+  /// room for it. Must be called with the lock held.
+  static void insertIntoTable(Table *table, Node *newNode) {
+    size_t mask = table->Capacity - 1;
+    auto slots = table->getSlots();
+    for (size_t i = newNode->Hash & mask; ; i = (i + 1) & mask) {
+      if (!slots[i].load(std::memory_order_relaxed)) {
+        slots[i].store(newNode, std::memory_order_release);
+        ++table->Count;
+        return;
+      }
+    }
+  }
+
+  /// Replace the current table with one that has twice the capacity.
+  /// Must be called with the lock held.
+  Table *grow(Table *table) {
+    size_t newCapacity = table ? table->Capacity * 2 : InitialCapacity;
+    Table *newTable = Table::allocate(newCapacity, table);
+    if (table) {
+      auto slots = table->getSlots();
+      for (size_t i = 0; i != table->Capacity; ++i)
+        if (Node *node = slots[i].load(std::memory_order_relaxed))
+          insertIntoTable(newTable, node);
+    }
+    // Publish the new table only after it has been fully populated.
+    Storage.store(newTable, std::memory_order_release);
+    return newTable;
+  }
+
+public:
+  ConcurrentHashMap() : Storage(nullptr) {}
+
+  ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+  ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+  ~ConcurrentHashMap() {
+    // These can be relaxed accesses because there is no safe way for
+    // another thread to race an access to this map with its destruction.
+    Table *table = Storage.load(std::memory_order_relaxed);
+    if (table) {
+      auto slots = table->getSlots();
+      for (size_t i = 0; i != table->Capacity; ++i) {
+        if (Node *node = slots[i].load(std::memory_order_relaxed)) {
+          node->~Node();
+          ::operator delete(node);
+        }
+      }
+    }
+    while (table) {
+      Table *previous = table->Previous;
+      ::operator delete(table);
+      table = previous;
+    }
+  }
+
+  /// Search for a value by key \p Key.
+  /// \returns a pointer to the value or null if the value is not in the map.
+  template <class KeyTy>
+  EntryTy *find(const KeyTy &key) {
+    Table *table = Storage.load(std::memory_order_acquire);
+    if (!table)
+      return nullptr;
+    if (Node *node = findInTable(table, EntryTy::getKeyHash(key), key))
+      return &node->Payload;
+    return nullptr;
+  }
+
+  /// Get or create an entry in the map.
+  ///
+  /// \returns the entry in the map and whether a new node was added (true)
+  ///   or already existed (false)
+  template <class KeyTy, class... ArgTys>
+  std::pair<EntryTy*, bool> getOrInsert(KeyTy key, ArgTys &&... args) {
+    size_t hash = EntryTy::getKeyHash(key);
+
+    // Try without the lock first.
+    if (Table *table = Storage.load(std::memory_order_acquire)) {
+      if (Node *node = findInTable(table, hash, key))
+        return { &node->Payload, false };
+    }
+
+    swift::ScopedLock guard(WriterLock);
+
+    // Another thread may have inserted the key while we waited on the lock.
+    Table *table = Storage.load(std::memory_order_relaxed);
+    if (table) {
+      if (Node *node = findInTable(table, hash, key))
+        return { &node->Payload, false };
+    }
+
+    // Keep the load factor at or below three-quarters.
+    if (!table || (table->Count + 1) * 4 > table->Capacity * 3)
+      table = grow(table);
+
+    size_t allocSize =
+      sizeof(Node) + EntryTy::getExtraAllocationSize(key, args...);
+    void *memory = ::operator new(allocSize);
+    Node *newNode = ::new (memory) Node(hash, key,
+                                        std::forward<ArgTys>(args)...);
+    insertIntoTable(table, newNode);
+    return { &newNode->Payload, true };
+  }
+};
+
 #endif // SWIFT_RUNTIME_CONCURRENTUTILS_H
@@ -39,6 +39,7 @@ template <typename Runtime> struct TargetHeapMetadata;
 using HeapMetadata = TargetHeapMetadata<InProcess>;
 
 struct OpaqueValue;
+struct ValueBuffer;
 
 /// Allocates a new heap object.  The returned memory is
 /// uninitialized outside of the heap-object header.  The object
@@ -88,6 +89,37 @@ extern "C" HeapObject *swift_initStackObject(HeapMetadata const *metadata,
 SWIFT_RUNTIME_EXPORT
 extern "C" void swift_verifyEndOfLifetime(HeapObject *object);
 
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+
+/// A region of memory that objects can be allocated in and released from
+/// all at once. Only available when the runtime is built with
+/// SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS.
+struct AllocationRegion;
+
+/// Push a new allocation region on the current thread.
+///
+/// Until the region is popped, swift_allocObject on this thread
+/// bump-allocates from the region instead of the heap. Objects released
+/// before then are destroyed as usual, but their memory is only reclaimed
+/// with the region.
+///
+/// \returns the region, which must be passed to swift_popAllocationRegion.
+SWIFT_RUNTIME_EXPORT
+extern "C" AllocationRegion *swift_pushAllocationRegion();
+
+/// Pop an allocation region, which must be the innermost region pushed on
+/// the current thread.
+///
+/// Objects in the region that are still alive are destroyed, in reverse
+/// order of allocation, and then the region's memory is freed. Memory that
+/// holds an object with outstanding unowned or weak references is kept, so
+/// that those references still see a deallocated object; it is an error
+/// for a strong reference to an object in the region to be used afterwards.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_popAllocationRegion(AllocationRegion *region);
+
+#endif // SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+
 /// A structure that's two pointers in size.
 ///
 /// C functions can use the TwoWordPair::Return type to return a value in
@@ -481,6 +513,57 @@ extern "C" void swift_deallocBox(HeapObject *object);
 SWIFT_RUNTIME_EXPORT
 extern "C" OpaqueValue *swift_projectBox(HeapObject *object);
 
+// The following functions implement fixed-size buffers for values that
+// can't be stored inline when existentials are copy-on-write (see
+// SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS). Such a value lives in a box
+// allocated by swift_allocBox, and copies of the buffer share the box.
+
+/// Allocate a box for a value of the given type and store it in an
+/// uninitialized buffer.
+///
+/// \returns the address of the uninitialized value inside the box.
+SWIFT_RUNTIME_EXPORT
+extern "C" OpaqueValue *swift_allocBufferBox(ValueBuffer *buffer,
+                                             const Metadata *type);
+
+/// Project the value out of the box in a buffer, first replacing the box
+/// with a copy if it is shared with another buffer.
+///
+/// The returned value may be modified or taken. Only use this when the
+/// buffer is accessed exclusively; reads should use
+/// swift_projectBufferForRead.
+SWIFT_RUNTIME_EXPORT
+extern "C" OpaqueValue *swift_projectBufferBox(ValueBuffer *buffer,
+                                               const Metadata *type);
+
+/// Project the value of the given type out of a buffer without changing the
+/// buffer, whether the value is stored inline or out of line.
+///
+/// Unlike swift_projectBufferBox, this never copies a shared box, so any
+/// number of threads may read through the same buffer at once. The returned
+/// value must not be modified or taken.
+SWIFT_RUNTIME_EXPORT
+extern "C" OpaqueValue *swift_projectBufferForRead(ValueBuffer *buffer,
+                                                   const Metadata *type);
+
+/// Initialize an uninitialized buffer by sharing the box in another buffer.
+///
+/// \returns the address of the shared value, which must not be modified
+///   without projecting it again.
+SWIFT_RUNTIME_EXPORT
+extern "C" OpaqueValue *swift_copyBufferBox(ValueBuffer *dest,
+                                            ValueBuffer *src);
+
+/// Deallocate the box in a buffer after its value has been taken, or
+/// before the value was initialized.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_deallocBufferBox(ValueBuffer *buffer);
+
+/// Release the box in a buffer, destroying the value if this was the last
+/// buffer sharing it.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_destroyBufferBox(ValueBuffer *buffer);
+
 /// RAII object that wraps a Swift heap object and releases it upon
 /// destruction.
 class SwiftRAII {
@@ -1155,6 +1238,14 @@ static inline void swift_unknownUnownedTakeAssign(UnownedReference *dest,
 
 #endif /* SWIFT_OBJC_INTEROP */
 
+/// Write the allocations sampled so far by the runtime's allocation profiler
+/// to \p path as a pprof profile.
+///
+/// Sampling is enabled by setting SWIFT_ALLOCATION_PROFILE in the
+/// environment. Returns false if sampling is disabled or the file can't be
+/// written.
+SWIFT_RUNTIME_EXPORT
+extern "C" bool swift_writeAllocationProfile(const char *path);
 
 } // end namespace swift
 
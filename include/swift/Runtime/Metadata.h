@@ -3447,6 +3447,38 @@ extern "C"
 void swift_registerTypeMetadataRecords(const TypeMetadataRecord *begin,
                                        const TypeMetadataRecord *end);
 
+/// A snapshot of the statistics for one runtime cache, as reported by
+/// swift_enumerateMetadataStatistics.
+struct SwiftMetadataStatistics {
+  /// The name of the cache, e.g. "GenericCache" or "ConformanceCache".
+  const char *Name;
+  uint64_t Hits;
+  uint64_t Misses;
+  uint64_t Instantiations;
+  uint64_t Bytes;
+  uint64_t Nanoseconds;
+};
+
+/// Call \p callback with the current statistics of each runtime metadata
+/// and conformance cache that has been used. The first record, named
+/// "MetadataAllocator", reports only the bytes obtained from the system
+/// for metadata.
+///
+/// Statistics are only collected when the SWIFT_DEBUG_METADATA_STATISTICS
+/// environment variable is set; otherwise all counters are zero.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+void swift_enumerateMetadataStatistics(
+    void (*callback)(const SwiftMetadataStatistics *statistics, void *context),
+    void *context);
+
+/// Print the statistics reported by swift_enumerateMetadataStatistics to
+/// stderr. This happens automatically at exit when
+/// SWIFT_DEBUG_METADATA_STATISTICS is set.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+void swift_dumpMetadataStatistics();
+
 /// Return the type name for a given type metadata.
 std::string nameForMetadata(const Metadata *type,
                             bool qualified = true);
@@ -915,6 +915,15 @@ public:
     return LiveLeafIndices.size();
   }
 
+  /// Returns true if some part of the projected value is not used, i.e. if
+  /// replacing the value with its live leafs would drop some of its fields.
+  bool hasDeadNodes() const {
+    for (const ProjectionTreeNode *Node : ProjectionTreeNodes)
+      if (!Node->IsLive)
+        return true;
+    return false;
+  }
+
   void createTreeFromValue(SILBuilder &B, SILLocation Loc, SILValue NewBase,
                            llvm::SmallVectorImpl<SILValue> &Leafs) const;
 
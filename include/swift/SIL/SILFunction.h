@@ -173,6 +173,10 @@ private:
   ///    method itself. In this case we need to create a vtable stub for it.
   bool Zombie = false;
 
+  /// The number of times this function was entered in the profile given to
+  /// -profile-use, if there was one and it covered this function.
+  Optional<uint64_t> EntryCount;
+
   SILFunction(SILModule &module, SILLinkage linkage,
               StringRef mangledName, CanSILFunctionType loweredType,
               GenericParamList *contextGenericParams,
@@ -479,6 +483,10 @@ public:
   Inline_t getInlineStrategy() const { return Inline_t(InlineStrategy); }
   void setInlineStrategy(Inline_t inStr) { InlineStrategy = inStr; }
 
+  /// Get the profiled entry count of this function, if there is one.
+  Optional<uint64_t> getEntryCount() const { return EntryCount; }
+  void setEntryCount(Optional<uint64_t> count) { EntryCount = count; }
+
   /// \return the function side effects information.
   EffectsKind getEffectsKind() const { return EffectsKindAttr; }
 
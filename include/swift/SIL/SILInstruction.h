@@ -917,12 +917,18 @@ class ApplyInstBase<Impl, Base, false> : public Base {
 
   /// The number of tail-allocated substitutions, allocated after the operand
   /// list's tail allocation.
-  unsigned NumSubstitutions: 31;
+  unsigned NumSubstitutions: 30;
 
   /// Used for apply_inst instructions: true if the called function has an
   /// error result but is not actually throwing.
   bool NonThrowing: 1;
 
+  /// Used for partial_apply instructions: true if the closure context can be
+  /// allocated on the stack. This can't be a StackPromotable member of
+  /// PartialApplyInst, because the operands are tail-allocated after this
+  /// class.
+  bool OnStack: 1;
+
   /// The number of call arguments as required by the callee.
   unsigned NumCallArguments;
 
@@ -946,7 +952,7 @@ protected:
                 As... baseArgs)
       : Base(kind, DebugLoc, baseArgs...), SubstCalleeType(substCalleeType),
         NumSubstitutions(substitutions.size()), NonThrowing(false),
-        NumCallArguments(args.size()),
+        OnStack(false), NumCallArguments(args.size()),
         Operands(this, args, openedArchetypesOperands, callee) {
     static_assert(sizeof(Impl) == sizeof(*this),
         "subclass has extra storage, cannot use TailAllocatedOperandList");
@@ -968,6 +974,10 @@ protected:
   void setNonThrowing(bool isNonThrowing) { NonThrowing = isNonThrowing; }
   
   bool isNonThrowingApply() const { return NonThrowing; }
+
+  void setOnStack(bool isOnStack) { OnStack = isOnStack; }
+
+  bool isOnStack() const { return OnStack; }
   
 public:
   /// The operand number of the first argument.
@@ -1236,6 +1246,10 @@ public:
 
 /// PartialApplyInst - Represents the creation of a closure object by partial
 /// application of a function value.
+///
+/// If the closure context can be allocated on the stack, the partial_apply is
+/// marked with [stack] and paired with a dealloc_ref [stack] at the end of the
+/// context's lifetime (see StackPromotion).
 class PartialApplyInst
     : public ApplyInstBase<PartialApplyInst, SILInstruction> {
   friend class SILBuilder;
@@ -1260,6 +1274,12 @@ public:
     return getType().castTo<SILFunctionType>();
   }
 
+  /// If true, the closure context can be allocated on the stack (the final
+  /// decision is in IRGen).
+  bool canAllocOnStack() const { return isOnStack(); }
+
+  void setStackAllocatable() { setOnStack(true); }
+
   static bool classof(const ValueBase *V) {
     return V->getKind() == ValueKind::PartialApplyInst;
   }
@@ -1896,29 +1916,31 @@ class LoadReferenceInstBase : public UnaryInstructionBase<K> {
     return SILType::getPrimitiveObjectType(refType.getReferentType());
   }
 
-  unsigned IsTake : 1; // FIXME: pack this somewhere
+  enum : unsigned { IsTakeFlag = 1 };
 
 protected:
   LoadReferenceInstBase(SILDebugLocation loc, SILValue lvalue, IsTake_t isTake)
-    : UnaryInstructionBase<K>(loc, lvalue, getResultType(lvalue->getType())),
-      IsTake(unsigned(isTake)) {
+    : UnaryInstructionBase<K>(loc, lvalue, getResultType(lvalue->getType())) {
+    this->setSubclassFlag(IsTakeFlag, isTake);
   }
 
 public:
-  IsTake_t isTake() const { return IsTake_t(IsTake); }
+  IsTake_t isTake() const {
+    return IsTake_t(this->getSubclassFlag(IsTakeFlag));
+  }
 };
 
 /// An abstract class representing a store to some kind of reference storage.
 template <ValueKind K>
 class StoreReferenceInstBase : public SILInstruction {
   enum { Src, Dest };
+  enum : unsigned { IsInitializationOfDestFlag = 1 };
   FixedOperandList<2> Operands;
-  unsigned IsInitializationOfDest : 1; // FIXME: pack this somewhere
 protected:
   StoreReferenceInstBase(SILDebugLocation loc, SILValue src, SILValue dest,
                          IsInitialization_t isInit)
-    : SILInstruction(K, loc), Operands(this, src, dest),
-      IsInitializationOfDest(unsigned(isInit)) {
+    : SILInstruction(K, loc), Operands(this, src, dest) {
+    setIsInitializationOfDest(isInit);
   }
 
 public:
@@ -1926,10 +1948,10 @@ public:
   SILValue getDest() const { return Operands[Dest].get(); }
 
   IsInitialization_t isInitializationOfDest() const {
-    return IsInitialization_t(IsInitializationOfDest);
+    return IsInitialization_t(getSubclassFlag(IsInitializationOfDestFlag));
   }
   void setIsInitializationOfDest(IsInitialization_t I) {
-    IsInitializationOfDest = (bool)I;
+    setSubclassFlag(IsInitializationOfDestFlag, I);
   }
 
   ArrayRef<Operand> getAllOperands() const { return Operands.asArray(); }
@@ -2012,15 +2034,15 @@ public:
   };
 
 private:
-  // FIXME: compress storage
-
-  /// IsTakeOfSrc - True if ownership will be taken from the value at the source
-  /// memory location.
-  unsigned IsTakeOfSrc : 1;
-
-  /// IsInitializationOfDest - True if this is the initialization of the
-  /// uninitialized destination memory location.
-  unsigned IsInitializationOfDest : 1;
+  enum : unsigned {
+    /// IsTakeOfSrc - True if ownership will be taken from the value at the
+    /// source memory location.
+    IsTakeOfSrcFlag = 1 << 0,
+
+    /// IsInitializationOfDest - True if this is the initialization of the
+    /// uninitialized destination memory location.
+    IsInitializationOfDestFlag = 1 << 1
+  };
 
   FixedOperandList<2> Operands;
 
@@ -2034,16 +2056,18 @@ public:
   void setSrc(SILValue V) { Operands[Src].set(V); }
   void setDest(SILValue V) { Operands[Dest].set(V); }
 
-  IsTake_t isTakeOfSrc() const { return IsTake_t(IsTakeOfSrc); }
+  IsTake_t isTakeOfSrc() const {
+    return IsTake_t(getSubclassFlag(IsTakeOfSrcFlag));
+  }
   IsInitialization_t isInitializationOfDest() const {
-    return IsInitialization_t(IsInitializationOfDest);
+    return IsInitialization_t(getSubclassFlag(IsInitializationOfDestFlag));
   }
 
   void setIsTakeOfSrc(IsTake_t T) {
-    IsTakeOfSrc = (bool)T;
+    setSubclassFlag(IsTakeOfSrcFlag, T);
   }
   void setIsInitializationOfDest(IsInitialization_t I) {
-    IsInitializationOfDest = (bool)I;
+    setSubclassFlag(IsInitializationOfDestFlag, I);
   }
 
   ArrayRef<Operand> getAllOperands() const { return Operands.asArray(); }
@@ -2743,13 +2767,13 @@ public:
     NonAtomic,
   };
 protected:
-  Atomicity atomicity;
-protected:
+  enum : unsigned { NonAtomicFlag = 1 };
+
   RefCountingInst(ValueKind Kind, SILDebugLocation DebugLoc)
-      : SILInstruction(Kind, DebugLoc), atomicity(Atomicity::Atomic) {}
+      : SILInstruction(Kind, DebugLoc) {}
 
   RefCountingInst(ValueKind Kind, SILDebugLocation DebugLoc, SILType Type)
-      : SILInstruction(Kind, DebugLoc, Type), atomicity(Atomicity::Atomic) {}
+      : SILInstruction(Kind, DebugLoc, Type) {}
 
 public:
   static bool classof(const ValueBase *V) {
@@ -2757,12 +2781,17 @@ public:
            V->getKind() <= ValueKind::Last_RefCountingInst;
   }
 
-  void setAtomicity(Atomicity flag) { atomicity = flag; }
-  void setNonAtomic() { atomicity = Atomicity::NonAtomic; }
-  void setAtomic() { atomicity = Atomicity::Atomic; }
-  Atomicity getAtomicity() const { return atomicity; }
-  bool isNonAtomic() const { return atomicity == Atomicity::NonAtomic; }
-  bool isAtomic() const { return atomicity == Atomicity::Atomic; }
+  void setAtomicity(Atomicity flag) {
+    setSubclassFlag(NonAtomicFlag, flag == Atomicity::NonAtomic);
+  }
+  void setNonAtomic() { setAtomicity(Atomicity::NonAtomic); }
+  void setAtomic() { setAtomicity(Atomicity::Atomic); }
+  Atomicity getAtomicity() const {
+    return getSubclassFlag(NonAtomicFlag) ? Atomicity::NonAtomic
+                                          : Atomicity::Atomic;
+  }
+  bool isNonAtomic() const { return getAtomicity() == Atomicity::NonAtomic; }
+  bool isAtomic() const { return getAtomicity() == Atomicity::Atomic; }
 };
 
 /// RetainValueInst - Copies a loadable value.
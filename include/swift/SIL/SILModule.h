@@ -267,6 +267,10 @@ public:
   ModuleDecl *getSwiftModule() const { return TheSwiftModule; }
   /// Get the AST context used for type uniquing etc. by this SIL module.
   ASTContext &getASTContext() const { return TheSwiftModule->getASTContext(); }
+
+  /// Returns the number of bytes allocated for the functions, instructions
+  /// and other pieces of this module.
+  size_t getAllocatedMemory() const { return BPA.getTotalMemory(); }
   SourceManager &getSourceManager() const { return getASTContext().SourceMgr; }
 
   /// Get the Swift DeclContext associated with this SIL module.
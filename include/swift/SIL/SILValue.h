@@ -59,9 +59,22 @@ class alignas(8) ValueBase : public SILAllocated<ValueBase> {
   ValueBase &operator=(const ValueBase &) = delete;
 
 protected:
+  /// Flags for use by subclasses. These occupy what would otherwise be
+  /// padding after Kind, so a flag kept here doesn't grow the instance the
+  /// way a bool or bitfield member in the subclass does.
+  unsigned SubclassData = 0;
+
   ValueBase(ValueKind Kind, SILType Ty)
     : Type(Ty), Kind(Kind) {}
 
+  bool getSubclassFlag(unsigned Mask) const { return SubclassData & Mask; }
+  void setSubclassFlag(unsigned Mask, bool Value) {
+    if (Value)
+      SubclassData |= Mask;
+    else
+      SubclassData &= ~Mask;
+  }
+
 public:
   ~ValueBase() {
     assert(use_empty() && "Cannot destroy a value that still has uses!");
@@ -87,6 +87,14 @@ namespace swift {
     /// this analysis.
     bool invalidationLock;
 
+    /// The number of times this analysis has computed its results.
+    unsigned NumComputations = 0;
+
+  protected:
+    /// Count a (re)computation of this analysis's results. These counts are
+    /// reported by -sil-pass-stats.
+    void recordComputation() { ++NumComputations; }
+
   public:
 
     /// Returns the kind of derived class.
@@ -111,6 +119,9 @@ namespace swift {
     /// Return True if this analysis is locked and should not be invalidated.
     bool isLocked() { return invalidationLock; }
 
+    /// Returns the number of times this analysis has computed its results.
+    unsigned getNumComputations() const { return NumComputations; }
+
     /// Invalidate all information in this analysis.
     virtual void invalidate(InvalidationKind K) {}
 
@@ -173,8 +184,10 @@ namespace swift {
       verifyFunction(F);
 
       auto &it = Storage.FindAndConstruct(F);
-      if (!it.second)
+      if (!it.second) {
         it.second = newFunctionAnalysis(F);
+        recordComputation();
+      }
       return it.second;
     }
 
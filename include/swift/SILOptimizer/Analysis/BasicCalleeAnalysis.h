@@ -136,8 +136,10 @@ public:
   virtual void invalidate(SILFunction *F, InvalidationKind K) { invalidate(K); }
 
   CalleeList getCalleeList(FullApplySite FAS) {
-    if (!Cache)
+    if (!Cache) {
       Cache = llvm::make_unique<CalleeCache>(M);
+      recordComputation();
+    }
 
     return Cache->getCalleeList(FAS);
   }
@@ -393,6 +393,9 @@ public:
       return Values2Nodes.empty() && Nodes.empty() && UsePoints.empty();
     }
 
+    /// Returns the number of allocated nodes, including merged ones.
+    unsigned getNumNodes() const { return Nodes.size(); }
+
     /// Removes all nodes from the graph.
     void clear();
     
@@ -0,0 +1,62 @@
+//===--- InlineCostAnalysis.h - Cached inlining cost ------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SILOPTIMIZER_ANALYSIS_INLINECOSTANALYSIS_H
+#define SWIFT_SILOPTIMIZER_ANALYSIS_INLINECOSTANALYSIS_H
+
+#include "swift/SILOptimizer/Analysis/Analysis.h"
+
+namespace swift {
+
+class SILFunction;
+
+/// The sum of instructionInlineCost over every instruction of a function.
+///
+/// This is an upper bound of what inlining the function costs at any call
+/// site: the inliner only ever subtracts the cost of blocks it proves dead.
+class FunctionInlineCost {
+  int TotalCost = 0;
+
+public:
+  FunctionInlineCost(SILFunction *F);
+
+  int getTotalCost() const { return TotalCost; }
+};
+
+/// Caches the FunctionInlineCost of callees, so that the inliner doesn't
+/// re-walk a function for every call site it considers. Entries are dropped
+/// when the instructions of their function change.
+class InlineCostAnalysis : public FunctionAnalysisBase<FunctionInlineCost> {
+protected:
+  virtual FunctionInlineCost *newFunctionAnalysis(SILFunction *F) override {
+    return new FunctionInlineCost(F);
+  }
+
+  virtual bool shouldInvalidate(SILAnalysis::InvalidationKind K) override {
+    return K & InvalidationKind::Instructions;
+  }
+
+public:
+  InlineCostAnalysis()
+      : FunctionAnalysisBase<FunctionInlineCost>(AnalysisKind::InlineCost) {}
+
+  InlineCostAnalysis(const InlineCostAnalysis &) = delete;
+  InlineCostAnalysis &operator=(const InlineCostAnalysis &) = delete;
+
+  static bool classof(const SILAnalysis *S) {
+    return S->getKind() == AnalysisKind::InlineCost;
+  }
+};
+
+} // end namespace swift
+
+#endif
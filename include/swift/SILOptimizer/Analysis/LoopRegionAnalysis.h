@@ -393,7 +393,11 @@ private:
   llvm::Optional<unsigned> ParentID;
 
   /// The IDs of the predecessor regions of this region.
-  llvm::SmallVector<unsigned, 4> Preds;
+  ///
+  /// There is one region per basic block, so the inline capacity of this list
+  /// and of Succs is kept to what a typical block needs. Regions with more
+  /// edges, like loops with several exits, spill to the heap.
+  llvm::SmallVector<unsigned, 2> Preds;
 
   /// The IDs of the local and non-local successor regions of this region.
   ///
@@ -414,7 +418,7 @@ private:
   /// of a loop, may have a non-local successor edge pointed at this region's
   /// successor edge. If we were to sort these edges, we would need to update
   /// those subregion edges as well which is strictly not necessary.
-  SmallBlotSetVector<SuccessorID, 8> Succs;
+  SmallBlotSetVector<SuccessorID, 2> Succs;
 
   /// True if this region the head of an edge that results from control flow
   /// that we do not handle.
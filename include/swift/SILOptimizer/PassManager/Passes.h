@@ -31,7 +31,7 @@ namespace swift {
   /// \brief Run all the SIL performance optimization passes on \p M.
   void runSILOptimizationPasses(SILModule &M);
 
-  /// \brief Run all SIL passes for -Onone on module \p M.
+  /// \brief Run all SIL passes for -Onone and -Odebug on module \p M.
   void runSILPassesForOnone(SILModule &M);
 
   void runSILOptimizationPassesWithFileSpecification(SILModule &Module,
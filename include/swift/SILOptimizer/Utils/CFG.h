@@ -15,6 +15,7 @@
 
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SIL/SILBuilder.h"
+#include <vector>
 
 namespace swift {
 
@@ -131,5 +132,27 @@ bool splitAllCriticalEdges(SILFunction &F, bool OnlyNonCondBr,
 bool mergeBasicBlockWithSuccessor(SILBasicBlock *BB, DominanceInfo *DT,
                                   SILLoopInfo *LI);
 
+/// \brief The shape of a function's control flow graph: its blocks and their
+/// successor edges.
+///
+/// Comparing the signatures taken before and after a transformation tells
+/// whether the CFG actually changed, and so whether the analyses that only
+/// depend on it (dominance, post order, loops) can be preserved.
+class CFGSignature {
+  /// Each block followed by its successors, in function order. A null
+  /// entry ends each block's successor list.
+  std::vector<SILBasicBlock *> Edges;
+
+public:
+  explicit CFGSignature(SILFunction &F);
+
+  bool operator==(const CFGSignature &Other) const {
+    return Edges == Other.Edges;
+  }
+  bool operator!=(const CFGSignature &Other) const {
+    return !(*this == Other);
+  }
+};
+
 } // End namespace swift.
 #endif
@@ -121,8 +121,17 @@ struct ArgumentDescriptor {
       return false;
 
     size_t explosionSize = ProjTree.liveLeafCount();
-    return explosionSize >= 1 && explosionSize <= 3;
+    if (explosionSize >= 1 && explosionSize <= 3)
+      return true;
+
+    // A bigger explosion is still profitable if the callee only uses a part
+    // of the aggregate, because then the unused fields are not passed anymore.
+    return explosionSize <= MaxPartialExplosionSize && ProjTree.hasDeadNodes();
   }
+
+  /// The maximum number of arguments an aggregate is exploded into if not all
+  /// of its fields are used.
+  static constexpr size_t MaxPartialExplosionSize = 6;
 };
 
 /// A structure that maintains all of the information about a specific
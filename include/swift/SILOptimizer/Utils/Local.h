@@ -217,6 +217,12 @@ bool
 tryDeleteDeadClosure(SILInstruction *Closure,
                      InstModCallbacks Callbacks = InstModCallbacks());
 
+/// Erase the dealloc_ref [stack] instructions which end the lifetime of the
+/// context of a partial_apply [stack]. This must be done before the closure is
+/// replaced with a value which doesn't allocate that context.
+void eraseClosureContextDeallocs(
+    PartialApplyInst *PAI, InstModCallbacks Callbacks = InstModCallbacks());
+
 /// Given a SILValue argument to a partial apply \p Arg and the associated
 /// parameter info for that argument, perform the necessary cleanups to Arg when
 /// one is attempting to delete the partial apply.
@@ -292,6 +292,12 @@ private:
 
   std::unique_ptr<SerializedObjCMethodTable> ObjCMethods;
 
+  class DeclMemberNamesTableInfo;
+  using SerializedDeclMemberNamesTable =
+    llvm::OnDiskIterableChainedHashTable<DeclMemberNamesTableInfo>;
+
+  std::unique_ptr<SerializedDeclMemberNamesTable> DeclMemberNames;
+
   llvm::DenseMap<const ValueDecl *, Identifier> PrivateDiscriminatorsByValue;
 
   TinyPtrVector<Decl *> ImportDecls;
@@ -300,6 +306,30 @@ private:
 
   DeclIDVector EagerDeserializationDecls;
 
+  /// How much of this module has been deserialized, reported by -print-stats.
+  struct DeserializationStats {
+    unsigned NumDecls = 0;
+    unsigned NumTypes = 0;
+    unsigned NumNormalConformances = 0;
+
+    /// The number of bits read from the decls-and-types block.
+    uint64_t NumBitsRead = 0;
+
+    /// Wall time spent in deserialization requests against this module.
+    ///
+    /// Only tracked when statistics are enabled. Time spent in a request
+    /// against another module made on this module's behalf is included.
+    double WallTime = 0;
+  };
+
+  DeserializationStats Stats;
+
+  /// The number of deserialization requests against this module currently
+  /// in progress, so that nested ones don't add to Stats.WallTime again.
+  unsigned StatsDepth = 0;
+
+  class StatsRAII;
+
   class DeclCommentTableInfo;
   using SerializedDeclCommentTable =
       llvm::OnDiskIterableChainedHashTable<DeclCommentTableInfo>;
@@ -400,6 +430,11 @@ private:
   std::unique_ptr<ModuleFile::SerializedObjCMethodTable>
   readObjCMethodTable(ArrayRef<uint64_t> fields, StringRef blobData);
 
+  /// Read an on-disk member name table stored in
+  /// index_block::DeclMemberNamesLayout format.
+  std::unique_ptr<ModuleFile::SerializedDeclMemberNamesTable>
+  readDeclMemberNamesTable(ArrayRef<uint64_t> fields, StringRef blobData);
+
   /// Reads the index block, which contains global tables.
   ///
   /// Returns false if there was an error.
@@ -615,9 +650,23 @@ public:
   /// Has no effect in NDEBUG builds.
   void verify() const;
 
+  /// Returns how much of this module has been deserialized so far.
+  const DeserializationStats &getStats() const { return Stats; }
+
+  /// Returns the size of the serialized module and module doc data backing
+  /// this file.
+  size_t getInputBufferSize() const {
+    return ModuleInputBuffer->getBufferSize() +
+      (ModuleDocInputBuffer ? ModuleDocInputBuffer->getBufferSize() : 0);
+  }
+
   virtual void loadAllMembers(Decl *D,
                               uint64_t contextData) override;
 
+  virtual Optional<TinyPtrVector<ValueDecl *>>
+  loadNamedMembers(const Decl *D, Identifier N,
+                   uint64_t contextData) override;
+
   virtual void
   loadAllConformances(const Decl *D, uint64_t contextData,
                     SmallVectorImpl<ProtocolConformance*> &Conforms) override;
@@ -53,7 +53,7 @@ const uint16_t VERSION_MAJOR = 0;
 /// in source control, you should also update the comment to briefly
 /// describe what change you made. The content of this comment isn't important;
 /// it just ensures a conflict if two people change the module format.
-const uint16_t VERSION_MINOR = 260; // Last change: open
+const uint16_t VERSION_MINOR = 262; // Last change: member name table
 
 using DeclID = PointerEmbeddedInt<unsigned, 31>;
 using DeclIDField = BCFixed<31>;
@@ -1456,6 +1456,11 @@ namespace index_block {
     NORMAL_CONFORMANCE_OFFSETS,
 
     PRECEDENCE_GROUPS,
+
+    /// The member name index, which maps base names to the members of
+    /// nominal types and extensions with that name, keyed by the offset of
+    /// the MEMBERS record that lists them.
+    DECL_MEMBER_NAMES,
   };
 
   using OffsetsLayout = BCGenericRecordLayout<
@@ -1480,6 +1485,12 @@ namespace index_block {
     BCBlob         // map from Objective-C selectors to methods with that selector
   >;
 
+  using DeclMemberNamesLayout = BCRecordLayout<
+    DECL_MEMBER_NAMES, // record ID
+    BCVBR<16>,         // table offset within the blob (see below)
+    BCBlob             // map from base names to member record offsets / IDs
+  >;
+
   using EntryPointLayout = BCRecordLayout<
     ENTRY_POINT,
     DeclIDField  // the ID of the main class; 0 if there was a main source file
@@ -91,6 +91,21 @@ public:
                  llvm::TinyPtrVector<AbstractFunctionDecl *> &methods) override;
 
   virtual void verifyAllModules() override;
+
+  /// Prints, for each serialized module loaded into \p Ctx, how many decls,
+  /// types and conformances have been deserialized from it and what that
+  /// cost.
+  static void printStatistics(ASTContext &Ctx, raw_ostream &OS);
+
+  /// Sums, over every serialized module loaded into \p Ctx, how many decls,
+  /// types and conformances have been deserialized.
+  static void getTotalStatistics(ASTContext &Ctx, uint64_t &NumDecls,
+                                 uint64_t &NumTypes,
+                                 uint64_t &NumConformances);
+
+  /// Prints, for each serialized module loaded into \p Ctx, how much
+  /// serialized data is held in memory for it.
+  static void printMemoryStatistics(ASTContext &Ctx, raw_ostream &OS);
 };
 
 /// A file-unit loaded from a serialized AST file.
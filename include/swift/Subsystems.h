@@ -247,6 +247,26 @@ namespace swift {
                       StringRef ModuleName, llvm::LLVMContext &LLVMContext,
                       unsigned StartElem = 0);
 
+  /// Turn the given Swift module into either LLVM IR or native code
+  /// and return the generated LLVM IR module.
+  ///
+  /// \p SILMod is destroyed as soon as it has been lowered to LLVM IR, so
+  /// that LLVM optimization and code generation can reuse its memory.
+  std::unique_ptr<llvm::Module>
+  performIRGeneration(IRGenOptions &Opts, ModuleDecl *M,
+                      std::unique_ptr<SILModule> SILMod,
+                      StringRef ModuleName, llvm::LLVMContext &LLVMContext);
+
+  /// Turn the given Swift source file into either LLVM IR or native code
+  /// and return the generated LLVM IR module.
+  ///
+  /// \p SILMod is destroyed as soon as it has been lowered to LLVM IR, so
+  /// that LLVM optimization and code generation can reuse its memory.
+  std::unique_ptr<llvm::Module>
+  performIRGeneration(IRGenOptions &Opts, SourceFile &SF,
+                      std::unique_ptr<SILModule> SILMod,
+                      StringRef ModuleName, llvm::LLVMContext &LLVMContext);
+
   /// Given an already created LLVM module, construct a pass pipeline and run
   /// the Swift LLVM Pipeline upon it. This does not cause the module to be
   /// printed, only to be optimized.
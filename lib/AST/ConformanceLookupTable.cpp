@@ -473,6 +473,7 @@ bool ConformanceLookupTable::addProtocol(NominalTypeDecl *nominal,
   /// Build the conformance entry (if it hasn't been built before).
   ConformanceEntry *entry = new (ctx) ConformanceEntry(loc, protocol, source);
   conformanceEntries.push_back(entry);
+  ResolvedProtocols.erase(protocol);
 
   // Record this as a conformance within the given declaration
   // context.
@@ -676,6 +677,11 @@ ConformanceLookupTable::Ordering ConformanceLookupTable::compareConformances(
 bool ConformanceLookupTable::resolveConformances(NominalTypeDecl *nominal,
                                                  ProtocolDecl *protocol,
                                                  LazyResolver *resolver) {
+  // If nothing changed since we last resolved this protocol, there is
+  // nothing new to supersede.
+  if (!ResolvedProtocols.insert(protocol).second)
+    return false;
+
   // Find any entries that are superseded by other entries.
   ConformanceEntries &entries = Conformances[protocol];
   llvm::SmallPtrSet<DeclContext *, 4> knownConformances;
@@ -845,6 +851,7 @@ ProtocolConformance *ConformanceLookupTable::getConformance(
 
   // Record the conformance.
   entry->Conformance = conformance;
+  ResolvedProtocols.erase(protocol);
   return conformance;
 }
 
@@ -868,6 +875,7 @@ void ConformanceLookupTable::registerProtocolConformance(
              entry->getConformance() == conformance &&
              "Mismatched conformances");
       entry->Conformance = conformance;
+      ResolvedProtocols.erase(protocol);
       return;
     }
   }
@@ -886,6 +894,7 @@ void ConformanceLookupTable::registerProtocolConformance(
 
   // Record that this type conforms to the given protocol.
   Conformances[protocol].push_back(entry);
+  ResolvedProtocols.erase(protocol);
 
   // Record this as a conformance within the given declaration
   // context.
@@ -24,6 +24,7 @@
 #include "swift/AST/TypeLoc.h"
 #include "swift/Basic/LLVM.h"
 #include "swift/Basic/SourceLoc.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SetVector.h"
@@ -307,6 +308,13 @@ class ConformanceLookupTable {
   /// The conformance table.
   ConformanceTable Conformances;
 
+  /// The protocols whose entries in the conformance table have been resolved
+  /// by resolveConformances() and have not changed since.
+  ///
+  /// Adding an entry for a protocol, or assigning a conformance to one of its
+  /// entries, removes the protocol from this set.
+  llvm::DenseSet<ProtocolDecl *> ResolvedProtocols;
+
   typedef llvm::SmallVector<ProtocolDecl *, 2> ProtocolList;
 
   /// List of all of the protocols to which a given context declares
@@ -560,6 +560,11 @@ DiagnosticState::Behavior DiagnosticState::determineBehavior(DiagID id) {
   case DiagnosticKind::Error:
     return set(diagInfo.isFatal ? Behavior::Fatal : Behavior::Error);
   case DiagnosticKind::Warning:
+    if (warningLimit && numWarningsEmitted >= warningLimit) {
+      ++numWarningsOverLimit;
+      return set(Behavior::Ignore);
+    }
+    ++numWarningsEmitted;
     return set(Behavior::Warning);
   }
 }
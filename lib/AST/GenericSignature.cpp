@@ -371,8 +371,13 @@ GenericSignature::getCanonicalManglingSignature(ModuleDecl &M) const {
   
   CanGenericSignature canSig(manglingSig);
   
-  // Cache the result.
+  // Cache the result. Minimizing is idempotent, so also record the minimized
+  // signature as its own mangling signature; the mangler and type checker
+  // often ask again for the signature of a type that was already built from a
+  // mangling signature, and would otherwise rebuild the archetype graph.
   Context.ManglingSignatures.insert({{canonical, &M}, canSig});
+  if (canSig != canonical)
+    Context.ManglingSignatures.insert({{canSig, &M}, canSig});
   Context.setArchetypeBuilder(canSig, &M, std::move(builder));
 
   return canSig;
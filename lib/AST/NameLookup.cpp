@@ -932,13 +932,64 @@ void NominalTypeDecl::makeMemberVisible(ValueDecl *member) {
   LookupTable.getPointer()->addMember(member);
 }
 
+/// Ask the loaders of \p nominal and of all of its extensions for just the
+/// members with the base name of \p name, and add them to \p table.
+///
+/// \returns false if some context has already been loaded or cannot be
+/// searched by name, in which case the caller must fall back to loading all
+/// members. Members already added to \p table stay there.
+static bool loadNamedMembers(NominalTypeDecl *nominal, DeclName name,
+                             MemberLookupTable &table) {
+  if (!nominal->hasLazyMembers())
+    return false;
+  for (auto ext : nominal->getExtensions())
+    if (!ext->hasLazyMembers())
+      return false;
+
+  Identifier baseName = name.getBaseName();
+  auto loadFrom = [&](const Decl *container,
+                      const IterableDeclContext *IDC) -> bool {
+    auto members = IDC->getLoader()->loadNamedMembers(
+                     container, baseName, IDC->getLoaderContextData());
+    if (!members)
+      return false;
+    for (auto member : *members)
+      table.addMember(member);
+    return true;
+  };
+
+  if (!loadFrom(nominal, nominal))
+    return false;
+  for (auto ext : nominal->getExtensions())
+    if (!loadFrom(ext, ext))
+      return false;
+  return true;
+}
+
 ArrayRef<ValueDecl *> NominalTypeDecl::lookupDirect(DeclName name,
                                                     bool ignoreNewExtensions) {
-  // Make sure we have the complete list of members (in this nominal and in all
-  // extensions).
-  if (!ignoreNewExtensions) {
-    for (auto E : getExtensions())
-      (void)E->getMembers();
+  // Make sure we have the complete list of extensions. Their members are
+  // loaded when the lookup table includes them, and members added later are
+  // registered through ExtensionDecl::addedMember, so there's no need to walk
+  // every extension on every lookup.
+  if (!ignoreNewExtensions)
+    (void)getExtensions();
+
+  // If the type and its extensions haven't been loaded yet, try to
+  // deserialize only the members with this name. Protocols always load all
+  // of their members along with their default witness table.
+  auto &ctx = getASTContext();
+  if (ctx.LangOpts.EnableNamedLazyMemberLoading && !ignoreNewExtensions &&
+      !isa<ProtocolDecl>(this)) {
+    if (!LookupTable.getPointer())
+      LookupTable.setPointer(new (ctx) MemberLookupTable(ctx));
+
+    if (loadNamedMembers(this, name, *LookupTable.getPointer())) {
+      auto known = LookupTable.getPointer()->find(name);
+      if (known == LookupTable.getPointer()->end())
+        return { };
+      return { known->second.begin(), known->second.size() };
+    }
   }
 
   (void)getMembers();
@@ -22,14 +22,15 @@
 using namespace swift;
 
 ClusteredBitVector ClusteredBitVector::fromAPInt(const llvm::APInt &bits) {
-  // This is not a very efficient algorithm.
+  // This assumes that the chunk size is the same as APInt's, and relies on
+  // APInt keeping the unused high bits of its last word zeroed.
   ClusteredBitVector result;
-  for (unsigned i = 0, e = bits.getBitWidth(); i != e; ++i) {
-    if (bits[i]) {
-      result.appendSetBits(1);
-    } else {
-      result.appendClearBits(1);
-    }
+  auto width = bits.getBitWidth();
+  auto words = bits.getRawData();
+  for (unsigned i = 0, e = bits.getNumWords(); i != e; ++i) {
+    auto numBits = std::min(size_t(width - i * ChunkSizeInBits),
+                            size_t(ChunkSizeInBits));
+    result.add(numBits, words[i]);
   }
   return result;
 }
@@ -11,7 +11,34 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/Basic/Timer.h"
+#include <mutex>
+#include <vector>
 
 using namespace swift;
 
 SharedTimer::State SharedTimer::CompilationTimersEnabled = State::Initial;
+bool SharedTimer::PhaseRecordingEnabled = false;
+
+static std::vector<SharedTimer::PhaseRecord> &getPhaseRecords() {
+  static std::vector<SharedTimer::PhaseRecord> records;
+  return records;
+}
+
+/// Guards the phase records, since LLVM code generation may run on several
+/// threads at once.
+static std::mutex &getPhaseRecordsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+SharedTimer::~SharedTimer() {
+  if (StartTime == llvm::sys::TimeValue::ZeroTime())
+    return;
+  llvm::sys::TimeValue endTime = llvm::sys::TimeValue::now();
+  std::lock_guard<std::mutex> lock(getPhaseRecordsMutex());
+  getPhaseRecords().push_back({ Name, StartTime, endTime });
+}
+
+ArrayRef<SharedTimer::PhaseRecord> SharedTimer::getRecordedPhases() {
+  return getPhaseRecords();
+}
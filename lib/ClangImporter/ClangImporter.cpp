@@ -2352,6 +2352,26 @@ auto ClangImporter::Implementation::importFullName(
        const clang::NamedDecl *D,
        ImportNameOptions options,
        clang::Sema *clangSemaOverride) -> ImportedName {
+  // Names computed against another Sema, such as while writing a module's
+  // lookup table, aren't cached.
+  if (clangSemaOverride)
+    return importFullNameImpl(D, options, clangSemaOverride);
+
+  auto known = ImportNameCache.find({D, options.toRaw()});
+  if (known != ImportNameCache.end() && known->second.first == Generation)
+    return known->second.second;
+
+  // Computing the name can import other names, so look the entry up again
+  // rather than holding on to an iterator.
+  ImportedName result = importFullNameImpl(D, options, nullptr);
+  ImportNameCache[{D, options.toRaw()}] = { Generation, result };
+  return result;
+}
+
+auto ClangImporter::Implementation::importFullNameImpl(
+       const clang::NamedDecl *D,
+       ImportNameOptions options,
+       clang::Sema *clangSemaOverride) -> ImportedName {
   clang::Sema &clangSema = clangSemaOverride ? *clangSemaOverride
                                              : getClangSema();
   ImportedName result;
@@ -4445,6 +4465,7 @@ ClangImporter::Implementation::SwiftNameLookupExtension::hashExtension(
   return llvm::hash_combine(code, StringRef("swift.lookup"),
                             SWIFT_LOOKUP_TABLE_VERSION_MAJOR,
                             SWIFT_LOOKUP_TABLE_VERSION_MINOR,
+                            version::getSwiftFullVersion(),
                             Impl.InferImportAsMember,
                             Impl.HonorSwiftNewtypeAttr);
 }
@@ -1037,6 +1037,28 @@ static bool addErrorDomain(NominalTypeDecl *swiftDecl,
   return addErrorDomain(swiftDecl, clangNamedDecl, importer);
 }
 
+/// Determine whether any of the declarations imported from \p decl,
+/// including its Swift 2 stub and the declaration imported without the
+/// factory-method-as-initializer transformation, may have the base name
+/// \p name.
+static bool mayImportWithBaseName(ClangImporter::Implementation &Impl,
+                                  const clang::NamedDecl *decl,
+                                  Identifier name) {
+  using ImportNameFlags = ClangImporter::Implementation::ImportNameFlags;
+  using ImportNameOptions = ClangImporter::Implementation::ImportNameOptions;
+
+  for (ImportNameOptions options : {
+         ImportNameOptions(),
+         ImportNameOptions(ImportNameFlags::SuppressFactoryMethodAsInit),
+         ImportNameOptions(ImportNameFlags::Swift2Name),
+         ImportNameOptions(ImportNameFlags::Swift2Name) |
+           ImportNameFlags::SuppressFactoryMethodAsInit }) {
+    if (Impl.importFullName(decl, options).Imported.getBaseName() == name)
+      return true;
+  }
+  return false;
+}
+
 namespace {
   /// \brief Convert Clang declarations into the corresponding Swift
   /// declarations.
@@ -5180,16 +5202,23 @@ namespace {
 
     /// Import members of the given Objective-C container and add them to the
     /// list of corresponding Swift members.
+    ///
+    /// If \p filterName is given, only members that may be imported with
+    /// that base name are imported.
     void importObjCMembers(const clang::ObjCContainerDecl *decl,
                            DeclContext *swiftContext,
                            llvm::SmallPtrSet<Decl *, 4> &knownMembers,
-                           SmallVectorImpl<Decl *> &members) {
+                           SmallVectorImpl<Decl *> &members,
+                           Identifier filterName = Identifier()) {
       for (auto m = decl->decls_begin(), mEnd = decl->decls_end();
            m != mEnd; ++m) {
         auto nd = dyn_cast<clang::NamedDecl>(*m);
         if (!nd || nd != nd->getCanonicalDecl())
           continue;
 
+        if (!filterName.empty() && !mayImportWithBaseName(Impl, nd, filterName))
+          continue;
+
         auto member = Impl.importDecl(nd, useSwift2Name);
         if (!member) continue;
 
@@ -5230,11 +5259,15 @@ namespace {
     /// it may still be necessary when the protocol's instance methods become
     /// class methods on a root class (e.g. NSObject-the-protocol's instance
     /// methods become class methods on NSObject).
+    ///
+    /// If \p filterName is given, only protocol members with that base name
+    /// are mirrored.
     void importMirroredProtocolMembers(const clang::ObjCContainerDecl *decl,
                                        DeclContext *dc,
                                        ArrayRef<ProtocolDecl *> protocols,
                                        SmallVectorImpl<Decl *> &members,
-                                       ASTContext &Ctx) {
+                                       ASTContext &Ctx,
+                                       Identifier filterName = Identifier()) {
       assert(dc);
       const clang::ObjCInterfaceDecl *interfaceDecl = nullptr;
       const ClangModuleUnit *declModule;
@@ -5272,6 +5305,12 @@ namespace {
           if (member->getAttrs().isUnavailableInCurrentSwift())
             continue;
 
+          if (!filterName.empty()) {
+            auto value = dyn_cast<ValueDecl>(member);
+            if (!value || value->getFullName().getBaseName() != filterName)
+              continue;
+          }
+
           if (auto prop = dyn_cast<VarDecl>(member)) {
             auto objcProp =
               dyn_cast_or_null<clang::ObjCPropertyDecl>(prop->getClangDecl());
@@ -7309,6 +7348,64 @@ ClangImporter::Implementation::loadAllMembers(Decl *D, uint64_t extra) {
 
 }
 
+Optional<TinyPtrVector<ValueDecl *>>
+ClangImporter::Implementation::loadNamedMembers(const Decl *D, Identifier N,
+                                                uint64_t extra) {
+  assert(D);
+
+  // Globals imported as members are only loaded all at once.
+  auto objcContainer =
+    dyn_cast_or_null<clang::ObjCContainerDecl>(D->getClangDecl());
+  if (!objcContainer)
+    return None;
+
+  // Initializers may be inherited from the superclass, and subscripts are
+  // formed from pairs of methods, so they need every member.
+  if (N == SwiftContext.Id_init || N == SwiftContext.Id_subscript)
+    return None;
+
+  clang::PrettyStackTraceDecl trace(objcContainer, clang::SourceLocation(),
+                                    Instance->getSourceManager(),
+                                    "loading named members for");
+
+  SwiftDeclConverter converter(*this, /*useSwift2Name=*/false);
+  SwiftDeclConverter swift2Converter(*this, /*useSwift2Name=*/true);
+
+  auto DC = const_cast<DeclContext *>(cast<DeclContext>(D));
+
+  ImportingEntityRAII Importing(*this);
+
+  SmallVector<Decl *, 16> members;
+  llvm::SmallPtrSet<Decl *, 4> knownMembers;
+  converter.importObjCMembers(objcContainer, DC, knownMembers, members, N);
+  swift2Converter.importObjCMembers(objcContainer, DC, knownMembers, members,
+                                    N);
+
+  // Mirror protocol members the same way loadAllMembers will, but leave the
+  // recorded protocols in place for it.
+  auto known = ImportedProtocols.find(D);
+  if (known != ImportedProtocols.end()) {
+    if (auto clangClass = dyn_cast<clang::ObjCInterfaceDecl>(objcContainer))
+      objcContainer = clangClass->getDefinition();
+    else if (auto clangProto = dyn_cast<clang::ObjCProtocolDecl>(objcContainer))
+      objcContainer = clangProto->getDefinition();
+
+    converter.importMirroredProtocolMembers(objcContainer, DC, known->second,
+                                            members, SwiftContext, N);
+  }
+
+  // Everything imported above is cached, so loadAllMembers will produce the
+  // same declarations again.
+  TinyPtrVector<ValueDecl *> results;
+  for (auto member : members) {
+    auto value = dyn_cast<ValueDecl>(member);
+    if (value && value->getDeclContext() == DC &&
+        value->getFullName().getBaseName() == N)
+      results.push_back(value);
+  }
+  return results;
+}
+
 void ClangImporter::Implementation::loadAllConformances(
        const Decl *D, uint64_t contextData,
        SmallVectorImpl<ProtocolConformance *> &Conformances) {
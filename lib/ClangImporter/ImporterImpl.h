@@ -903,6 +903,22 @@ public:
                               ImportNameOptions options = None,
                               clang::Sema *clangSemaOverride = nullptr);
 
+private:
+  /// Computes the result of importFullName without consulting the cache.
+  ImportedName importFullNameImpl(const clang::NamedDecl *D,
+                                  ImportNameOptions options,
+                                  clang::Sema *clangSemaOverride);
+
+  /// Results of importFullName, keyed by declaration and options, along with
+  /// the generation in which each was computed.
+  ///
+  /// Loading more modules can change an imported name, e.g. through a new
+  /// category, so entries from an older generation are recomputed.
+  llvm::DenseMap<std::pair<const clang::NamedDecl *, unsigned>,
+                 std::pair<unsigned, ImportedName>> ImportNameCache;
+
+public:
+
   /// Imports the name of the given Clang macro into Swift.
   Identifier importMacroName(const clang::IdentifierInfo *clangIdentifier,
                              const clang::MacroInfo *macro,
@@ -1380,6 +1396,9 @@ public:
   virtual void
   loadAllMembers(Decl *D, uint64_t unused) override;
 
+  virtual Optional<TinyPtrVector<ValueDecl *>>
+  loadNamedMembers(const Decl *D, Identifier N, uint64_t extra) override;
+
   void
   loadAllConformances(
     const Decl *D, uint64_t contextData,
@@ -15,6 +15,8 @@
 #include "swift/AST/DiagnosticEngine.h"
 #include "swift/AST/DiagnosticsDriver.h"
 #include "swift/Basic/Fallthrough.h"
+#include "swift/Basic/JSONSerialization.h"
+#include "swift/Basic/Platform.h"
 #include "swift/Basic/Program.h"
 #include "swift/Basic/TaskQueue.h"
 #include "swift/Basic/Version.h"
@@ -26,13 +28,19 @@
 #include "swift/Driver/ParseableOutput.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TinyPtrVector.h"
+#include "llvm/ADT/Triple.h"
 #include "llvm/Option/Arg.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/YAMLParser.h"
 
 using namespace swift;
@@ -83,6 +91,34 @@ namespace {
     ///
     /// Only intended for source files.
     llvm::SmallDenseMap<const Job *, bool, 16> UnfinishedCommands;
+
+    /// When each job that has been run started executing.
+    llvm::SmallDenseMap<const Job *, llvm::sys::TimeValue, 16> StartTimes;
+
+    /// How long each job that has finished execution took.
+    llvm::SmallDenseMap<const Job *, llvm::sys::TimeValue, 16> Durations;
+
+    /// The trace lane each job that has been run was assigned.
+    ///
+    /// Only used when writing a time trace. A lane is free again once its job
+    /// finishes, so the number of lanes in use shows how many jobs were
+    /// running in parallel.
+    llvm::SmallDenseMap<const Job *, unsigned, 16> Lanes;
+
+    /// Whether each lane is currently in use.
+    SmallVector<bool, 16> LanesInUse;
+
+    /// The compilation cache key of each running job whose outputs should be
+    /// stored in the cache when it succeeds.
+    llvm::SmallDenseMap<const Job *, std::string, 16> CacheKeys;
+
+    /// Jobs whose outputs were just copied from the compilation cache, with
+    /// what they printed when they ran, waiting to be treated as finished.
+    SmallVector<std::pair<const Job *, std::string>, 16> CacheHits;
+
+    /// The hash of the Swift modules in each search path that a compilation
+    /// cache key has covered so far.
+    llvm::StringMap<std::string> SearchPathHashes;
   };
 }
 
@@ -106,6 +142,23 @@ static const Job *findUnfinishedJob(ArrayRef<const Job *> JL,
 using InputInfoMap =
   llvm::SmallMapVector<const llvm::opt::Arg *, CompileJobAction::InputInfo, 16>;
 
+/// Returns how long \p cmd took to run in this build, or in the previous
+/// build if it didn't run this time.
+static llvm::sys::TimeValue getDuration(const Job *cmd,
+                                        const PerformJobsState &endState) {
+  auto iter = endState.Durations.find(cmd);
+  if (iter != endState.Durations.end())
+    return iter->second;
+  if (auto *compileAction = dyn_cast<CompileJobAction>(&cmd->getSource()))
+    return compileAction->getInputInfo().previousDuration;
+  return llvm::sys::TimeValue::ZeroTime();
+}
+
+/// Returns \p time as a whole number of milliseconds.
+static uint64_t toMilliseconds(llvm::sys::TimeValue time) {
+  return uint64_t(time.seconds()) * 1000 + time.milliseconds();
+}
+
 static void populateInputInfoMap(InputInfoMap &inputs,
                                  const PerformJobsState &endState) {
   for (auto &entry : endState.UnfinishedCommands) {
@@ -114,6 +167,7 @@ static void populateInputInfoMap(InputInfoMap &inputs,
 
       CompileJobAction::InputInfo info;
       info.previousModTime = entry.first->getInputModTime();
+      info.previousDuration = getDuration(entry.first, endState);
       info.status = entry.second ?
           CompileJobAction::InputInfo::NeedsCascadingBuild :
           CompileJobAction::InputInfo::NeedsNonCascadingBuild;
@@ -131,6 +185,7 @@ static void populateInputInfoMap(InputInfoMap &inputs,
 
       CompileJobAction::InputInfo info;
       info.previousModTime = entry->getInputModTime();
+      info.previousDuration = getDuration(entry, endState);
       info.status = CompileJobAction::InputInfo::UpToDate;
       inputs[&inputFile->getInputArg()] = info;
     }
@@ -172,6 +227,12 @@ static void checkForOutOfDateInputs(DiagnosticEngine &diags,
   }
 }
 
+/// Returns the path of the dependency graph cache that accompanies the
+/// compilation record at \p recordPath.
+static std::string getDependencyGraphCachePath(StringRef recordPath) {
+  return (recordPath + ".graph").str();
+}
+
 static void writeCompilationRecord(StringRef path, StringRef argsHash,
                                    llvm::sys::TimeValue buildTime,
                                    const InputInfoMap &inputs) {
@@ -213,6 +274,196 @@ static void writeCompilationRecord(StringRef path, StringRef argsHash,
     writeTimeValue(out, entry.second.previousModTime);
     out << "\n";
   }
+
+  // Record how long each input took to compile, so that the next build can
+  // start the slowest ones first.
+  bool hasDurations = std::any_of(inputs.begin(), inputs.end(),
+                                  [](const InputInfoMap::value_type &entry) {
+    return toMilliseconds(entry.second.previousDuration) != 0;
+  });
+  if (!hasDurations)
+    return;
+
+  out << "durations:\n";
+  for (auto &entry : inputs) {
+    uint64_t milliseconds = toMilliseconds(entry.second.previousDuration);
+    if (milliseconds == 0)
+      continue;
+    out << "  \"" << llvm::yaml::escape(entry.first->getValue()) << "\": "
+        << milliseconds << "\n";
+  }
+}
+
+namespace {
+  /// A complete event in a Chrome trace, covering either a whole job or one
+  /// compilation phase within it.
+  struct TraceEvent {
+    std::string Name;
+    std::string Category;
+    uint32_t Lane;
+    /// Microseconds since the start of the build.
+    uint64_t Start;
+    uint64_t Duration;
+  };
+
+  struct Trace {
+    std::vector<TraceEvent> Events;
+  };
+}
+
+namespace swift {
+namespace json {
+template <> struct ObjectTraits<TraceEvent> {
+  static void mapping(Output &out, TraceEvent &event) {
+    std::string phase = "X";
+    uint32_t pid = 1;
+    out.mapRequired("name", event.Name);
+    out.mapRequired("cat", event.Category);
+    out.mapRequired("ph", phase);
+    out.mapRequired("pid", pid);
+    out.mapRequired("tid", event.Lane);
+    out.mapRequired("ts", event.Start);
+    out.mapRequired("dur", event.Duration);
+  }
+};
+
+template <> struct ObjectTraits<Trace> {
+  static void mapping(Output &out, Trace &trace) {
+    out.mapRequired("traceEvents", trace.Events);
+  }
+};
+} // end namespace json
+} // end namespace swift
+
+/// Returns \p time as microseconds since the Unix epoch, matching the
+/// frontend's phase timings.
+static uint64_t toEpochMicroseconds(llvm::sys::TimeValue time) {
+  return time.toEpochTime() * 1000000 + time.microseconds();
+}
+
+/// Returns a short description of \p cmd for the trace, such as
+/// "compile main.swift".
+static std::string getTraceName(const Job &cmd) {
+  std::string name = cmd.getSource().getClassName();
+  SmallVector<StringRef, 4> inputs;
+  for (const Action *A : cmd.getSource().getInputs())
+    if (auto *IA = dyn_cast<InputAction>(A))
+      inputs.push_back(llvm::sys::path::filename(IA->getInputArg().getValue()));
+  if (inputs.size() == 1) {
+    name += " ";
+    name += inputs.front();
+  }
+  return name;
+}
+
+/// Reads the phase timings written by a frontend job, as a YAML list of
+/// [name, start, end] entries, and calls \p callback for each.
+///
+/// Entries that can't be read are skipped; the trace is a debugging aid, so
+/// a job that crashed part way through shouldn't stop it being written.
+static void readPhaseTimings(StringRef path,
+                             llvm::function_ref<void(StringRef name,
+                                                     uint64_t start,
+                                                     uint64_t end)> callback) {
+  namespace yaml = llvm::yaml;
+
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return;
+
+  llvm::SourceMgr SM;
+  yaml::Stream stream(buffer.get()->getMemBufferRef(), SM);
+  auto I = stream.begin();
+  if (I == stream.end() || !I->getRoot())
+    return;
+
+  auto *phases = dyn_cast<yaml::SequenceNode>(I->getRoot());
+  if (!phases)
+    return;
+
+  SmallString<64> nameScratch;
+  SmallString<32> scratch;
+  for (yaml::Node &rawEntry : *phases) {
+    auto *entry = dyn_cast<yaml::SequenceNode>(&rawEntry);
+    if (!entry)
+      continue;
+
+    SmallVector<yaml::ScalarNode *, 3> fields;
+    for (yaml::Node &field : *entry)
+      fields.push_back(dyn_cast<yaml::ScalarNode>(&field));
+    if (fields.size() != 3 ||
+        std::find(fields.begin(), fields.end(), nullptr) != fields.end())
+      continue;
+
+    uint64_t start, end;
+    if (fields[1]->getValue(scratch).getAsInteger(10, start) ||
+        fields[2]->getValue(scratch).getAsInteger(10, end) ||
+        end < start)
+      continue;
+
+    callback(fields[0]->getValue(nameScratch), start, end);
+  }
+}
+
+/// Writes a Chrome trace of the jobs that ran in this build, along with the
+/// phase timings each frontend job reported, so that it can be loaded into
+/// chrome://tracing.
+static void writeTimeTrace(DiagnosticEngine &diags, StringRef path,
+                           llvm::sys::TimeValue buildStartTime,
+                           const PerformJobsState &state) {
+  uint64_t origin = toEpochMicroseconds(buildStartTime);
+  auto sinceOrigin = [origin](uint64_t time) -> uint64_t {
+    return time > origin ? time - origin : 0;
+  };
+
+  Trace trace;
+  for (auto &entry : state.Lanes) {
+    const Job *cmd = entry.first;
+    uint32_t lane = entry.second;
+
+    auto start = state.StartTimes.find(cmd);
+    auto duration = state.Durations.find(cmd);
+    if (start == state.StartTimes.end() || duration == state.Durations.end())
+      continue;
+
+    uint64_t startMicroseconds = toEpochMicroseconds(start->second);
+    uint64_t durationMicroseconds =
+        uint64_t(duration->second.seconds()) * 1000000 +
+        duration->second.microseconds();
+    trace.Events.push_back({ getTraceName(*cmd), "job", lane,
+                             sinceOrigin(startMicroseconds),
+                             durationMicroseconds });
+
+    StringRef timingsPath =
+        cmd->getOutput().getAdditionalOutputForType(types::TY_PhaseTimings);
+    if (timingsPath.empty())
+      continue;
+    readPhaseTimings(timingsPath,
+                     [&](StringRef name, uint64_t phaseStart,
+                         uint64_t phaseEnd) {
+      trace.Events.push_back({ name, "phase", lane, sinceOrigin(phaseStart),
+                               phaseEnd - phaseStart });
+    });
+  }
+
+  // Jobs are visited in an arbitrary order, so sort the events to keep the
+  // output stable.
+  std::stable_sort(trace.Events.begin(), trace.Events.end(),
+                   [](const TraceEvent &LHS, const TraceEvent &RHS) {
+    return std::tie(LHS.Lane, LHS.Start) < std::tie(RHS.Lane, RHS.Start);
+  });
+
+  std::error_code EC;
+  llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::F_None);
+  if (EC) {
+    diags.diagnose(SourceLoc(), diag::error_opening_output, path,
+                   EC.message());
+    return;
+  }
+
+  json::Output yout(out);
+  yout << trace;
+  out << '\n';
 }
 
 static bool writeFilelistIfNecessary(const Job *job, DiagnosticEngine &diags) {
@@ -252,6 +503,288 @@ static bool writeFilelistIfNecessary(const Job *job, DiagnosticEngine &diags) {
   return true;
 }
 
+/// Hashes the contents of the Swift module at \p path, which is either a
+/// single file or a directory of per-architecture files.
+static void hashSwiftModule(llvm::MD5 &hash, StringRef path) {
+  if (llvm::sys::fs::is_directory(path)) {
+    std::vector<std::string> entries;
+    std::error_code error;
+    for (llvm::sys::fs::directory_iterator iter(path, error), end;
+         iter != end && !error; iter.increment(error)) {
+      entries.push_back(iter->path());
+    }
+    std::sort(entries.begin(), entries.end());
+    for (auto &entry : entries)
+      hashSwiftModule(hash, entry);
+    return;
+  }
+
+  hash.update(path);
+  if (auto buffer = llvm::MemoryBuffer::getFile(path))
+    hash.update((*buffer)->getBuffer());
+}
+
+/// Hashes every Swift module that an import could find directly in the search
+/// path \p dir.
+static void hashSearchPathModules(llvm::MD5 &hash, StringRef dir,
+                                  bool isFrameworkPath) {
+  std::vector<std::string> modules;
+  std::error_code error;
+  for (llvm::sys::fs::directory_iterator iter(dir, error), end;
+       iter != end && !error; iter.increment(error)) {
+    StringRef entry = iter->path();
+    StringRef extension = llvm::sys::path::extension(entry);
+    if (extension == ".swiftmodule") {
+      modules.push_back(entry.str());
+    } else if (isFrameworkPath && extension == ".framework") {
+      SmallString<128> modulePath(entry);
+      llvm::sys::path::append(modulePath, "Modules",
+                              llvm::sys::path::stem(entry) + ".swiftmodule");
+      if (llvm::sys::fs::exists(modulePath))
+        modules.push_back(modulePath.str().str());
+    }
+  }
+  std::sort(modules.begin(), modules.end());
+  for (auto &module : modules)
+    hashSwiftModule(hash, module);
+}
+
+/// Returns the hash of the Swift modules in the search path \p dir, computing
+/// it only the first time \p dir is seen in \p searchPathHashes.
+///
+/// Every compile job of a build searches the same paths, and the modules in
+/// them, such as the standard library, can be large.
+static StringRef
+getSearchPathModulesHash(llvm::StringMap<std::string> &searchPathHashes,
+                         StringRef dir, bool isFrameworkPath) {
+  SmallString<128> cacheKey(isFrameworkPath ? "F" : "I");
+  cacheKey += dir;
+  auto known = searchPathHashes.find(cacheKey);
+  if (known != searchPathHashes.end())
+    return known->second;
+
+  llvm::MD5 hash;
+  hashSearchPathModules(hash, dir, isFrameworkPath);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> resultString;
+  llvm::MD5::stringifyResult(result, resultString);
+  return searchPathHashes[cacheKey] = resultString.str();
+}
+
+/// Returns the directory given by \p arg if it is a joined \p flag option,
+/// such as "-Ifoo" or "-I=foo" for "-I".
+static StringRef getJoinedSearchPath(StringRef arg, StringRef flag) {
+  if (!arg.startswith(flag) || arg.size() == flag.size())
+    return StringRef();
+  arg = arg.drop_front(flag.size());
+  if (arg.startswith("="))
+    arg = arg.drop_front();
+  return arg;
+}
+
+/// Computes the key under which the outputs of \p job are stored in the
+/// compilation cache.
+///
+/// The key covers the compiler, every argument, the contents of every
+/// argument that names a file, and the Swift modules in each import and
+/// framework search path and in the runtime library import path of the
+/// resource directory. Output paths are replaced by their type, since they
+/// don't affect what is written to them. Headers reached only through Clang
+/// module maps, including everything the frontend reads from the SDK, are not
+/// covered.
+///
+/// \returns false if \p job can't be cached.
+static bool
+computeCompilationCacheKey(const Job *job, SmallVectorImpl<char> &key,
+                           llvm::StringMap<std::string> &searchPathHashes) {
+  if (!isa<CompileJobAction>(job->getSource()) ||
+      !job->getFilelistInfo().path.empty() ||
+      !job->getExtraEnvironment().empty())
+    return false;
+
+  const CommandOutput &output = job->getOutput();
+  llvm::StringMap<types::ID> outputTypes;
+  for (auto &primary : output.getPrimaryOutputFilenames())
+    outputTypes[primary] = output.getPrimaryOutputType();
+  for (auto &additional : output.getAdditionalOutputs())
+    if (!additional.second.empty())
+      outputTypes[additional.second] = additional.first;
+
+  llvm::MD5 hash;
+  hash.update(version::getSwiftFullVersion());
+  hash.update(job->getExecutable());
+
+  // The frontend finds the resource directory next to itself unless it is
+  // given one.
+  SmallString<128> resourceDir(job->getExecutable());
+  llvm::sys::path::remove_filename(resourceDir); // Remove /swift
+  llvm::sys::path::remove_filename(resourceDir); // Remove /bin
+  llvm::sys::path::append(resourceDir, "lib", "swift");
+  llvm::Triple triple(llvm::sys::getDefaultTargetTriple());
+  bool skipRuntimeLibraryImportPath = false;
+
+  StringRef previousArg;
+  for (const char *rawArg : job->getArguments()) {
+    StringRef arg = rawArg;
+    // The contents of a filelist are paths, which would have to be resolved
+    // and hashed in turn.
+    if (arg == "-filelist")
+      return false;
+
+    hash.update(StringRef("\0", 1));
+    auto outputType = outputTypes.find(arg);
+    if (outputType != outputTypes.end()) {
+      hash.update(types::getTypeName(outputType->second));
+      previousArg = arg;
+      continue;
+    }
+
+    hash.update(arg);
+    if (llvm::sys::fs::is_regular_file(arg)) {
+      auto buffer = llvm::MemoryBuffer::getFile(arg);
+      if (!buffer)
+        return false;
+      hash.update((*buffer)->getBuffer());
+    }
+
+    StringRef importPath = getJoinedSearchPath(arg, "-I");
+    if (previousArg == "-I")
+      importPath = arg;
+    if (!importPath.empty())
+      hash.update(getSearchPathModulesHash(searchPathHashes, importPath,
+                                           /*isFrameworkPath=*/false));
+
+    StringRef frameworkPath = getJoinedSearchPath(arg, "-F");
+    if (previousArg == "-F")
+      frameworkPath = arg;
+    if (!frameworkPath.empty())
+      hash.update(getSearchPathModulesHash(searchPathHashes, frameworkPath,
+                                           /*isFrameworkPath=*/true));
+
+    if (previousArg == "-resource-dir")
+      resourceDir = arg;
+    else if (previousArg == "-target")
+      triple = llvm::Triple(arg);
+    else if (arg == "-nostdimport")
+      skipRuntimeLibraryImportPath = true;
+
+    previousArg = arg;
+  }
+
+  // Imports that no search path satisfies are looked up in the same place as
+  // the standard library.
+  if (!skipRuntimeLibraryImportPath) {
+    llvm::sys::path::append(resourceDir, getPlatformNameForTriple(triple),
+                            getMajorArchitectureName(triple));
+    hash.update(StringRef("\0", 1));
+    hash.update(getSearchPathModulesHash(searchPathHashes, resourceDir,
+                                         /*isFrameworkPath=*/false));
+  }
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> resultString;
+  llvm::MD5::stringifyResult(result, resultString);
+  key.append(resultString.begin(), resultString.end());
+  return true;
+}
+
+/// Collects the path of each output of \p job together with the path of its
+/// entry in the compilation cache.
+using CachedOutputPaths = SmallVector<std::pair<std::string, std::string>, 4>;
+
+static void getCachedOutputPaths(StringRef cachePath, StringRef key,
+                                 const Job *job, CachedOutputPaths &paths) {
+  const CommandOutput &output = job->getOutput();
+  auto addEntry = [&](StringRef outputPath, types::ID type,
+                      const Twine &suffix) {
+    SmallString<128> entryPath(cachePath);
+    llvm::sys::path::append(entryPath, key + suffix + "." +
+                                       types::getTypeTempSuffix(type));
+    paths.push_back({outputPath.str(), entryPath.str().str()});
+  };
+
+  auto primaries = output.getPrimaryOutputFilenames();
+  for (unsigned i = 0, e = primaries.size(); i != e; ++i)
+    addEntry(primaries[i], output.getPrimaryOutputType(), "-" + Twine(i));
+  for (auto &additional : output.getAdditionalOutputs())
+    if (!additional.second.empty())
+      addEntry(additional.second, additional.first, "");
+}
+
+/// Returns the path of the file holding what a cached job printed. It is
+/// written last, so its presence means the entry is complete.
+static std::string getCachedJobOutputPath(StringRef cachePath, StringRef key) {
+  SmallString<128> path(cachePath);
+  llvm::sys::path::append(path, key + ".out");
+  return path.str().str();
+}
+
+/// Writes \p contents to \p path through a temporary file, so that concurrent
+/// builds sharing a cache never see a partially written file.
+static bool writeFileAtomically(StringRef path, StringRef contents) {
+  SmallString<128> tmpPath;
+  int fd;
+  if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%%%", fd, tmpPath))
+    return false;
+  {
+    llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+    out << contents;
+    if (out.has_error()) {
+      out.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return false;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path)) {
+    llvm::sys::fs::remove(tmpPath);
+    return false;
+  }
+  return true;
+}
+
+/// Copies the cached outputs of \p job into place.
+///
+/// \returns false if the cache has no complete entry for \p key, in which case
+/// the job has to run.
+static bool restoreCachedOutputs(StringRef cachePath, StringRef key,
+                                 const Job *job, std::string &jobOutput) {
+  auto jobOutputBuffer =
+      llvm::MemoryBuffer::getFile(getCachedJobOutputPath(cachePath, key));
+  if (!jobOutputBuffer)
+    return false;
+
+  CachedOutputPaths paths;
+  getCachedOutputPaths(cachePath, key, job, paths);
+  for (auto &path : paths) {
+    auto buffer = llvm::MemoryBuffer::getFile(path.second);
+    if (!buffer || !writeFileAtomically(path.first, (*buffer)->getBuffer()))
+      return false;
+  }
+
+  jobOutput = (*jobOutputBuffer)->getBuffer();
+  return true;
+}
+
+/// Stores the outputs of \p job, which just succeeded, in the compilation
+/// cache. Failures are ignored; the job will just run again next time.
+static void storeCachedOutputs(StringRef cachePath, StringRef key,
+                               const Job *job, StringRef jobOutput) {
+  if (llvm::sys::fs::create_directories(cachePath))
+    return;
+
+  CachedOutputPaths paths;
+  getCachedOutputPaths(cachePath, key, job, paths);
+  for (auto &path : paths) {
+    auto buffer = llvm::MemoryBuffer::getFile(path.first);
+    if (!buffer || !writeFileAtomically(path.second, (*buffer)->getBuffer()))
+      return;
+  }
+
+  writeFileAtomically(getCachedJobOutputPath(cachePath, key), jobOutput);
+}
+
 int Compilation::performJobsImpl() {
   // Create a TaskQueue for execution.
   std::unique_ptr<TaskQueue> TQ;
@@ -286,6 +819,38 @@ int Compilation::performJobsImpl() {
     });
   };
 
+  // Commands that become ready before execution begins are collected here, so
+  // that they can be started slowest-first once everything that's initially
+  // out of date is known.
+  bool HasStartedExecution = false;
+  SmallVector<const Job *, 16> InitiallyReadyCommands;
+
+  auto addTask = [&] (const Job *Cmd) {
+    // A job whose outputs are cached doesn't run; it is finished along with
+    // the other cache hits once the task queue is free to take new tasks.
+    SmallString<32> CacheKey;
+    if (!CompilationCachePath.empty() &&
+        computeCompilationCacheKey(Cmd, CacheKey, State.SearchPathHashes)) {
+      std::string CachedOutput;
+      if (restoreCachedOutputs(CompilationCachePath, CacheKey, Cmd,
+                               CachedOutput)) {
+        State.CacheHits.push_back({Cmd, std::move(CachedOutput)});
+        return;
+      }
+      State.CacheKeys[Cmd] = CacheKey.str();
+    }
+
+    // FIXME: Failing here should not take down the whole process.
+    bool success = writeFilelistIfNecessary(Cmd, Diags);
+    assert(success && "failed to write filelist");
+    (void)success;
+
+    assert(Cmd->getExtraEnvironment().empty() &&
+           "not implemented for compilations with multiple jobs");
+    TQ->addTask(Cmd->getExecutable(), Cmd->getArguments(), llvm::None,
+                (void *)Cmd);
+  };
+
   // Set up scheduleCommandIfNecessaryAndPossible.
   // This will only schedule the given command if it has not been scheduled
   // and if all of its inputs are in FinishedCommands.
@@ -299,16 +864,12 @@ int Compilation::performJobsImpl() {
       return;
     }
 
-    // FIXME: Failing here should not take down the whole process.
-    bool success = writeFilelistIfNecessary(Cmd, Diags);
-    assert(success && "failed to write filelist");
-    (void)success;
-
-    assert(Cmd->getExtraEnvironment().empty() &&
-           "not implemented for compilations with multiple jobs");
     State.ScheduledCommands.insert(Cmd);
-    TQ->addTask(Cmd->getExecutable(), Cmd->getArguments(), llvm::None,
-                (void *)Cmd);
+    if (!HasStartedExecution) {
+      InitiallyReadyCommands.push_back(Cmd);
+      return;
+    }
+    addTask(Cmd);
   };
 
   // When a task finishes, we need to reevaluate the other commands that
@@ -325,6 +886,31 @@ int Compilation::performJobsImpl() {
     }
   };
 
+  // Load whatever we can from the dependency graph cache written by the last
+  // build, which is much faster than parsing each dependencies file.
+  SmallPtrSet<const Job *, 16> CachedCommands;
+  if (getIncrementalBuildEnabled() && !CompilationRecordPath.empty()) {
+    llvm::StringMap<const Job *> JobsByDependenciesFile;
+    for (const Job *Cmd : getJobs()) {
+      if (Cmd->getCondition() == Job::Condition::NewlyAdded)
+        continue;
+      StringRef DependenciesFile =
+        Cmd->getOutput().getAdditionalOutputForType(types::TY_SwiftDeps);
+      if (!DependenciesFile.empty())
+        JobsByDependenciesFile[DependenciesFile] = Cmd;
+    }
+
+    SmallVector<const Job *, 16> LoadedCommands;
+    DepGraph.loadFromCache(getDependencyGraphCachePath(CompilationRecordPath),
+                           [&](StringRef Path) -> Optional<const Job *> {
+      auto Iter = JobsByDependenciesFile.find(Path);
+      if (Iter == JobsByDependenciesFile.end())
+        return None;
+      return Iter->second;
+    }, LoadedCommands);
+    CachedCommands.insert(LoadedCommands.begin(), LoadedCommands.end());
+  }
+
   // Schedule all jobs we can.
   for (const Job *Cmd : getJobs()) {
     if (!getIncrementalBuildEnabled()) {
@@ -343,6 +929,8 @@ int Compilation::performJobsImpl() {
     if (!DependenciesFile.empty()) {
       if (Cmd->getCondition() == Job::Condition::NewlyAdded) {
         DepGraph.addIndependentNode(Cmd);
+      } else if (CachedCommands.count(Cmd)) {
+        Condition = Cmd->getCondition();
       } else {
         switch (DepGraph.loadFromPath(Cmd, DependenciesFile)) {
         case DependencyGraphImpl::LoadResult::HadError:
@@ -422,12 +1010,33 @@ int Compilation::performJobsImpl() {
 
   int Result = EXIT_SUCCESS;
 
+  // Give each running job the lowest lane that's free, so that the trace
+  // shows one row per job slot.
+  auto assignLane = [&] (const Job *Cmd) {
+    auto FreeLane = std::find(State.LanesInUse.begin(),
+                              State.LanesInUse.end(), false);
+    unsigned Lane = FreeLane - State.LanesInUse.begin();
+    if (FreeLane == State.LanesInUse.end())
+      State.LanesInUse.push_back(true);
+    else
+      *FreeLane = true;
+    State.Lanes[Cmd] = Lane;
+  };
+  auto releaseLane = [&] (const Job *Cmd) {
+    auto Lane = State.Lanes.find(Cmd);
+    if (Lane != State.Lanes.end())
+      State.LanesInUse[Lane->second] = false;
+  };
+
   // Set up a callback which will be called immediately after a task has
   // started. This callback may be used to provide output indicating that the
   // task began.
-  auto taskBegan = [this] (ProcessId Pid, void *Context) {
+  auto taskBegan = [&] (ProcessId Pid, void *Context) {
     // TODO: properly handle task began.
     const Job *BeganCmd = (const Job *)Context;
+    State.StartTimes[BeganCmd] = llvm::sys::TimeValue::now();
+    if (!TimeTracePath.empty())
+      assignLane(BeganCmd);
 
     // For verbose output, print out each command as it begins execution.
     if (Level == OutputLevel::Verbose)
@@ -445,6 +1054,13 @@ int Compilation::performJobsImpl() {
                            void *Context) -> TaskFinishedResponse {
     const Job *FinishedCmd = (const Job *)Context;
 
+    auto StartTime = State.StartTimes.find(FinishedCmd);
+    if (StartTime != State.StartTimes.end()) {
+      State.Durations[FinishedCmd] =
+          llvm::sys::TimeValue::now() - StartTime->second;
+    }
+    releaseLane(FinishedCmd);
+
     if (Level == OutputLevel::Parseable) {
       // Parseable output was requested.
       parseable_output::emitFinishedMessage(llvm::errs(), *FinishedCmd, Pid,
@@ -492,13 +1108,21 @@ int Compilation::performJobsImpl() {
           case DependencyGraphImpl::LoadResult::UpToDate:
             if (!wasCascading)
               break;
-            SWIFT_FALLTHROUGH;
-          case DependencyGraphImpl::LoadResult::AffectsDownstream:
             DepGraph.markTransitive(Dependents, FinishedCmd);
             break;
+          case DependencyGraphImpl::LoadResult::AffectsDownstream:
+            // If this file was rebuilt because of a cascading change, anything
+            // that depends on it may be affected. Otherwise, only the files
+            // that depend on declarations whose fingerprints changed are.
+            DepGraph.markTransitive(Dependents, FinishedCmd, /*tracer=*/nullptr,
+                                    /*onlyChangedDecls=*/!wasCascading);
+            break;
           }
         } else {
-          // If there's an abnormal exit (a crash), assume the worst.
+          // If there's an abnormal exit (a crash), assume the worst. The
+          // dependencies file may have changed without being reloaded, so
+          // don't cache what we loaded before.
+          DepGraph.discardCachedRecord(FinishedCmd);
           switch (FinishedCmd->getCondition()) {
           case Job::Condition::NewlyAdded:
             // The job won't be treated as newly added next time. Conservatively
@@ -555,6 +1179,13 @@ int Compilation::performJobsImpl() {
           TaskFinishedResponse::StopExecution;
     }
 
+    auto CacheKey = State.CacheKeys.find(FinishedCmd);
+    if (CacheKey != State.CacheKeys.end()) {
+      storeCachedOutputs(CompilationCachePath, CacheKey->second, FinishedCmd,
+                         Output);
+      State.CacheKeys.erase(CacheKey);
+    }
+
     // When a task finishes, we need to reevaluate the other commands that
     // might have been blocked.
     markFinished(FinishedCmd);
@@ -571,6 +1202,7 @@ int Compilation::performJobsImpl() {
   auto taskSignalled = [&] (ProcessId Pid, StringRef ErrorMsg, StringRef Output,
                             void *Context) -> TaskFinishedResponse {
     const Job *SignalledCmd = (const Job *)Context;
+    releaseLane(SignalledCmd);
 
     if (Level == OutputLevel::Parseable) {
       // Parseable output was requested.
@@ -596,9 +1228,48 @@ int Compilation::performJobsImpl() {
     return TaskFinishedResponse::StopExecution;
   };
 
+  // Start the commands that took longest in the previous build first. The
+  // jobs that wait on all the compiles, such as merge-module and linking,
+  // can't start until the slowest compile is done, so this shortens the
+  // critical path. It makes no difference when running one job at a time.
+  // Commands with no recorded duration keep their order.
+  if (NumberOfParallelCommands > 1) {
+    std::stable_sort(InitiallyReadyCommands.begin(),
+                     InitiallyReadyCommands.end(),
+                     [&](const Job *LHS, const Job *RHS) {
+      return getDuration(LHS, State) > getDuration(RHS, State);
+    });
+  }
+
+  // Finish the jobs whose outputs were copied from the compilation cache as
+  // if they had just run, so that their dependency files are read and their
+  // dependents are scheduled.
+  auto finishCacheHits = [&] {
+    while (!State.CacheHits.empty()) {
+      auto CacheHits = std::move(State.CacheHits);
+      State.CacheHits.clear();
+      for (auto &Hit : CacheHits) {
+        if (Level == OutputLevel::Parseable)
+          parseable_output::emitBeganMessage(llvm::errs(), *Hit.first,
+                                             /*Pid=*/0);
+        taskFinished(/*Pid=*/0, EXIT_SUCCESS, Hit.second, (void *)Hit.first);
+      }
+    }
+  };
+
+  HasStartedExecution = true;
+  for (const Job *Cmd : InitiallyReadyCommands)
+    addTask(Cmd);
+  finishCacheHits();
+
   do {
-    // Ask the TaskQueue to execute.
-    TQ->execute(taskBegan, taskFinished, taskSignalled);
+    // Ask the TaskQueue to execute. A job that finishes may hit the cache for
+    // the jobs it schedules, and those hits may schedule further jobs in
+    // turn, so keep going until neither tasks nor cache hits are left.
+    do {
+      TQ->execute(taskBegan, taskFinished, taskSignalled);
+      finishCacheHits();
+    } while (Result == 0 && TQ->hasRemainingTasks());
 
     // Mark all remaining deferred commands as skipped.
     for (const Job *Cmd : DeferredCommands) {
@@ -611,6 +1282,9 @@ int Compilation::performJobsImpl() {
       State.ScheduledCommands.insert(Cmd);
       markFinished(Cmd);
     }
+    DeferredCommands.clear();
+
+    finishCacheHits();
 
     // ...which may allow us to go on and do later tasks.
   } while (Result == 0 && TQ->hasRemainingTasks());
@@ -646,8 +1320,16 @@ int Compilation::performJobsImpl() {
     checkForOutOfDateInputs(Diags, InputInfo);
     writeCompilationRecord(CompilationRecordPath, ArgsHash, BuildStartTime,
                            InputInfo);
+
+    // The cache is only an optimization, so it doesn't matter if this fails.
+    if (getIncrementalBuildEnabled())
+      (void)DepGraph.writeCache(
+          getDependencyGraphCachePath(CompilationRecordPath));
   }
 
+  if (!TimeTracePath.empty())
+    writeTimeTrace(Diags, TimeTracePath, BuildStartTime, State);
+
   if (Result == 0)
     Result = Diags.hadAnyError();
   return Result;
@@ -722,8 +1404,8 @@ int Compilation::performJobs() {
   // If we don't have to do any cleanup work, just exec the subprocess.
   if (Level < OutputLevel::Parseable &&
       (SaveTemps || TempFilePaths.empty()) &&
-      CompilationRecordPath.empty() &&
-      Jobs.size() == 1) {
+      CompilationRecordPath.empty() && TimeTracePath.empty() &&
+      CompilationCachePath.empty() && Jobs.size() == 1) {
     return performSingleCommand(Jobs.front().get());
   }
 
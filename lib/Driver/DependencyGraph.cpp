@@ -16,6 +16,10 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
@@ -34,6 +38,23 @@ enum class DependencyGraphImpl::DependencyFlags : uint8_t {
   IsCascading = 1 << 0
 };
 
+namespace {
+/// The kinds of entries in a NodeRecordTy.
+enum class RecordKind : uint8_t {
+  Provides,
+  Depends,
+  InterfaceHash,
+  Fingerprint
+};
+} // end anonymous namespace
+
+/// The signature at the start of a dependency graph cache file.
+static const char GraphCacheSignature[] = { 'S', 'D', 'G', 'C' };
+
+/// The version of the dependency graph cache format. Caches with any other
+/// version are ignored.
+static const uint32_t GraphCacheVersion = 1;
+
 class DependencyGraphImpl::MarkTracerImpl::Entry {
 public:
   const void *Node;
@@ -48,12 +69,21 @@ using LoadResult = DependencyGraphImpl::LoadResult;
 using DependencyKind = DependencyGraphImpl::DependencyKind;
 using DependencyCallbackTy = LoadResult(StringRef, DependencyKind, bool);
 using InterfaceHashCallbackTy = LoadResult(StringRef);
+using FingerprintCallbackTy = LoadResult(StringRef, DependencyKind, StringRef);
+
+struct DependencyGraphImpl::LoadCallbacks {
+  llvm::function_ref<DependencyCallbackTy> provides;
+  llvm::function_ref<DependencyCallbackTy> depends;
+  llvm::function_ref<InterfaceHashCallbackTy> interfaceHash;
+  llvm::function_ref<FingerprintCallbackTy> fingerprint;
+};
 
 static LoadResult
 parseDependencyFile(llvm::MemoryBuffer &buffer,
                     llvm::function_ref<DependencyCallbackTy> providesCallback,
                     llvm::function_ref<DependencyCallbackTy> dependsCallback,
-                    llvm::function_ref<InterfaceHashCallbackTy> interfaceHashCallback) {
+                    llvm::function_ref<InterfaceHashCallbackTy> interfaceHashCallback,
+                    llvm::function_ref<FingerprintCallbackTy> fingerprintCallback) {
   namespace yaml = llvm::yaml;
 
   // FIXME: Switch to a format other than YAML.
@@ -105,6 +135,42 @@ parseDependencyFile(llvm::MemoryBuffer &buffer,
       StringRef valueString = value->getValue(scratch);
       UPDATE_RESULT(interfaceHashCallback(valueString));
 
+    } else if (keyString == "fingerprints-top-level" ||
+               keyString == "fingerprints-nominal") {
+      DependencyKind kind = (keyString == "fingerprints-top-level")
+                              ? DependencyKind::TopLevelName
+                              : DependencyKind::NominalType;
+
+      auto *entries = dyn_cast<yaml::SequenceNode>(i->getValue());
+      if (!entries)
+        return LoadResult::HadError;
+
+      // Fingerprints come in the form ["name", "fingerprint"].
+      for (yaml::Node &rawEntry : *entries) {
+        auto *entry = dyn_cast<yaml::SequenceNode>(&rawEntry);
+        if (!entry)
+          return LoadResult::HadError;
+
+        auto iter = entry->begin();
+        auto *name = dyn_cast<yaml::ScalarNode>(&*iter);
+        if (!name)
+          return LoadResult::HadError;
+        ++iter;
+
+        auto *fingerprint = dyn_cast<yaml::ScalarNode>(&*iter);
+        if (!fingerprint)
+          return LoadResult::HadError;
+        ++iter;
+
+        // FIXME: LLVM's YAML support doesn't implement == correctly for end
+        // iterators.
+        assert(!(iter != entry->end()));
+
+        SmallString<64> nameScratch;
+        UPDATE_RESULT(fingerprintCallback(name->getValue(nameScratch), kind,
+                                          fingerprint->getValue(scratch)));
+      }
+
     } else {
       enum class DependencyDirection : bool {
         Depends,
@@ -206,11 +272,27 @@ parseDependencyFile(llvm::MemoryBuffer &buffer,
   return result;
 }
 
+static std::string hashContents(const llvm::MemoryBuffer &buffer) {
+  llvm::MD5 hash;
+  hash.update(buffer.getBuffer());
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str().str();
+}
+
 LoadResult DependencyGraphImpl::loadFromPath(const void *node, StringRef path) {
   auto buffer = llvm::MemoryBuffer::getFile(path);
   if (!buffer)
     return LoadResult::HadError;
-  return loadFromBuffer(node, *buffer.get());
+  LoadResult result = loadFromBuffer(node, *buffer.get());
+  if (result != LoadResult::HadError) {
+    auto &record = Records[node];
+    record.Path = path;
+    record.ContentHash = hashContents(*buffer.get());
+  }
+  return result;
 }
 
 LoadResult
@@ -221,10 +303,46 @@ DependencyGraphImpl::loadFromString(const void *node, StringRef data) {
 
 LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
                                                llvm::MemoryBuffer &buffer) {
+  return loadFromParser(node, [&buffer](const LoadCallbacks &callbacks) {
+    return parseDependencyFile(buffer, callbacks.provides, callbacks.depends,
+                               callbacks.interfaceHash, callbacks.fingerprint);
+  });
+}
+
+uint32_t DependencyGraphImpl::internString(StringRef str) {
+  auto insertResult = StringIDs.insert({str, Strings.size()});
+  if (insertResult.second)
+    Strings.push_back(insertResult.first->getKey());
+  return insertResult.first->getValue();
+}
+
+LoadResult DependencyGraphImpl::loadFromParser(
+    const void *node,
+    llvm::function_ref<LoadResult(const LoadCallbacks &)> parse) {
   auto &provides = Provides[node];
 
-  auto dependsCallback = [this, node](StringRef name, DependencyKind kind,
-                                      bool isCascading) -> LoadResult {
+  // Keep a copy of everything that was loaded, for writeCache.
+  std::vector<NodeRecordTy::Entry> recordEntries;
+  auto addRecordEntry = [this, &recordEntries](RecordKind kind,
+                                               StringRef name,
+                                               StringRef value,
+                                               DependencyKind depKind,
+                                               bool isCascading) {
+    recordEntries.push_back({internString(name), internString(value),
+                             static_cast<uint8_t>(kind),
+                             static_cast<uint8_t>(depKind), isCascading});
+  };
+
+  // Whether the node depends on something that has already been marked dirty,
+  // in which case everything it provides must be considered changed.
+  bool dependsOnDirty = false;
+  bool interfaceChanged = false;
+  bool hasFingerprints = false;
+  FingerprintsTy newFingerprints;
+
+  auto dependsCallback = [&](StringRef name, DependencyKind kind,
+                             bool isCascading) -> LoadResult {
+    addRecordEntry(RecordKind::Depends, name, "", kind, isCascading);
     if (kind == DependencyKind::ExternalFile)
       ExternalDependencies.insert(name);
 
@@ -245,15 +363,17 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
       iter->flags |= flags;
     }
 
-    if (isCascading && (entries.second & kind))
+    if (isCascading && (entries.second & kind)) {
+      dependsOnDirty = true;
       return LoadResult::AffectsDownstream;
+    }
     return LoadResult::UpToDate;
   };
 
-  auto providesCallback =
-      [this, node, &provides](StringRef name, DependencyKind kind,
+  auto providesCallback = [&](StringRef name, DependencyKind kind,
                               bool isCascading) -> LoadResult {
     assert(isCascading);
+    addRecordEntry(RecordKind::Provides, name, "", kind, isCascading);
     auto iter = std::find_if(provides.begin(), provides.end(),
                              [name](const ProvidesEntryTy &entry) -> bool {
       return name == entry.name;
@@ -267,7 +387,9 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
     return LoadResult::UpToDate;
   };
 
-  auto interfaceHashCallback = [this, node](StringRef hash) -> LoadResult {
+  auto interfaceHashCallback = [&](StringRef hash) -> LoadResult {
+    addRecordEntry(RecordKind::InterfaceHash, hash, "", DependencyKind(),
+                   /*isCascading=*/true);
     auto insertResult = InterfaceHashes.insert(std::make_pair(node, hash));
 
     if (insertResult.second) {
@@ -279,14 +401,305 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
     auto iter = insertResult.first;
     if (hash != iter->second) {
       iter->second = hash;
+      interfaceChanged = true;
       return LoadResult::AffectsDownstream;
     }
 
     return LoadResult::UpToDate;
   };
 
-  return parseDependencyFile(buffer, providesCallback, dependsCallback,
-                             interfaceHashCallback);
+  auto fingerprintCallback = [&](StringRef name, DependencyKind kind,
+                                 StringRef fingerprint) -> LoadResult {
+    addRecordEntry(RecordKind::Fingerprint, name, fingerprint, kind,
+                   /*isCascading=*/true);
+    hasFingerprints = true;
+    auto &table = (kind == DependencyKind::TopLevelName)
+                    ? newFingerprints.TopLevel
+                    : newFingerprints.Nominal;
+    table[name] = fingerprint;
+    return LoadResult::UpToDate;
+  };
+
+  LoadResult result = parse({providesCallback, dependsCallback,
+                             interfaceHashCallback, fingerprintCallback});
+  if (result == LoadResult::HadError) {
+    Records.erase(node);
+    return result;
+  }
+
+  // The caller sets the path if the record can be cached.
+  auto &record = Records[node];
+  record.Path.clear();
+  record.ContentHash.clear();
+  record.Entries = std::move(recordEntries);
+
+  // Record which names kept their fingerprints, so that only the dependents
+  // of the changed declarations have to be rebuilt. This can only be done by
+  // comparing against fingerprints from a previous load.
+  UnchangedNames.erase(node);
+  auto oldFingerprints = Fingerprints.find(node);
+  if (interfaceChanged && !dependsOnDirty && hasFingerprints &&
+      oldFingerprints != Fingerprints.end()) {
+    auto collectUnchanged = [](const llvm::StringMap<std::string> &oldTable,
+                               const llvm::StringMap<std::string> &newTable,
+                               llvm::StringSet<> &unchanged) {
+      for (auto &entry : newTable) {
+        auto oldEntry = oldTable.find(entry.getKey());
+        if (oldEntry != oldTable.end() &&
+            oldEntry->getValue() == entry.getValue()) {
+          unchanged.insert(entry.getKey());
+        }
+      }
+    };
+
+    auto &unchanged = UnchangedNames[node];
+    collectUnchanged(oldFingerprints->second.TopLevel,
+                     newFingerprints.TopLevel, unchanged.TopLevel);
+    collectUnchanged(oldFingerprints->second.Nominal,
+                     newFingerprints.Nominal, unchanged.Nominal);
+  }
+
+  if (hasFingerprints)
+    Fingerprints[node] = std::move(newFingerprints);
+  else
+    Fingerprints.erase(node);
+
+  return result;
+}
+
+namespace {
+/// Reads little-endian values from a buffer, failing instead of reading past
+/// the end.
+class GraphCacheReader {
+  const char *Ptr;
+  const char *End;
+  bool HadError = false;
+
+public:
+  explicit GraphCacheReader(StringRef data)
+    : Ptr(data.begin()), End(data.end()) {}
+
+  bool hadError() const { return HadError; }
+  bool atEnd() const { return Ptr == End; }
+  size_t remaining() const { return End - Ptr; }
+
+  StringRef readBytes(size_t length) {
+    if (HadError || size_t(End - Ptr) < length) {
+      HadError = true;
+      return StringRef();
+    }
+    StringRef result(Ptr, length);
+    Ptr += length;
+    return result;
+  }
+
+  template <typename T>
+  T read() {
+    StringRef bytes = readBytes(sizeof(T));
+    if (HadError)
+      return T();
+    using namespace llvm::support;
+    return endian::read<T, little, unaligned>(bytes.data());
+  }
+
+  StringRef readString() {
+    auto length = read<uint32_t>();
+    return readBytes(length);
+  }
+};
+} // end anonymous namespace
+
+bool DependencyGraphImpl::isValidRecordEntry(const NodeRecordTy::Entry &entry) {
+  auto isValidKind = [](uint8_t rawKind) {
+    switch (static_cast<DependencyKind>(rawKind)) {
+    case DependencyKind::TopLevelName:
+    case DependencyKind::DynamicLookupName:
+    case DependencyKind::NominalType:
+    case DependencyKind::NominalTypeMember:
+    case DependencyKind::ExternalFile:
+      return true;
+    }
+    return false;
+  };
+
+  switch (static_cast<RecordKind>(entry.Kind)) {
+  case RecordKind::Provides:
+    return entry.IsCascading && isValidKind(entry.DepKind);
+  case RecordKind::Depends:
+    return isValidKind(entry.DepKind);
+  case RecordKind::InterfaceHash:
+    return true;
+  case RecordKind::Fingerprint:
+    return entry.DepKind == uint8_t(DependencyKind::TopLevelName) ||
+           entry.DepKind == uint8_t(DependencyKind::NominalType);
+  }
+  return false;
+}
+
+bool DependencyGraphImpl::writeCache(StringRef path) const {
+  std::error_code EC;
+  llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::F_None);
+  if (EC)
+    return true;
+
+  llvm::support::endian::Writer<llvm::support::little> writer(out);
+  auto writeString = [&](StringRef str) {
+    writer.write<uint32_t>(str.size());
+    out << str;
+  };
+
+  out.write(GraphCacheSignature, sizeof(GraphCacheSignature));
+  writer.write<uint32_t>(GraphCacheVersion);
+
+  writer.write<uint32_t>(Strings.size());
+  for (StringRef str : Strings)
+    writeString(str);
+
+  // Sort the records so that the cache doesn't depend on pointer values.
+  std::vector<const NodeRecordTy *> records;
+  for (auto &entry : Records)
+    if (!entry.second.Path.empty())
+      records.push_back(&entry.second);
+  std::sort(records.begin(), records.end(),
+            [](const NodeRecordTy *lhs, const NodeRecordTy *rhs) {
+    return lhs->Path < rhs->Path;
+  });
+
+  writer.write<uint32_t>(records.size());
+  for (const NodeRecordTy *record : records) {
+    writeString(record->Path);
+    writeString(record->ContentHash);
+    writer.write<uint32_t>(record->Entries.size());
+    for (const NodeRecordTy::Entry &entry : record->Entries) {
+      writer.write<uint8_t>(entry.Kind);
+      writer.write<uint8_t>(entry.DepKind);
+      writer.write<uint8_t>(entry.IsCascading);
+      writer.write<uint32_t>(entry.Name);
+      writer.write<uint32_t>(entry.Value);
+    }
+  }
+
+  out.close();
+  if (out.has_error()) {
+    out.clear_error();
+    return true;
+  }
+  return false;
+}
+
+bool DependencyGraphImpl::loadFromCache(
+    StringRef path,
+    llvm::function_ref<const void *(StringRef)> getNodeForPath,
+    SmallVectorImpl<const void *> &loaded) {
+  auto buffer = llvm::MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer)
+    return true;
+
+  GraphCacheReader reader(buffer.get()->getBuffer());
+  StringRef signature = reader.readBytes(sizeof(GraphCacheSignature));
+  if (reader.hadError() ||
+      signature != StringRef(GraphCacheSignature, sizeof(GraphCacheSignature)))
+    return true;
+  if (reader.read<uint32_t>() != GraphCacheVersion)
+    return true;
+
+  // Read and validate the whole cache before changing the graph, so that a
+  // corrupted cache can be ignored.
+  // Every string and node takes at least four bytes, so a count larger than
+  // that means the cache is corrupt.
+  auto numStrings = reader.read<uint32_t>();
+  if (numStrings > reader.remaining() / 4)
+    return true;
+  std::vector<StringRef> strings(numStrings);
+  for (StringRef &str : strings)
+    str = reader.readString();
+
+  struct CachedNode {
+    StringRef Path;
+    StringRef ContentHash;
+    std::vector<NodeRecordTy::Entry> Entries;
+  };
+  auto numNodes = reader.read<uint32_t>();
+  if (numNodes > reader.remaining() / 4)
+    return true;
+  std::vector<CachedNode> cachedNodes(numNodes);
+  for (CachedNode &cachedNode : cachedNodes) {
+    cachedNode.Path = reader.readString();
+    cachedNode.ContentHash = reader.readString();
+    auto numEntries = reader.read<uint32_t>();
+    if (reader.hadError())
+      return true;
+
+    for (uint32_t i = 0; i != numEntries; ++i) {
+      NodeRecordTy::Entry entry;
+      entry.Kind = reader.read<uint8_t>();
+      entry.DepKind = reader.read<uint8_t>();
+      entry.IsCascading = reader.read<uint8_t>();
+      entry.Name = reader.read<uint32_t>();
+      entry.Value = reader.read<uint32_t>();
+      if (reader.hadError() || !isValidRecordEntry(entry) ||
+          entry.Name >= strings.size() || entry.Value >= strings.size())
+        return true;
+      cachedNode.Entries.push_back(entry);
+    }
+  }
+  if (reader.hadError() || !reader.atEnd())
+    return true;
+
+  for (const CachedNode &cachedNode : cachedNodes) {
+    const void *node = getNodeForPath(cachedNode.Path);
+    if (!node)
+      continue;
+
+    // Only trust the cache if the dependency file hasn't changed.
+    auto depsBuffer =
+        llvm::MemoryBuffer::getFile(cachedNode.Path, /*FileSize=*/-1,
+                                    /*RequiresNullTerminator=*/false);
+    if (!depsBuffer)
+      continue;
+    if (hashContents(*depsBuffer.get()) != cachedNode.ContentHash)
+      continue;
+
+    auto loadResult = loadFromParser(node,
+                                     [&](const LoadCallbacks &callbacks) {
+      LoadResult result = LoadResult::UpToDate;
+      for (const NodeRecordTy::Entry &entry : cachedNode.Entries) {
+        StringRef name = strings[entry.Name];
+        auto depKind = static_cast<DependencyKind>(entry.DepKind);
+        LoadResult update = LoadResult::UpToDate;
+        switch (static_cast<RecordKind>(entry.Kind)) {
+        case RecordKind::Provides:
+          update = callbacks.provides(name, depKind, entry.IsCascading);
+          break;
+        case RecordKind::Depends:
+          update = callbacks.depends(name, depKind, entry.IsCascading);
+          break;
+        case RecordKind::InterfaceHash:
+          update = callbacks.interfaceHash(name);
+          break;
+        case RecordKind::Fingerprint:
+          update = callbacks.fingerprint(name, depKind,
+                                         strings[entry.Value]);
+          break;
+        }
+        if (update == LoadResult::HadError)
+          return update;
+        if (update == LoadResult::AffectsDownstream)
+          result = update;
+      }
+      return result;
+    });
+    if (loadResult == LoadResult::HadError)
+      continue;
+
+    auto &record = Records[node];
+    record.Path = cachedNode.Path;
+    record.ContentHash = cachedNode.ContentHash;
+    loaded.push_back(node);
+  }
+
+  return false;
 }
 
 void DependencyGraphImpl::markExternal(SmallVectorImpl<const void *> &visited,
@@ -298,7 +711,7 @@ void DependencyGraphImpl::markExternal(SmallVectorImpl<const void *> &visited,
   for (const auto &dependent : allDependents->second.first) {
     if (!dependent.kindMask.contains(DependencyKind::ExternalFile))
       continue;
-    if (isMarked(dependent.node))
+    if (isMarkedThrough(dependent.node))
       continue;
     assert(dependent.flags & DependencyFlags::IsCascading);
     visited.push_back(dependent.node);
@@ -306,9 +719,38 @@ void DependencyGraphImpl::markExternal(SmallVectorImpl<const void *> &visited,
   }
 }
 
+bool DependencyGraphImpl::isAffectedByChange(const ProvidesEntryTy &provided,
+                                             const UnchangedNamesTy &unchanged) {
+  // Dynamic lookup names aren't fingerprinted.
+  if (provided.kindMask.contains(DependencyKind::DynamicLookupName) ||
+      provided.kindMask.contains(DependencyKind::ExternalFile)) {
+    return true;
+  }
+
+  if (provided.kindMask.contains(DependencyKind::TopLevelName) &&
+      !unchanged.TopLevel.count(provided.name)) {
+    return true;
+  }
+
+  if (provided.kindMask.contains(DependencyKind::NominalType) &&
+      !unchanged.Nominal.count(provided.name)) {
+    return true;
+  }
+
+  if (provided.kindMask.contains(DependencyKind::NominalTypeMember)) {
+    // Members are covered by the fingerprint of their type.
+    StringRef typeName = StringRef(provided.name).split('\0').first;
+    if (!unchanged.Nominal.count(typeName))
+      return true;
+  }
+
+  return false;
+}
+
 void
 DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
-                                    const void *node, MarkTracerImpl *tracer) {
+                                    const void *node, MarkTracerImpl *tracer,
+                                    bool onlyChangedDecls) {
   assert(Provides.count(node) && "node is not in the graph");
   llvm::SpecificBumpPtrAllocator<MarkTracerImpl::Entry> scratchAlloc;
 
@@ -322,12 +764,16 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
   SmallPtrSet<const void *, 16> visitedSet;
 
   auto addDependentsToWorklist = [&](const void *next,
-                                     ArrayRef<MarkTracerImpl::Entry> reason) {
+                                     ArrayRef<MarkTracerImpl::Entry> reason,
+                                     const UnchangedNamesTy *unchanged) {
     auto allProvided = Provides.find(next);
     if (allProvided == Provides.end())
       return;
 
     for (const auto &provided : allProvided->second) {
+      if (unchanged && !isAffectedByChange(provided, *unchanged))
+        continue;
+
       auto allDependents = Dependencies.find(provided.name);
       if (allDependents == Dependencies.end())
         continue;
@@ -344,7 +790,7 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
         auto intersectingKinds = provided.kindMask & dependent.kindMask;
         if (!intersectingKinds)
           continue;
-        if (isMarked(dependent.node))
+        if (isMarkedThrough(dependent.node))
           continue;
         bool isCascading{dependent.flags & DependencyFlags::IsCascading};
 
@@ -372,9 +818,22 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
     }
   };
 
+  // If everything downstream of the node has already been traversed, there's
+  // nothing to gain from looking at fingerprints.
+  const UnchangedNamesTy *unchanged = nullptr;
+  if (onlyChangedDecls && !isMarkedThrough(node)) {
+    auto iter = UnchangedNames.find(node);
+    if (iter != UnchangedNames.end())
+      unchanged = &iter->second;
+  }
+
   // Always mark through the starting node, even if it's already marked.
   markIntransitive(node);
-  addDependentsToWorklist(node, {});
+  if (unchanged)
+    PartiallyMarked.insert(node);
+  else
+    PartiallyMarked.erase(node);
+  addDependentsToWorklist(node, {}, unchanged);
 
   while (!worklist.empty()) {
     auto next = worklist.pop_back_val();
@@ -386,8 +845,9 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
       continue;
     }
 
-    addDependentsToWorklist(next.Node, next.Reason);
-    if (!markIntransitive(next.Node))
+    addDependentsToWorklist(next.Node, next.Reason, nullptr);
+    bool wasPartiallyMarked = PartiallyMarked.erase(next.Node);
+    if (!markIntransitive(next.Node) && !wasPartiallyMarked)
       continue;
     record(next);
   }
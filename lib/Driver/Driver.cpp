@@ -215,6 +215,7 @@ static bool populateOutOfDateMap(InputInfoMap &map, StringRef argsHashStr,
   SmallString<64> scratch;
 
   llvm::StringMap<InputInfo> previousInputs;
+  llvm::StringMap<llvm::sys::TimeValue> previousDurations;
   bool versionValid = false;
   bool optionsMatch = true;
 
@@ -316,6 +317,30 @@ static bool populateOutOfDateMap(InputInfoMap &map, StringRef argsHashStr,
         auto inputName = key->getValue(scratch);
         previousInputs[inputName] = { *previousBuildState, timeValue };
       }
+
+    } else if (keyStr == "durations") {
+      // Durations are only used to order jobs, so a bad entry is ignored
+      // rather than invalidating the whole record.
+      auto *durationMap = dyn_cast<yaml::MappingNode>(i->getValue());
+      if (!durationMap)
+        continue;
+
+      // FIXME: LLVM's YAML support does incremental parsing in such a way that
+      // for-range loops break.
+      for (auto i = durationMap->begin(), e = durationMap->end(); i != e; ++i) {
+        auto *key = dyn_cast<yaml::ScalarNode>(i->getKey());
+        auto *value = dyn_cast<yaml::ScalarNode>(i->getValue());
+        if (!key || !value)
+          continue;
+
+        uint64_t milliseconds;
+        if (value->getValue(scratch).getAsInteger(10, milliseconds))
+          continue;
+
+        llvm::sys::TimeValue duration(milliseconds / 1000,
+                                      (milliseconds % 1000) * 1000000);
+        previousDurations[key->getValue(scratch)] = duration;
+      }
     }
   }
 
@@ -330,7 +355,10 @@ static bool populateOutOfDateMap(InputInfoMap &map, StringRef argsHashStr,
       continue;
     }
     ++numInputsFromPrevious;
-    map[inputPair.second] = iter->getValue();
+    auto &info = map[inputPair.second];
+    info = iter->getValue();
+    info.previousDuration =
+        previousDurations.lookup(inputPair.second->getValue());
   }
 
   // If a file was removed, we've lost its dependency info. Rebuild everything.
@@ -514,6 +542,13 @@ std::unique_ptr<Compilation> Driver::buildCompilation(
   if (ShowIncrementalBuildDecisions)
     C->setShowsIncrementalBuildDecisions();
 
+  if (const Arg *A = C->getArgs().getLastArg(options::OPT_driver_time_trace))
+    C->setTimeTracePath(A->getValue());
+
+  if (const Arg *A =
+          C->getArgs().getLastArg(options::OPT_compilation_cache_path))
+    C->setCompilationCachePath(A->getValue());
+
   // This has to happen after building jobs, because otherwise we won't even
   // emit .swiftdeps files for the next build.
   if (rebuildEverything)
@@ -1194,6 +1229,7 @@ void Driver::buildActions(const ToolChain &TC,
       case types::TY_ClangModuleFile:
       case types::TY_SwiftDeps:
       case types::TY_Remapping:
+      case types::TY_PhaseTimings:
         // We could in theory handle assembly or LLVM input, but let's not.
         // FIXME: What about LTO?
         Diags.diagnose(SourceLoc(), diag::error_unexpected_input_file,
@@ -1876,6 +1912,25 @@ Job *Driver::buildJobsForAction(Compilation &C, const JobAction *JA,
     }
   }
 
+  // Choose the phase timings output path. These are only read back by the
+  // driver when writing the trace, so they always go in temporary files.
+  // Backend jobs are left out because their arguments are embedded in the
+  // bitcode they produce.
+  if ((isa<CompileJobAction>(JA) || isa<MergeModuleJobAction>(JA)) &&
+      C.getArgs().hasArg(options::OPT_driver_time_trace)) {
+    llvm::SmallString<128> Path;
+    std::error_code EC = llvm::sys::fs::createTemporaryFile(
+        llvm::sys::path::stem(BaseInput),
+        types::getTypeTempSuffix(types::TY_PhaseTimings), Path);
+    if (EC) {
+      Diags.diagnose(SourceLoc(), diag::error_unable_to_make_temporary_file,
+                     EC.message());
+    } else {
+      Output->setAdditionalOutputForType(types::TY_PhaseTimings, Path);
+      C.addTemporaryFile(Path);
+    }
+  }
+
   // 4. Construct a Job which produces the right CommandOutput.
   std::unique_ptr<Job> ownedJob = TC.constructJob(*JA, C, std::move(InputJobs),
                                                   InputActions, 
@@ -63,6 +63,16 @@ static void addInputsOfType(ArgStringList &Arguments,
   }
 }
 
+static void addPhaseTimingsArgs(ArgStringList &Arguments,
+                                const CommandOutput &Output) {
+  const std::string &PhaseTimingsPath =
+    Output.getAdditionalOutputForType(types::TY_PhaseTimings);
+  if (!PhaseTimingsPath.empty()) {
+    Arguments.push_back("-emit-phase-timings-path");
+    Arguments.push_back(PhaseTimingsPath.c_str());
+  }
+}
+
 static void addPrimaryInputsOfType(ArgStringList &Arguments,
                                    ArrayRef<const Job *> Jobs,
                                    types::ID InputType) {
@@ -127,10 +137,13 @@ static void addCommonFrontendArgs(const ToolChain &TC,
   inputArgs.AddLastArg(arguments, options::OPT_parse_stdlib);
   inputArgs.AddLastArg(arguments, options::OPT_resource_dir);
   inputArgs.AddLastArg(arguments, options::OPT_solver_memory_threshold);
+  inputArgs.AddLastArg(arguments, options::OPT_stats_output_dir);
   inputArgs.AddLastArg(arguments, options::OPT_suppress_warnings);
   inputArgs.AddLastArg(arguments, options::OPT_profile_generate);
+  inputArgs.AddLastArg(arguments, options::OPT_profile_use);
   inputArgs.AddLastArg(arguments, options::OPT_profile_coverage_mapping);
   inputArgs.AddLastArg(arguments, options::OPT_warnings_as_errors);
+  inputArgs.AddLastArg(arguments, options::OPT_warning_limit);
   inputArgs.AddLastArg(arguments, options::OPT_sanitize_EQ);
   inputArgs.AddLastArg(arguments, options::OPT_sanitize_coverage_EQ);
 
@@ -220,6 +233,7 @@ ToolChain::constructInvocation(const CompileJobAction &job,
     case types::TY_Image:
     case types::TY_SwiftDeps:
     case types::TY_Remapping:
+    case types::TY_PhaseTimings:
       llvm_unreachable("Output type can never be primary output.");
     case types::TY_INVALID:
       llvm_unreachable("Invalid type ID");
@@ -358,6 +372,8 @@ ToolChain::constructInvocation(const CompileJobAction &job,
     Arguments.push_back(FixitsPath.c_str());
   }
 
+  addPhaseTimingsArgs(Arguments, context.Output);
+
   if (context.OI.numThreads > 0) {
     Arguments.push_back("-num-threads");
     Arguments.push_back(
@@ -384,6 +400,15 @@ ToolChain::constructInvocation(const CompileJobAction &job,
   if (context.Args.hasArg(options::OPT_embed_bitcode_marker))
     Arguments.push_back("-embed-bitcode-marker");
 
+  // If all we're producing is a module, only declarations and the SIL that
+  // gets serialized matter, so skip as much else as possible.
+  if (context.Output.getPrimaryOutputType() == types::TY_SwiftModuleFile &&
+      context.Args.hasArg(options::OPT_fast_emit_module)) {
+    if (context.OI.CompilerMode == OutputInfo::Mode::StandardCompile)
+      Arguments.push_back("-skip-secondary-function-bodies");
+    Arguments.push_back("-disable-sil-perf-optzns");
+  }
+
   return II;
 }
 
@@ -413,6 +438,7 @@ ToolChain::constructInvocation(const InterpretJobAction &job,
   context.Args.AddLastArg(Arguments, options::OPT_O_Group);
 
   context.Args.AddLastArg(Arguments, options::OPT_parse_sil);
+  context.Args.AddLastArg(Arguments, options::OPT_immediate_object_cache_path);
 
   Arguments.push_back("-module-name");
   Arguments.push_back(context.Args.MakeArgString(context.OI.ModuleName));
@@ -477,6 +503,7 @@ ToolChain::constructInvocation(const BackendJobAction &job,
     case types::TY_Image:
     case types::TY_SwiftDeps:
     case types::TY_Remapping:
+    case types::TY_PhaseTimings:
       llvm_unreachable("Output type can never be primary output.");
     case types::TY_INVALID:
       llvm_unreachable("Invalid type ID");
@@ -613,6 +640,13 @@ ToolChain::constructInvocation(const MergeModuleJobAction &job,
     Arguments.push_back(ObjCHeaderOutputPath.c_str());
   }
 
+  addPhaseTimingsArgs(Arguments, context.Output);
+
+  // Optimizing the merged module's SIL only affects how well its clients can
+  // inline from it, so skip it to get the module out sooner.
+  if (context.Args.hasArg(options::OPT_fast_emit_module))
+    Arguments.push_back("-disable-sil-perf-optzns");
+
   Arguments.push_back("-o");
   Arguments.push_back(
       context.Args.MakeArgString(context.Output.getPrimaryOutputFilename()));
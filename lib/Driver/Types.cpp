@@ -88,6 +88,7 @@ bool types::isTextual(ID Id) {
   case types::TY_SwiftDeps:
   case types::TY_Nothing:
   case types::TY_Remapping:
+  case types::TY_PhaseTimings:
     return false;
   case types::TY_INVALID:
     llvm_unreachable("Invalid type ID.");
@@ -118,6 +119,7 @@ bool types::isAfterLLVM(ID Id) {
   case types::TY_SwiftDeps:
   case types::TY_Nothing:
   case types::TY_Remapping:
+  case types::TY_PhaseTimings:
     return false;
   case types::TY_INVALID:
     llvm_unreachable("Invalid type ID.");
@@ -148,6 +150,7 @@ bool types::isPartOfSwiftCompilation(ID Id) {
   case types::TY_SwiftDeps:
   case types::TY_Nothing:
   case types::TY_Remapping:
+  case types::TY_PhaseTimings:
     return false;
   case types::TY_INVALID:
     llvm_unreachable("Invalid type ID.");
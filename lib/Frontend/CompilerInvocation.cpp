@@ -167,10 +167,13 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   Opts.EmitSortedSIL |= Args.hasArg(OPT_emit_sorted_sil);
 
   Opts.DelayedFunctionBodyParsing |= Args.hasArg(OPT_delayed_function_body_parsing);
+  Opts.SkipSecondaryFunctionBodies |=
+    Args.hasArg(OPT_skip_secondary_function_bodies);
   Opts.EnableTesting |= Args.hasArg(OPT_enable_testing);
   Opts.EnableResilience |= Args.hasArg(OPT_enable_resilience);
 
   Opts.PrintStats |= Args.hasArg(OPT_print_stats);
+  Opts.PrintMemoryStats |= Args.hasArg(OPT_print_memory_stats);
   Opts.PrintClangStats |= Args.hasArg(OPT_print_clang_stats);
   Opts.DebugTimeFunctionBodies |= Args.hasArg(OPT_debug_time_function_bodies);
   Opts.DebugTimeCompilation |= Args.hasArg(OPT_debug_time_compilation);
@@ -595,6 +598,18 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     Opts.FixitsOutputPath = A->getValue();
   }
 
+  if (const Arg *A = Args.getLastArg(OPT_emit_phase_timings_path)) {
+    Opts.PhaseTimingsFilePath = A->getValue();
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_stats_output_dir)) {
+    Opts.StatsOutputDir = A->getValue();
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_immediate_object_cache_path)) {
+    Opts.ImmediateObjectCachePath = A->getValue();
+  }
+
   bool IsSIB =
     Opts.RequestedAction == FrontendOptions::EmitSIB ||
     Opts.RequestedAction == FrontendOptions::EmitSIBGen;
@@ -743,6 +758,9 @@ static bool ParseLangArgs(LangOptions &Opts, ArgList &Args,
   Opts.EnableExperimentalCollectionCasts |=
     Args.hasArg(OPT_enable_experimental_collection_casts);
 
+  Opts.EnableNamedLazyMemberLoading |=
+    Args.hasArg(OPT_enable_named_lazy_member_loading);
+
   Opts.DisableAvailabilityChecking |=
       Args.hasArg(OPT_disable_availability_checking);
   
@@ -816,6 +834,31 @@ static bool ParseLangArgs(LangOptions &Opts, ArgList &Args,
     
     Opts.SolverMemoryThreshold = threshold;
   }
+
+  if (const Arg *A = Args.getLastArg(OPT_solver_expression_time_threshold_EQ)) {
+    unsigned threshold;
+    if (StringRef(A->getValue()).getAsInteger(10, threshold)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+
+    Opts.SolverExpressionTimeThreshold = threshold;
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_warn_long_expression_type_checking)) {
+    unsigned limit;
+    if (StringRef(A->getValue()).getAsInteger(10, limit)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+
+    Opts.WarnLongExpressionTypeChecking = limit;
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_expression_type_checking_stats_path))
+    Opts.ExpressionTypeCheckingStatsPath = A->getValue();
   
   for (const Arg *A : make_range(Args.filtered_begin(OPT_D),
                                  Args.filtered_end())) {
@@ -962,6 +1005,16 @@ static bool ParseDiagnosticArgs(DiagnosticOptions &Opts, ArgList &Args,
   Opts.SuppressWarnings |= Args.hasArg(OPT_suppress_warnings);
   Opts.WarningsAsErrors |= Args.hasArg(OPT_warnings_as_errors);
 
+  if (const Arg *A = Args.getLastArg(OPT_warning_limit)) {
+    unsigned limit;
+    if (StringRef(A->getValue()).getAsInteger(10, limit)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+    Opts.WarningLimit = limit;
+  }
+
   assert(!(Opts.WarningsAsErrors && Opts.SuppressWarnings) &&
          "conflicting arguments; should of been caught by driver");
 
@@ -1023,6 +1076,16 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
     if (A->getOption().matches(OPT_Onone)) {
       IRGenOpts.Optimize = false;
       Opts.Optimization = SILOptions::SILOptMode::None;
+    } else if (A->getOption().matches(OPT_Odebug)) {
+      // Keep the LLVM pipeline, variable lifetimes and debug info of -Onone,
+      // but run a few cheap SIL optimizations.
+      IRGenOpts.Optimize = false;
+      Opts.Optimization = SILOptions::SILOptMode::Debug;
+    } else if (A->getOption().matches(OPT_Osize)) {
+      // Turn on optimizations, but don't grow code for speed.
+      IRGenOpts.Optimize = true;
+      IRGenOpts.OptimizeForSize = true;
+      Opts.Optimization = SILOptions::SILOptMode::OptimizeForSize;
     } else if (A->getOption().matches(OPT_Ounchecked)) {
       // Turn on optimizations and remove all runtime checks.
       IRGenOpts.Optimize = true;
@@ -1082,6 +1145,8 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
 
   Opts.GenerateProfile |= Args.hasArg(OPT_profile_generate);
   Opts.EmitProfileCoverageMapping |= Args.hasArg(OPT_profile_coverage_mapping);
+  if (const Arg *A = Args.getLastArg(OPT_profile_use))
+    Opts.UseProfile = A->getValue();
   Opts.EnableGuaranteedClosureContexts |=
     Args.hasArg(OPT_enable_guaranteed_closure_contexts);
 
@@ -1192,6 +1257,11 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
     Opts.Verify = false;
 
   Opts.EmitStackPromotionChecks |= Args.hasArg(OPT_stack_promotion_checks);
+  Opts.UseCOWExistentials |= Args.hasArg(OPT_enable_cow_existentials);
+  Opts.OutlineValueOperations |=
+    Args.hasArg(OPT_enable_outlined_value_operations);
+  Opts.StaticClassMetadata |= Args.hasArg(OPT_enable_static_class_metadata);
+  Opts.InoutNoAlias |= Args.hasArg(OPT_assume_inout_noalias);
   if (const Arg *A = Args.getLastArg(OPT_stack_promotion_limit)) {
     unsigned limit;
     if (StringRef(A->getValue()).getAsInteger(10, limit)) {
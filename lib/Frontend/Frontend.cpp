@@ -75,6 +75,7 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
   if (Invocation.getDiagnosticOptions().WarningsAsErrors) {
     Diagnostics.setWarningsAsErrors(true);
   }
+  Diagnostics.setWarningLimit(Invocation.getDiagnosticOptions().WarningLimit);
 
   // If we are asked to emit a module documentation file, configure lexing and
   // parsing to remember comments.
@@ -277,7 +278,7 @@ void CompilerInstance::performSema() {
     }
 
     const auto &silOptions = Invocation.getSILOptions();
-    if ((silOptions.Optimization <= SILOptions::SILOptMode::None &&
+    if ((silOptions.Optimization <= SILOptions::SILOptMode::Debug &&
          (options.RequestedAction == FrontendOptions::EmitObject ||
           options.RequestedAction == FrontendOptions::Immediate ||
           options.RequestedAction == FrontendOptions::EmitSIL)) ||
@@ -383,6 +384,19 @@ void CompilerInstance::performSema() {
     DelayedCB.reset(new AlwaysDelayedCallbacks);
   }
 
+  // Only the declarations in secondary files matter when there's a primary
+  // file, so their function bodies can be skipped.
+  std::unique_ptr<DelayedParsingCallbacks> SecondaryDelayedCB;
+  if (!DelayedCB && PrimaryBufferID != NO_SUCH_BUFFER &&
+      options.SkipSecondaryFunctionBodies) {
+    SecondaryDelayedCB.reset(new SkipNonTransparentFunctions);
+  }
+  auto getDelayedCallbacks = [&](unsigned BufferID) {
+    if (SecondaryDelayedCB && BufferID != PrimaryBufferID)
+      return SecondaryDelayedCB.get();
+    return DelayedCB.get();
+  };
+
   PersistentParserState PersistentState;
 
   // Make sure the main file is the first file in the module. This may only be
@@ -441,7 +455,7 @@ void CompilerInstance::performSema() {
       // Parser may stop at some erroneous constructions like #else, #endif
       // or '}' in some cases, continue parsing until we are done
       parseIntoSourceFile(*NextInput, BufferID, &Done, nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, getDelayedCallbacks(BufferID));
     } while (!Done);
 
     Diags.setSuppressWarnings(DidSuppressWarnings);
@@ -494,7 +508,7 @@ void CompilerInstance::performSema() {
       // with 'sil' definitions.
       parseIntoSourceFile(MainFile, MainFile.getBufferID().getValue(), &Done,
                           TheSILModule ? &SILContext : nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, getDelayedCallbacks(MainBufferID));
       if (mainIsPrimary) {
         performTypeChecking(MainFile, PersistentState.getTopLevelContext(),
                             TypeCheckOptions, CurTUElem,
@@ -528,6 +542,8 @@ void CompilerInstance::performSema() {
   if (DelayedCB) {
     performDelayedParsing(MainModule, PersistentState,
                           Invocation.getCodeCompletionFactory());
+  } else if (SecondaryDelayedCB) {
+    performDelayedParsing(MainModule, PersistentState, nullptr);
   }
 
   // Perform whole-module type checking.
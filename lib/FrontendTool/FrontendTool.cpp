@@ -23,11 +23,13 @@
 #include "swift/FrontendTool/FrontendTool.h"
 
 #include "swift/Subsystems.h"
+#include "swift/AST/ClangModuleLoader.h"
 #include "swift/AST/DiagnosticsFrontend.h"
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/AST/IRGenOptions.h"
 #include "swift/AST/Mangle.h"
 #include "swift/AST/NameLookup.h"
+#include "swift/AST/Pattern.h"
 #include "swift/AST/ReferencedNameTracker.h"
 #include "swift/AST/TypeRefinementContext.h"
 #include "swift/Basic/Dwarf.h"
@@ -41,21 +43,27 @@
 #include "swift/Frontend/SerializedDiagnosticConsumer.h"
 #include "swift/Immediate/Immediate.h"
 #include "swift/Option/Options.h"
+#include "swift/Parse/Lexer.h"
 #include "swift/PrintAsObjC/PrintAsObjC.h"
 #include "swift/Serialization/SerializationOptions.h"
+#include "swift/Serialization/SerializedModuleLoader.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 
 // FIXME: We're just using CompilerInstance::createOutputFile.
 // This API should be sunk down to LLVM.
+#include "clang/AST/ASTContext.h"
 #include "clang/Frontend/CompilerInstance.h"
 
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Option/OptTable.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/TargetSelect.h"
@@ -197,6 +205,207 @@ static std::string mangleTypeAsContext(const NominalTypeDecl *type) {
   return mangler.finalize();
 }
 
+/// Collects the source ranges of the bodies of any functions and accessors
+/// declared by \p D, which do not contribute to its fingerprint.
+static void collectBodyRanges(const Decl *D,
+                              SmallVectorImpl<SourceRange> &bodies) {
+  auto addBody = [&bodies](const AbstractFunctionDecl *AFD) {
+    if (!AFD)
+      return;
+    SourceRange range = AFD->getBodySourceRange();
+    if (range.isValid())
+      bodies.push_back(range);
+  };
+
+  if (auto *AFD = dyn_cast<AbstractFunctionDecl>(D)) {
+    addBody(AFD);
+    return;
+  }
+
+  if (auto *ASD = dyn_cast<AbstractStorageDecl>(D)) {
+    addBody(ASD->getGetter());
+    addBody(ASD->getSetter());
+    if (ASD->hasObservers()) {
+      addBody(ASD->getWillSetFunc());
+      addBody(ASD->getDidSetFunc());
+    }
+    if (ASD->hasAddressors()) {
+      addBody(ASD->getAddressor());
+      addBody(ASD->getMutableAddressor());
+    }
+    return;
+  }
+
+  if (auto *PBD = dyn_cast<PatternBindingDecl>(D)) {
+    for (auto entry : PBD->getPatternList()) {
+      entry.getPattern()->forEachVariable([&](VarDecl *VD) {
+        collectBodyRanges(VD, bodies);
+      });
+    }
+    return;
+  }
+
+  if (auto *NTD = dyn_cast<NominalTypeDecl>(D)) {
+    for (const Decl *member : NTD->getMembers())
+      collectBodyRanges(member, bodies);
+  } else if (auto *ED = dyn_cast<ExtensionDecl>(D)) {
+    for (const Decl *member : ED->getMembers())
+      collectBodyRanges(member, bodies);
+  }
+}
+
+/// Returns true if the interface of \p D depends on a type that is inferred
+/// from an expression, such as a stored property without a type annotation.
+///
+/// Such a declaration can change without its own tokens changing, so it
+/// cannot be given a fingerprint.
+static bool hasInferredInterfaceType(const Decl *D) {
+  if (auto *VD = dyn_cast<VarDecl>(D)) {
+    if (auto *PBD = VD->getParentPatternBinding())
+      return hasInferredInterfaceType(PBD);
+    return false;
+  }
+
+  if (auto *PBD = dyn_cast<PatternBindingDecl>(D)) {
+    return std::any_of(PBD->getPatternList().begin(),
+                       PBD->getPatternList().end(),
+                       [](const PatternBindingEntry &entry) {
+      return !isa<TypedPattern>(entry.getPattern());
+    });
+  }
+
+  if (auto *NTD = dyn_cast<NominalTypeDecl>(D)) {
+    return std::any_of(NTD->getMembers().begin(), NTD->getMembers().end(),
+                       hasInferredInterfaceType);
+  }
+  if (auto *ED = dyn_cast<ExtensionDecl>(D)) {
+    return std::any_of(ED->getMembers().begin(), ED->getMembers().end(),
+                       hasInferredInterfaceType);
+  }
+  return false;
+}
+
+/// Adds the interface tokens of \p D to \p hash, the same way the parser
+/// records tokens for SourceFile's interface hash: function bodies are
+/// skipped, as are comments.
+///
+/// \returns false if \p D has no source range.
+static bool updateInterfaceTokens(llvm::MD5 &hash, const Decl *D,
+                                  const SourceManager &SM,
+                                  const LangOptions &langOpts) {
+  // The 'var' keyword belongs to the pattern binding, but the attributes
+  // belong to the VarDecl.
+  SourceRange range = D->getSourceRange();
+  if (auto *VD = dyn_cast<VarDecl>(D))
+    if (auto *PBD = VD->getParentPatternBinding())
+      range = PBD->getSourceRange();
+  if (range.isInvalid())
+    return false;
+
+  SourceLoc attrLoc = D->getAttrs().getStartLoc();
+  if (attrLoc.isValid() && SM.isBeforeInBuffer(attrLoc, range.Start))
+    range.Start = attrLoc;
+
+  unsigned bufferID = SM.findBufferContainingLoc(range.Start);
+  unsigned startOffset = SM.getLocOffsetInBuffer(range.Start, bufferID);
+  unsigned endOffset =
+    SM.getLocOffsetInBuffer(Lexer::getLocForEndOfToken(SM, range.End),
+                            bufferID);
+
+  SmallVector<SourceRange, 8> bodies;
+  collectBodyRanges(D, bodies);
+  std::sort(bodies.begin(), bodies.end(),
+            [&SM](SourceRange lhs, SourceRange rhs) {
+    return SM.isBeforeInBuffer(lhs.Start, rhs.Start);
+  });
+
+  auto nextBody = bodies.begin();
+  for (const Token &tok : tokenize(langOpts, SM, bufferID, startOffset,
+                                   endOffset, /*KeepComments=*/false,
+                                   /*TokenizeInterpolatedString=*/false)) {
+    if (tok.is(tok::eof))
+      break;
+
+    // Keep the braces of a body, but not what's inside them.
+    while (nextBody != bodies.end() &&
+           !SM.isBeforeInBuffer(tok.getLoc(), nextBody->End)) {
+      ++nextBody;
+    }
+    if (nextBody != bodies.end() &&
+        SM.isBeforeInBuffer(nextBody->Start, tok.getLoc())) {
+      continue;
+    }
+
+    hash.update(tok.getText());
+    // Add null byte to separate tokens.
+    uint8_t a[1] = {0};
+    hash.update(a);
+  }
+  return true;
+}
+
+/// Adds the interface tokens of \p D to \p hash.
+///
+/// \returns false if \p D cannot be fingerprinted.
+static bool updateFingerprint(llvm::MD5 &hash, const Decl *D,
+                              const SourceManager &SM,
+                              const LangOptions &langOpts) {
+  if (hasInferredInterfaceType(D))
+    return false;
+  return updateInterfaceTokens(hash, D, SM, langOpts);
+}
+
+/// Computes a hash of the top-level declarations in \p SF that other
+/// declarations in the file can depend on without their own tokens changing:
+/// everything except functions, variables and top-level code.
+///
+/// A token hash of a declaration doesn't see what the names in it resolve
+/// to. Changing `typealias T = Int` to `= String` changes the meaning of
+/// `func f(_: T)`, so this hash is part of every fingerprint in the file.
+static std::string computeFileContextHash(const SourceFile *SF,
+                                          const SourceManager &SM,
+                                          const LangOptions &langOpts) {
+  llvm::MD5 hash;
+  for (const Decl *D : SF->Decls) {
+    switch (D->getKind()) {
+    case DeclKind::Func:
+    case DeclKind::Var:
+    case DeclKind::PatternBinding:
+    case DeclKind::TopLevelCode:
+      continue;
+    default:
+      if (!D->isImplicit())
+        updateInterfaceTokens(hash, D, SM, langOpts);
+      break;
+    }
+  }
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str().str();
+}
+
+/// Computes a combined fingerprint for \p decls in a file whose context hash
+/// is \p fileContext, or returns None if any of them cannot be fingerprinted.
+static Optional<std::string> computeFingerprint(ArrayRef<const Decl *> decls,
+                                                StringRef fileContext,
+                                                const SourceManager &SM,
+                                                const LangOptions &langOpts) {
+  llvm::MD5 hash;
+  hash.update(fileContext);
+  for (const Decl *D : decls)
+    if (!updateFingerprint(hash, D, SM, langOpts))
+      return None;
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str().str();
+}
+
 /// Emits a Swift-style dependencies file.
 static bool emitReferenceDependencies(DiagnosticEngine &diags,
                                       SourceFile *SF,
@@ -229,6 +438,11 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
   llvm::SmallVector<const FuncDecl *, 8> memberOperatorDecls;
   llvm::SmallVector<const ExtensionDecl *, 8> extensionsWithJustMembers;
 
+  // The declarations that make up each provided name's fingerprint.
+  llvm::MapVector<Identifier, SmallVector<const Decl *, 1>> topLevelDecls;
+  llvm::DenseMap<const NominalTypeDecl *, SmallVector<const Decl *, 2>>
+    extensionsByNominal;
+
   out << "provides-top-level:\n";
   for (const Decl *D : SF->Decls) {
     switch (D->getKind()) {
@@ -261,6 +475,7 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
         }
       }
       extendedNominals[NTD] |= !justMembers;
+      extensionsByNominal[NTD].push_back(ED);
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                ED->getMembers());
       break;
@@ -270,10 +485,12 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
     case DeclKind::PrefixOperator:
     case DeclKind::PostfixOperator:
       out << "- \"" << escape(cast<OperatorDecl>(D)->getName()) << "\"\n";
+      topLevelDecls[cast<OperatorDecl>(D)->getName()].push_back(D);
       break;
 
     case DeclKind::PrecedenceGroup:
       out << "- \"" << escape(cast<PrecedenceGroupDecl>(D)->getName()) << "\"\n";
+      topLevelDecls[cast<PrecedenceGroupDecl>(D)->getName()].push_back(D);
       break;
 
     case DeclKind::Enum:
@@ -288,6 +505,7 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
         break;
       }
       out << "- \"" << escape(NTD->getName()) << "\"\n";
+      topLevelDecls[NTD->getName()].push_back(NTD);
       extendedNominals[NTD] |= true;
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                NTD->getMembers());
@@ -305,6 +523,7 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
         break;
       }
       out << "- \"" << escape(VD->getName()) << "\"\n";
+      topLevelDecls[VD->getName()].push_back(VD);
       break;
     }
 
@@ -327,8 +546,10 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
   }
 
   // This is also part of "provides-top-level".
-  for (auto *operatorFunction : memberOperatorDecls)
+  for (auto *operatorFunction : memberOperatorDecls) {
     out << "- \"" << escape(operatorFunction->getName()) << "\"\n";
+    topLevelDecls[operatorFunction->getName()].push_back(operatorFunction);
+  }
 
   out << "provides-nominal:\n";
   for (auto entry : extendedNominals) {
@@ -468,6 +689,53 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
     out << "- \"" << llvm::yaml::escape(entry) << "\"\n";
   }
 
+  // Fingerprints let the driver tell which of the provided names were
+  // affected by a change to the interface hash. A name without a fingerprint
+  // is always considered changed.
+  const SourceManager &SM = SF->getASTContext().SourceMgr;
+  const LangOptions &langOpts = SF->getASTContext().LangOpts;
+  std::string fileContext = computeFileContextHash(SF, SM, langOpts);
+
+  // A type's fingerprint covers its extensions in this file, since they can
+  // add members and conformances.
+  auto getNominalDecls = [&](const NominalTypeDecl *NTD) {
+    SmallVector<const Decl *, 2> decls;
+    if (NTD->getParentSourceFile() == SF)
+      decls.push_back(NTD);
+    auto extensions = extensionsByNominal.find(NTD);
+    if (extensions != extensionsByNominal.end())
+      decls.append(extensions->second.begin(), extensions->second.end());
+    return decls;
+  };
+
+  out << "fingerprints-top-level:\n";
+  for (auto &entry : topLevelDecls) {
+    SmallVector<const Decl *, 2> decls;
+    for (const Decl *D : entry.second) {
+      if (auto *NTD = dyn_cast<NominalTypeDecl>(D)) {
+        auto nominalDecls = getNominalDecls(NTD);
+        decls.append(nominalDecls.begin(), nominalDecls.end());
+      } else {
+        decls.push_back(D);
+      }
+    }
+    if (auto fingerprint =
+          computeFingerprint(decls, fileContext, SM, langOpts)) {
+      out << "- [\"" << escape(entry.first) << "\", \"" << *fingerprint
+          << "\"]\n";
+    }
+  }
+
+  out << "fingerprints-nominal:\n";
+  for (auto entry : extendedNominals) {
+    auto decls = getNominalDecls(entry.first);
+    if (auto fingerprint =
+          computeFingerprint(decls, fileContext, SM, langOpts)) {
+      out << "- [\"" << mangleTypeAsContext(entry.first) << "\", \""
+          << *fingerprint << "\"]\n";
+    }
+  }
+
   llvm::SmallString<32> interfaceHash;
   SF->getInterfaceHash(interfaceHash);
   out << "interface-hash: \"" << interfaceHash << "\"\n";
@@ -676,13 +944,74 @@ static void debugFailWithCrash() {
   LLVM_BUILTIN_TRAP;
 }
 
+/// Print how much memory the compiler's main data structures are using once
+/// \p phase has finished.
+static void printMemoryStats(StringRef phase, CompilerInstance &Instance,
+                             const SILModule *SM) {
+  ASTContext &Context = Instance.getASTContext();
+  auto &OS = llvm::errs();
+  OS << "*** Memory use after " << phase << " ***\n";
+  OS << "  ASTContext: " << Context.getTotalMemory() << " bytes ("
+     << Context.getSolverMemory() << " in the constraint solver arena)\n";
+  if (auto *ClangLoader = Context.getClangModuleLoader()) {
+    auto &ClangContext = ClangLoader->getClangASTContext();
+    OS << "  Clang ASTContext: "
+       << ClangContext.getASTAllocatedMemory() +
+            ClangContext.getSideTableAllocatedMemory()
+       << " bytes\n";
+  }
+  SerializedModuleLoader::printMemoryStatistics(Context, OS);
+  if (SM)
+    OS << "  SILModule: " << SM->getAllocatedMemory() << " bytes\n";
+}
+
+namespace {
+/// Counters written by -stats-output-dir in addition to the phase timings.
+struct FrontendStatistics {
+  uint64_t NumSILGenFunctions = 0;
+  uint64_t NumSILGenInstructions = 0;
+  uint64_t NumSILOptFunctions = 0;
+  uint64_t NumSILOptInstructions = 0;
+  /// False when IRGen didn't hand back a module to count, as with
+  /// multi-threaded whole-module builds; the LLVM counters are then omitted
+  /// rather than reported as zero.
+  bool HaveLLVMCounts = false;
+  uint64_t NumLLVMFunctions = 0;
+  uint64_t NumLLVMInstructions = 0;
+};
+} // end anonymous namespace
+
+static void countSILInstructions(const SILModule &SM, uint64_t &NumFunctions,
+                                 uint64_t &NumInstructions) {
+  NumFunctions = NumInstructions = 0;
+  for (auto &F : SM) {
+    ++NumFunctions;
+    for (auto &BB : F)
+      NumInstructions += std::distance(BB.begin(), BB.end());
+  }
+}
+
+static void countLLVMInstructions(const llvm::Module &M,
+                                  uint64_t &NumFunctions,
+                                  uint64_t &NumInstructions) {
+  NumFunctions = NumInstructions = 0;
+  for (auto &F : M) {
+    if (F.isDeclaration())
+      continue;
+    ++NumFunctions;
+    for (auto &BB : F)
+      NumInstructions += BB.size();
+  }
+}
+
 /// Performs the compile requested by the user.
 /// \returns true on error
 static bool performCompile(CompilerInstance &Instance,
                            CompilerInvocation &Invocation,
                            ArrayRef<const char *> Args,
                            int &ReturnValue,
-                           FrontendObserver *observer) {
+                           FrontendObserver *observer,
+                           FrontendStatistics *stats) {
   FrontendOptions opts = Invocation.getFrontendOptions();
   FrontendOptions::ActionType Action = opts.RequestedAction;
 
@@ -785,6 +1114,9 @@ static bool performCompile(CompilerInstance &Instance,
   if (opts.PrintClangStats && Context.getClangModuleLoader())
     Context.getClangModuleLoader()->printStatistics();
 
+  if (opts.PrintMemoryStats)
+    printMemoryStats("type checking", Instance, nullptr);
+
   if (!opts.DependenciesFilePath.empty())
     (void)emitMakeDependencies(Context.Diags, *Instance.getDependencyTracker(),
                                opts);
@@ -834,6 +1166,9 @@ static bool performCompile(CompilerInstance &Instance,
   if (observer) {
     observer->performedSILGeneration(*SM);
   }
+  if (stats)
+    countSILInstructions(*SM, stats->NumSILGenFunctions,
+                         stats->NumSILGenInstructions);
 
   // We've been told to emit SIL after SILGen, so write it now.
   if (Action == FrontendOptions::EmitSILGen) {
@@ -886,7 +1221,7 @@ static bool performCompile(CompilerInstance &Instance,
   {
     SharedTimer timer("SIL optimization");
     if (Invocation.getSILOptions().Optimization >
-        SILOptions::SILOptMode::None) {
+        SILOptions::SILOptMode::Debug) {
       StringRef CustomPipelinePath =
         Invocation.getSILOptions().ExternalPassPipelineFilename;
       if (!CustomPipelinePath.empty()) {
@@ -902,6 +1237,9 @@ static bool performCompile(CompilerInstance &Instance,
   if (observer) {
     observer->performedSILOptimization(*SM);
   }
+  if (stats)
+    countSILInstructions(*SM, stats->NumSILOptFunctions,
+                         stats->NumSILOptInstructions);
 
   {
     SharedTimer timer("SIL verification (post-optimization)");
@@ -913,6 +1251,9 @@ static bool performCompile(CompilerInstance &Instance,
     performSILInstCount(&*SM);
   }
 
+  if (opts.PrintMemoryStats)
+    printMemoryStats("SIL optimization", Instance, SM.get());
+
   // Get the main source file's private discriminator and attach it to
   // the compile unit's flags.
   if (PrimarySourceFile) {
@@ -1006,20 +1347,35 @@ static bool performCompile(CompilerInstance &Instance,
     }
 
     ReturnValue =
-      RunImmediately(Instance, CmdLine, IRGenOpts, Invocation.getSILOptions());
+      RunImmediately(Instance, CmdLine, IRGenOpts, Invocation.getSILOptions(),
+                     opts.ImmediateObjectCachePath);
     return false;
   }
 
   // FIXME: We shouldn't need to use the global context here, but
   // something is persisting across calls to performIRGeneration.
   auto &LLVMContext = llvm::getGlobalContext();
+  std::unique_ptr<llvm::Module> IRModule;
   if (PrimarySourceFile) {
-    performIRGeneration(IRGenOpts, *PrimarySourceFile, SM.get(),
-                        opts.getSingleOutputFilename(), LLVMContext);
+    IRModule = performIRGeneration(IRGenOpts, *PrimarySourceFile,
+                                   std::move(SM),
+                                   opts.getSingleOutputFilename(),
+                                   LLVMContext);
   } else {
-    performIRGeneration(IRGenOpts, Instance.getMainModule(), SM.get(),
-                        opts.getSingleOutputFilename(), LLVMContext);
+    IRModule = performIRGeneration(IRGenOpts, Instance.getMainModule(),
+                                   std::move(SM),
+                                   opts.getSingleOutputFilename(),
+                                   LLVMContext);
   }
+  if (stats && IRModule) {
+    countLLVMInstructions(*IRModule, stats->NumLLVMFunctions,
+                          stats->NumLLVMInstructions);
+    stats->HaveLLVMCounts = true;
+  }
+
+  // IRGen has already destroyed the SILModule.
+  if (opts.PrintMemoryStats)
+    printMemoryStats("IRGen", Instance, nullptr);
 
   return false;
 }
@@ -1086,6 +1442,113 @@ static bool dumpAPI(Module *Mod, StringRef OutDir) {
   return false;
 }
 
+/// Writes out the phases recorded by SharedTimer as a YAML list of
+/// [name, start, end] entries, with times in microseconds since the Unix
+/// epoch.
+///
+/// Returns true if an error occurred.
+static bool emitPhaseTimings(DiagnosticEngine &diags, StringRef path) {
+  std::error_code EC;
+  llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::F_None);
+  if (out.has_error() || EC) {
+    diags.diagnose(SourceLoc(), diag::error_opening_output, path,
+                   EC.message());
+    out.clear_error();
+    return true;
+  }
+
+  auto toMicroseconds = [](llvm::sys::TimeValue time) -> uint64_t {
+    return time.toEpochTime() * 1000000 + time.microseconds();
+  };
+
+  for (auto &phase : SharedTimer::getRecordedPhases()) {
+    out << "- [\"" << llvm::yaml::escape(phase.Name) << "\", "
+        << toMicroseconds(phase.Start) << ", " << toMicroseconds(phase.End)
+        << "]\n";
+  }
+  return false;
+}
+
+/// Writes the counters and phase timings of this job as a JSON file with a
+/// unique name in \p dir, so that the jobs of a build can share a directory.
+static bool emitStatistics(CompilerInstance &Instance,
+                           const FrontendStatistics &stats, StringRef dir) {
+  DiagnosticEngine &diags = Instance.getDiags();
+  ASTContext &Context = Instance.getASTContext();
+
+  int fd;
+  SmallString<128> path;
+  std::error_code EC = llvm::sys::fs::create_directories(dir);
+  if (!EC) {
+    SmallString<128> pattern = dir;
+    llvm::sys::path::append(pattern, "frontend-" +
+                            Instance.getMainModule()->getName().str() +
+                            "-%%%%%%%%.json");
+    EC = llvm::sys::fs::createUniqueFile(pattern, fd, path);
+  }
+  if (EC) {
+    diags.diagnose(SourceLoc(), diag::error_opening_output, dir, EC.message());
+    return true;
+  }
+
+  llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+  uint64_t numDecls, numTypes, numConformances;
+  SerializedModuleLoader::getTotalStatistics(Context, numDecls, numTypes,
+                                             numConformances);
+
+  out << "{\n";
+  out << "  \"module\": \""
+      << llvm::yaml::escape(Instance.getMainModule()->getName().str())
+      << "\",\n";
+  if (auto *primary = Instance.getPrimarySourceFile())
+    out << "  \"primary-file\": \""
+        << llvm::yaml::escape(primary->getFilename()) << "\",\n";
+
+  out << "  \"counters\": {\n";
+  auto counter = [&](StringRef name, uint64_t value, bool last = false) {
+    out << "    \"" << name << "\": " << value << (last ? "\n" : ",\n");
+  };
+  counter("Deserialization.NumDecls", numDecls);
+  counter("Deserialization.NumTypes", numTypes);
+  counter("Deserialization.NumConformances", numConformances);
+  counter("AST.TotalMemory", Context.getTotalMemory());
+  counter("AST.SolverMemory", Context.getSolverMemory());
+  counter("SILGen.NumFunctions", stats.NumSILGenFunctions);
+  counter("SILGen.NumInstructions", stats.NumSILGenInstructions);
+  counter("SILOptimizer.NumFunctions", stats.NumSILOptFunctions);
+  counter("SILOptimizer.NumInstructions", stats.NumSILOptInstructions,
+          /*last=*/!stats.HaveLLVMCounts);
+  if (stats.HaveLLVMCounts) {
+    counter("LLVM.NumFunctions", stats.NumLLVMFunctions);
+    counter("LLVM.NumInstructions", stats.NumLLVMInstructions, /*last=*/true);
+  }
+  out << "  },\n";
+
+  auto toMicroseconds = [](llvm::sys::TimeValue time) -> uint64_t {
+    return time.toEpochTime() * 1000000 + time.microseconds();
+  };
+
+  // Sum the phases that ran more than once, keeping the order they started.
+  llvm::StringMap<double> phaseTimes;
+  std::vector<StringRef> phaseOrder;
+  for (auto &phase : SharedTimer::getRecordedPhases()) {
+    auto inserted = phaseTimes.insert({phase.Name, 0});
+    if (inserted.second)
+      phaseOrder.push_back(inserted.first->getKey());
+    inserted.first->getValue() +=
+      (toMicroseconds(phase.End) - toMicroseconds(phase.Start)) / 1e6;
+  }
+  out << "  \"phases\": {";
+  for (unsigned i = 0, e = phaseOrder.size(); i != e; ++i) {
+    out << (i ? ",\n" : "\n") << "    \""
+        << llvm::yaml::escape(phaseOrder[i]) << "\": "
+        << llvm::format("%.6f", phaseTimes[phaseOrder[i]]);
+  }
+  out << "\n  }\n";
+  out << "}\n";
+  return false;
+}
+
 int swift::performFrontend(ArrayRef<const char *> Args,
                            const char *Argv0, void *MainAddr,
                            FrontendObserver *observer) {
@@ -1203,6 +1666,14 @@ int swift::performFrontend(ArrayRef<const char *> Args,
   if (Invocation.getFrontendOptions().DebugTimeCompilation)
     SharedTimer::enableCompilationTimers();
 
+  if (!Invocation.getFrontendOptions().PhaseTimingsFilePath.empty() ||
+      !Invocation.getFrontendOptions().StatsOutputDir.empty())
+    SharedTimer::enablePhaseRecording();
+
+  std::unique_ptr<FrontendStatistics> stats;
+  if (!Invocation.getFrontendOptions().StatsOutputDir.empty())
+    stats.reset(new FrontendStatistics());
+
   if (Invocation.getFrontendOptions().PrintStats) {
     llvm::EnableStatistics();
   }
@@ -1228,9 +1699,23 @@ int swift::performFrontend(ArrayRef<const char *> Args,
 
   int ReturnValue = 0;
   bool HadError =
-    performCompile(Instance, Invocation, Args, ReturnValue, observer) ||
+    performCompile(Instance, Invocation, Args, ReturnValue, observer,
+                   stats.get()) ||
     Instance.getASTContext().hadError();
 
+  if (Invocation.getFrontendOptions().PrintStats)
+    SerializedModuleLoader::printStatistics(Instance.getASTContext(),
+                                            llvm::errs());
+
+  // Say how many warnings were cut off, lifting the limit so that this one
+  // is not swallowed too.
+  DiagnosticEngine &Diags = Instance.getDiags();
+  if (unsigned overLimit = Diags.getNumWarningsOverLimit()) {
+    Diags.setWarningLimit(0);
+    Diags.diagnose(SourceLoc(), diag::warning_limit_reached, overLimit,
+                   overLimit != 1);
+  }
+
   if (!HadError && !Invocation.getFrontendOptions().DumpAPIPath.empty()) {
     HadError = dumpAPI(Instance.getMainModule(),
                        Invocation.getFrontendOptions().DumpAPIPath);
@@ -1248,6 +1733,17 @@ int swift::performFrontend(ArrayRef<const char *> Args,
     }
   }
 
+  // Write the timings even if compilation failed, so that the driver can
+  // still account for the time spent.
+  if (!Invocation.getFrontendOptions().PhaseTimingsFilePath.empty()) {
+    HadError |= emitPhaseTimings(Instance.getDiags(),
+                        Invocation.getFrontendOptions().PhaseTimingsFilePath);
+  }
+  if (stats) {
+    HadError |= emitStatistics(Instance, *stats,
+                               Invocation.getFrontendOptions().StatsOutputDir);
+  }
+
   return (HadError ? 1 : ReturnValue);
 }
 
@@ -204,8 +204,10 @@ void getClangDocKeyword(ClangImporter &Importer, const Decl *D,
   if (auto RC = Importer.getClangASTContext().getRawCommentForAnyRedecl(D)) {
     auto RT = RC->getRawText(Importer.getClangASTContext().getSourceManager());
     if (containsInterestedWords(RT, "@", /*AllowWhitespace*/false)) {
+      // getCommentForDecl caches the parsed comment, so a declaration that
+      // shows up in many completion results is only parsed once.
       FullComment* Comment = Importer.getClangASTContext().
-        getLocalCommentForDeclUncached(D);
+        getCommentForDecl(D, /*PP=*/nullptr);
       Extractor.visit(Comment);
     }
   }
@@ -1209,24 +1211,35 @@ void CodeCompletionContext::sortCompletionResults(
     MutableArrayRef<CodeCompletionResult *> Results) {
   struct ResultAndName {
     CodeCompletionResult *result;
-    std::string name;
+    StringRef name;
   };
 
   // Caching the name of each field is important to avoid unnecessary calls to
-  // CodeCompletionString::getName().
+  // CodeCompletionString::getName(). The names are all printed into a single
+  // buffer rather than one string per result, since there can be tens of
+  // thousands of results.
+  std::string nameBuffer;
+  std::vector<std::pair<size_t, size_t>> nameRanges(Results.size());
+  {
+    llvm::raw_string_ostream OS(nameBuffer);
+    for (unsigned i = 0, n = Results.size(); i < n; ++i) {
+      size_t start = OS.tell();
+      Results[i]->getCompletionString()->getName(OS);
+      nameRanges[i] = {start, OS.tell() - start};
+    }
+  }
+
   std::vector<ResultAndName> nameCache(Results.size());
   for (unsigned i = 0, n = Results.size(); i < n; ++i) {
-    auto *result = Results[i];
-    nameCache[i].result = result;
-    llvm::raw_string_ostream OS(nameCache[i].name);
-    result->getCompletionString()->getName(OS);
-    OS.flush();
+    nameCache[i].result = Results[i];
+    nameCache[i].name =
+        StringRef(nameBuffer).substr(nameRanges[i].first, nameRanges[i].second);
   }
 
   // Sort nameCache, and then transform Results to return the pointers in order.
   std::sort(nameCache.begin(), nameCache.end(),
             [](const ResultAndName &LHS, const ResultAndName &RHS) {
-    int Result = StringRef(LHS.name).compare_lower(RHS.name);
+    int Result = LHS.name.compare_lower(RHS.name);
     // If the case insensitive comparison is equal, then secondary sort order
     // should be case sensitive.
     if (Result == 0)
@@ -158,16 +158,20 @@ static bool readCachedModule(llvm::MemoryBuffer *in,
   const char *strings = chunks + chunkSize;
   auto stringCount = read32le(strings);
   assert(strings + stringCount == end && "incorrect file size");
-  (void)stringCount; // so it is not seen as "unused" in release builds.
-  
+
   // STRINGS
+  // Copy the whole string table into the sink's allocator at once, so the
+  // strings of every result can refer into it directly instead of being copied
+  // one at a time. The results outlive the buffer, but not the allocator.
+  StringRef stringTable =
+      copyString(*V.Sink.Allocator, StringRef(strings, stringCount));
   auto getString = [&](uint32_t index) -> StringRef {
     if (index == ~0u)
       return "";
 
-    const char *p = strings + index;
-    auto size = read32le(p);
-    return copyString(*V.Sink.Allocator, StringRef(p, size));
+    const char *p = stringTable.data() + index;
+    auto size = llvm::support::endian::read32le(p);
+    return StringRef(p + sizeof(size), size);
   };
 
   // CHUNKS
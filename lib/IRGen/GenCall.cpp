@@ -105,8 +105,10 @@ static void addInoutParameterAttributes(IRGenModule &IGM,
                                         bool aliasable) {
   llvm::AttrBuilder b;
   // Aliasing inouts is unspecified, but we still want aliasing to be memory-
-  // safe, so we can't mark inouts as noalias at the LLVM level.
-  // They still can't be captured without doing unsafe stuff, though.
+  // safe, so we can't mark inouts as noalias at the LLVM level unless asked
+  // to. They still can't be captured without doing unsafe stuff, though.
+  if (!aliasable && IGM.IRGen.Opts.InoutNoAlias)
+    b.addAttribute(llvm::Attribute::NoAlias);
   b.addAttribute(llvm::Attribute::NoCapture);
   // The inout must reference dereferenceable memory of the type.
   addDereferenceableAttributeToBuilder(IGM, b, ti);
@@ -53,6 +53,7 @@
 #include "IRGenFunction.h"
 #include "IRGenModule.h"
 #include "Linking.h"
+#include "LoadableTypeInfo.h"
 
 using namespace swift;
 using namespace irgen;
@@ -812,6 +813,7 @@ void IRGenerator::emitGlobalTopLevel() {
       continue;
 
     CurrentIGMPtr IGM = getGenModule(&f);
+    noteEmittedFunction(IGM.get(), &f);
     IGM->emitSILFunction(&f);
   }
 
@@ -900,10 +902,11 @@ void IRGenerator::emitLazyDefinitions() {
     // Emit any lazy function definitions we require.
     while (!LazyFunctionDefinitions.empty()) {
       SILFunction *f = LazyFunctionDefinitions.pop_back_val();
-      CurrentIGMPtr IGM = getGenModule(f);
+      CurrentIGMPtr IGM = getGenModuleForLazyFunction(f);
       assert(!isPossiblyUsedExternally(f->getLinkage(),
                                        IGM->getSILModule().isWholeModule())
              && "function with externally-visible linkage emitted lazily?");
+      noteEmittedFunction(IGM.get(), f);
       IGM->emitSILFunction(f);
     }
   }
@@ -2130,6 +2133,22 @@ llvm::Constant *IRGenModule::emitProtocolConformances() {
   if (ProtocolConformances.empty())
     return nullptr;
 
+  // Group the records by protocol, keeping the protocols in the order they
+  // were first seen so that the output stays deterministic. The runtime
+  // indexes each run of records for the same protocol as a single entry,
+  // and a lookup for one protocol then only visits its own runs.
+  {
+    llvm::DenseMap<ProtocolDecl *, unsigned> protocolOrder;
+    for (auto *conformance : ProtocolConformances)
+      protocolOrder.insert({conformance->getProtocol(), protocolOrder.size()});
+    std::stable_sort(ProtocolConformances.begin(), ProtocolConformances.end(),
+                     [&](NormalProtocolConformance *lhs,
+                         NormalProtocolConformance *rhs) {
+                       return protocolOrder[lhs->getProtocol()]
+                         < protocolOrder[rhs->getProtocol()];
+                     });
+  }
+
   // Define the global variable for the conformance list.
   // We have to do this before defining the initializer since the entries will
   // contain offsets relative to themselves.
@@ -3216,3 +3235,41 @@ IRGenModule::getOrCreateHelperFunction(StringRef fnName, llvm::Type *resultTy,
   return fn;
 }
 
+llvm::Function *IRGenModule::getOrCreateOutlinedValueOperation(
+    const LoadableTypeInfo &type, OutlinedValueOperation op,
+    llvm::function_ref<void(IRGenFunction &IGF, Explosion &params)> generate) {
+  llvm::Function *&entry = OutlinedValueOperations[{&type, unsigned(op)}];
+  if (entry)
+    return entry;
+
+  ExplosionSchema schema = type.getSchema();
+  SmallVector<llvm::Type *, 8> paramTys;
+  for (auto &elt : schema)
+    paramTys.push_back(elt.getScalarType());
+  auto fnTy = llvm::FunctionType::get(VoidTy, paramTys, false);
+
+  llvm::SmallString<64> fnName;
+  fnName += (op == OutlinedValueOperation::Copy ? "__swift_outlined_copy"
+                                                : "__swift_outlined_consume");
+  auto structTy = dyn_cast<llvm::StructType>(type.getStorageType());
+  if (structTy && structTy->hasName()) {
+    fnName += '_';
+    fnName += structTy->getName();
+  }
+
+  // The name is only for readability; internal linkage lets LLVM make it
+  // unique if two types have the same storage type name.
+  entry = llvm::Function::Create(fnTy, llvm::GlobalValue::InternalLinkage,
+                                 fnName, &Module);
+  entry->setDoesNotThrow();
+  entry->setCallingConv(DefaultCC);
+
+  IRGenFunction IGF(*this, entry);
+  if (DebugInfo)
+    DebugInfo->emitArtificialFunction(IGF, entry);
+  Explosion params = IGF.collectParameters();
+  generate(IGF, params);
+  IGF.Builder.CreateRetVoid();
+  return entry;
+}
+
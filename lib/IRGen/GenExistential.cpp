@@ -1879,7 +1879,7 @@ void irgen::emitMetatypeOfOpaqueExistential(IRGenFunction &IGF, Address addr,
   // Project the buffer and apply the 'typeof' value witness.
   Address buffer = existLayout.projectExistentialBuffer(IGF, addr);
   llvm::Value *object =
-    emitProjectBufferCall(IGF, metadata, buffer);
+    emitProjectBufferForReadCall(IGF, metadata, buffer);
   llvm::Value *dynamicType =
     IGF.Builder.CreateCall(IGF.IGM.getGetDynamicTypeFn(),
                            {object, metadata});
@@ -1985,7 +1985,8 @@ std::pair<Address, llvm::Value*>
 irgen::emitIndirectExistentialProjectionWithMetadata(IRGenFunction &IGF,
                                                      Address base,
                                                      SILType baseTy,
-                                                     CanType _openedArchetype) {
+                                                     CanType _openedArchetype,
+                                                     bool forRead) {
   CanArchetypeType openedArchetype;
   if (_openedArchetype) openedArchetype = cast<ArchetypeType>(_openedArchetype);
 
@@ -2016,7 +2017,8 @@ irgen::emitIndirectExistentialProjectionWithMetadata(IRGenFunction &IGF,
     llvm::Value *metadata = layout.loadMetadataRef(IGF, base);
     Address buffer = layout.projectExistentialBuffer(IGF, base);
     llvm::Value *object =
-      emitProjectBufferCall(IGF, metadata, buffer);
+      forRead ? emitProjectBufferForReadCall(IGF, metadata, buffer)
+              : emitProjectBufferCall(IGF, metadata, buffer);
 
     // If we are projecting into an opened archetype, capture the
     // witness tables.
@@ -2037,10 +2039,12 @@ irgen::emitIndirectExistentialProjectionWithMetadata(IRGenFunction &IGF,
 Address irgen::emitOpaqueExistentialProjection(IRGenFunction &IGF,
                                                Address base,
                                                SILType baseTy,
-                                               CanArchetypeType openedArchetype)
+                                               CanArchetypeType openedArchetype,
+                                               bool forRead)
 {
   return emitIndirectExistentialProjectionWithMetadata(IGF, base, baseTy,
-                                                       openedArchetype)
+                                                       openedArchetype,
+                                                       forRead)
     .first;
 }
 
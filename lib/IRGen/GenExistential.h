@@ -88,10 +88,13 @@ namespace irgen {
   ///
   /// \param openedArchetype If non-null, the archetype that will capture the
   /// metadata and witness tables produced by projecting the archetype.
+  /// \param forRead If true, the value is only read through the projection,
+  /// so a buffer shared with other existentials need not be made unique.
   Address emitOpaqueExistentialProjection(IRGenFunction &IGF,
                                           Address base,
                                           SILType baseTy,
-                                          CanArchetypeType openedArchetype);
+                                          CanArchetypeType openedArchetype,
+                                          bool forRead = false);
   
   /// Extract the instance pointer from a class existential value.
   ///
@@ -145,7 +148,8 @@ namespace irgen {
   emitIndirectExistentialProjectionWithMetadata(IRGenFunction &IGF,
                                                 Address base,
                                                 SILType baseTy,
-                                                CanType openedArchetype);
+                                                CanType openedArchetype,
+                                                bool forRead = false);
   
 } // end namespace irgen
 } // end namespace swift
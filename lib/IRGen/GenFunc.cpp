@@ -1135,7 +1135,13 @@ void irgen::emitFunctionPartialApplication(IRGenFunction &IGF,
                                            CanSILFunctionType origType,
                                            CanSILFunctionType substType,
                                            CanSILFunctionType outType,
-                                           Explosion &out) {
+                                           Explosion &out,
+                                           int &StackAllocSize) {
+  // Unless we end up allocating the context on the stack, report that nothing
+  // was stack allocated.
+  int MaxStackAllocSize = StackAllocSize;
+  StackAllocSize = -1;
+
   // If we have a single Swift-refcounted context value, we can adopt it
   // directly as our closure context without creating a box and thunk.
   enum HasSingleSwiftRefcountedContext { Maybe, Yes, No, Thunkable }
@@ -1349,7 +1355,19 @@ void irgen::emitFunctionPartialApplication(IRGenFunction &IGF,
     // Allocate a new object.
     HeapNonFixedOffsets offsets(IGF, layout);
 
-    data = IGF.emitUnmanagedAlloc(layout, "closure", descriptor, &offsets);
+    if (layout.isFixedLayout() &&
+        (int)layout.getSize().getValue() < MaxStackAllocSize) {
+      // The context does not escape: allocate it on the stack.
+      auto alloca = IGF.createAlloca(layout.getType(), layout.getAlignment(),
+                                     "closure.raw");
+      llvm::Value *metadata = layout.getPrivateMetadata(IGF.IGM, descriptor);
+      data = IGF.Builder.CreateBitCast(alloca.getAddress(),
+                                       IGF.IGM.RefCountedPtrTy);
+      data = IGF.emitInitStackObjectCall(metadata, data, "closure");
+      StackAllocSize = layout.getSize().getValue();
+    } else {
+      data = IGF.emitUnmanagedAlloc(layout, "closure", descriptor, &offsets);
+    }
     Address dataAddr = layout.emitCastTo(IGF, data);
     
     unsigned i = 0;
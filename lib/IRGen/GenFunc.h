@@ -47,6 +47,12 @@ namespace irgen {
 
   /// Emit a partial application thunk for a function pointer applied to a
   /// partial set of argument values.
+  ///
+  /// The \p StackAllocSize is an in- and out-parameter, like in
+  /// emitClassAllocation. The passed value specifies the maximum size of a
+  /// stack allocated closure context (-1 means: don't allocate on the stack).
+  /// The returned value is the actual size if the context is allocated on the
+  /// stack, or -1 if it is allocated on the heap or not allocated at all.
   void emitFunctionPartialApplication(IRGenFunction &IGF,
                                       SILFunction &SILFn,
                                       llvm::Value *fnPtr,
@@ -57,7 +63,8 @@ namespace irgen {
                                       CanSILFunctionType origType,
                                       CanSILFunctionType substType,
                                       CanSILFunctionType outType,
-                                      Explosion &out);
+                                      Explosion &out,
+                                      int &StackAllocSize);
   
 } // end namespace irgen
 } // end namespace swift
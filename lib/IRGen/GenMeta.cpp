@@ -377,9 +377,9 @@ static llvm::Value *emitNominalMetadataRef(IRGenFunction &IGF,
 
   if (!theDecl->isGenericContext()) {
     assert(!IGF.IGM.isResilient(theDecl, ResilienceExpansion::Maximal));
-    // TODO: If Obj-C interop is off, we can relax this to allow referencing
-    // class metadata too.
-    assert(isa<StructDecl>(theDecl) || isa<EnumDecl>(theDecl));
+    // Without Obj-C interop, class metadata can be referenced directly too.
+    assert(isa<StructDecl>(theDecl) || isa<EnumDecl>(theDecl) ||
+           !IGF.IGM.ObjCInterop);
     return IGF.IGM.getAddrOfTypeMetadata(theType, false);
   }
 
@@ -451,6 +451,11 @@ bool irgen::hasKnownVTableEntry(IRGenModule &IGM,
   if (!theClass) {
     return false;
   }
+  // FIXME: In whole-module builds a non-open method of a non-public class
+  // that nothing overrides could be left out of the vtable. That needs
+  // every class_method on it to have been devirtualized first, including
+  // at -Onone, and the debugger and reflection to stop assuming a slot
+  // per method, so the layout here has to stay as the AST describes it.
   return hasKnownSwiftImplementation(IGM, theClass);
 }
 
@@ -477,6 +482,29 @@ bool irgen::isTypeMetadataAccessTrivial(IRGenModule &IGM, CanType type) {
     return (IGM.getTypeInfoForLowered(type).isFixedSize());
   }
 
+  // Without Objective-C interop, nothing needs to happen at runtime to
+  // finish the metadata of a non-generic class with a fixed layout, as long
+  // as its superclass and parent can be referenced as constants.
+  if (auto classType = dyn_cast<ClassType>(type)) {
+    auto classDecl = classType->getDecl();
+    if (!IGM.IRGen.Opts.StaticClassMetadata || IGM.ObjCInterop ||
+        classDecl->isForeign() ||
+        !hasKnownSwiftMetadata(IGM, classDecl) ||
+        IGM.isResilient(classDecl, ResilienceExpansion::Maximal))
+      return false;
+
+    if (auto superclass = classType->getSuperclass(nullptr)) {
+      auto superclassType = superclass->getCanonicalType();
+      if (!isa<ClassType>(superclassType) ||
+          !isTypeMetadataAccessTrivial(IGM, superclassType))
+        return false;
+    }
+
+    // This also covers genericity, resilient fields, and parents whose
+    // metadata isn't a constant.
+    return !doesClassMetadataRequireDynamicInitialization(IGM, classDecl);
+  }
+
   // The empty tuple type has a singleton metadata.
   if (auto tuple = dyn_cast<TupleType>(type))
     return tuple->getNumElements() == 0;
@@ -476,6 +476,25 @@ llvm::Value *irgen::emitProjectBufferCall(IRGenFunction &IGF,
   return result;
 }
 
+/// Emit a 'projectBuffer' operation whose result is only read.
+llvm::Value *irgen::emitProjectBufferForReadCall(IRGenFunction &IGF,
+                                                 llvm::Value *metadata,
+                                                 Address buffer) {
+  // Only copy-on-write buffers can be shared; otherwise projecting never
+  // modifies the buffer.
+  if (!IGF.IGM.IRGen.Opts.UseCOWExistentials)
+    return emitProjectBufferCall(IGF, metadata, buffer);
+
+  llvm::Value *bufferArg =
+    IGF.Builder.CreateBitCast(buffer.getAddress(), IGF.IGM.OpaquePtrTy);
+  llvm::CallInst *result =
+    IGF.Builder.CreateCall(IGF.IGM.getProjectBufferForReadFn(),
+                           {bufferArg, metadata});
+  result->setCallingConv(IGF.IGM.DefaultCC);
+  result->setDoesNotThrow();
+  return result;
+}
+
 /// Emit a call to do an 'initializeWithCopy' operation.
 void irgen::emitInitializeWithCopyCall(IRGenFunction &IGF,
                                        SILType T,
@@ -85,6 +85,12 @@ namespace irgen {
                                      SILType T,
                                      Address buffer);
 
+  /// Emit a 'projectBuffer' operation whose result is only read, which
+  /// leaves a buffer shared with other existentials as it is.
+  llvm::Value *emitProjectBufferForReadCall(IRGenFunction &IGF,
+                                            llvm::Value *metadata,
+                                            Address buffer);
+
   /// Emit a call to do an 'initializeWithCopy' operation.
   void emitInitializeWithCopyCall(IRGenFunction &IGF,
                                   SILType T,
@@ -451,6 +451,37 @@ private:
     }
   }
 
+  /// The number of non-POD fields from which copies and destroys are
+  /// outlined when -enable-outlined-value-operations is given.
+  enum : unsigned { OutlinedValueOperationThreshold = 3 };
+
+  bool shouldOutlineValueOperations(IRGenModule &IGM) const {
+    if (!IGM.IRGen.Opts.OutlineValueOperations)
+      return false;
+    unsigned numNonPODFields = 0;
+    for (auto &field : getFields())
+      if (!field.isPOD())
+        ++numNonPODFields;
+    return numNonPODFields >= OutlinedValueOperationThreshold;
+  }
+
+  void copyFields(IRGenFunction &IGF, Explosion &src, Explosion &dest) const {
+    for (auto &field : getFields())
+      cast<LoadableTypeInfo>(field.getTypeInfo())
+          .copy(IGF, src, dest, Atomicity::Atomic);
+  }
+
+  void consumeFields(IRGenFunction &IGF, Explosion &src) const {
+    for (auto &field : getFields())
+      cast<LoadableTypeInfo>(field.getTypeInfo())
+          .consume(IGF, src, Atomicity::Atomic);
+  }
+
+  static void emitOutlinedCall(IRGenFunction &IGF, llvm::Function *fn,
+                               ArrayRef<llvm::Value *> values) {
+    IGF.Builder.CreateCall(fn, values)->setDoesNotThrow();
+  }
+
 public:
   using super::getFields;
 
@@ -485,16 +516,36 @@ public:
 
   void copy(IRGenFunction &IGF, Explosion &src,
             Explosion &dest, Atomicity atomicity) const override {
-    for (auto &field : getFields())
-      cast<LoadableTypeInfo>(field.getTypeInfo())
-          .copy(IGF, src, dest, Atomicity::Atomic);
+    if (shouldOutlineValueOperations(IGF.IGM)) {
+      auto values = src.claim(getExplosionSize());
+      auto fn = IGF.IGM.getOrCreateOutlinedValueOperation(asImpl(),
+                                                OutlinedValueOperation::Copy,
+                         [&](IRGenFunction &outlinedIGF, Explosion &params) {
+        Explosion copies;
+        copyFields(outlinedIGF, params, copies);
+        (void) copies.claimAll();
+      });
+      emitOutlinedCall(IGF, fn, values);
+      // A copy of a loadable value has the same bits as the original.
+      dest.add(values);
+      return;
+    }
+    copyFields(IGF, src, dest);
   }
 
   void consume(IRGenFunction &IGF, Explosion &src,
                Atomicity atomicity) const override {
-    for (auto &field : getFields())
-      cast<LoadableTypeInfo>(field.getTypeInfo())
-          .consume(IGF, src, Atomicity::Atomic);
+    if (shouldOutlineValueOperations(IGF.IGM)) {
+      auto values = src.claim(getExplosionSize());
+      auto fn = IGF.IGM.getOrCreateOutlinedValueOperation(asImpl(),
+                                                OutlinedValueOperation::Consume,
+                         [&](IRGenFunction &outlinedIGF, Explosion &params) {
+        consumeFields(outlinedIGF, params);
+      });
+      emitOutlinedCall(IGF, fn, values);
+      return;
+    }
+    consumeFields(IGF, src);
   }
 
   void fixLifetime(IRGenFunction &IGF, Explosion &src) const override {
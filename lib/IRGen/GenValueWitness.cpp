@@ -240,6 +240,34 @@ static ResultTy emitForDynamicPacking(IRGenFunction &IGF,
   return operation.get(IGF, T, type);
 }
 
+/// Are out-of-line buffer payloads kept in copy-on-write boxes?
+static bool useCOWBuffers(IRGenFunction &IGF) {
+  return IGF.IGM.IRGen.Opts.UseCOWExistentials;
+}
+
+/// Call one of the runtime's buffer box entry points.
+static llvm::CallInst *emitBufferBoxCall(IRGenFunction &IGF,
+                                         llvm::Constant *fn,
+                                         ArrayRef<llvm::Value*> args) {
+  auto call = IGF.Builder.CreateCall(fn, args);
+  call->setCallingConv(IGF.IGM.DefaultCC);
+  call->setDoesNotThrow();
+  return call;
+}
+
+/// Turn the address of a buffer into an opaque pointer for a runtime call.
+static llvm::Value *getBufferArg(IRGenFunction &IGF, Address buffer) {
+  return IGF.Builder.CreateBitCast(buffer.getAddress(), IGF.IGM.OpaquePtrTy);
+}
+
+/// Turn the opaque value address returned by a runtime call into a T*.
+static Address getBoxedValueAddress(IRGenFunction &IGF, llvm::Value *value,
+                                    const TypeInfo &type) {
+  value = IGF.Builder.CreateBitCast(value,
+                                    type.getStorageType()->getPointerTo());
+  return type.getAddressForPointer(value);
+}
+
 /// Emit a 'projectBuffer' operation.  Always returns a T*.
 static Address emitDefaultProjectBuffer(IRGenFunction &IGF, Address buffer,
                                         SILType T, const TypeInfo &type,
@@ -247,6 +275,14 @@ static Address emitDefaultProjectBuffer(IRGenFunction &IGF, Address buffer,
   llvm::PointerType *resultTy = type.getStorageType()->getPointerTo();
   switch (packing) {
   case FixedPacking::Allocate: {
+    if (useCOWBuffers(IGF)) {
+      // Projection may have to copy a shared box before it can be modified.
+      auto value = emitBufferBoxCall(IGF, IGF.IGM.getProjectBufferBoxFn(),
+                                     {getBufferArg(IGF, buffer),
+                                      IGF.emitTypeMetadataRefForLayout(T)});
+      return getBoxedValueAddress(IGF, value, type);
+    }
+
     Address slot = IGF.Builder.CreateBitCast(buffer, resultTy->getPointerTo(),
                                              "storage-slot");
     llvm::Value *address = IGF.Builder.CreateLoad(slot);
@@ -272,6 +308,13 @@ static Address emitDefaultAllocateBuffer(IRGenFunction &IGF, Address buffer,
                                          FixedPacking packing) {
   switch (packing) {
   case FixedPacking::Allocate: {
+    if (useCOWBuffers(IGF)) {
+      auto value = emitBufferBoxCall(IGF, IGF.IGM.getAllocBufferBoxFn(),
+                                     {getBufferArg(IGF, buffer),
+                                      IGF.emitTypeMetadataRefForLayout(T)});
+      return getBoxedValueAddress(IGF, value, type);
+    }
+
     auto sizeAndAlign = type.getSizeAndAlignmentMask(IGF, T);
     llvm::Value *addr =
       IGF.emitAllocRawCall(sizeAndAlign.first, sizeAndAlign.second);
@@ -301,6 +344,12 @@ static void emitDefaultDeallocateBuffer(IRGenFunction &IGF,
                                         FixedPacking packing) {
   switch (packing) {
   case FixedPacking::Allocate: {
+    if (useCOWBuffers(IGF)) {
+      emitBufferBoxCall(IGF, IGF.IGM.getDeallocBufferBoxFn(),
+                        getBufferArg(IGF, buffer));
+      return;
+    }
+
     Address slot =
       IGF.Builder.CreateBitCast(buffer, IGF.IGM.Int8PtrPtrTy);
     llvm::Value *addr = IGF.Builder.CreateLoad(slot, "storage");
@@ -329,6 +378,13 @@ static void emitDefaultDestroyBuffer(IRGenFunction &IGF, Address buffer,
     return emitForDynamicPacking(IGF, &emitDefaultDestroyBuffer,
                                  T, type, buffer);
 
+  // A shared box is destroyed along with its last reference.
+  if (packing == FixedPacking::Allocate && useCOWBuffers(IGF)) {
+    emitBufferBoxCall(IGF, IGF.IGM.getDestroyBufferBoxFn(),
+                      getBufferArg(IGF, buffer));
+    return;
+  }
+
   Address object = emitDefaultProjectBuffer(IGF, buffer, T, type, packing);
   type.destroy(IGF, object, T);
   emitDefaultDeallocateBuffer(IGF, buffer, T, type, packing);
@@ -349,6 +405,14 @@ emitDefaultInitializeBufferWithCopyOfBuffer(IRGenFunction &IGF,
                                  &emitDefaultInitializeBufferWithCopyOfBuffer,
                                  T, type, destBuffer, srcBuffer);
 
+  // Copying a boxed value just shares the box.
+  if (packing == FixedPacking::Allocate && useCOWBuffers(IGF)) {
+    auto value = emitBufferBoxCall(IGF, IGF.IGM.getCopyBufferBoxFn(),
+                                   {getBufferArg(IGF, destBuffer),
+                                    getBufferArg(IGF, srcBuffer)});
+    return getBoxedValueAddress(IGF, value, type);
+  }
+
   Address destObject =
     emitDefaultAllocateBuffer(IGF, destBuffer, T, type, packing);
   Address srcObject =
@@ -391,6 +455,12 @@ emitDefaultInitializeBufferWithTakeOfBuffer(IRGenFunction &IGF,
     llvm::Value *addr = IGF.Builder.CreateLoad(srcBuffer);
     destBuffer = IGF.Builder.CreateBitCast(destBuffer, ptrTy);
     IGF.Builder.CreateStore(addr, destBuffer);
+    if (useCOWBuffers(IGF)) {
+      // The stored pointer is the box; hand back the value inside it.
+      auto box = IGF.Builder.CreateBitCast(addr, IGF.IGM.RefCountedPtrTy);
+      return getBoxedValueAddress(IGF,
+                                  IGF.emitProjectBoxCall(box, nullptr), type);
+    }
     return type.getAddressForPointer(addr);
   }
   }
@@ -1140,7 +1210,8 @@ static llvm::Constant *getValueWitness(IRGenModule &IGM,
     goto standard;
 
   case ValueWitness::InitializeBufferWithTakeOfBuffer:
-    if (packing == FixedPacking::Allocate) {
+    if (packing == FixedPacking::Allocate &&
+        !IGM.IRGen.Opts.UseCOWExistentials) {
       return asOpaquePtr(IGM, getCopyOutOfLinePointerFunction(IGM));
     } else if (packing == FixedPacking::OffsetZero &&
                concreteTI.isBitwiseTakable(ResilienceExpansion::Maximal)) {
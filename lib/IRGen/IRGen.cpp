@@ -149,7 +149,15 @@ void swift::performLLVMOptimizations(IRGenOptions &Opts, llvm::Module *Module,
   // Set up a pipeline.
   PassManagerBuilderWrapper PMBuilder(Opts);
 
-  if (Opts.Optimize && !Opts.DisableLLVMOptzns) {
+  if (Opts.Optimize && Opts.OptimizeForSize && !Opts.DisableLLVMOptzns) {
+    // The equivalent of clang's -Os.
+    PMBuilder.OptLevel = 2;
+    PMBuilder.SizeLevel = 1;
+    PMBuilder.Inliner = llvm::createFunctionInliningPass(/*OptLevel=*/2,
+                                                         /*SizeOptLevel=*/1);
+    PMBuilder.DisableUnrollLoops = true;
+    PMBuilder.MergeFunctions = true;
+  } else if (Opts.Optimize && !Opts.DisableLLVMOptzns) {
     PMBuilder.OptLevel = 3;
     PMBuilder.Inliner = llvm::createFunctionInliningPass(200);
     PMBuilder.SLPVectorize = true;
@@ -572,13 +580,14 @@ static void initLLVMModule(const IRGenModule &IGM) {
 
 /// Generates LLVM IR, runs the LLVM passes and produces the output file.
 /// All this is done in a single thread.
-static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
-                                                         swift::Module *M,
-                                                         SILModule *SILMod,
-                                                         StringRef ModuleName,
-                                                 llvm::LLVMContext &LLVMContext,
-                                                       SourceFile *SF = nullptr,
-                                                       unsigned StartElem = 0) {
+///
+/// If \p OwnedSILMod is non-null it owns \p SILMod, and is destroyed once
+/// the LLVM IR has been generated so that LLVM can reuse its memory.
+static std::unique_ptr<llvm::Module>
+performIRGeneration(IRGenOptions &Opts, swift::Module *M, SILModule *SILMod,
+                    std::unique_ptr<SILModule> OwnedSILMod,
+                    StringRef ModuleName, llvm::LLVMContext &LLVMContext,
+                    SourceFile *SF = nullptr, unsigned StartElem = 0) {
   auto &Ctx = M->getASTContext();
   assert(!Ctx.hadError());
 
@@ -666,6 +675,9 @@ static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
   // Bail out if there are any errors.
   if (Ctx.hadError()) return nullptr;
 
+  // Nothing reads the SILModule after this point.
+  OwnedSILMod.reset();
+
   embedBitcode(IGM.getModule(), Opts);
 
   if (performLLVM(Opts, IGM.Context.Diags, nullptr, IGM.ModuleHash,
@@ -701,6 +713,7 @@ static void ThreadEntryPoint(IRGenerator *irgen,
 static void performParallelIRGeneration(IRGenOptions &Opts,
                                         swift::Module *M,
                                         SILModule *SILMod,
+                                        std::unique_ptr<SILModule> OwnedSILMod,
                                         StringRef ModuleName, int numThreads) {
 
   IRGenerator irgen(Opts, *SILMod);
@@ -860,6 +873,10 @@ static void performParallelIRGeneration(IRGenOptions &Opts,
   // Bail out if there are any errors.
   if (Ctx.hadError()) return;
 
+  // The threads below only run LLVM; free the SILModule before they start so
+  // that its memory is available to them.
+  OwnedSILMod.reset();
+
   std::vector<std::thread> Threads;
   llvm::sys::Mutex DiagMutex;
 
@@ -878,25 +895,56 @@ static void performParallelIRGeneration(IRGenOptions &Opts,
 }
 
 
-std::unique_ptr<llvm::Module> swift::
-performIRGeneration(IRGenOptions &Opts, swift::Module *M, SILModule *SILMod,
-                    StringRef ModuleName, llvm::LLVMContext &LLVMContext) {
+static std::unique_ptr<llvm::Module>
+performWholeModuleIRGeneration(IRGenOptions &Opts, swift::Module *M,
+                               SILModule *SILMod,
+                               std::unique_ptr<SILModule> OwnedSILMod,
+                               StringRef ModuleName,
+                               llvm::LLVMContext &LLVMContext) {
   int numThreads = SILMod->getOptions().NumThreads;
   if (numThreads != 0) {
-    ::performParallelIRGeneration(Opts, M, SILMod, ModuleName, numThreads);
+    ::performParallelIRGeneration(Opts, M, SILMod, std::move(OwnedSILMod),
+                                  ModuleName, numThreads);
     // TODO: Parallel LLVM compilation cannot be used if a (single) module is
     // needed as return value.
     return nullptr;
   }
-  return ::performIRGeneration(Opts, M, SILMod, ModuleName, LLVMContext);
+  return ::performIRGeneration(Opts, M, SILMod, std::move(OwnedSILMod),
+                               ModuleName, LLVMContext);
+}
+
+std::unique_ptr<llvm::Module> swift::
+performIRGeneration(IRGenOptions &Opts, swift::Module *M, SILModule *SILMod,
+                    StringRef ModuleName, llvm::LLVMContext &LLVMContext) {
+  return performWholeModuleIRGeneration(Opts, M, SILMod, nullptr, ModuleName,
+                                        LLVMContext);
+}
+
+std::unique_ptr<llvm::Module> swift::
+performIRGeneration(IRGenOptions &Opts, swift::Module *M,
+                    std::unique_ptr<SILModule> SILMod,
+                    StringRef ModuleName, llvm::LLVMContext &LLVMContext) {
+  SILModule *SILModPtr = SILMod.get();
+  return performWholeModuleIRGeneration(Opts, M, SILModPtr, std::move(SILMod),
+                                        ModuleName, LLVMContext);
 }
 
 std::unique_ptr<llvm::Module> swift::
 performIRGeneration(IRGenOptions &Opts, SourceFile &SF, SILModule *SILMod,
                     StringRef ModuleName, llvm::LLVMContext &LLVMContext,
                     unsigned StartElem) {
-  return ::performIRGeneration(Opts, SF.getParentModule(), SILMod, ModuleName,
-                               LLVMContext, &SF, StartElem);
+  return ::performIRGeneration(Opts, SF.getParentModule(), SILMod, nullptr,
+                               ModuleName, LLVMContext, &SF, StartElem);
+}
+
+std::unique_ptr<llvm::Module> swift::
+performIRGeneration(IRGenOptions &Opts, SourceFile &SF,
+                    std::unique_ptr<SILModule> SILMod,
+                    StringRef ModuleName, llvm::LLVMContext &LLVMContext) {
+  SILModule *SILModPtr = SILMod.get();
+  return ::performIRGeneration(Opts, SF.getParentModule(), SILModPtr,
+                               std::move(SILMod), ModuleName, LLVMContext,
+                               &SF);
 }
 
 void
@@ -672,7 +672,10 @@ llvm::DISubprogram *IRGenDebugInfo::emitFunction(
   auto Line = L.Line;
   auto File = getOrCreateFile(L.Filename);
   llvm::DIScope *Scope = MainModule;
-  if (SILFn && SILFn->getDeclContext())
+  // Line tables don't describe types, so don't create (forward declarations
+  // of) the nominal types that methods are nested in.
+  if (SILFn && SILFn->getDeclContext() &&
+      Opts.DebugInfoKind > IRGenDebugInfoKind::LineTables)
     Scope = getOrCreateContext(SILFn->getDeclContext()->getParent());
 
   // We know that main always comes from MainFile.
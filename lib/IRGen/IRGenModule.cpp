@@ -406,6 +406,7 @@ static bool isReturnAttribute(llvm::Attribute::AttrKind Attr);
 namespace RuntimeConstants {
   const auto ReadNone = llvm::Attribute::ReadNone;
   const auto ReadOnly = llvm::Attribute::ReadOnly;
+  const auto ArgMemOnly = llvm::Attribute::ArgMemOnly;
   const auto NoReturn = llvm::Attribute::NoReturn;
   const auto NoUnwind = llvm::Attribute::NoUnwind;
   const auto ZExt = llvm::Attribute::ZExt;
@@ -742,6 +743,12 @@ llvm::AttributeSet IRGenModule::constructInitialAttributes() {
         "no-frame-pointer-elim-non-leaf");
   }
 
+  // Tell LLVM's code generator to favor size, like clang does for -Os.
+  if (IRGen.Opts.OptimizeForSize)
+    attrsUpdated = attrsUpdated.addAttribute(LLVMContext,
+                     llvm::AttributeSet::FunctionIndex,
+                     llvm::Attribute::OptimizeForSize);
+
   // Add target-cpu and target-features if they are non-null.
   auto *Clang = static_cast<ClangImporter *>(Context.getClangModuleLoader());
   clang::TargetOptions &ClangOpts = Clang->getTargetInfo().getTargetOpts();
@@ -1118,3 +1125,27 @@ IRGenModule *IRGenerator::getGenModule(SILFunction *f) {
 
   return getPrimaryIGM();
 }
+
+IRGenModule *IRGenerator::getGenModuleForLazyFunction(SILFunction *f) {
+  if (GenModules.size() == 1 || !hasSharedVisibility(f->getLinkage()))
+    return getGenModule(f);
+
+  // Iterate over the queue rather than GenModules to keep the choice
+  // deterministic if several IGMs are equally loaded.
+  IRGenModule *LeastLoaded = nullptr;
+  unsigned LeastCount = 0;
+  for (IRGenModule *IGM : Queue) {
+    unsigned Count = EmittedInstructionCounts.lookup(IGM);
+    if (!LeastLoaded || Count < LeastCount) {
+      LeastLoaded = IGM;
+      LeastCount = Count;
+    }
+  }
+  return LeastLoaded;
+}
+
+void IRGenerator::noteEmittedFunction(IRGenModule *IGM, SILFunction *f) {
+  unsigned &Count = EmittedInstructionCounts[IGM];
+  for (auto &BB : *f)
+    Count += std::distance(BB.begin(), BB.end());
+}
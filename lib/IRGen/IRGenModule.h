@@ -114,6 +114,7 @@ namespace irgen {
   class ClangTypeConverter;
   class DebugTypeInfo;
   class EnumImplStrategy;
+  class Explosion;
   class ExplosionSchema;
   class FixedTypeInfo;
   class ForeignFunctionInfo;
@@ -131,6 +132,12 @@ namespace irgen {
 
 class IRGenModule;
 
+/// A value operation that IRGen can emit as a call to an outlined function.
+enum class OutlinedValueOperation : unsigned char {
+  Copy,
+  Consume,
+};
+
 /// A type descriptor for a field type accessor.
 class FieldTypeInfo {
   llvm::PointerIntPair<CanType, 1, unsigned> Info;
@@ -210,6 +217,10 @@ private:
   /// The queue of IRGenModules for multi-threaded compilation.
   SmallVector<IRGenModule *, 8> Queue;
 
+  /// The number of SIL instructions emitted into each IRGenModule so far.
+  /// Used to balance shared functions across the LLVM modules.
+  llvm::DenseMap<IRGenModule *, unsigned> EmittedInstructionCounts;
+
   std::atomic<int> QueueIndex;
   
   friend class CurrentIGMPtr;  
@@ -241,6 +252,16 @@ public:
   /// first time.
   IRGenModule *getGenModule(SILFunction *f);
 
+  /// Get an IRGenModule for a function which is emitted lazily.
+  /// In multi-threaded compilation, a function with shared linkage, like a
+  /// specialization or a thunk, can be emitted into any LLVM module. It goes
+  /// to the IRGenModule with the fewest SIL instructions emitted so far.
+  /// Other functions are handled like in getGenModule.
+  IRGenModule *getGenModuleForLazyFunction(SILFunction *f);
+
+  /// Record that \p f is emitted into \p IGM.
+  void noteEmittedFunction(IRGenModule *IGM, SILFunction *f);
+
   /// Returns the primary IRGenModule. This is the first added IRGenModule.
   /// It is used for everything which cannot be correlated to a specific source
   /// file. And of course, in single-threaded compilation there is only the
@@ -625,6 +646,15 @@ public:
                                             ArrayRef<llvm::Type*> paramTypes,
                         llvm::function_ref<void(IRGenFunction &IGF)> generate);
 
+  /// Get or create the outlined function which performs \p op on an
+  /// explosion of \p type, using \p generate to fill in its body from the
+  /// parameter explosion.  The function is internal to this module; identical
+  /// functions for different types are left to LLVM's function merging.
+  llvm::Function *getOrCreateOutlinedValueOperation(
+      const LoadableTypeInfo &type, OutlinedValueOperation op,
+      llvm::function_ref<void(IRGenFunction &IGF, Explosion &params)>
+        generate);
+
 private:
   llvm::Constant *getAddrOfClangGlobalDecl(clang::GlobalDecl global,
                                            ForDefinition_t forDefinition);
@@ -633,6 +663,8 @@ private:
   llvm::DenseMap<LinkEntity, llvm::Constant*> GlobalGOTEquivalents;
   llvm::DenseMap<LinkEntity, llvm::Function*> GlobalFuncs;
   llvm::DenseSet<const clang::Decl *> GlobalClangDecls;
+  llvm::DenseMap<std::pair<const TypeInfo *, unsigned>, llvm::Function *>
+    OutlinedValueOperations;
   llvm::StringMap<std::pair<llvm::GlobalVariable*, llvm::Constant*>>
     GlobalStrings;
   llvm::StringMap<llvm::Constant*> GlobalUTF16Strings;
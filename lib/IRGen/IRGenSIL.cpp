@@ -1365,6 +1365,10 @@ void IRGenSILFunction::emitSILFunction() {
   if (IGM.DebugInfo)
     IGM.DebugInfo->emitFunction(*CurSILFn, CurFn);
 
+  // Pass the profiled entry count on to LLVM's optimizers.
+  if (auto EntryCount = CurSILFn->getEntryCount())
+    CurFn->setEntryCount(*EntryCount);
+
   // Map the entry bb.
   LoweredBBs[&*CurSILFn->begin()] = LoweredBB(&*CurFn->begin(), {});
   // Create LLVM basic blocks for the other bbs.
@@ -2259,6 +2263,13 @@ void IRGenSILFunction::visitPartialApplyInst(swift::PartialApplyInst *i) {
     = getPartialApplicationFunction(*this, i->getCallee(),
                                     i->getSubstitutions());
 
+  int StackAllocSize = -1;
+  if (i->canAllocOnStack()) {
+    estimateStackSize();
+    // Is there enough space for stack allocation?
+    StackAllocSize = IGM.IRGen.Opts.StackPromotionSizeLimit - EstimatedStackSize;
+  }
+
   // Create the thunk and function value.
   Explosion function;
   emitFunctionPartialApplication(*this, *CurSILFn,
@@ -2266,7 +2277,12 @@ void IRGenSILFunction::visitPartialApplyInst(swift::PartialApplyInst *i) {
                                  params, i->getSubstitutions(),
                                  origCalleeTy, i->getSubstCalleeType(),
                                  i->getType().castTo<SILFunctionType>(),
-                                 function);
+                                 function, StackAllocSize);
+  if (StackAllocSize >= 0) {
+    // Remember that this partial_apply allocates the context on the stack.
+    StackAllocs.insert(i);
+    EstimatedStackSize += StackAllocSize;
+  }
   setLoweredExplosion(v, function);
 }
 
@@ -3632,8 +3648,15 @@ void IRGenSILFunction::visitDeallocRefInst(swift::DeallocRefInst *i) {
   // It's a dealloc_ref [stack]. Even if the alloc_ref did not allocate the
   // object on the stack, we don't have to deallocate it, because it is
   // deallocated in the final release.
-  assert(ARI->canAllocOnStack());
-  if (StackAllocs.count(ARI)) {
+  // The same is true for the context of a partial_apply [stack], whose
+  // lowered explosion is the function pointer followed by the context.
+  SILInstruction *Alloc = ARI;
+  if (auto *PAI = dyn_cast<PartialApplyInst>(i->getOperand())) {
+    selfValue = self.claimNext();
+    Alloc = PAI;
+  }
+  assert(Alloc && Alloc->isAllocatingStack());
+  if (StackAllocs.count(Alloc)) {
     if (IGM.IRGen.Opts.EmitStackPromotionChecks) {
       selfValue = Builder.CreateBitCast(selfValue, IGM.RefCountedPtrTy);
       emitVerifyEndOfLifetimeCall(selfValue);
@@ -4390,14 +4413,52 @@ void IRGenSILFunction::visitDeinitExistentialAddrInst(
                                        i->getOperand()->getType());
 }
 
+/// Is the value projected by an open_existential_addr only read, never
+/// modified or taken, through the projection?
+static bool isOnlyReadThroughProjection(OpenExistentialAddrInst *i) {
+  for (Operand *use : i->getUses()) {
+    SILInstruction *user = use->getUser();
+    // Naming the opened archetype doesn't access the value.
+    if (user->isOpenedArchetypeOperand(*use))
+      continue;
+
+    switch (user->getKind()) {
+    case ValueKind::LoadInst:
+    case ValueKind::DebugValueAddrInst:
+      continue;
+    case ValueKind::CopyAddrInst: {
+      auto copy = cast<CopyAddrInst>(user);
+      if (copy->getSrc() == SILValue(i) && !copy->isTakeOfSrc())
+        continue;
+      return false;
+    }
+    case ValueKind::ApplyInst:
+    case ValueKind::TryApplyInst: {
+      FullApplySite site(user);
+      // The callee is operand 0.
+      unsigned argIndex = use->getOperandNumber() - 1;
+      if (argIndex < site.getNumArguments() &&
+          site.getArgumentConvention(argIndex) ==
+            SILArgumentConvention::Indirect_In_Guaranteed)
+        continue;
+      return false;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
 void IRGenSILFunction::visitOpenExistentialAddrInst(OpenExistentialAddrInst *i) {
   SILType baseTy = i->getOperand()->getType();
   Address base = getLoweredAddress(i->getOperand());
 
   auto openedArchetype = cast<ArchetypeType>(
                            i->getType().getSwiftRValueType());
+  bool forRead = isOnlyReadThroughProjection(i);
   Address object = emitOpaqueExistentialProjection(*this, base, baseTy,
-                                                   openedArchetype);
+                                                   openedArchetype, forRead);
 
   setLoweredAddress(i, object);
 }
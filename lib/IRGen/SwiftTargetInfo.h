@@ -95,6 +95,11 @@ public:
   /// The value stored in a Builtin.once predicate to indicate that an
   /// initialization has already happened, if known.
   Optional<int64_t> OnceDonePredicateValue = None;
+
+  /// True if the inline check of a Builtin.once predicate must be an
+  /// acquire load, because the runtime doesn't guarantee that a plain load
+  /// of the "done" value also observes the initialization.
+  bool OnceDonePredicateNeedsAcquire = false;
 };
 
 }
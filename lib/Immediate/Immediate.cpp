@@ -27,15 +27,19 @@
 #include "swift/Frontend/Frontend.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/Basic/LLVM.h"
+#include "swift/Basic/Version.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/Config/config.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Linker/Linker.h"
-#include "llvm/Transforms/IPO.h"
-#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 
 #if defined(_MSC_VER)
@@ -289,8 +293,86 @@ bool swift::immediate::IRGenImportedModules(
   return hadError;
 }
 
+namespace {
+/// An on-disk cache of the object code that the JIT generates for a module.
+///
+/// Objects are keyed by a hash of the module's bitcode, the code generation
+/// level and the compiler version, so a script whose source, imports and flags
+/// did not change skips the LLVM backend on its next run.
+class ImmediateObjectCache : public llvm::ObjectCache {
+  std::string CacheDir;
+  bool Optimize;
+  const llvm::Module *KeyModule = nullptr;
+  SmallString<128> ObjectPath;
+
+  /// Compute the path of the cache entry for \p M.
+  StringRef getObjectPath(const llvm::Module *M) {
+    if (M == KeyModule)
+      return ObjectPath;
+
+    SmallString<0> Bitcode;
+    {
+      llvm::raw_svector_ostream OS(Bitcode);
+      llvm::WriteBitcodeToFile(M, OS);
+    }
+    llvm::MD5 Hash;
+    Hash.update(version::getSwiftFullVersion());
+    Hash.update(Optimize ? "O" : "Onone");
+    Hash.update(Bitcode);
+    llvm::MD5::MD5Result Result;
+    Hash.final(Result);
+    SmallString<32> Key;
+    llvm::MD5::stringifyResult(Result, Key);
+    Key += ".o";
+
+    KeyModule = M;
+    ObjectPath = CacheDir;
+    llvm::sys::path::append(ObjectPath, Key);
+    return ObjectPath;
+  }
+
+public:
+  ImmediateObjectCache(StringRef CacheDir, bool Optimize)
+    : CacheDir(CacheDir), Optimize(Optimize) {}
+
+  void notifyObjectCompiled(const llvm::Module *M,
+                            llvm::MemoryBufferRef Obj) override {
+    StringRef Path = getObjectPath(M);
+    if (llvm::sys::fs::create_directories(CacheDir))
+      return;
+
+    // Write to a temporary file first, so that concurrent runs of the same
+    // script never see a partially written object.
+    SmallString<128> TmpPath;
+    int FD;
+    if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TmpPath))
+      return;
+    {
+      llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+      OS << Obj.getBuffer();
+      if (OS.has_error()) {
+        OS.clear_error();
+        llvm::sys::fs::remove(TmpPath);
+        return;
+      }
+    }
+    if (llvm::sys::fs::rename(TmpPath, Path))
+      llvm::sys::fs::remove(TmpPath);
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer>
+  getObject(const llvm::Module *M) override {
+    auto Buffer = llvm::MemoryBuffer::getFile(getObjectPath(M));
+    if (!Buffer)
+      return nullptr;
+    return std::move(*Buffer);
+  }
+};
+} // end anonymous namespace
+
 int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
-                          IRGenOptions &IRGenOpts, const SILOptions &SILOpts) {
+                          IRGenOptions &IRGenOpts, const SILOptions &SILOpts,
+                          StringRef ObjectCachePath) {
   ASTContext &Context = CI.getASTContext();
   
   // IRGen the main module.
@@ -337,11 +419,12 @@ int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
                            IRGenOpts, SILOpts))
     return -1;
 
-  llvm::PassManagerBuilder PMBuilder;
-  PMBuilder.OptLevel = 2;
-  PMBuilder.Inliner = llvm::createFunctionInliningPass(200);
-
   // Build the ExecutionEngine.
+  //
+  // FIXME(performance): MCJIT code-generates the whole module, including
+  // every imported module, before main runs. Large scripts that run little of
+  // their code would start faster on an ORC lazy JIT that compiles function
+  // bodies on first call.
   llvm::EngineBuilder builder(std::move(ModuleOwner));
   std::string ErrorMsg;
   llvm::TargetOptions TargetOpt;
@@ -355,12 +438,25 @@ int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
   builder.setMAttrs(Features);
   builder.setErrorStr(&ErrorMsg);
   builder.setEngineKind(llvm::EngineKind::JIT);
+  // Match the code generation level of a compile, so that unoptimized
+  // scripts don't spend their startup time in the backend's optimizations.
+  builder.setOptLevel(IRGenOpts.Optimize ? llvm::CodeGenOpt::Aggressive
+                                         : llvm::CodeGenOpt::None);
   llvm::ExecutionEngine *EE = builder.create();
   if (!EE) {
     llvm::errs() << "Error loading JIT: " << ErrorMsg;
     return -1;
   }
 
+  // The cache has to outlive code generation, which happens in
+  // finalizeObject() below.
+  std::unique_ptr<ImmediateObjectCache> ObjCache;
+  if (!ObjectCachePath.empty()) {
+    ObjCache.reset(new ImmediateObjectCache(ObjectCachePath,
+                                            IRGenOpts.Optimize));
+    EE->setObjectCache(ObjCache.get());
+  }
+
   DEBUG(llvm::dbgs() << "Module to be executed:\n";
         Module->dump());
 
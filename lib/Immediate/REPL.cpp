@@ -956,6 +956,8 @@ public:
     builder.setMAttrs(Features);
     builder.setErrorStr(&ErrorMsg);
     builder.setEngineKind(llvm::EngineKind::JIT);
+    // REPL input is never optimized; don't spend time on it in the backend.
+    builder.setOptLevel(llvm::CodeGenOpt::None);
     EE = builder.create();
 
     IRGenOpts.OutputFilenames.clear();
@@ -324,6 +324,10 @@ private:
 
   // This maps a module to all its imports, recursively.
   llvm::DenseMap<Module *, llvm::SmallVector<Module *, 4>> ImportsMap;
+
+  // This maps a module to its hash, so that a module imported from many places
+  // is only hashed (and its file and imports stat'ed) once.
+  llvm::DenseMap<Module *, llvm::hash_code> ModuleHashes;
 };
 } // anonymous namespace
 
@@ -1055,7 +1059,18 @@ void IndexSwiftASTWalker::collectRecursiveModuleImports(
 void IndexSwiftASTWalker::getModuleHash(SourceFileOrModule Mod,
                                         llvm::raw_ostream &OS) {
   // FIXME: Use a longer hash string to minimize possibility for conflicts.
-  llvm::hash_code code = hashModule(0, Mod);
+  llvm::hash_code code;
+  if (Module *M = Mod.getAsModule()) {
+    auto It = ModuleHashes.find(M);
+    if (It != ModuleHashes.end()) {
+      code = It->second;
+    } else {
+      code = hashModule(0, Mod);
+      ModuleHashes[M] = code;
+    }
+  } else {
+    code = hashModule(0, Mod);
+  }
   OS << llvm::APInt(64, code).toString(36, /*Signed=*/false);
 }
 
@@ -397,6 +397,26 @@ OutOfLoop:
 //                         Retain() Motion
 //===----------------------------------------------------------------------===//
 
+/// Return true if the call \p CI can neither release \p Object nor observe
+/// its reference count, e.g. through isUniquelyReferenced. This is the case
+/// if the call only reads memory reached through its arguments, and each
+/// pointer argument is based on a local alloca other than the object.
+static bool cannotReleaseOrObserveRefCount(CallInst &CI, Value *Object) {
+  if (!CI.onlyReadsMemory() || !CI.onlyAccessesArgMemory())
+    return false;
+
+  auto &DL = CI.getModule()->getDataLayout();
+  Value *ObjectBase = GetUnderlyingObject(Object, DL);
+  for (Value *Arg : CI.arg_operands()) {
+    if (!Arg->getType()->isPointerTy())
+      continue;
+    Value *ArgBase = GetUnderlyingObject(Arg, DL);
+    if (!isa<AllocaInst>(ArgBase) || ArgBase == ObjectBase)
+      return false;
+  }
+  return true;
+}
+
 /// performLocalRetainMotion - Scan forward from the specified retain, moving it
 /// later in the function if possible, over instructions that provably can't
 /// release the object.  If we get to a release of the object, zap both.
@@ -494,6 +514,13 @@ static bool performLocalRetainMotion(CallInst &Retain, BasicBlock &BB,
           isa<MemIntrinsic>(CurInst))
         break;
 
+      // Neither can a call that only reads local memory. A call that might
+      // read the object could observe the retain, so it can't be skipped
+      // just because it doesn't write memory.
+      if (auto *CI = dyn_cast<CallInst>(&CurInst))
+        if (cannotReleaseOrObserveRefCount(*CI, RetainedObject))
+          break;
+
       // CurInst->dump(); BBI->dump();
       // Otherwise, we get to something unknown/unhandled.  Bail out for now.
       goto OutOfLoop;
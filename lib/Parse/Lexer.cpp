@@ -25,6 +25,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Twine.h"
+#include <cstring>
 // FIXME: Figure out if this can be migrated to LLVM.
 #include "clang/Basic/CharInfo.h"
 
@@ -306,8 +307,35 @@ static void diagnoseEmbeddedNul(DiagnosticEngine *Diags, const char *Ptr) {
       .fixItRemoveChars(NulLoc, NulEndLoc);
 }
 
+/// skipPlainCommentText - Advance \p Ptr eight bytes at a time over comment
+/// text that the scalar loops would just eat: printable ASCII, stopping at
+/// anything that ends a line, needs UTF-8 validation, or is a nul.  If
+/// \p CheckNesting is true, also stop at '*' and '/'.
+template <bool CheckNesting>
+static void skipPlainCommentText(const char *&Ptr, const char *End) {
+  const uint64_t Ones = 0x0101010101010101ULL;
+  const uint64_t HighBits = 0x8080808080808080ULL;
+  while (End - Ptr >= 8) {
+    uint64_t Word;
+    memcpy(&Word, Ptr, sizeof(Word));
+    // The high bit of some byte is set if any byte is below ' ' or isn't
+    // ASCII.
+    uint64_t Special = (Word - Ones * ' ') | Word;
+    if (CheckNesting) {
+      uint64_t Stars = Word ^ (Ones * '*');
+      uint64_t Slashes = Word ^ (Ones * '/');
+      Special |= (Stars - Ones) & ~Stars;
+      Special |= (Slashes - Ones) & ~Slashes;
+    }
+    if (Special & HighBits)
+      return;
+    Ptr += 8;
+  }
+}
+
 void Lexer::skipToEndOfLine() {
   while (1) {
+    skipPlainCommentText</*CheckNesting=*/false>(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '\n':
     case '\r':
@@ -361,6 +389,7 @@ void Lexer::skipSlashStarComment() {
   unsigned Depth = 1;
   
   while (1) {
+    skipPlainCommentText</*CheckNesting=*/true>(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '*':
       // Check for a '*/'
@@ -522,6 +551,18 @@ static bool advanceIfValidContinuationOfOperator(char const *&ptr,
   return advanceIf(ptr, end, Identifier::isOperatorContinuationCodePoint);
 }
 
+/// Advance \p ptr past the rest of an identifier, taking a fast path over
+/// ASCII characters that doesn't need to decode UTF-8.
+static void skipIdentifierContinuation(char const *&ptr, char const *end) {
+  while (1) {
+    while (ptr < end && clang::isIdentifierBody(*ptr, /*dollar*/true))
+      ++ptr;
+    if (ptr == end || (signed char)(*ptr) >= 0 ||
+        !advanceIfValidContinuationOfIdentifier(ptr, end))
+      return;
+  }
+}
+
 bool Lexer::isIdentifier(StringRef string) {
   if (string.empty()) return false;
   char const *p = string.data(), *end = string.end();
@@ -569,7 +610,7 @@ void Lexer::lexIdentifier() {
   (void) didStart;
 
   // Lex [a-zA-Z_$0-9[[:XID_Continue:]]]*
-  while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
+  skipIdentifierContinuation(CurPtr, BufferEnd);
 
   tok Kind = kindOfIdentifier(StringRef(TokStart, CurPtr-TokStart), InSILMode);
   return formToken(Kind, TokStart);
@@ -1665,6 +1706,10 @@ Restart:
   case '\t':
   case '\f':
   case '\v':
+    // Skip the rest of a run of horizontal whitespace, such as indentation,
+    // without going back through Restart for each character.
+    while (*CurPtr == ' ' || *CurPtr == '\t')
+      ++CurPtr;
     goto Restart;  // Skip whitespace.
 
   case -1:
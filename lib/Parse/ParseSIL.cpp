@@ -690,7 +690,9 @@ static bool parseDeclSILOptional(bool *isTransparent, bool *isFragile,
                                  SmallVectorImpl<std::string> *Semantics,
                                  SmallVectorImpl<ParsedSpecAttr> *SpecAttrs,
                                  ValueDecl **ClangDecl,
-                                 EffectsKind *MRK, SILParser &SP) {
+                                 EffectsKind *MRK,
+                                 Optional<uint64_t> *EntryCount,
+                                 SILParser &SP) {
   while (SP.P.consumeIf(tok::l_square)) {
     if (isLet && SP.P.Tok.is(tok::kw_let)) {
       *isLet = true;
@@ -752,6 +754,16 @@ static bool parseDeclSILOptional(bool *isTransparent, bool *isFragile,
       SP.P.parseToken(tok::r_square, diag::expected_in_attribute_list);
       continue;
     }
+    else if (EntryCount && SP.P.Tok.getText() == "entry_count") {
+      SP.P.consumeToken(tok::identifier);
+      uint64_t Count;
+      if (SP.parseInteger(Count, diag::expected_in_attribute_list))
+        return true;
+      *EntryCount = Count;
+
+      SP.P.parseToken(tok::r_square, diag::expected_in_attribute_list);
+      continue;
+    }
     else if (ClangDecl && SP.P.Tok.getText() == "clang") {
       SP.P.consumeToken(tok::identifier);
       if (SP.parseSILDottedPathWithoutPound(*ClangDecl))
@@ -3633,8 +3645,13 @@ bool SILParser::parseCallInstruction(SILLocation InstLoc,
   SmallVector<UnresolvedValueName, 4> ArgNames;
 
   bool IsNonThrowingApply = false;
-  if (parseSILOptional(IsNonThrowingApply, *this, "nothrow"))
+  bool IsOnStack = false;
+  if (Opcode == ValueKind::PartialApplyInst) {
+    if (parseSILOptional(IsOnStack, *this, "stack"))
+      return true;
+  } else if (parseSILOptional(IsNonThrowingApply, *this, "nothrow")) {
     return true;
+  }
   
   if (parseValueName(FnName))
     return true;
@@ -3733,8 +3750,11 @@ bool SILParser::parseCallInstruction(SILLocation InstLoc,
     SILType closureTy =
       SILBuilder::getPartialApplyResultType(Ty, ArgNames.size(), SILMod, subs);
     // FIXME: Why the arbitrary order difference in IRBuilder type argument?
-    ResultVal = B.createPartialApply(InstLoc, FnVal, FnTy,
+    auto *PAI = B.createPartialApply(InstLoc, FnVal, FnTy,
                                      subs, Args, closureTy);
+    if (IsOnStack)
+      PAI->setStackAllocatable();
+    ResultVal = PAI;
     break;
   }
   case ValueKind::TryApplyInst: {
@@ -3897,10 +3917,11 @@ bool Parser::parseDeclSIL() {
   SmallVector<ParsedSpecAttr, 4> SpecAttrs;
   ValueDecl *ClangDecl = nullptr;
   EffectsKind MRK = EffectsKind::Unspecified;
+  Optional<uint64_t> EntryCount;
   if (parseSILLinkage(FnLinkage, *this) ||
       parseDeclSILOptional(&isTransparent, &isFragile, &isThunk, &isGlobalInit,
                            &inlineStrategy, nullptr, &Semantics, &SpecAttrs,
-                           &ClangDecl, &MRK, FunctionState) ||
+                           &ClangDecl, &MRK, &EntryCount, FunctionState) ||
       parseToken(tok::at_sign, diag::expected_sil_function_name) ||
       parseIdentifier(FnName, FnNameLoc, diag::expected_sil_function_name) ||
       parseToken(tok::colon, diag::expected_sil_type))
@@ -3927,6 +3948,7 @@ bool Parser::parseDeclSIL() {
     FunctionState.F->setGlobalInit(isGlobalInit);
     FunctionState.F->setInlineStrategy(inlineStrategy);
     FunctionState.F->setEffectsKind(MRK);
+    FunctionState.F->setEntryCount(EntryCount);
     if (ClangDecl)
       FunctionState.F->setClangNodeOwner(ClangDecl);
     for (auto &Attr : Semantics) {
@@ -4058,7 +4080,7 @@ bool Parser::parseSILGlobal() {
   if (parseSILLinkage(GlobalLinkage, *this) ||
       parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr,
                            nullptr, &isLet, nullptr, nullptr, nullptr,
-                           nullptr, State) ||
+                           nullptr, nullptr, State) ||
       parseToken(tok::at_sign, diag::expected_sil_value_name) ||
       parseIdentifier(GlobalName, NameLoc, diag::expected_sil_value_name) ||
       parseToken(tok::colon, diag::expected_sil_type))
@@ -4401,7 +4423,7 @@ bool Parser::parseSILWitnessTable() {
   bool isFragile = false;
   if (parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr,
                            nullptr, nullptr, nullptr, nullptr, nullptr,
-                           nullptr, WitnessState))
+                           nullptr, nullptr, WitnessState))
     return true;
 
   Scope S(this, ScopeKind::TopLevel);
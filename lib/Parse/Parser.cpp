@@ -34,6 +34,12 @@ using namespace swift;
 
 void DelayedParsingCallbacks::anchor() { }
 
+bool SkipNonTransparentFunctions::shouldDelayFunctionBodyParsing(
+    Parser &TheParser, AbstractFunctionDecl *AFD, const DeclAttributes &Attrs,
+    SourceRange BodyRange) {
+  return Attrs.hasAttribute<TransparentAttr>();
+}
+
 namespace {
   /// To assist debugging parser crashes, tell us the location of the
   /// current token.
@@ -942,6 +942,10 @@ bool SILInstruction::isAllocatingStack() const {
     if (ARI->canAllocOnStack())
       return true;
   }
+  if (auto *PAI = dyn_cast<PartialApplyInst>(this)) {
+    if (PAI->canAllocOnStack())
+      return true;
+  }
   return false;
 }
 
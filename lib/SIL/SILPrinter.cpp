@@ -395,6 +395,11 @@ class SILPrinter : public SILVisitor<SILPrinter> {
   llvm::DenseMap<const SILBasicBlock *, unsigned> BlocksToIDMap;
   llvm::DenseMap<const ValueBase *, unsigned> ValueToIDMap;
 
+  /// The printed form of each lowered type seen so far. The same few types
+  /// are printed over and over in a function body, and each print walks the
+  /// whole type.
+  llvm::DenseMap<CanType, std::string> SILTypeStrings;
+
   // Printers for the underlying stream.
 #define SIMPLE_PRINTER(TYPE) \
   SILPrinter &operator<<(TYPE value) { \
@@ -424,7 +429,16 @@ class SILPrinter : public SILVisitor<SILPrinter> {
   
   SILPrinter &operator<<(SILType t) {
     printSILTypeColorAndSigil(PrintState.OS, t);
-    t.getSwiftRValueType().print(PrintState.OS, PrintState.ASTOptions);
+    CanType swiftType = t.getSwiftRValueType();
+    auto known = SILTypeStrings.find(swiftType);
+    if (known == SILTypeStrings.end()) {
+      std::string printed;
+      llvm::raw_string_ostream typeOS(printed);
+      swiftType.print(typeOS, PrintState.ASTOptions);
+      typeOS.flush();
+      known = SILTypeStrings.insert({swiftType, std::move(printed)}).first;
+    }
+    PrintState.OS << known->second;
     return *this;
   }
   
@@ -881,6 +895,8 @@ public:
   
   void visitPartialApplyInst(PartialApplyInst *CI) {
     *this << "partial_apply ";
+    if (CI->canAllocOnStack())
+      *this << "[stack] ";
     *this << getID(CI->getCallee());
     printSubstitutions(CI->getSubstitutions());
     *this << '(';
@@ -1744,6 +1760,9 @@ void SILFunction::print(SILPrintContext &PrintCtx) const {
   if (getEffectsKind() == EffectsKind::ReadWrite)
     OS << "[readwrite] ";
 
+  if (auto Count = getEntryCount())
+    OS << "[entry_count " << *Count << "] ";
+
   for (auto &Attr : getSemanticsAttrs())
     OS << "[_semantics \"" << Attr << "\"] ";
 
@@ -258,7 +258,7 @@ void SILGenFunction::emitValueConstructor(ConstructorDecl *ctor) {
     emitMemberInitializers(dc, selfDecl, nominal);
   }
 
-  emitProfilerIncrement(ctor->getBody());
+  emitProfilerEntryIncrement(ctor->getBody());
   // Emit the constructor body.
   emitStmt(ctor->getBody());
 
@@ -646,7 +646,7 @@ void SILGenFunction::emitClassConstructorInitializer(ConstructorDecl *ctor) {
     emitMemberInitializers(dc, selfDecl, selfClassDecl);
   }
 
-  emitProfilerIncrement(ctor->getBody());
+  emitProfilerEntryIncrement(ctor->getBody());
   // Emit the constructor body.
   emitStmt(ctor->getBody());
 
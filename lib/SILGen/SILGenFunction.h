@@ -467,9 +467,19 @@ public:
 
   /// Emit code to increment a counter for profiling.
   void emitProfilerIncrement(ASTNode N) {
-    if (SGM.Profiler && SGM.Profiler->hasRegionCounters())
+    if (SGM.Profiler && SGM.Profiler->hasRegionCounters() &&
+        SGM.Profiler->shouldEmitCounterIncrements())
       SGM.Profiler->emitCounterIncrement(B, N);
   }
+
+  /// Emit the counter increment for \p N, the entry of the current function,
+  /// and record its profiled execution count as the function's entry count.
+  void emitProfilerEntryIncrement(ASTNode N) {
+    emitProfilerIncrement(N);
+    if (SGM.Profiler)
+      if (auto Count = SGM.Profiler->getExecutionCount(N))
+        F.setEntryCount(Count);
+  }
   
   SILGenFunction(SILGenModule &SGM, SILFunction &F);
   ~SILGenFunction();
@@ -23,6 +23,7 @@
 #include "llvm/ProfileData/CoverageMapping.h"
 #include "llvm/ProfileData/CoverageMappingWriter.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 
 #include <forward_list>
 
@@ -63,10 +64,11 @@ static void walkForProfiling(AbstractFunctionDecl *Root, ASTWalker &Walker) {
 ProfilerRAII::ProfilerRAII(SILGenModule &SGM, AbstractFunctionDecl *D)
     : SGM(SGM), PreviousProfiler(std::move(SGM.Profiler)) {
   const auto &Opts = SGM.M.getOptions();
-  if (!Opts.GenerateProfile || isUnmappedDecl(D))
+  if ((!Opts.GenerateProfile && !SGM.ProfileReader) || isUnmappedDecl(D))
     return;
-  SGM.Profiler =
-      llvm::make_unique<SILGenProfiling>(SGM, Opts.EmitProfileCoverageMapping);
+  SGM.Profiler = llvm::make_unique<SILGenProfiling>(
+      SGM, Opts.GenerateProfile,
+      Opts.GenerateProfile && Opts.EmitProfileCoverageMapping);
   SGM.Profiler->assignRegionCounters(D);
 }
 
@@ -692,6 +694,33 @@ void SILGenProfiling::assignRegionCounters(AbstractFunctionDecl *Root) {
                                    getEquivalentPGOLinkage(CurrentFuncLinkage)),
                                FunctionHash, RegionCounterMap, CurrentFileName);
   }
+
+  if (auto *Reader = SGM.ProfileReader.get()) {
+    // A function that is missing from the profile, or whose counters no
+    // longer match, just gets no counts.
+    if (auto E = Reader->getFunctionCounts(getPGOFuncName(), FunctionHash,
+                                           RegionCounts)) {
+      llvm::consumeError(std::move(E));
+      RegionCounts.clear();
+    } else if (RegionCounts.size() != NumRegionCounters) {
+      RegionCounts.clear();
+    }
+  }
+}
+
+std::string SILGenProfiling::getPGOFuncName() const {
+  return llvm::getPGOFuncName(CurrentFuncName,
+                              getEquivalentPGOLinkage(CurrentFuncLinkage),
+                              CurrentFileName);
+}
+
+Optional<uint64_t> SILGenProfiling::getExecutionCount(ASTNode Node) const {
+  if (RegionCounts.empty())
+    return None;
+  auto CounterIt = RegionCounterMap.find(Node);
+  if (CounterIt == RegionCounterMap.end())
+    return None;
+  return RegionCounts[CounterIt->second];
 }
 
 static SILLocation getLocation(ASTNode Node) {
@@ -715,9 +744,7 @@ void SILGenProfiling::emitCounterIncrement(SILGenBuilder &Builder,ASTNode Node){
   auto Int32Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(32, C));
   auto Int64Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(64, C));
 
-  std::string PGOFuncName = llvm::getPGOFuncName(
-      CurrentFuncName, getEquivalentPGOLinkage(CurrentFuncLinkage),
-      CurrentFileName);
+  std::string PGOFuncName = getPGOFuncName();
 
   SILLocation Loc = getLocation(Node);
   SILValue Args[] = {
@@ -14,6 +14,8 @@
 #define SWIFT_SILGEN_PROFILING_H
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "swift/Basic/LLVM.h"
 #include "swift/AST/ASTNode.h"
 #include "swift/AST/Stmt.h"
 #include "swift/SIL/FormalLinkage.h"
@@ -33,6 +35,7 @@ struct ProfilerRAII;
 class SILGenProfiling {
 private:
   SILGenModule &SGM;
+  bool EmitCounterIncrements;
   bool EmitCoverageMapping;
 
   // The current function's name and counter data.
@@ -43,15 +46,29 @@ private:
   uint64_t FunctionHash;
   llvm::DenseMap<ASTNode, unsigned> RegionCounterMap;
 
+  // The current function's counter values in the -profile-use profile, or
+  // empty if the profile has no data for it.
+  std::vector<uint64_t> RegionCounts;
+
   std::vector<std::tuple<std::string, uint64_t, std::string>> CoverageData;
 
 public:
-  SILGenProfiling(SILGenModule &SGM, bool EmitCoverageMapping)
-      : SGM(SGM), EmitCoverageMapping(EmitCoverageMapping),
-        NumRegionCounters(0), FunctionHash(0) {}
+  SILGenProfiling(SILGenModule &SGM, bool EmitCounterIncrements,
+                  bool EmitCoverageMapping)
+      : SGM(SGM), EmitCounterIncrements(EmitCounterIncrements),
+        EmitCoverageMapping(EmitCoverageMapping), NumRegionCounters(0),
+        FunctionHash(0) {}
 
   bool hasRegionCounters() const { return NumRegionCounters != 0; }
 
+  /// Whether counter increments should be emitted, as opposed to only
+  /// reading counts from an existing profile.
+  bool shouldEmitCounterIncrements() const { return EmitCounterIncrements; }
+
+  /// Return the profiled execution count of \c Node, if the profile given
+  /// to -profile-use has one.
+  Optional<uint64_t> getExecutionCount(ASTNode Node) const;
+
   /// Emit SIL to increment the counter for \c Node.
   void emitCounterIncrement(SILGenBuilder &Builder, ASTNode Node);
 
@@ -59,6 +76,9 @@ private:
   /// Map counters to ASTNodes and set them up for profiling the given function.
   void assignRegionCounters(AbstractFunctionDecl *Root);
 
+  /// Return the name of the current function in the profile.
+  std::string getPGOFuncName() const;
+
   friend struct ProfilerRAII;
 };
 
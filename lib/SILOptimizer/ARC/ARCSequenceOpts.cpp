@@ -40,6 +40,14 @@ STATISTIC(NumRefCountOpsRemoved, "Total number of increments removed");
 
 llvm::cl::opt<bool> EnableLoopARC("enable-loop-arc", llvm::cl::init(true));
 
+/// Matching a pair of nested increments, decrements exposes the next level of
+/// nesting, so the pairing is rerun until it stops finding nested pairs. Bound
+/// the number of reruns so deeply nested code cannot make the pass quadratic.
+llvm::cl::opt<unsigned> ARCSequenceOptsMaxIterations(
+    "arc-sequence-opts-max-iterations", llvm::cl::init(32),
+    llvm::cl::desc("Maximum number of pairing iterations ARC sequence opts "
+                   "runs over a function or loop region"));
+
 //===----------------------------------------------------------------------===//
 //                                Code Motion
 //===----------------------------------------------------------------------===//
@@ -145,6 +153,7 @@ bool LoopARCPairingContext::processRegion(const LoopRegion *Region,
   bool MadeChange = false;
   bool NestingDetected = false;
   bool MatchedPair = false;
+  unsigned Iterations = 0;
 
   do {
     NestingDetected = Evaluator.runOnLoop(Region, FreezePostDomReleases,
@@ -179,7 +188,8 @@ bool LoopARCPairingContext::processRegion(const LoopRegion *Region,
     // This ensures we only ever recompute post dominating releases on the first
     // iteration.
     RecomputePostDomReleases = false;
-  } while (NestingDetected && MatchedPair);
+  } while (NestingDetected && MatchedPair &&
+           ++Iterations < ARCSequenceOptsMaxIterations);
 
   return MadeChange;
 }
@@ -205,8 +215,9 @@ processFunctionWithoutLoopSupport(SILFunction &F, bool FreezePostDomReleases,
   bool Changed = false;
   BlockARCPairingContext Context(F, AA, POTA, RCIA, PTFI);
   // Until we do not remove any instructions or have nested increments,
-  // decrements...
-  while (true) {
+  // decrements, or have run out of iterations...
+  for (unsigned Iterations = 0; Iterations < ARCSequenceOptsMaxIterations;
+       ++Iterations) {
     // Compute matching sets of increments, decrements, and their insertion
     // points.
     //
@@ -18,11 +18,20 @@
 #include "swift/SILOptimizer/PassManager/PassManager.h"
 #include "swift/SIL/SILArgument.h"
 #include "swift/SIL/DebugUtils.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace swift;
 
+/// The maximum number of nodes a caller graph may grow to by merging callee
+/// summary graphs into it. Beyond that, call sites are handled conservatively,
+/// so that graphs in large call trees stay bounded.
+static llvm::cl::opt<unsigned> MaxGraphNodesForMerge(
+    "escapes-max-graph-nodes", llvm::cl::init(10000),
+    llvm::cl::desc("Maximum number of nodes in a connection graph before "
+                   "callee graphs are no longer merged into it"));
+
 static bool isProjection(ValueBase *V) {
   switch (V->getKind()) {
     case ValueKind::IndexAddrInst:
@@ -1541,6 +1550,7 @@ void EscapeAnalysis::setAllEscaping(SILInstruction *I,
 
 void EscapeAnalysis::recompute(FunctionInfo *Initial) {
   allocNewUpdateID();
+  recordComputation();
 
   DEBUG(llvm::dbgs() << "recompute escape analysis with UpdateID " <<
         getCurrentUpdateID() << '\n');
@@ -1587,6 +1597,21 @@ void EscapeAnalysis::recompute(FunctionInfo *Initial) {
 
             // Only include callers which we are actually recomputing.
             if (BottomUpOrder.wasRecomputedWithCurrentUpdateID(E.Caller)) {
+              if (E.Caller->Graph.getNumNodes() +
+                      FInfo->SummaryGraph.getNumNodes() >
+                  MaxGraphNodesForMerge) {
+                // Don't let the caller graph grow any further. Treat the
+                // call as if we didn't know the callee.
+                DEBUG(llvm::dbgs() << "  too large to merge " <<
+                      FInfo->Graph.F->getName() << " into " <<
+                      E.Caller->Graph.F->getName() << '\n');
+                setAllEscaping(E.FAS.getInstruction(), &E.Caller->Graph);
+                E.Caller->NeedUpdateSummaryGraph = true;
+                if (!E.Caller->isScheduledAfter(FInfo))
+                  NeedAnotherIteration = true;
+                continue;
+              }
+
               DEBUG(llvm::dbgs() << "  merge  " << FInfo->Graph.F->getName() <<
                     " into " << E.Caller->Graph.F->getName() << '\n');
 
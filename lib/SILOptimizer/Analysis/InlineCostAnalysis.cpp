@@ -0,0 +1,27 @@
+//===--- InlineCostAnalysis.cpp - Cached inlining cost --------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/SILOptimizer/Analysis/InlineCostAnalysis.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SILOptimizer/Utils/SILInliner.h"
+
+using namespace swift;
+
+FunctionInlineCost::FunctionInlineCost(SILFunction *F) {
+  for (SILBasicBlock &Block : *F)
+    for (SILInstruction &I : Block)
+      TotalCost += int(instructionInlineCost(I));
+}
+
+SILAnalysis *swift::createInlineCostAnalysis(SILModule *M) {
+  return new InlineCostAnalysis();
+}
@@ -352,6 +352,12 @@ void SideEffectAnalysis::analyzeInstruction(FunctionInfo *FInfo,
     case ValueKind::CondFailInst:
       FInfo->FE.Traps = true;
       return;
+    case ValueKind::IsUniqueInst:
+    case ValueKind::IsUniqueOrPinnedInst:
+      FInfo->FE.ReadsRC = true;
+      // The memory effects are handled below by checking the memory behavior
+      // of the instruction.
+      break;
     case ValueKind::PartialApplyInst: {
       FInfo->FE.AllocsObjects = true;
       auto *PAI = cast<PartialApplyInst>(I);
@@ -425,6 +431,7 @@ void SideEffectAnalysis::initialize(SILPassManager *PM) {
 
 void SideEffectAnalysis::recompute(FunctionInfo *Initial) {
   allocNewUpdateID();
+  recordComputation();
 
   DEBUG(llvm::dbgs() << "recompute side-effect analysis with UpdateID " <<
         getCurrentUpdateID() << '\n');
@@ -264,6 +264,8 @@ void CapturePropagation::rewritePartialApply(PartialApplyInst *OrigPAI,
                                            ArrayRef<Substitution>(),
                                            ArrayRef<SILValue>(),
                                            OrigPAI->getType());
+  // The new closure captures nothing, so it has no context to deallocate.
+  eraseClosureContextDeallocs(OrigPAI);
   OrigPAI->replaceAllUsesWith(NewPAI);
   recursivelyDeleteTriviallyDeadInstructions(OrigPAI, true);
   DEBUG(llvm::dbgs() << "  Rewrote caller:\n" << *NewPAI);
@@ -348,13 +348,17 @@ static void rewriteApplyInst(const CallSiteDescriptor &CSDesc,
     }
   }
 
+  // A generic callee's specialization is generic too, so forward the
+  // original substitutions.
+  ArrayRef<Substitution> Subs = AI.getSubstitutions();
   SILType LoweredType = NewF->getLoweredType();
+  if (!Subs.empty())
+    LoweredType = LoweredType.substGenericArgs(M, Subs);
   SILType ResultType = LoweredType.castTo<SILFunctionType>()->getSILResult();
   Builder.setInsertionPoint(AI.getInstruction());
   FullApplySite NewAI;
   if (auto *TAI = dyn_cast<TryApplyInst>(AI)) {
-    NewAI = Builder.createTryApply(AI.getLoc(), FRI, LoweredType,
-                                   ArrayRef<Substitution>(),
+    NewAI = Builder.createTryApply(AI.getLoc(), FRI, LoweredType, Subs,
                                    NewArgs,
                                    TAI->getNormalBB(), TAI->getErrorBB());
     // If we passed in the original closure as @owned, then insert a release
@@ -369,7 +373,7 @@ static void rewriteApplyInst(const CallSiteDescriptor &CSDesc,
     }
   } else {
     NewAI = Builder.createApply(AI.getLoc(), FRI, LoweredType,
-                                ResultType, ArrayRef<Substitution>(),
+                                ResultType, Subs,
                                 NewArgs, cast<ApplyInst>(AI)->isNonThrowing());
     // If we passed in the original closure as @owned, then insert a release
     // right after NewAI. This is to balance the +1 from being an @owned
@@ -737,11 +741,10 @@ void ClosureSpecializer::gatherCallSites(
 
       // Go through all uses of our closure.
       for (auto *Use : II.getUses()) {
-        // If this use is not an apply inst or an apply inst with
-        // substitutions, there is nothing interesting for us to do, so
-        // continue...
+        // If this use is not an apply inst, there is nothing interesting for
+        // us to do, so continue...
         auto AI = FullApplySite::isa(Use->getUser());
-        if (!AI || AI.hasSubstitutions())
+        if (!AI)
           continue;
 
         // Check if we have already associated this apply inst with a closure to
@@ -796,6 +799,18 @@ void ClosureSpecializer::gatherCallSites(
         assert(ClosureIndex.getValue() >= NumIndirectResults);
         auto ClosureParamIndex = ClosureIndex.getValue() - NumIndirectResults;
 
+        // A generic callee keeps its generic signature in the specialized
+        // function, so the closure that replaces the argument, which is never
+        // generic, must not depend on the callee's generic parameters.
+        if (AI.hasSubstitutions()) {
+          auto OrigParams =
+            ApplyCallee->getLoweredFunctionType()->getParameters();
+          CanType OrigClosureTy = OrigParams[ClosureParamIndex].getType();
+          if (OrigClosureTy->hasTypeParameter() ||
+              OrigClosureTy->hasArchetype())
+            continue;
+        }
+
         auto ParamInfo = AI.getSubstCalleeType()->getParameters();
         SILParameterInfo ClosureParamInfo = ParamInfo[ClosureParamIndex];
 
@@ -0,0 +1,370 @@
+//===--- ConstantArgumentPropagation.cpp - Propagate constant arguments ---===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Specialize functions for constant arguments which are passed at call sites.
+//
+// This is the interprocedural counterpart of constant propagation: a callee
+// which branches on a literal flag argument, switches on a literal value or
+// calls a function passed as argument is cloned with the literal in place of
+// the argument. The following SSA passes then fold away the dead paths in the
+// specialized function.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "constant-arg-prop"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/SIL/Mangle.h"
+#include "swift/SIL/SILCloner.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SILOptimizer/Utils/Local.h"
+#include "llvm/ADT/SmallBitVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumConstantArgsPropagated,
+          "Number of call sites specialized for constant arguments");
+
+/// The maximum number of instructions in a callee which is cloned for a call
+/// site.
+llvm::cl::opt<unsigned> ConstantArgPropCalleeSizeLimit(
+    "sil-constant-arg-prop-callee-size-limit", llvm::cl::init(200),
+    llvm::cl::desc("The maximum size of a function which is specialized "
+                   "for constant arguments"));
+
+namespace {
+/// Specialize the callees of apply instructions for the constant arguments of
+/// the apply.
+class ConstantArgumentPropagation : public SILModuleTransform {
+public:
+  void run() override;
+
+  StringRef getName() override { return "Constant Argument Propagation"; }
+
+protected:
+  bool optimizeApply(ApplyInst *AI);
+  SILFunction *specializeForConstantArgs(ApplyInst *AI, SILFunction *OrigF,
+                                         const llvm::SmallBitVector &ConstArgs);
+  void rewriteApply(ApplyInst *AI, SILFunction *SpecialF,
+                    const llvm::SmallBitVector &ConstArgs);
+};
+} // namespace
+
+/// Return the literal for \p V if it can be propagated into a callee.
+static LiteralInst *getPropagatableConstant(SILValue V) {
+  if (isa<IntegerLiteralInst>(V) || isa<FloatLiteralInst>(V) ||
+      isa<FunctionRefInst>(V))
+    return cast<LiteralInst>(V);
+
+  // We do not optimize string literals of length > 32 since we would need to
+  // encode them into the symbol name for uniqueness.
+  if (auto *SLI = dyn_cast<StringLiteralInst>(V))
+    if (SLI->getValue().size() <= 32)
+      return SLI;
+
+  return nullptr;
+}
+
+static std::string getClonedName(ApplyInst *AI, IsFragile_t Fragile,
+                                 SILFunction *F,
+                                 const llvm::SmallBitVector &ConstArgs) {
+  Mangle::Mangler M;
+  auto P = SpecializationPass::ConstantArgumentPropagation;
+  FunctionSignatureSpecializationMangler Mangler(P, M, Fragile, F);
+
+  auto Args = AI->getArguments();
+  for (unsigned i : indices(Args))
+    if (ConstArgs[i])
+      Mangler.setArgumentConstantProp(i, getPropagatableConstant(Args[i]));
+  Mangler.mangle();
+
+  return M.finalize();
+}
+
+namespace {
+/// Clone a function, replacing some of its arguments with literal constants
+/// from a call site.
+///
+/// As in CapturePropagation the cloned literals take on the location and the
+/// debug scope of the new function.
+class ConstantArgumentCloner
+  : public SILClonerWithScopes<ConstantArgumentCloner> {
+  using SuperTy = SILClonerWithScopes<ConstantArgumentCloner>;
+  friend class SILVisitor<ConstantArgumentCloner>;
+  friend class SILCloner<ConstantArgumentCloner>;
+
+  SILFunction *OrigF;
+  bool IsCloningConstant;
+public:
+  ConstantArgumentCloner(SILFunction *OrigF, SILFunction *NewF)
+    : SuperTy(*NewF), OrigF(OrigF), IsCloningConstant(false) {}
+
+  void cloneBlocks(OperandValueArrayRef Args,
+                   const llvm::SmallBitVector &ConstArgs);
+
+protected:
+  SILLocation remapLocation(SILLocation InLoc) {
+    if (IsCloningConstant)
+      return getBuilder().getFunction().getLocation();
+    return InLoc;
+  }
+
+  void postProcess(SILInstruction *Orig, SILInstruction *Cloned) {
+    assert(IsCloningConstant == (Orig->getFunction() != OrigF) &&
+           "Expect only cloned constants from the caller function.");
+    SuperTy::postProcess(Orig, Cloned);
+  }
+
+  const SILDebugScope *remapScope(const SILDebugScope *DS) {
+    if (IsCloningConstant)
+      return getBuilder().getFunction().getDebugScope();
+    return SuperTy::remapScope(DS);
+  }
+};
+} // namespace
+
+/// Clone the original function into the new specialized function, replacing
+/// the arguments marked in \p ConstArgs with the literals of the call site.
+void ConstantArgumentCloner::cloneBlocks(
+    OperandValueArrayRef ApplyArgs, const llvm::SmallBitVector &ConstArgs) {
+  SILFunction &CloneF = getBuilder().getFunction();
+  SILModule &M = CloneF.getModule();
+
+  SILBasicBlock *OrigEntryBB = &*OrigF->begin();
+  SILBasicBlock *ClonedEntryBB = new (M) SILBasicBlock(&CloneF);
+  BBMap.insert(std::make_pair(OrigEntryBB, ClonedEntryBB));
+
+  // Only clone the arguments which are not replaced by constants.
+  for (unsigned i = 0, e = OrigEntryBB->bbarg_size(); i != e; ++i) {
+    if (ConstArgs[i])
+      continue;
+    SILArgument *Arg = OrigEntryBB->getBBArg(i);
+    SILValue MappedValue = new (M)
+        SILArgument(ClonedEntryBB, remapType(Arg->getType()), Arg->getDecl());
+    ValueMap.insert(std::make_pair(Arg, MappedValue));
+  }
+
+  // Materialize the constants at the beginning of the entry block.
+  getBuilder().setInsertionPoint(ClonedEntryBB);
+  IsCloningConstant = true;
+  for (unsigned i = 0, e = OrigEntryBB->bbarg_size(); i != e; ++i) {
+    if (!ConstArgs[i])
+      continue;
+    auto *LI = getPropagatableConstant(ApplyArgs[i]);
+    assert(LI && "expected a constant argument");
+    if (InstructionMap.find(LI) == InstructionMap.end())
+      visit(LI);
+    ValueMap.insert(std::make_pair(OrigEntryBB->getBBArg(i), remapValue(LI)));
+  }
+  IsCloningConstant = false;
+
+  // Recursively visit original BBs in depth-first preorder, starting with the
+  // entry block, cloning all instructions other than terminators.
+  visitSILBasicBlock(OrigEntryBB);
+
+  // Now iterate over the BBs and fix up the terminators.
+  for (auto BI = BBMap.begin(), BE = BBMap.end(); BI != BE; ++BI) {
+    getBuilder().setInsertionPoint(BI->second);
+    visit(BI->first->getTerminator());
+  }
+}
+
+/// Return the type of \p OrigF without the parameters marked in \p ConstArgs.
+static CanSILFunctionType
+getSpecializedType(SILFunction *OrigF, const llvm::SmallBitVector &ConstArgs) {
+  CanSILFunctionType FTy = OrigF->getLoweredFunctionType();
+  unsigned NumIndirectResults = FTy->getNumIndirectResults();
+
+  llvm::SmallVector<SILParameterInfo, 8> Params;
+  for (unsigned i : indices(FTy->getParameters()))
+    if (!ConstArgs[NumIndirectResults + i])
+      Params.push_back(FTy->getParameters()[i]);
+
+  return SILFunctionType::get(FTy->getGenericSignature(), FTy->getExtInfo(),
+                              FTy->getCalleeConvention(), Params,
+                              FTy->getAllResults(),
+                              FTy->getOptionalErrorResult(),
+                              OrigF->getModule().getASTContext());
+}
+
+SILFunction *ConstantArgumentPropagation::specializeForConstantArgs(
+    ApplyInst *AI, SILFunction *OrigF, const llvm::SmallBitVector &ConstArgs) {
+  IsFragile_t Fragile = IsNotFragile;
+  if (AI->getFunction()->isFragile() && OrigF->isFragile())
+    Fragile = IsFragile;
+
+  std::string Name = getClonedName(AI, Fragile, OrigF, ConstArgs);
+
+  // See if we already have a version of this function in the module. If so,
+  // just return it.
+  if (auto *NewF = OrigF->getModule().lookUpFunction(Name)) {
+    assert(NewF->isFragile() == Fragile);
+    DEBUG(llvm::dbgs()
+              << "  Found an already specialized version of the callee: ";
+          NewF->printName(llvm::dbgs()); llvm::dbgs() << "\n");
+    return NewF;
+  }
+
+  CanSILFunctionType NewFTy = getSpecializedType(OrigF, ConstArgs);
+  SILFunction *NewF = getModule()->createFunction(
+      SILLinkage::Shared, Name, NewFTy,
+      /*contextGenericParams*/ nullptr, OrigF->getLocation(), OrigF->isBare(),
+      OrigF->isTransparent(), Fragile, OrigF->isThunk(),
+      OrigF->getClassVisibility(), OrigF->getInlineStrategy(),
+      OrigF->getEffectsKind(),
+      /*InsertBefore*/ OrigF, OrigF->getDebugScope(), OrigF->getDeclContext());
+  NewF->setDeclCtx(OrigF->getDeclContext());
+  DEBUG(llvm::dbgs() << "  Specialize callee as ";
+        NewF->printName(llvm::dbgs()); llvm::dbgs() << " " << NewFTy << "\n");
+
+  ConstantArgumentCloner Cloner(OrigF, NewF);
+  Cloner.cloneBlocks(AI->getArguments(), ConstArgs);
+  return NewF;
+}
+
+void ConstantArgumentPropagation::rewriteApply(
+    ApplyInst *AI, SILFunction *SpecialF,
+    const llvm::SmallBitVector &ConstArgs) {
+  llvm::SmallVector<SILValue, 8> NewArgs;
+  auto Args = AI->getArguments();
+  for (unsigned i : indices(Args))
+    if (!ConstArgs[i])
+      NewArgs.push_back(Args[i]);
+
+  SILBuilderWithScope Builder(AI);
+  auto *FuncRef = Builder.createFunctionRef(AI->getLoc(), SpecialF);
+  auto *NewAI = Builder.createApply(AI->getLoc(), FuncRef, NewArgs,
+                                    AI->isNonThrowing());
+  AI->replaceAllUsesWith(NewAI);
+  recursivelyDeleteTriviallyDeadInstructions(AI, true);
+  DEBUG(llvm::dbgs() << "  Rewrote caller:\n" << *NewAI);
+}
+
+/// Return true if \p V is the condition of a branch or switch, or is
+/// compared by a builtin which feeds a branch.
+static bool isUsedAsCondition(SILValue V, bool LookThroughBuiltin = true) {
+  for (auto *Op : V->getUses()) {
+    SILInstruction *User = Op->getUser();
+    if (isa<CondBranchInst>(User) || isa<SwitchValueInst>(User))
+      return true;
+    if (LookThroughBuiltin && isa<BuiltinInst>(User) &&
+        isUsedAsCondition(User, /*LookThroughBuiltin*/ false))
+      return true;
+  }
+  return false;
+}
+
+/// We only specialize if a constant argument lets the callee fold a branch or
+/// convert a call of the argument to a direct call.
+static bool isProfitable(SILFunction *Callee,
+                         const llvm::SmallBitVector &ConstArgs) {
+  SILBasicBlock *EntryBB = &*Callee->begin();
+  for (unsigned i = 0, e = EntryBB->bbarg_size(); i != e; ++i) {
+    if (!ConstArgs[i])
+      continue;
+    SILArgument *Arg = EntryBB->getBBArg(i);
+    if (isUsedAsCondition(Arg))
+      return true;
+    for (auto *Op : Arg->getUses()) {
+      if (auto *AI = dyn_cast<ApplyInst>(Op->getUser()))
+        if (AI->getCallee() == Op->get())
+          return true;
+    }
+  }
+  return false;
+}
+
+static bool isSmallEnoughToClone(SILFunction *F) {
+  unsigned Size = 0;
+  for (auto &BB : *F) {
+    Size += std::distance(BB.begin(), BB.end());
+    if (Size > ConstantArgPropCalleeSizeLimit)
+      return false;
+  }
+  return true;
+}
+
+bool ConstantArgumentPropagation::optimizeApply(ApplyInst *AI) {
+  // FIXME: We could handle generic callees if it's worthwhile.
+  if (AI->hasSubstitutions())
+    return false;
+
+  auto *FRI = dyn_cast<FunctionRefInst>(AI->getCallee());
+  if (!FRI)
+    return false;
+
+  SILFunction *Callee = FRI->getReferencedFunction();
+  if (Callee->isExternalDeclaration() || Callee == AI->getFunction() ||
+      !Callee->shouldOptimize() || Callee->isThunk() ||
+      Callee->getRepresentation() != SILFunctionTypeRepresentation::Thin ||
+      Callee->getLoweredFunctionType()->isPolymorphic())
+    return false;
+
+  // Constants are never indirect results, so the argument index is also the
+  // index of the callee's entry block argument.
+  auto Args = AI->getArguments();
+  llvm::SmallBitVector ConstArgs(Args.size());
+  for (unsigned i : indices(Args))
+    if (getPropagatableConstant(Args[i]))
+      ConstArgs.set(i);
+
+  if (ConstArgs.none() || !isProfitable(Callee, ConstArgs) ||
+      !isSmallEnoughToClone(Callee))
+    return false;
+
+  DEBUG(llvm::dbgs() << "Specializing callee for constant arguments:\n"
+        << "  " << Callee->getName() << "\n" << *AI);
+  ++NumConstantArgsPropagated;
+  SILFunction *NewF = specializeForConstantArgs(AI, Callee, ConstArgs);
+  rewriteApply(AI, NewF, ConstArgs);
+  return true;
+}
+
+void ConstantArgumentPropagation::run() {
+  DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
+  bool HasChanged = false;
+  for (auto &F : *getModule()) {
+
+    // Don't optimize functions that are marked with the opt.never attribute.
+    if (!F.shouldOptimize())
+      continue;
+
+    // Cache cold blocks per function.
+    ColdBlockInfo ColdBlocks(DA);
+    for (auto &BB : F) {
+      if (ColdBlocks.isCold(&BB))
+        continue;
+
+      auto I = BB.begin();
+      while (I != BB.end()) {
+        SILInstruction *Inst = &*I;
+        ++I;
+        if (auto *AI = dyn_cast<ApplyInst>(Inst))
+          HasChanged |= optimizeApply(AI);
+      }
+    }
+  }
+
+  if (HasChanged) {
+    invalidateAnalysis(SILAnalysis::InvalidationKind::Everything);
+  }
+}
+
+SILTransform *swift::createConstantArgumentPropagation() {
+  return new ConstantArgumentPropagation();
+}
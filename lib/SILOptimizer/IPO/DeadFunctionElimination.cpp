@@ -25,6 +25,8 @@ using namespace swift;
 
 STATISTIC(NumDeadFunc, "Number of dead functions eliminated");
 STATISTIC(NumEliminatedExternalDefs, "Number of external function definitions eliminated");
+STATISTIC(NumDeadDeserializedFunc,
+          "Number of dead functions eliminated that were deserialized");
 
 namespace {
 
@@ -415,6 +417,8 @@ public:
       if (!isAlive(F)) {
         DEBUG(llvm::dbgs() << "  erase dead function " << F->getName() << "\n");
         NumDeadFunc++;
+        if (F->isAvailableExternally())
+          NumDeadDeserializedFunc++;
         DFEPass->invalidateAnalysisForDeadFunction(F,
                                      SILAnalysis::InvalidationKind::Everything);
         Module->eraseFunction(F);
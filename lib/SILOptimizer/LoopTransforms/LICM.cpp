@@ -13,11 +13,13 @@
 #define DEBUG_TYPE "sil-licm"
 
 #include "swift/SIL/Dominance.h"
+#include "swift/SILOptimizer/Analysis/ARCAnalysis.h"
 #include "swift/SILOptimizer/Analysis/AliasAnalysis.h"
 #include "swift/SILOptimizer/Analysis/Analysis.h"
 #include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Analysis/LoopAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ArraySemantic.h"
+#include "swift/SILOptimizer/Analysis/RCIdentityAnalysis.h"
 #include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
@@ -310,6 +312,141 @@ static bool hoistInstructions(SILLoop *Loop, DominanceInfo *DT,
   return Changed;
 }
 
+/// Returns true if \p I is the only instruction in \p RCInsts which operates
+/// on the RC root of its operand.
+static bool isOnlyRCInstOnRoot(SILInstruction *I,
+                               ArrayRef<SILInstruction *> RCInsts,
+                               RCIdentityFunctionInfo *RCIA) {
+  SILValue Root = RCIA->getRCIdentityRoot(I->getOperand(0));
+  unsigned NumOnRoot = 0;
+  for (auto *RCI : RCInsts)
+    if (RCIA->getRCIdentityRoot(RCI->getOperand(0)) == Root)
+      ++NumOnRoot;
+  return NumOnRoot == 1;
+}
+
+/// Returns true if \p Second follows \p First in the same block.
+static bool isLaterInBlock(SILInstruction *First, SILInstruction *Second) {
+  if (First->getParent() != Second->getParent())
+    return false;
+  for (auto Iter = First->getIterator(), End = First->getParent()->end();
+       Iter != End; ++Iter) {
+    if (&*Iter == Second)
+      return true;
+  }
+  return false;
+}
+
+/// Hoist retains into the preheader and sink their matching releases into the
+/// exit block of \p Loop, if the retained values are loop invariant.
+///
+/// This is done for pairs which ARCSequenceOpts cannot remove, e.g. because
+/// there is a call between the retain and the release which may decrement the
+/// reference count. Keeping the value alive for the whole loop instead of a
+/// single iteration is fine, as long as nothing in the loop observes the
+/// reference count, e.g. with an isUnique check.
+static bool hoistAndSinkRetainReleasePairs(SILLoop *Loop,
+                                           DominanceInfo *DomTree,
+                                           SILLoopInfo *LI,
+                                           RCIdentityFunctionInfo *RCIA,
+                                           SideEffectAnalysis *SEA) {
+  DEBUG(llvm::dbgs() << " Hoist retain/release pairs attempt\n");
+  auto *Preheader = Loop->getLoopPreheader();
+  if (!Preheader)
+    return false;
+
+  // Only handle innermost loops for now.
+  if (!Loop->getSubLoops().empty())
+    return false;
+
+  // Only handle single exit blocks for now.
+  auto *ExitBB = Loop->getExitBlock();
+  if (!ExitBB)
+    return false;
+  auto *ExitingBB = Loop->getExitingBlock();
+  if (!ExitingBB)
+    return false;
+
+  SmallVector<SILInstruction *, 8> Retains;
+  SmallVector<SILInstruction *, 8> Releases;
+  for (auto *BB : Loop->getBlocks()) {
+    for (auto &Inst : *BB) {
+      if (isa<StrongRetainInst>(&Inst) || isa<RetainValueInst>(&Inst)) {
+        Retains.push_back(&Inst);
+        continue;
+      }
+      if (isa<StrongReleaseInst>(&Inst) || isa<ReleaseValueInst>(&Inst)) {
+        Releases.push_back(&Inst);
+        continue;
+      }
+      // Moving the pairs out of the loop would let a uniqueness check fail in
+      // every iteration.
+      if (mayCheckRefCount(&Inst)) {
+        DEBUG(llvm::dbgs() << "  may check the reference count " << Inst);
+        return false;
+      }
+      if (FullApplySite FAS = FullApplySite::isa(&Inst)) {
+        SideEffectAnalysis::FunctionEffects E;
+        SEA->getEffects(E, FAS);
+        if (E.mayReadRC()) {
+          DEBUG(llvm::dbgs() << "  may check the reference count " << Inst);
+          return false;
+        }
+      }
+    }
+  }
+
+  auto isLoopInvariant = [&](SILValue V) -> bool {
+    return DomTree->dominates(V->getParentBB(), Preheader);
+  };
+
+  // Collect the pairs of a retain and a following release in the same block,
+  // which is executed in every iteration.
+  SmallVector<std::pair<SILInstruction *, SILInstruction *>, 4> Pairs;
+  for (auto *Retain : Retains) {
+    if (!DomTree->dominates(Retain->getParent(), ExitingBB) ||
+        !isLoopInvariant(Retain->getOperand(0)) ||
+        !isOnlyRCInstOnRoot(Retain, Retains, RCIA))
+      continue;
+
+    SILValue Root = RCIA->getRCIdentityRoot(Retain->getOperand(0));
+    for (auto *Release : Releases) {
+      if (RCIA->getRCIdentityRoot(Release->getOperand(0)) != Root)
+        continue;
+      if (isLaterInBlock(Retain, Release) &&
+          isLoopInvariant(Release->getOperand(0)) &&
+          isOnlyRCInstOnRoot(Release, Releases, RCIA))
+        Pairs.push_back({Retain, Release});
+      break;
+    }
+  }
+  // Any other release in the loop may call a deinit which checks the
+  // reference count of a hoisted value.
+  if (Pairs.empty() || Pairs.size() != Releases.size())
+    return false;
+
+  // Find (or create) the block outside the loop to which the releases are
+  // sunk.
+  SILBasicBlock *OutsideBB = ExitBB;
+  auto Succs = ExitingBB->getSuccessors();
+  for (unsigned EdgeIdx = 0; EdgeIdx < Succs.size(); ++EdgeIdx) {
+    if (Succs[EdgeIdx] == ExitBB) {
+      if (auto *SplitBB = splitCriticalEdge(ExitingBB->getTerminator(),
+                                            EdgeIdx, DomTree, LI))
+        OutsideBB = SplitBB;
+      break;
+    }
+  }
+
+  for (auto &Pair : Pairs) {
+    DEBUG(llvm::dbgs() << "  hoisting " << *Pair.first);
+    Pair.first->moveBefore(Preheader->getTerminator());
+    DEBUG(llvm::dbgs() << "  sinking " << *Pair.second);
+    Pair.second->moveBefore(&*OutsideBB->begin());
+  }
+  return true;
+}
+
 static bool sinkFixLifetime(SILLoop *Loop, DominanceInfo *DomTree,
                             SILLoopInfo *LI) {
   DEBUG(llvm::errs() << " Sink fix_lifetime attempt\n");
@@ -399,6 +536,7 @@ class LoopTreeOptimization {
   SILLoopInfo *LoopInfo;
   AliasAnalysis *AA;
   SideEffectAnalysis *SEA;
+  RCIdentityFunctionInfo *RCIA;
   DominanceInfo *DomTree;
   bool Changed;
 
@@ -409,9 +547,10 @@ class LoopTreeOptimization {
 public:
   LoopTreeOptimization(SILLoop *TopLevelLoop, SILLoopInfo *LI,
                        AliasAnalysis *AA, SideEffectAnalysis *SEA,
-                       DominanceInfo *DT,
+                       RCIdentityFunctionInfo *RCIA, DominanceInfo *DT,
                        bool RunsOnHighLevelSil)
-      : LoopInfo(LI), AA(AA), SEA(SEA), DomTree(DT), Changed(false),
+      : LoopInfo(LI), AA(AA), SEA(SEA), RCIA(RCIA), DomTree(DT),
+        Changed(false),
         RunsOnHighLevelSil(RunsOnHighLevelSil) {
     // Collect loops for a recursive bottom-up traversal in the loop tree.
     BotUpWorkList.push_back(TopLevelLoop);
@@ -522,6 +661,11 @@ void LoopTreeOptimization::optimizeLoop(SILLoop *CurrentLoop,
   Changed |= hoistInstructions(CurrentLoop, DomTree, SafeReads,
                                RunsOnHighLevelSil);
   Changed |= sinkFixLifetime(CurrentLoop, DomTree, LoopInfo);
+  // On high-level SIL uniqueness checks may still be hidden in semantic
+  // calls, so only do this after they are inlined.
+  if (!RunsOnHighLevelSil)
+    Changed |= hoistAndSinkRetainReleasePairs(CurrentLoop, DomTree, LoopInfo,
+                                              RCIA, SEA);
 }
 
 namespace {
@@ -555,6 +699,8 @@ public:
     DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
     AliasAnalysis *AA = PM->getAnalysis<AliasAnalysis>();
     SideEffectAnalysis *SEA = PM->getAnalysis<SideEffectAnalysis>();
+    RCIdentityFunctionInfo *RCIA =
+      PM->getAnalysis<RCIdentityAnalysis>()->get(F);
     DominanceInfo *DomTree = nullptr;
 
     DEBUG(llvm::dbgs() << "Processing loops in " << F->getName() << "\n");
@@ -562,7 +708,7 @@ public:
 
     for (auto *TopLevelLoop : *LoopInfo) {
       if (!DomTree) DomTree = DA->get(F);
-      LoopTreeOptimization Opt(TopLevelLoop, LoopInfo, AA, SEA, DomTree,
+      LoopTreeOptimization Opt(TopLevelLoop, LoopInfo, AA, SEA, RCIA, DomTree,
                                RunsOnHighLevelSil);
       Changed |= Opt.optimize();
     }
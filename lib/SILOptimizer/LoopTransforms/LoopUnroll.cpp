@@ -30,6 +30,12 @@ using llvm::MapVector;
 
 static const uint64_t SILLoopUnrollThreshold = 250;
 
+/// The cost of an unrolled loop body that partial unrolling may create.
+static const uint64_t SILLoopPartialUnrollThreshold = 64;
+
+/// The largest number of iterations partial unrolling puts in one body.
+static const uint64_t SILLoopMaxPartialUnrollFactor = 4;
+
 namespace {
 
 /// Clone the basic blocks in a loop.
@@ -416,6 +422,200 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
   return true;
 }
 
+/// Match a loop that counts an induction variable up by one until it equals a
+/// loop invariant, but not necessarily constant, value:
+///
+///   Header(%i):
+///     ...
+///     %next = tuple_extract (sadd_with_overflow %i, 1), 0
+///     %done = cmp_eq %next, %end
+///     cond_br %done, Exit, Header(%next)
+///
+/// On success, \p IndVar is the header argument for %i, \p End is %end and
+/// \p ExitBr is the loop's only exiting branch.
+static bool matchRuntimeTripCount(SILLoop *Loop, SILBasicBlock *Header,
+                                  SILBasicBlock *Latch, SILArgument *&IndVar,
+                                  SILValue &End, CondBranchInst *&ExitBr) {
+  // Skip a split backedge.
+  SILBasicBlock *OrigLatch = Latch;
+  if (!Loop->isLoopExiting(Latch) && !(Latch = Latch->getSinglePredecessor()))
+    return false;
+
+  // The partially unrolled body has no exits, so the latch must be the only
+  // way out of the loop.
+  SmallVector<SILBasicBlock *, 4> ExitingBlocks;
+  Loop->getExitingBlocks(ExitingBlocks);
+  if (ExitingBlocks.size() != 1 || ExitingBlocks[0] != Latch)
+    return false;
+
+  ExitBr = dyn_cast<CondBranchInst>(Latch->getTerminator());
+  if (!ExitBr || Loop->contains(ExitBr->getTrueBB()) ||
+      !Loop->contains(ExitBr->getFalseBB()))
+    return false;
+
+  SILValue RecNext;
+  if (!match(ExitBr->getCondition(),
+             m_BuiltinInst(BuiltinValueKind::ICMP_EQ, m_SILValue(RecNext),
+                           m_SILValue(End))))
+    return false;
+  if (!match(RecNext,
+             m_TupleExtractInst(m_ApplyInst(BuiltinValueKind::SAddOver,
+                                            m_SILArgument(IndVar), m_One()),
+                                0)))
+    return false;
+
+  if (IndVar->getParent() != Header)
+    return false;
+  if (RecNext != IndVar->getIncomingValue(OrigLatch))
+    return false;
+
+  // The end value must not change while the loop runs.
+  if (auto *EndBB = End->getParentBB())
+    if (Loop->contains(EndBB))
+      return false;
+
+  return true;
+}
+
+/// Return how many iterations to put into one partially unrolled body of
+/// \p Loop, or zero if it should not be partially unrolled.
+static uint64_t getPartialUnrollFactor(SILLoop *Loop) {
+  uint64_t Cost = 0;
+  for (auto *BB : Loop->getBlocks()) {
+    for (auto &Inst : *BB) {
+      if (!Loop->canDuplicate(&Inst))
+        return 0;
+      // Calls dominate the cost of the loop and hide its body from LLVM's
+      // vectorizer; unrolling them buys nothing.
+      if (FullApplySite::isa(&Inst))
+        return 0;
+      if (instructionInlineCost(Inst) != InlineCost::Free)
+        ++Cost;
+    }
+  }
+
+  uint64_t Factor = SILLoopMaxPartialUnrollFactor;
+  while (Factor > 1 && Cost * Factor > SILLoopPartialUnrollThreshold)
+    Factor /= 2;
+  return Factor > 1 ? Factor : 0;
+}
+
+/// Partially unroll a loop with a runtime trip count.
+///
+/// The loop is preceded by a new loop whose body holds several iterations of
+/// the original body without their exit checks. It runs while at least that
+/// many iterations remain, after which the original loop runs the remainder:
+///
+///   Check(%i):
+///     cond_br %i < %end && %end - %i > Factor, Body1(%i), Header(%i)
+///   Body1(%i) ... BodyN(%i + Factor - 1):
+///     br Check(%i + Factor)
+///   Header(%i):
+///     <the original loop>
+static bool tryToPartiallyUnrollLoop(SILLoop *Loop) {
+  assert(Loop->getSubLoops().empty() && "Expecting innermost loops");
+
+  auto *Preheader = Loop->getLoopPreheader();
+  if (!Preheader)
+    return false;
+
+  auto *Latch = Loop->getLoopLatch();
+  if (!Latch)
+    return false;
+
+  auto *Header = Loop->getHeader();
+  auto *Fun = Header->getParent();
+
+  // Don't grow code that the profile says never runs.
+  auto EntryCount = Fun->getEntryCount();
+  if (EntryCount && *EntryCount == 0)
+    return false;
+
+  auto *PreheaderBr = dyn_cast<BranchInst>(Preheader->getTerminator());
+  if (!PreheaderBr || PreheaderBr->getDestBB() != Header)
+    return false;
+
+  SILArgument *IndVar;
+  SILValue End;
+  CondBranchInst *ExitBr;
+  if (!matchRuntimeTripCount(Loop, Header, Latch, IndVar, End, ExitBr))
+    return false;
+
+  uint64_t Factor = getPartialUnrollFactor(Loop);
+  if (!Factor)
+    return false;
+
+  // A short constant trip count would never take the unrolled body.
+  Optional<uint64_t> MaxTripCount =
+      getMaxLoopTripCount(Loop, Preheader, Header, Latch);
+  if (MaxTripCount && *MaxTripCount <= Factor)
+    return false;
+
+  DEBUG(llvm::dbgs() << "Partially unrolling loop by " << Factor << " in "
+                     << Fun->getName() << " " << *Loop << "\n");
+
+  auto &Mod = Fun->getModule();
+  auto *Check = new (Mod) SILBasicBlock(Fun);
+  SmallVector<SILValue, 8> CheckArgs;
+  for (auto *Arg : Header->getBBArgs())
+    CheckArgs.push_back(new (Mod) SILArgument(Check, Arg->getType()));
+
+  // Clone the body once per unrolled iteration and drop the clones' exit
+  // checks.
+  SmallVector<SILBasicBlock *, 4> Headers;
+  SmallVector<SILBasicBlock *, 4> Latches;
+  for (uint64_t Cnt = 0; Cnt < Factor; ++Cnt) {
+    LoopCloner Cloner(Loop);
+    Cloner.cloneLoop();
+    auto &BBMap = Cloner.getBBMap();
+    Headers.push_back(BBMap[Header]);
+    Latches.push_back(BBMap[Latch]);
+
+    auto *ClonedExitBr = cast<CondBranchInst>(
+        BBMap[ExitBr->getParent()]->getTerminator());
+    SILBuilder(ClonedExitBr)
+        .createBranch(ClonedExitBr->getLoc(), ClonedExitBr->getFalseBB(),
+                      ClonedExitBr->getFalseArgs());
+    ClonedExitBr->eraseFromParent();
+  }
+
+  // Every clone falls through to the next one and the last one returns to
+  // the check.
+  for (unsigned Iteration = 0, E = Latches.size(); Iteration != E;
+       ++Iteration) {
+    auto *Backedge = cast<BranchInst>(Latches[Iteration]->getTerminator());
+    auto *Next = Iteration + 1 == E ? Check : Headers[Iteration + 1];
+    SILBuilder(Backedge).createBranch(Backedge->getLoc(), Next,
+                                      Backedge->getArgs());
+    Backedge->eraseFromParent();
+  }
+
+  // Only enter the unrolled body if the induction variable will not reach
+  // the end value within it. The subtraction may wrap if the range is huge;
+  // the original loop handles that case.
+  SILBuilder B(Check);
+  auto Loc = ExitBr->getLoc();
+  auto &Ctx = Mod.getASTContext();
+  SILType IntTy = IndVar->getType();
+  SILType Int1Ty = SILType::getBuiltinIntegerType(1, Ctx);
+  SILValue Cur = CheckArgs[IndVar->getIndex()];
+  SILValue InRange = B.createBuiltinBinaryFunction(Loc, "cmp_slt", IntTy,
+                                                   Int1Ty, {Cur, End});
+  SILValue Remaining = B.createBuiltinBinaryFunction(Loc, "sub", IntTy, IntTy,
+                                                     {End, Cur});
+  SILValue FactorVal = B.createIntegerLiteral(Loc, IntTy, Factor);
+  SILValue Enough = B.createBuiltinBinaryFunction(
+      Loc, "cmp_sgt", IntTy, Int1Ty, {Remaining, FactorVal});
+  SILValue EnterBody = B.createBuiltinBinaryFunction(Loc, "and", Int1Ty,
+                                                     Int1Ty, {InRange, Enough});
+  B.createCondBranch(Loc, EnterBody, Headers[0], CheckArgs, Header, CheckArgs);
+
+  SILBuilder(PreheaderBr)
+      .createBranch(PreheaderBr->getLoc(), Check, PreheaderBr->getArgs());
+  PreheaderBr->eraseFromParent();
+  return true;
+}
+
 // =============================================================================
 //                                 Driver
 // =============================================================================
@@ -423,8 +623,17 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
 namespace {
 
 class LoopUnrolling : public SILFunctionTransform {
+  /// Whether to partially unroll loops with runtime trip counts instead of
+  /// fully unrolling loops with constant trip counts.
+  bool Partial;
 
-  StringRef getName() override { return "SIL Loop Unrolling"; }
+public:
+  LoopUnrolling(bool Partial) : Partial(Partial) {}
+
+private:
+  StringRef getName() override {
+    return Partial ? "SIL Partial Loop Unrolling" : "SIL Loop Unrolling";
+  }
 
   void run() override {
     bool Changed = false;
@@ -449,7 +658,8 @@ class LoopUnrolling : public SILFunctionTransform {
 
     // Try to unroll innermost loops.
     for (auto *Loop : InnermostLoops)
-      Changed |= tryToUnrollLoop(Loop);
+      Changed |= Partial ? tryToPartiallyUnrollLoop(Loop)
+                         : tryToUnrollLoop(Loop);
 
     if (Changed) {
       invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
@@ -460,5 +670,9 @@ class LoopUnrolling : public SILFunctionTransform {
 } // end anonymous namespace.
 
 SILTransform *swift::createLoopUnroll() {
-  return new LoopUnrolling();
+  return new LoopUnrolling(/*Partial=*/false);
+}
+
+SILTransform *swift::createPartialLoopUnroll() {
+  return new LoopUnrolling(/*Partial=*/true);
 }
@@ -256,9 +256,17 @@ namespace {
     }
     
     void mergeIn(const AvailabilitySet &RHS) {
+      mergeIn(RHS, 0, size());
+    }
+
+    /// Merge in only the elements [FirstElt, FirstElt+NumElts) of RHS, so
+    /// that a query about a few fields of a large struct doesn't pay for all
+    /// of them.
+    void mergeIn(const AvailabilitySet &RHS, unsigned FirstElt,
+                 unsigned NumElts) {
       // Logically, this is an elementwise "this = merge(this, RHS)" operation,
       // using the lattice merge operation for each element.
-      for (unsigned i = 0, e = size(); i != e; ++i)
+      for (unsigned i = FirstElt, e = FirstElt+NumElts; i != e; ++i)
         set(i, mergeKinds(getConditional(i), RHS.getConditional(i)));
     }
 
@@ -512,7 +520,8 @@ namespace {
     typedef SmallVector<SILBasicBlock *, 16> WorkListType;
     void putIntoWorkList(SILBasicBlock *BB, WorkListType &WorkList);
     void computePredsLiveOut(SILBasicBlock *BB);
-    void getOutAvailability(SILBasicBlock *BB, AvailabilitySet &Result);
+    void getOutAvailability(SILBasicBlock *BB, AvailabilitySet &Result,
+                            unsigned FirstElt, unsigned NumElts);
     void getOutSelfConsumed(SILBasicBlock *BB, Optional<DIKind> &Result);
 
     bool shouldEmitError(SILInstruction *Inst);
@@ -2267,7 +2276,8 @@ computePredsLiveOut(SILBasicBlock *BB) {
 }
 
 void LifetimeChecker::
-getOutAvailability(SILBasicBlock *BB, AvailabilitySet &Result) {
+getOutAvailability(SILBasicBlock *BB, AvailabilitySet &Result,
+                   unsigned FirstElt, unsigned NumElts) {
   computePredsLiveOut(BB);
   
   for (auto Pred : BB->getPreds()) {
@@ -2280,7 +2290,7 @@ getOutAvailability(SILBasicBlock *BB, AvailabilitySet &Result) {
         *BBInfo.OutSelfConsumed == DIKind::Yes)
       continue;
 
-    Result.mergeIn(BBInfo.OutAvailability);
+    Result.mergeIn(BBInfo.OutAvailability, FirstElt, NumElts);
   }
   DEBUG(llvm::dbgs() << "    Result: " << Result << "\n");
 }
@@ -2337,7 +2347,7 @@ getLivenessAtInst(SILInstruction *Inst, unsigned FirstElt, unsigned NumElts) {
       }
     }
 
-    getOutAvailability(InstBB, Result);
+    getOutAvailability(InstBB, Result, 0, 1);
 
     // If the result element wasn't computed, we must be analyzing code within
     // an unreachable cycle that is not dominated by "TheMemory".  Just force
@@ -2390,7 +2400,8 @@ getLivenessAtInst(SILInstruction *Inst, unsigned FirstElt, unsigned NumElts) {
   }
 
   // Compute the liveness of each element according to our predecessors.
-  getOutAvailability(InstBB, Result);
+  // Only the requested elements are merged; the rest are left unknown.
+  getOutAvailability(InstBB, Result, FirstElt, NumElts);
   
   // If any of the elements was locally satisfied, make sure to mark them.
   for (unsigned i = FirstElt, e = i+NumElts; i != e; ++i) {
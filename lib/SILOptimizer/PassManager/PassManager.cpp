@@ -14,6 +14,7 @@
 
 #include "swift/SILOptimizer/PassManager/PassManager.h"
 #include "swift/Basic/DemangleWrappers.h"
+#include "swift/Basic/JSONSerialization.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
@@ -25,6 +26,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/TimeValue.h"
@@ -45,6 +47,11 @@ llvm::cl::opt<bool> SILPrintPassTime(
     "sil-print-pass-time", llvm::cl::init(false),
     llvm::cl::desc("Print the execution time of each SIL pass"));
 
+llvm::cl::opt<std::string> SILPassStats(
+    "sil-pass-stats", llvm::cl::init(""),
+    llvm::cl::desc("Write the time spent in and the changes made by each SIL "
+                   "pass to the given file as JSON"));
+
 llvm::cl::opt<unsigned> SILNumOptPassesToRun(
     "sil-opt-pass-count", llvm::cl::init(UINT_MAX),
     llvm::cl::desc("Stop optimizing after <N> optimization passes"));
@@ -231,6 +238,149 @@ public:
   }
 };
 
+namespace {
+
+/// The accumulated statistics of one pass.
+struct PassStatsRecord {
+  StringRef ID;
+  StringRef Tag;
+  /// The number of times the pass ran, counting each function separately
+  /// for function passes.
+  uint64_t Runs = 0;
+  /// The number of those runs that changed something.
+  uint64_t Changes = 0;
+  uint64_t Nanoseconds = 0;
+};
+
+/// The statistics of one iteration of a pipeline stage.
+struct StageStatsRecord {
+  std::string Name;
+  uint64_t InstructionsBefore = 0;
+  uint64_t InstructionsAfter = 0;
+  uint64_t Nanoseconds = 0;
+};
+
+/// The accumulated statistics of one analysis.
+struct AnalysisStatsRecord {
+  StringRef Name;
+  uint64_t Computations = 0;
+};
+
+/// What -sil-pass-stats reports. This is collected across all pass managers
+/// in the process and written out each time one of them is destroyed.
+struct PassStatistics {
+  std::vector<PassStatsRecord> Passes;
+  std::vector<StageStatsRecord> Stages;
+  std::vector<AnalysisStatsRecord> Analyses;
+
+  PassStatistics() {
+#define PASS(ID, TAG, DESCRIPTION)                                            \
+    Passes.emplace_back();                                                    \
+    Passes.back().ID = #ID;                                                   \
+    Passes.back().Tag = TAG;
+#include "swift/SILOptimizer/PassManager/Passes.def"
+
+#define ANALYSIS(NAME)                                                        \
+    Analyses.emplace_back();                                                  \
+    Analyses.back().Name = #NAME;
+#include "swift/SILOptimizer/Analysis/Analysis.def"
+  }
+
+  void recordPass(SILTransform *T, uint64_t Nanoseconds, bool Changed) {
+    PassStatsRecord &Record = Passes[(size_t)T->getPassKind()];
+    ++Record.Runs;
+    Record.Changes += Changed;
+    Record.Nanoseconds += Nanoseconds;
+  }
+
+  void recordAnalysis(SILAnalysis *A) {
+    Analyses[(size_t)A->getKind()].Computations += A->getNumComputations();
+  }
+
+  void write(StringRef Path);
+};
+
+} // end anonymous namespace
+
+static llvm::ManagedStatic<PassStatistics> PassStats;
+
+namespace swift {
+namespace json {
+
+template <> struct ObjectTraits<PassStatsRecord> {
+  static void mapping(Output &out, PassStatsRecord &Record) {
+    out.mapRequired("pass", Record.ID);
+    out.mapRequired("tag", Record.Tag);
+    out.mapRequired("runs", Record.Runs);
+    out.mapRequired("changes", Record.Changes);
+    out.mapRequired("time-ns", Record.Nanoseconds);
+  }
+};
+
+template <> struct ObjectTraits<StageStatsRecord> {
+  static void mapping(Output &out, StageStatsRecord &Record) {
+    out.mapRequired("stage", Record.Name);
+    out.mapRequired("instructions-before", Record.InstructionsBefore);
+    out.mapRequired("instructions-after", Record.InstructionsAfter);
+    out.mapRequired("time-ns", Record.Nanoseconds);
+  }
+};
+
+template <> struct ObjectTraits<AnalysisStatsRecord> {
+  static void mapping(Output &out, AnalysisStatsRecord &Record) {
+    out.mapRequired("analysis", Record.Name);
+    out.mapRequired("computations", Record.Computations);
+  }
+};
+
+template <> struct ObjectTraits<PassStatistics> {
+  static void mapping(Output &out, PassStatistics &Stats) {
+    out.mapRequired("passes", Stats.Passes);
+    out.mapRequired("stages", Stats.Stages);
+    out.mapRequired("analyses", Stats.Analyses);
+  }
+};
+
+} // end namespace json
+} // end namespace swift
+
+void PassStatistics::write(StringRef Path) {
+  std::error_code EC;
+  llvm::raw_fd_ostream OS(Path, EC, llvm::sys::fs::F_None);
+  if (EC) {
+    llvm::errs() << "error: cannot write SIL pass statistics to '" << Path
+                 << "': " << EC.message() << '\n';
+    return;
+  }
+
+  // Leave out the passes that never ran.
+  PassStatistics Ran;
+  Ran.Passes.clear();
+  for (auto &Record : Passes)
+    if (Record.Runs)
+      Ran.Passes.push_back(Record);
+  Ran.Stages = Stages;
+  Ran.Analyses = Analyses;
+
+  json::Output Out(OS);
+  Out << Ran;
+  OS << '\n';
+}
+
+static uint64_t nanosecondsSince(llvm::sys::TimeValue StartTime) {
+  llvm::sys::TimeValue Delta = llvm::sys::TimeValue::now() - StartTime;
+  return uint64_t(Delta.seconds()) *
+           llvm::sys::TimeValue::NANOSECONDS_PER_SECOND +
+         Delta.nanoseconds();
+}
+
+static uint64_t countInstructions(SILModule &M) {
+  uint64_t Count = 0;
+  for (auto &F : M)
+    for (auto &BB : F)
+      Count += std::distance(BB.begin(), BB.end());
+  return Count;
+}
 
 SILPassManager::SILPassManager(SILModule *M, llvm::StringRef Stage) :
   Mod(M), StageName(Stage) {
@@ -336,11 +486,13 @@ void SILPassManager::runPassesOnFunction(PassList FuncTransforms,
     // to the top of our worklist?
     bool newFunctionsAdded = (F != FunctionWorklist.back());
 
-    if (SILPrintPassTime) {
-      auto Delta =
-          llvm::sys::TimeValue::now().nanoseconds() - StartTime.nanoseconds();
-      llvm::dbgs() << Delta << " (" << SFT->getName() << "," << F->getName()
-                   << ")\n";
+    if (SILPrintPassTime || !SILPassStats.empty()) {
+      auto Delta = nanosecondsSince(StartTime);
+      if (SILPrintPassTime)
+        llvm::dbgs() << Delta << " (" << SFT->getName() << "," << F->getName()
+                     << ")\n";
+      if (!SILPassStats.empty())
+        PassStats->recordPass(SFT, Delta, CurrentPassHasInvalidated);
     }
 
     // If this pass invalidated anything, print and verify.
@@ -507,10 +659,12 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
   Mod->removeDeleteNotificationHandler(SMT);
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
 
-  if (SILPrintPassTime) {
-    auto Delta = llvm::sys::TimeValue::now().nanoseconds() -
-      StartTime.nanoseconds();
-    llvm::dbgs() << Delta << " (" << SMT->getName() << ",Module)\n";
+  if (SILPrintPassTime || !SILPassStats.empty()) {
+    auto Delta = nanosecondsSince(StartTime);
+    if (SILPrintPassTime)
+      llvm::dbgs() << Delta << " (" << SMT->getName() << ",Module)\n";
+    if (!SILPassStats.empty())
+      PassStats->recordPass(SMT, Delta, CurrentPassHasInvalidated);
   }
 
   // If this pass invalidated anything, print and verify.
@@ -544,6 +698,14 @@ void SILPassManager::runOneIteration() {
   NumOptimizationIterations++;
   SmallVector<SILFunctionTransform*, 16> PendingFuncTransforms;
 
+  StageStatsRecord StageStats;
+  llvm::sys::TimeValue StartTime;
+  if (!SILPassStats.empty()) {
+    StageStats.Name = StageName;
+    StageStats.InstructionsBefore = countInstructions(*Mod);
+    StartTime = llvm::sys::TimeValue::now();
+  }
+
   // Run the transforms by alternating between function transforms and
   // module transforms. We'll queue up all the function transforms
   // that we see in a row and then run the entire group of transforms
@@ -570,6 +732,12 @@ void SILPassManager::runOneIteration() {
       ++NumPassesRun;
     }
   }
+
+  if (!SILPassStats.empty()) {
+    StageStats.Nanoseconds = nanosecondsSince(StartTime);
+    StageStats.InstructionsAfter = countInstructions(*Mod);
+    PassStats->Stages.push_back(std::move(StageStats));
+  }
 }
 
 void SILPassManager::run() {
@@ -608,11 +776,16 @@ SILPassManager::~SILPassManager() {
 
   // delete the analysis.
   for (auto A : Analysis) {
+    if (!SILPassStats.empty())
+      PassStats->recordAnalysis(A);
     Mod->removeDeleteNotificationHandler(A);
     assert(!A->isLocked() &&
            "Deleting a locked analysis. Did we forget to unlock ?");
     delete A;
   }
+
+  if (!SILPassStats.empty())
+    PassStats->write(SILPassStats);
 }
 
 void SILPassManager::restartWithCurrentFunction(SILTransform *T) {
@@ -134,6 +134,10 @@ void AddSimplifyCFGSILCombine(SILPassManager &PM) {
 
 /// Perform semantic annotation/loop base optimizations.
 void AddHighLevelLoopOptPasses(SILPassManager &PM) {
+  // Unrolling trades code size for speed, which -Osize doesn't want.
+  bool OptimizeForSize = PM.getOptions().Optimization ==
+                         SILOptions::SILOptMode::OptimizeForSize;
+
   // Perform classic SSA optimizations for cleanup.
   PM.addLowerAggregateInstrs();
   PM.addSILCombine();
@@ -157,7 +161,8 @@ void AddHighLevelLoopOptPasses(SILPassManager &PM) {
   PM.addArrayCountPropagation();
   // To simplify induction variable.
   PM.addSILCombine();
-  PM.addLoopUnroll();
+  if (!OptimizeForSize)
+    PM.addLoopUnroll();
   PM.addSimplifyCFG();
   PM.addPerformanceConstantPropagation();
   PM.addSimplifyCFG();
@@ -170,6 +175,12 @@ void AddHighLevelLoopOptPasses(SILPassManager &PM) {
   PM.addCOWArrayOpts();
   // Cleanup.
   PM.addDCE();
+  // Unroll loops with runtime trip counts once bounds checks and uniqueness
+  // checks have been hoisted out of them.
+  if (!OptimizeForSize)
+    PM.addPartialLoopUnroll();
+  PM.addSimplifyCFG();
+  PM.addDCE();
   PM.addSwiftArrayOpts();
 }
 
@@ -328,6 +339,10 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   // take advantage of static dispatch.
   PM.addCapturePropagation();
 
+  // Specialize functions for constant call site arguments. Like
+  // CapturePropagation this should run after specialization and inlining.
+  PM.addConstantArgumentPropagation();
+
   // Specialize closure.
   PM.addClosureSpecializer();
 
@@ -388,6 +403,10 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   // after FSO.
   PM.addLateReleaseHoisting();
 
+  // Now that the ARC optimizations are done, use non-atomic reference
+  // counting for objects which never leave the current thread.
+  PM.addNonAtomicRC();
+
   PM.runOneIteration();
 
   PM.resetAndRemoveTransformations();
@@ -421,6 +440,20 @@ void swift::runSILPassesForOnone(SILModule &Module) {
   PM.run();
   PM.resetAndRemoveTransformations();
 
+  // At -Odebug run a few cheap optimizations which neither shorten variable
+  // lifetimes nor remove debug info: specialize the remaining generic calls
+  // into the standard library and remove redundant retain/release pairs.
+  if (Module.getOptions().Optimization == SILOptions::SILOptMode::Debug) {
+    PM.setStageName("Odebug");
+    // The generic specializer links the callees it specializes on demand, so
+    // don't deserialize the transitive closure of everything the module
+    // references.
+    PM.addGenericSpecializer();
+    PM.addARCSequenceOpts();
+    PM.runOneIteration();
+    PM.resetAndRemoveTransformations();
+  }
+
   // Don't keep external functions from stdlib and other modules.
   // We don't want that our unoptimized version will be linked instead
   // of the optimized version from the stdlib.
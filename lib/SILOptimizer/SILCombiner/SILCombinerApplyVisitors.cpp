@@ -44,8 +44,13 @@ static bool foldInverseReabstractionThunks(PartialApplyInst *PAI,
   if (!PAI2)
     return false;
 
-  if (!hasOneNonDebugUse(PAI2))
-    return false;
+  // Besides PAI, the only use of PAI2 may be the dealloc_ref [stack] of its
+  // context, which is removed together with it.
+  for (auto *Use : getNonDebugUses(PAI2)) {
+    auto *User = Use->getUser();
+    if (User != PAI && !isa<DeallocRefInst>(User))
+      return false;
+  }
 
   auto PAI2Arg = isPartialApplyOfReabstractionThunk(PAI2);
   if (!PAI2Arg)
@@ -57,6 +62,13 @@ static bool foldInverseReabstractionThunks(PartialApplyInst *PAI,
 
   // Replace the partial_apply(partial_apply(X)) by X and remove the
   // partial_applies.
+  InstModCallbacks Callbacks(
+      [Combiner](SILInstruction *DeadInst) {
+        Combiner->eraseInstFromFunction(*DeadInst);
+      },
+      [](SILInstruction *) {});
+  eraseClosureContextDeallocs(PAI, Callbacks);
+  eraseClosureContextDeallocs(PAI2, Callbacks);
 
   Combiner->replaceInstUsesWith(*PAI, PAI2->getArgument(0));
   Combiner->eraseInstFromFunction(*PAI);
@@ -69,9 +81,17 @@ static bool foldInverseReabstractionThunks(PartialApplyInst *PAI,
 SILInstruction *SILCombiner::visitPartialApplyInst(PartialApplyInst *PAI) {
   // partial_apply without any substitutions or arguments is just a
   // thin_to_thick_function.
-  if (!PAI->hasSubstitutions() && (PAI->getNumArguments() == 0))
+  if (!PAI->hasSubstitutions() && (PAI->getNumArguments() == 0)) {
+    // There is no context, so there is nothing to deallocate either.
+    eraseClosureContextDeallocs(
+        PAI, InstModCallbacks(
+                 [this](SILInstruction *DeadInst) {
+                   eraseInstFromFunction(*DeadInst);
+                 },
+                 [](SILInstruction *) {}));
     return Builder.createThinToThickFunction(PAI->getLoc(), PAI->getCallee(),
                                              PAI->getType());
+  }
 
   // partial_apply %reabstraction_thunk_typeAtoB(
   //    partial_apply %reabstraction_thunk_typeBtoA %closure_typeB))
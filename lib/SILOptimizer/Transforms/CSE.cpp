@@ -347,6 +347,14 @@ public:
     return llvm::hash_combine(X->getKind(), X->getOperand(), X->getType());
   }
 
+  hash_code visitThinToThickFunctionInst(ThinToThickFunctionInst *X) {
+    return llvm::hash_combine(X->getKind(), X->getOperand(), X->getType());
+  }
+
+  hash_code visitConvertFunctionInst(ConvertFunctionInst *X) {
+    return llvm::hash_combine(X->getKind(), X->getOperand(), X->getType());
+  }
+
   hash_code visitPointerToThinFunctionInst(PointerToThinFunctionInst *X) {
     return llvm::hash_combine(X->getKind(), X->getOperand(), X->getType());
   }
@@ -863,6 +871,8 @@ bool CSE::canHandle(SILInstruction *Inst) {
     case ValueKind::BridgeObjectToWordInst:
     case ValueKind::ThinFunctionToPointerInst:
     case ValueKind::PointerToThinFunctionInst:
+    case ValueKind::ThinToThickFunctionInst:
+    case ValueKind::ConvertFunctionInst:
     case ValueKind::MarkDependenceInst:
     case ValueKind::OpenExistentialRefInst:
       return true;
@@ -162,12 +162,20 @@ namespace {
 ///
 /// we could run DSE on functions with 256 basic blocks and 256 locations,
 /// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 256*256;
+llvm::cl::opt<unsigned> MaxLSLocationBBMultiplicationNone(
+    "dse-max-location-bb-multiplication", llvm::cl::init(256*256),
+    llvm::cl::Hidden);
 
 /// we could run optimistic DSE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
 constexpr unsigned MaxLSLocationBBMultiplicationPessimistic = 64*64;
 
+/// Past MaxLSLocationBBMultiplicationNone we still remove stores that are
+/// dead within their own basic block, which takes time linear in the size of
+/// the function. The bit vectors kept for each basic block still grow with
+/// # of BBs x # of locations, so give up entirely past this.
+constexpr unsigned MaxLSLocationBBMultiplicationLocal = 1024*1024;
+
 /// forward declaration.
 class DSEContext;
 /// BlockState summarizes how LSLocations are used in a basic block.
@@ -265,8 +273,6 @@ public:
   void stopTrackingLocation(llvm::SmallBitVector &BV, unsigned bit);
   bool isTrackingLocation(llvm::SmallBitVector &BV, unsigned bit);
 
-  /// Set the store bit for stack slot deallocated in this basic block. 
-  void initStoreSetAtEndOfBlock(DSEContext &Ctx);
 };
 
 } // end anonymous namespace
@@ -303,7 +309,8 @@ class DSEContext {
 enum class ProcessKind {
   ProcessOptimistic = 0,
   ProcessPessimistic = 1,
-  ProcessNone = 2,
+  ProcessLocal = 2,
+  ProcessNone = 3,
 }; 
 
 private:
@@ -451,7 +458,14 @@ public:
 
   /// Compute the kill set for the basic block. return true if the store set
   /// changes.
-  void processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic);
+  ///
+  /// If \p Local is true, the successors are not looked at, and only stores
+  /// that are dead within the basic block are found.
+  void processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic, bool Local);
+
+  /// Set the store bit for stack slots at the end of the basic blocks where
+  /// they are deallocated.
+  void initStoreSetAtEndOfBlocks();
 
   /// Compute the genset and killset for the current basic block.
   void processBasicBlockForGenKillSet(SILBasicBlock *BB);
@@ -542,9 +556,13 @@ DSEContext::ProcessKind DSEContext::getProcessFunctionKind(unsigned StoreCount)
     HandledBBs.insert(B);
   }
 
-  // Data flow may take too long to run.
-  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone)
-    return ProcessKind::ProcessNone;
+  // Data flow may take too long to run. Only look for stores that are dead
+  // within their basic block.
+  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone) {
+    if (BBCount * LocationCount > MaxLSLocationBBMultiplicationLocal)
+      return ProcessKind::ProcessNone;
+    return ProcessKind::ProcessLocal;
+  }
 
   // This function's data flow would converge in 1 iteration.
   if (RunOneIteration)
@@ -616,7 +634,8 @@ bool DSEContext::processBasicBlockWithGenKillSet(SILBasicBlock *BB) {
   return S->updateBBWriteSetIn(S->BBWriteSetMid);
 }
 
-void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic) {
+void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic,
+                                         bool Local) {
   // If we know this is not a one iteration function which means its
   // its BBWriteSetIn and BBWriteSetOut have been computed and converged, 
   // and this basic block does not even have StoreInsts, there is no point
@@ -627,10 +646,18 @@ void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic) {
 
   // Intersect in the successor WriteSetIns. A store is dead if it is not read
   // from any path to the end of the program. Thus an intersection.
-  mergeSuccessorLiveIns(BB);
+  //
+  // When only looking within the basic block, assume every location may be
+  // read after it, except for stack slots deallocated in it.
+  BlockState *S = getBlockState(BB);
+  if (Local) {
+    S->BBWriteSetOut.reset();
+    S->BBWriteSetOut |= S->BBDeallocateLocation;
+  } else {
+    mergeSuccessorLiveIns(BB);
+  }
 
   // Initialize the BBWriteSetMid to BBWriteSetOut to get started.
-  BlockState *S = getBlockState(BB);
   S->BBWriteSetMid = S->BBWriteSetOut;
 
   // Process instructions in post-order fashion.
@@ -647,19 +674,18 @@ void DSEContext::processBasicBlockForDSE(SILBasicBlock *BB, bool Optimistic) {
   S->BBWriteSetIn = S->BBWriteSetMid;
 }
 
-void BlockState::initStoreSetAtEndOfBlock(DSEContext &Ctx) {
-  std::vector<LSLocation> &LocationVault = Ctx.getLocationVault();
+void DSEContext::initStoreSetAtEndOfBlocks() {
   // We set the store bit at the end of the basic block in which a stack
-  // allocated location is deallocated.
+  // allocated location is deallocated. Walk the locations once rather than
+  // once per basic block, as large functions have many of both.
   for (unsigned i = 0; i < LocationVault.size(); ++i) {
+    auto *ASI = dyn_cast<AllocStackInst>(LocationVault[i].getBase());
+    if (!ASI)
+      continue;
     // Turn on the store bit at the block which the stack slot is deallocated.
-    if (auto *ASI = dyn_cast<AllocStackInst>(LocationVault[i].getBase())) {
-      for (auto X : findDeallocStackInst(ASI)) {
-        SILBasicBlock *DSIBB = X->getParent();
-        if (DSIBB != BB)
-          continue;
-        startTrackingLocation(BBDeallocateLocation, i);
-      }
+    for (auto X : findDeallocStackInst(ASI)) {
+      BlockState *S = getBlockState(X->getParent());
+      S->startTrackingLocation(S->BBDeallocateLocation, i);
     }
   }
 }
@@ -1149,6 +1175,9 @@ bool DSEContext::run() {
   // Do we run a pessimistic data flow ?
   bool Optimistic = Kind == ProcessKind::ProcessOptimistic ? true : false;
 
+  // Do we only look for dead stores within basic blocks ?
+  bool Local = Kind == ProcessKind::ProcessLocal;
+
   // For all basic blocks in the function, initialize a BB state.
   //
   // Initialize the BBToLocState mapping.
@@ -1156,8 +1185,8 @@ bool DSEContext::run() {
   for (auto &B : *F) {
     auto *State = new (BPA.Allocate()) BlockState(&B, LocationNum, Optimistic);
     BBToLocState[&B] = State;
-    State->initStoreSetAtEndOfBlock(*this);
   }
+  initStoreSetAtEndOfBlocks();
 
   // We perform dead store elimination in the following phases.
   //
@@ -1186,7 +1215,7 @@ bool DSEContext::run() {
   // Is this a one iteration function.
   auto *PO = PM->getAnalysis<PostOrderAnalysis>()->get(F);
   for (SILBasicBlock *B : PO->getPostOrder()) {
-    processBasicBlockForDSE(B, Optimistic);
+    processBasicBlockForDSE(B, Optimistic, Local);
   }
 
   // Finally, delete the dead stores and create the live stores.
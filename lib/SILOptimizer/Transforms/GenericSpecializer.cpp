@@ -19,6 +19,7 @@
 
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILInstruction.h"
+#include "swift/SIL/SILModule.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
@@ -68,7 +69,15 @@ bool GenericSpecializer::specializeAppliesInFunction(SILFunction &F) {
         continue;
 
       auto *Callee = Apply.getReferencedFunction();
-      if (!Callee || !Callee->isDefinition())
+      if (!Callee)
+        continue;
+
+      // Deserialize the body of the callee on demand, rather than relying
+      // on the whole module having been linked up front.
+      if (Callee->isExternalDeclaration())
+        F.getModule().linkFunction(Callee,
+                                   SILModule::LinkingMode::LinkNormal);
+      if (!Callee->isDefinition())
         continue;
 
       Applies.insert(Apply.getInstruction());
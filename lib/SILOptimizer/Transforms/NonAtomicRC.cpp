@@ -0,0 +1,89 @@
+//===--- NonAtomicRC.cpp - Use non-atomic RC for thread-local objects -----===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+///
+/// Marks reference counting instructions as non-atomic if the object they
+/// operate on cannot be seen by any other thread.
+///
+/// An object whose connection graph node does not escape the function, not
+/// even via the return value or an argument, must have been created in the
+/// function and can only be reached from the current thread. Retains and
+/// releases of such an object don't need to be atomic.
+///
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "non-atomic-rc"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SILOptimizer/Analysis/EscapeAnalysis.h"
+#include "swift/SIL/SILInstruction.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+STATISTIC(NumNonAtomicRC, "Number of reference counting instructions made "
+                          "non-atomic");
+
+using namespace swift;
+
+namespace {
+
+class NonAtomicRC : public SILFunctionTransform {
+
+  /// Returns true if \p RCI is one of the instructions this pass handles.
+  static bool isCandidate(RefCountingInst *RCI) {
+    if (RCI->isNonAtomic())
+      return false;
+    return isa<StrongRetainInst>(RCI) || isa<StrongReleaseInst>(RCI) ||
+           isa<RetainValueInst>(RCI) || isa<ReleaseValueInst>(RCI);
+  }
+
+  /// The entry point to the transformation.
+  void run() override {
+    SILFunction *F = getFunction();
+    DEBUG(llvm::dbgs() << "** NonAtomicRC in " << F->getName() << " **\n");
+
+    auto *EA = PM->getAnalysis<EscapeAnalysis>();
+    auto *ConGraph = EA->getConnectionGraph(F);
+    if (!ConGraph)
+      return;
+
+    bool Changed = false;
+    for (auto &BB : *F) {
+      for (auto &I : BB) {
+        auto *RCI = dyn_cast<RefCountingInst>(&I);
+        if (!RCI || !isCandidate(RCI))
+          continue;
+
+        // Values which are not pointers (e.g. trivial structs) don't have a
+        // node; leave those alone.
+        auto *Node = ConGraph->getNodeOrNull(RCI->getOperand(0), EA);
+        if (!Node || Node->escapes())
+          continue;
+
+        DEBUG(llvm::dbgs() << "  Making non-atomic: " << *RCI);
+        RCI->setNonAtomic();
+        ++NumNonAtomicRC;
+        Changed = true;
+      }
+    }
+
+    if (Changed)
+      invalidateAnalysis(SILAnalysis::InvalidationKind::Instructions);
+  }
+
+  StringRef getName() override { return "Non-Atomic Reference Counting"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createNonAtomicRC() {
+  return new NonAtomicRC();
+}
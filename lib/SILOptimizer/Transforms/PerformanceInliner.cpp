@@ -19,6 +19,7 @@
 #include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
 #include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Analysis/FunctionOrder.h"
+#include "swift/SILOptimizer/Analysis/InlineCostAnalysis.h"
 #include "swift/SILOptimizer/Analysis/LoopAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ArraySemantic.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
@@ -977,6 +978,7 @@ class SILPerformanceInliner {
 
   DominanceAnalysis *DA;
   SILLoopAnalysis *LA;
+  InlineCostAnalysis *ICA;
 
   // For keys of SILFunction and SILLoop.
   llvm::DenseMap<SILFunction *, ShortestPathAnalysis *> SPAs;
@@ -1060,8 +1062,8 @@ class SILPerformanceInliner {
 
 public:
   SILPerformanceInliner(InlineSelection WhatToInline, DominanceAnalysis *DA,
-                        SILLoopAnalysis *LA)
-      : WhatToInline(WhatToInline), DA(DA), LA(LA), CBI(DA) {}
+                        SILLoopAnalysis *LA, InlineCostAnalysis *ICA)
+      : WhatToInline(WhatToInline), DA(DA), LA(LA), ICA(ICA), CBI(DA) {}
 
   bool inlineCallsIntoFunction(SILFunction *F);
 };
@@ -1178,6 +1180,18 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
   if (Callee->getInlineStrategy() == AlwaysInline)
     return true;
 
+  // Only trivial functions are inlined into thunks. If the whole callee is
+  // trivial, no call-site specific pruning can change that, so skip the walk.
+  if (AI.getFunction()->isThunk() &&
+      ICA->get(Callee)->getTotalCost() <= TrivialFunctionThreshold) {
+    DEBUG(
+      dumpCaller(AI.getFunction());
+      llvm::dbgs() << "    decision {" << ICA->get(Callee)->getTotalCost()
+                   << " into thunk} " << Callee->getName() << '\n';
+    );
+    return true;
+  }
+
   SILLoopInfo *LI = LA->get(Callee);
   ShortestPathAnalysis *SPA = getSPA(Callee, LI);
   assert(SPA->isValid());
@@ -1199,6 +1213,9 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
   // increasing the code size too much.
   if (Opts.Optimization == SILOptions::SILOptMode::OptimizeUnchecked)
     BaseBenefit *= 2;
+  // With -Osize only inline callees that are cheap compared to the call.
+  else if (Opts.Optimization == SILOptions::SILOptMode::OptimizeForSize)
+    BaseBenefit /= 2;
 
   CallerWeight.updateBenefit(Benefit, BaseBenefit);
 
@@ -1301,15 +1318,10 @@ bool SILPerformanceInliner::isProfitableInColdBlock(FullApplySite AI,
   if (Callee->getInlineStrategy() == AlwaysInline)
     return true;
 
-  int CalleeCost = 0;
+  int CalleeCost = ICA->get(Callee)->getTotalCost();
+  if (CalleeCost > TrivialFunctionThreshold)
+    return false;
 
-  for (SILBasicBlock &Block : *Callee) {
-    for (SILInstruction &I : Block) {
-      CalleeCost += int(instructionInlineCost(I));
-      if (CalleeCost > TrivialFunctionThreshold)
-        return false;
-    }
-  }
   DEBUG(
     dumpCaller(AI.getFunction());
     llvm::dbgs() << "    cold decision {" << CalleeCost << "} " <<
@@ -1385,6 +1397,11 @@ void SILPerformanceInliner::collectAppliesToInline(
   DominanceOrder domOrder(&Caller->front(), DT, Caller->size());
   int NumCallerBlocks = (int)Caller->size();
 
+  // If the profile shows that the caller is never entered, treat all of it
+  // like a cold block.
+  auto EntryCount = Caller->getEntryCount();
+  bool IsColdCaller = EntryCount && *EntryCount == 0;
+
   // Go through all instructions and find candidates for inlining.
   // We do this in dominance order for the constTracker.
   SmallVector<FullApplySite, 8> InitialCandidates;
@@ -1408,7 +1425,11 @@ void SILPerformanceInliner::collectAppliesToInline(
         // The actual weight including a possible weight correction.
         Weight W(BlockWeight, WeightCorrections.lookup(AI));
 
-        if (isProfitableToInline(AI, W, constTracker, NumCallerBlocks))
+        bool IsProfitable =
+            IsColdCaller ? isProfitableInColdBlock(AI, Callee)
+                         : isProfitableToInline(AI, W, constTracker,
+                                                NumCallerBlocks);
+        if (IsProfitable)
           InitialCandidates.push_back(AI);
       }
     }
@@ -1547,12 +1568,13 @@ public:
   void run() override {
     DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
     SILLoopAnalysis *LA = PM->getAnalysis<SILLoopAnalysis>();
+    InlineCostAnalysis *ICA = PM->getAnalysis<InlineCostAnalysis>();
 
     if (getOptions().InlineThreshold == 0) {
       return;
     }
 
-    SILPerformanceInliner Inliner(WhatToInline, DA, LA);
+    SILPerformanceInliner Inliner(WhatToInline, DA, LA, ICA);
 
     assert(getFunction()->isDefinition() &&
            "Expected only functions with bodies!");
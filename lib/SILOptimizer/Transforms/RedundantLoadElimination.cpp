@@ -176,12 +176,20 @@ namespace {
 ///
 /// we could run RLE on functions with 128 basic blocks and 128 locations,
 /// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 128*128;
+llvm::cl::opt<unsigned> MaxLSLocationBBMultiplicationNone(
+    "rle-max-location-bb-multiplication", llvm::cl::init(128*128),
+    llvm::cl::Hidden);
 
 /// we could run optimistic RLE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
 constexpr unsigned MaxLSLocationBBMultiplicationPessimistic = 64*64;
 
+/// Past MaxLSLocationBBMultiplicationNone we still forward values within
+/// basic blocks, which takes time linear in the size of the function. The
+/// bit vectors kept for each basic block still grow with # of BBs x # of
+/// locations, so give up entirely past this.
+constexpr unsigned MaxLSLocationBBMultiplicationLocal = 1024*1024;
+
 /// forward declaration.
 class RLEContext;
 
@@ -328,6 +336,13 @@ public:
   /// Initialize the AvailSet and AvailVal of the current basic block.
   void mergePredecessorAvailSetAndValue(RLEContext &Ctx);
 
+  /// Clear the AvailSet and AvailVal of the current basic block, as if it had
+  /// no predecessors. Used when only forwarding within basic blocks.
+  void clearAvailSetAndValue() {
+    ForwardSetIn.reset();
+    ForwardValIn.clear();
+  }
+
   /// Reached the end of the basic block, update the ForwardValOut with the
   /// ForwardValIn.
   void updateForwardValOut() { ForwardValOut = ForwardValIn; }
@@ -418,7 +433,8 @@ class RLEContext {
   enum class ProcessKind {
     ProcessMultipleIterations = 0,
     ProcessOneIteration = 1,
-    ProcessNone = 2,
+    ProcessLocal = 2,
+    ProcessNone = 3,
   }; 
 private:
   /// Function currently processing.
@@ -509,7 +525,10 @@ public:
   void processBasicBlocksForAvailValue();
 
   /// Process basic blocks to perform the redundant load elimination.
-  void processBasicBlocksForRLE(bool Optimistic);
+  ///
+  /// If \p Local is true, nothing is assumed to be available at the beginning
+  /// of a basic block, and only loads made redundant within it are removed.
+  void processBasicBlocksForRLE(bool Optimistic, bool Local);
 
   /// Returns the alias analysis we will use during all computations.
   AliasAnalysis *getAA() const { return AA; }
@@ -1104,9 +1123,13 @@ getProcessFunctionKind(unsigned LoadCount, unsigned StoreCount) {
     HandledBBs.insert(B);
   }
 
-  // Data flow may take too long to run.
-  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone)
-    return ProcessKind::ProcessNone;
+  // Data flow may take too long to run. Only forward values within basic
+  // blocks.
+  if (BBCount * LocationCount > MaxLSLocationBBMultiplicationNone) {
+    if (BBCount * LocationCount > MaxLSLocationBBMultiplicationLocal)
+      return ProcessKind::ProcessNone;
+    return ProcessKind::ProcessLocal;
+  }
 
   // This function's data flow would converge in 1 iteration.
   if (RunOneIteration)
@@ -1384,7 +1407,7 @@ void RLEContext::processBasicBlocksForAvailValue() {
   }
 }
 
-void RLEContext::processBasicBlocksForRLE(bool Optimistic) {
+void RLEContext::processBasicBlocksForRLE(bool Optimistic, bool Local) {
   for (SILBasicBlock *BB : PO->getReversePostOrder()) {
     // If we know this is not a one iteration function which means its
     // forward sets have been computed and converged, 
@@ -1399,14 +1422,18 @@ void RLEContext::processBasicBlocksForRLE(bool Optimistic) {
     // Merge the predecessors. After merging, BlockState now contains
     // lists of available LSLocations and their values that reach the
     // beginning of the basic block along all paths.
-    Forwarder.mergePredecessorAvailSetAndValue(*this);
+    if (Local)
+      Forwarder.clearAvailSetAndValue();
+    else
+      Forwarder.mergePredecessorAvailSetAndValue(*this);
 
     // Perform the actual redundant load elimination.
     Forwarder.processBasicBlockWithKind(*this, RLEKind::PerformRLE);
 
     // If this is not a one iteration data flow, then the forward sets
-    // have been computed.
-    if (Optimistic)
+    // have been computed. If we only forward within basic blocks, nothing
+    // reads them.
+    if (Optimistic || Local)
       continue;
 
     // Update the locations with available values and their values.
@@ -1482,7 +1509,7 @@ bool RLEContext::run() {
 
   // We have the available value bit computed and the local forwarding value.
   // Set up the load forwarding.
-  processBasicBlocksForRLE(Optimistic);
+  processBasicBlocksForRLE(Optimistic, Kind == ProcessKind::ProcessLocal);
 
   // Finally, perform the redundant load replacements.
   llvm::DenseSet<SILInstruction *> InstsToDelete;
@@ -96,6 +96,15 @@ STATISTIC(NumReleasesHoisted, "Number of releases hoisted");
 llvm::cl::opt<bool> DisableRRCodeMotion("disable-rr-cm", llvm::cl::init(false));
 llvm::cl::opt<bool> DisableIfWithCriticalEdge("disable-with-critical-edge", llvm::cl::init(false));
 
+/// The data flow keeps one bit per RC root per basic block and computing the
+/// genset and killset queries alias analysis for every root at every
+/// instruction. Skip functions whose number of RC roots times number of basic
+/// blocks exceeds this budget.
+llvm::cl::opt<unsigned> RRCodeMotionMaxDataFlowSize(
+    "rr-cm-max-data-flow-size", llvm::cl::init(1000000),
+    llvm::cl::desc("Maximum number of RC roots times basic blocks retain "
+                   "release code motion processes in a function"));
+
 //===----------------------------------------------------------------------===//
 //                             Utility 
 //===----------------------------------------------------------------------===//
@@ -190,6 +199,17 @@ protected:
   /// we compute the genset and killset.
   llvm::SmallPtrSet<SILBasicBlock *, 8> InterestBlocks;
 
+  /// Return true if the data flow over the collected RC roots would exceed
+  /// the size budget of the pass.
+  bool isDataFlowTooLarge() const {
+    uint64_t Size = uint64_t(RCRootVault.size()) * F->size();
+    if (Size <= RRCodeMotionMaxDataFlowSize)
+      return false;
+    DEBUG(llvm::dbgs() << "Skipping RRCM, " << RCRootVault.size()
+                       << " RC roots in " << F->size() << " blocks\n");
+    return true;
+  }
+
   /// Return the rc-identity root of the SILValue.
   SILValue getRCRoot(SILValue R) {
      return RCFI->getRCIdentityRoot(R);
@@ -220,8 +240,9 @@ public:
   /// or a pessimistic would suffice.
   virtual bool requireIteration() = 0;
 
-  /// Initialize necessary things to run the iterative data flow.
-  virtual void initializeCodeMotionDataFlow() = 0;
+  /// Initialize necessary things to run the iterative data flow. Return false
+  /// if the function is too large to run the data flow on.
+  virtual bool initializeCodeMotionDataFlow() = 0;
 
   /// Initialize the basic block maximum refcounted set.
   virtual void initializeCodeMotionBBMaxSet() = 0;
@@ -250,8 +271,9 @@ public:
 };
 
 bool CodeMotionContext::run() {
-  // Initialize the data flow.
-  initializeCodeMotionDataFlow();
+  // Initialize the data flow. Leave the function alone if it is too large.
+  if (!initializeCodeMotionDataFlow())
+    return false;
 
   // Converge the BBSetOut with iterative data flow.
   if (MultiIteration) {
@@ -338,7 +360,7 @@ public:
   bool requireIteration();
 
   /// Initialize necessary things to run the iterative data flow.
-  void initializeCodeMotionDataFlow();
+  bool initializeCodeMotionDataFlow();
 
   /// Initialize the basic block maximum refcounted set.
   void initializeCodeMotionBBMaxSet();
@@ -379,7 +401,7 @@ bool RetainCodeMotionContext::requireIteration() {
   return false;
 }
 
-void RetainCodeMotionContext::initializeCodeMotionDataFlow() {
+bool RetainCodeMotionContext::initializeCodeMotionDataFlow() {
   // Find all the RC roots in the function.
   for (auto &BB : *F) {
     for (auto &II : BB) {
@@ -394,11 +416,16 @@ void RetainCodeMotionContext::initializeCodeMotionDataFlow() {
     }
   }
 
+  // Bail out before allocating the per-block bit vectors.
+  if (isDataFlowTooLarge())
+    return false;
+
   // Initialize all the data flow bit vector for all basic blocks.
   for (auto &BB : *F) {
     BlockStates[&BB] = new (BPA.Allocate()) RetainBlockState(&BB == &*F->begin(),
                                  RCRootVault.size(), MultiIteration);
   }
+  return true;
 }
 
 void RetainCodeMotionContext::initializeCodeMotionBBMaxSet() {
@@ -667,7 +694,7 @@ public:
   bool requireIteration(); 
 
   /// Initialize necessary things to run the iterative data flow.
-  void initializeCodeMotionDataFlow();
+  bool initializeCodeMotionDataFlow();
 
   /// Initialize the basic block maximum refcounted set.
   void initializeCodeMotionBBMaxSet();
@@ -708,7 +735,7 @@ bool ReleaseCodeMotionContext::requireIteration() {
   return false;
 }
 
-void ReleaseCodeMotionContext::initializeCodeMotionDataFlow() {
+bool ReleaseCodeMotionContext::initializeCodeMotionDataFlow() {
   // Find all the RC roots in the function.
   for (auto &BB : *F) {
     for (auto &II : BB) {
@@ -726,6 +753,10 @@ void ReleaseCodeMotionContext::initializeCodeMotionDataFlow() {
     }
   }
 
+  // Bail out before allocating the per-block bit vectors.
+  if (isDataFlowTooLarge())
+    return false;
+
   // Initialize all the data flow bit vector for all basic blocks.
   llvm::SmallPtrSet<SILBasicBlock *, 2> Exits;
   auto Return = F->findReturnBB();
@@ -738,6 +769,7 @@ void ReleaseCodeMotionContext::initializeCodeMotionDataFlow() {
     BlockStates[&BB] = new (BPA.Allocate()) ReleaseBlockState(Exits.count(&BB),
                                             RCRootVault.size(), MultiIteration);
   }
+  return true;
 }
 
 void ReleaseCodeMotionContext::initializeCodeMotionBBMaxSet() {
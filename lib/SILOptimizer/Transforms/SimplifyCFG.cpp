@@ -73,6 +73,9 @@ namespace {
 
     bool ShouldVerify;
     bool EnableJumpThread;
+
+    /// Set by run() if it changed the CFG, and not just instructions.
+    bool ChangedCFG = false;
   public:
     SimplifyCFG(SILFunction &Fn, SILPassManager *PM, bool Verify,
                 bool EnableJumpThread)
@@ -80,6 +83,8 @@ namespace {
           EnableJumpThread(EnableJumpThread) {}
 
     bool run();
+
+    bool hasChangedCFG() const { return ChangedCFG; }
     
     bool simplifyBlockArgs() {
       auto *DA = PM->getAnalysis<DominanceAnalysis>();
@@ -2712,11 +2717,22 @@ bool SimplifyCFG::run() {
 
   DEBUG(llvm::dbgs() << "### Run SimplifyCFG on " << Fn.getName() << '\n');
 
+  // The CFG analyses are up to date for this CFG. Any change to it makes
+  // them stale, even if a later simplification restores the original shape
+  // after the dominator tree was recomputed.
+  CFGSignature InitialCFG(Fn);
+  ChangedCFG = false;
+
   RemoveUnreachable RU(Fn);
 
   // First remove any block not reachable from the entry.
   bool Changed = RU.run();
 
+  auto noteCFGChanges = [&]() {
+    if (Changed && !ChangedCFG)
+      ChangedCFG = CFGSignature(Fn) != InitialCFG;
+  };
+
   // Find the set of loop headers. We don't want to jump-thread through headers.
   findLoopHeaders();
 
@@ -2736,12 +2752,14 @@ bool SimplifyCFG::run() {
   // Do simplifications that require the dominator tree to be accurate.
   DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
 
-  if (Changed) {
+  noteCFGChanges();
+  if (ChangedCFG) {
     // Force dominator recomputation since we modified the cfg.
     DA->invalidate(&Fn, SILAnalysis::InvalidationKind::Everything);
   }
 
   Changed |= dominatorBasedSimplify(DA);
+  noteCFGChanges();
 
   DT = nullptr;
   // Now attempt to simplify the remaining blocks.
@@ -2763,7 +2781,10 @@ bool SimplifyCFG::run() {
 
   // Canonicalize switch_enum instructions.
   Changed |= canonicalizeSwitchEnums();
-  
+
+  // Many runs only simplify block arguments and terminator operands. Let the
+  // caller keep the CFG analyses in that case.
+  noteCFGChanges();
   return Changed;
 }
 
@@ -3430,10 +3451,15 @@ public:
 
   /// The entry point to the transformation.
   void run() override {
-    if (SimplifyCFG(*getFunction(), PM, getOptions().VerifyAll,
-                    EnableJumpThread)
-            .run())
+    SimplifyCFG SCFG(*getFunction(), PM, getOptions().VerifyAll,
+                     EnableJumpThread);
+    if (!SCFG.run())
+      return;
+
+    if (SCFG.hasChangedCFG())
       invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+    else
+      invalidateAnalysis(SILAnalysis::InvalidationKind::CallsAndInstructions);
   }
 
   StringRef getName() override { return "Simplify CFG"; }
@@ -32,6 +32,7 @@
 #include "swift/SILOptimizer/Utils/Devirtualize.h"
 #include "swift/SILOptimizer/Utils/SILInliner.h"
 #include "swift/AST/ASTContext.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/Statistic.h"
@@ -309,6 +310,48 @@ static bool isDefaultCaseKnown(ClassHierarchyAnalysis *CHA,
   return true;
 }
 
+/// Return the profiled entry count of the implementation of \p CMI's method
+/// in the class \p CD, if there is one.
+static Optional<uint64_t> getProfiledEntryCount(SILModule &M,
+                                                ClassMethodInst *CMI,
+                                                ClassDecl *CD) {
+  if (auto *F = M.lookUpFunctionInVTable(CD, CMI->getMember()))
+    return F->getEntryCount();
+  return None;
+}
+
+/// Order \p Subs so that the subclasses whose implementation of \p CMI's
+/// method the profile shows to be entered most often are tested first.
+/// Subclasses whose implementation was never entered are moved to
+/// \p ColdSubs. Without profile data, the order is left unchanged.
+static void sortSubclassesByProfile(SILModule &M, ClassMethodInst *CMI,
+                                    SmallVectorImpl<ClassDecl *> &Subs,
+                                    SmallVectorImpl<ClassDecl *> &ColdSubs) {
+  llvm::DenseMap<ClassDecl *, uint64_t> Counts;
+  for (auto S : Subs)
+    if (auto Count = getProfiledEntryCount(M, CMI, S))
+      Counts[S] = *Count;
+  if (Counts.empty())
+    return;
+
+  auto ColdIt = std::stable_partition(Subs.begin(), Subs.end(),
+                                      [&Counts](ClassDecl *S) {
+    auto It = Counts.find(S);
+    return It == Counts.end() || It->second != 0;
+  });
+  ColdSubs.append(ColdIt, Subs.end());
+  Subs.erase(ColdIt, Subs.end());
+
+  // Subclasses without a count keep their place behind the profiled ones.
+  std::stable_sort(Subs.begin(), Subs.end(),
+                   [&Counts](ClassDecl *LHS, ClassDecl *RHS) {
+    auto L = Counts.find(LHS), R = Counts.find(RHS);
+    if (R == Counts.end())
+      return L != Counts.end();
+    return L != Counts.end() && L->second > R->second;
+  });
+}
+
 /// \brief Try to speculate the call target for the call \p AI. This function
 /// returns true if a change was made.
 static bool tryToSpeculateTarget(FullApplySite AI,
@@ -342,6 +385,18 @@ static bool tryToSpeculateTarget(FullApplySite AI,
   ClassDecl *CD = ClassType.getClassOrBoundGenericClass();
   assert(CD && "Expected decl for class type!");
 
+  // If no class in the hierarchy rooted at CD provides a different
+  // implementation of the method, there is nothing to speculate on.
+  if (isEffectivelyFinalMethod(AI, ClassType, CD, CHA)) {
+    DEBUG(llvm::dbgs() << "Devirtualizing effectively final method of class "
+                       << CD->getName() << "\n");
+    auto NewInstPair = tryDevirtualizeClassMethod(AI, SubTypeValue);
+    if (NewInstPair.first)
+      replaceDeadApply(AI, NewInstPair.first);
+    if (NewInstPair.second.getInstruction())
+      return true;
+  }
+
   if (!CHA->hasKnownDirectSubclasses(CD)) {
     // If there is only one possible alternative for this method,
     // try to devirtualize it completely.
@@ -396,6 +451,19 @@ static bool tryToSpeculateTarget(FullApplySite AI,
 
   // Number of subclasses which cannot be handled by checked_cast_br checks.
   int NotHandledSubsNum = 0;
+
+  // With profile data, spend the checks on the hottest subclasses and none
+  // on subclasses whose implementation is never entered. Those are left to
+  // the default case.
+  SmallVector<ClassDecl *, 8> ColdSubs;
+  sortSubclassesByProfile(M, CMI, Subs, ColdSubs);
+  if (!ColdSubs.empty()) {
+    DEBUG(llvm::dbgs() << "Not speculating " << ColdSubs.size()
+                       << " subclasses of " << CD->getName()
+                       << " that are never called in the profile.\n");
+    NotHandledSubsNum += ColdSubs.size();
+  }
+
   if (Subs.size() > MaxNumSpeculativeTargets) {
     DEBUG(llvm::dbgs() << "Class " << CD->getName() << " has too many ("
                        << Subs.size() << ") subclasses. Performing speculative "
@@ -456,12 +524,11 @@ static bool tryToSpeculateTarget(FullApplySite AI,
   // Remark: With the current implementation of a speculative devirtualization,
   // if devirtualization of the "default" case is possible, then it would
   // by construction directly invoke the implementation of the method
-  // corresponding to the static type of the instance. This may change
-  // in the future, if we start using PGO for ordering of checked_cast_br
-  // checks.
-
-  // TODO: The ordering of checks may benefit from using a PGO, because
-  // the most probable alternatives could be checked first.
+  // corresponding to the static type of the instance.
+  //
+  // When the module was compiled with -profile-use, the subclass checks are
+  // ordered by the entry counts of the subclasses' implementations, so the
+  // most probable alternatives are checked first.
 
   for (auto S : Subs) {
     DEBUG(llvm::dbgs() << "Inserting a speculative call for class "
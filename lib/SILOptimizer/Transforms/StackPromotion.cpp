@@ -31,6 +31,10 @@ using namespace swift;
 /// *) alloc_ref instructions of native swift classes: if promoted, the [stack]
 ///    attribute is set in the alloc_ref and a dealloc_ref [stack] is inserted
 ///    at the end of the object's lifetime.
+/// *) Closure contexts of partial_apply instructions: if promoted, the [stack]
+///    attribute is set in the partial_apply and a dealloc_ref [stack] is
+///    inserted at the end of the context's lifetime. IRGen decides if the
+///    context really fits on the stack.
 /// *) Array buffers which are allocated by a call to swift_bufferAllocate: if
 ///    promoted the swift_bufferAllocate call is replaced by a call to
 ///    swift_bufferAllocateOnStack and a call to swift_bufferDeallocateFromStack
@@ -220,6 +224,10 @@ static bool isPromotableAllocInst(SILInstruction *I) {
       return true;
     return false;
   }
+  // Check for closure context allocation. Without any captured arguments
+  // there is no context to allocate.
+  if (auto *PAI = dyn_cast<PartialApplyInst>(I))
+    return PAI->getNumArguments() != 0 && !PAI->canAllocOnStack();
   // Check for array buffer allocation.
   auto *AI = dyn_cast<ApplyInst>(I);
   if (AI && AI->getNumArguments() == 3) {
@@ -300,6 +308,14 @@ void StackPromoter::tryPromoteAlloc(SILInstruction *I) {
     ChangedInsts = true;
     return;
   }
+  if (auto *PAI = dyn_cast<PartialApplyInst>(I)) {
+    assert(!AllocInsertionPoint && "can't move a partial_apply");
+    // It's a closure context allocation. Same as for alloc_ref.
+    PAI->setStackAllocatable();
+    B.createDeallocRef(I->getLoc(), I, true);
+    ChangedInsts = true;
+    return;
+  }
   if (auto *AI = dyn_cast<ApplyInst>(I)) {
     assert(!AllocInsertionPoint && "can't move call to swift_bufferAlloc");
     // It's an array buffer allocation.
@@ -783,3 +783,12 @@ SILBasicBlock *swift::splitIfCriticalEdge(SILBasicBlock *From,
   }
   llvm_unreachable("Destination block not found");
 }
+
+CFGSignature::CFGSignature(SILFunction &F) {
+  for (SILBasicBlock &BB : F) {
+    Edges.push_back(&BB);
+    for (SILBasicBlock *Succ : BB.getSuccessors())
+      Edges.push_back(Succ);
+    Edges.push_back(nullptr);
+  }
+}
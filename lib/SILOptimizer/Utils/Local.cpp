@@ -72,10 +72,10 @@ swift::createDecrementBefore(SILValue Ptr, SILInstruction *InsertPt) {
 /// This routine only examines the state of the instruction at hand.
 bool
 swift::isInstructionTriviallyDead(SILInstruction *I) {
-  // At Onone, consider all uses, including the debug_info.
-  // This way, debug_info is preserved at Onone.
+  // At Onone and Odebug, consider all uses, including the debug_info.
+  // This way, debug_info is preserved at Onone and Odebug.
   if (!I->use_empty() &&
-      I->getModule().getOptions().Optimization <= SILOptions::SILOptMode::None)
+      I->getModule().getOptions().Optimization <= SILOptions::SILOptMode::Debug)
     return false;
 
   if (!onlyHaveDebugUses(I) || isa<TermInst>(I))
@@ -1029,11 +1029,26 @@ static bool useDoesNotKeepClosureAlive(const SILInstruction *I) {
   case ValueKind::ReleaseValueInst:
   case ValueKind::DebugValueInst:
     return true;
+  // The end of a stack allocated context goes away with the closure.
+  case ValueKind::DeallocRefInst:
+    return cast<DeallocRefInst>(I)->canAllocOnStack();
   default:
     return false;
   }
 }
 
+void swift::eraseClosureContextDeallocs(PartialApplyInst *PAI,
+                                        InstModCallbacks Callbacks) {
+  if (!PAI->canAllocOnStack())
+    return;
+  SmallVector<SILInstruction *, 4> Deallocs;
+  for (auto *Use : PAI->getUses())
+    if (isa<DeallocRefInst>(Use->getUser()))
+      Deallocs.push_back(Use->getUser());
+  for (auto *Dealloc : Deallocs)
+    Callbacks.DeleteInst(Dealloc);
+}
+
 void swift::releasePartialApplyCapturedArg(SILBuilder &Builder, SILLocation Loc,
                                            SILValue Arg, SILParameterInfo PInfo,
                                            InstModCallbacks Callbacks) {
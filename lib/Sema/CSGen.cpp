@@ -745,6 +745,80 @@ namespace {
     
     return { nOperands, nNoDefault };
   }
+
+  /// Collect the argument labels written at a call site.
+  ///
+  /// \returns false if the labels cannot be matched against declaration names
+  /// syntactically, e.g. because of a trailing closure.
+  bool getCallArgumentLabels(Expr *arg, SmallVectorImpl<Identifier> &labels) {
+    if (auto parenExpr = dyn_cast<ParenExpr>(arg)) {
+      if (parenExpr->hasTrailingClosure())
+        return false;
+      labels.push_back(Identifier());
+      return true;
+    }
+
+    if (auto tupleExpr = dyn_cast<TupleExpr>(arg)) {
+      if (tupleExpr->hasTrailingClosure())
+        return false;
+      for (unsigned i = 0, e = tupleExpr->getNumElements(); i != e; ++i)
+        labels.push_back(tupleExpr->getElementName(i));
+      return true;
+    }
+
+    return false;
+  }
+
+  /// Determine whether a call to \p VD must use exactly the argument labels
+  /// of its name, i.e. it has no default arguments or variadic parameters.
+  bool hasFixedArgumentLabels(ValueDecl *VD) {
+    auto AFD = dyn_cast<AbstractFunctionDecl>(VD);
+    if (!AFD)
+      return false;
+
+    for (auto params : AFD->getParameterLists()) {
+      for (auto param : *params) {
+        if (param->isDefaultArgument() || param->isVariadic())
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// Favor the overloads whose argument labels match the labels written at
+  /// the call site.
+  ///
+  /// Overloads which differ only in their argument labels all look applicable
+  /// by arity, so without this the solver explores every one of them.
+  void favorMatchingArgumentLabels(ApplyExpr *expr,
+                                   OverloadedDeclRefExpr *ODR,
+                                   ConstraintSystem &CS) {
+    SmallVector<Identifier, 4> callLabels;
+    if (!getCallArgumentLabels(expr->getArg(), callLabels))
+      return;
+
+    // With default arguments or variadic parameters an overload can be called
+    // with fewer or more labels than its name has.
+    for (auto VD : ODR->getDecls()) {
+      if (!hasFixedArgumentLabels(VD))
+        return;
+    }
+
+    auto isFavoredDecl = [&](ValueDecl *value) -> bool {
+      auto declLabels = value->getFullName().getArgumentNames();
+      return declLabels.size() == callLabels.size() &&
+             std::equal(declLabels.begin(), declLabels.end(),
+                        callLabels.begin());
+    };
+
+    // Favoring all or none of the overloads doesn't prune anything.
+    unsigned numFavored = std::count_if(ODR->getDecls().begin(),
+                                        ODR->getDecls().end(), isFavoredDecl);
+    if (numFavored == 0 || numFavored == ODR->getDecls().size())
+      return;
+
+    favorCallOverloads(expr, CS, isFavoredDecl);
+  }
   
   /// Favor unary operator constraints where we have exact matches
   /// for the operand and contextual type.
@@ -795,6 +869,9 @@ namespace {
           
           if (nArgs == nParams.first) {
             if (haveMultipleApplicableOverloads) {
+              // Arity doesn't distinguish the overloads, but argument labels
+              // still might.
+              favorMatchingArgumentLabels(expr, ODR, CS);
               return;
             } else {
               haveMultipleApplicableOverloads = true;
@@ -1717,15 +1794,28 @@ namespace {
                                              /*options=*/0);
 
       // Introduce conversions from each element to the element type of the
-      // array.
+      // array. Literals of the same kind share the type variable of the first
+      // one, so that large literal tables don't need a conversion per element.
+      llvm::SmallDenseMap<unsigned, TypeVariableType *, 4> literalReps;
       unsigned index = 0;
       for (auto element : expr->getElements()) {
+        auto elementIndex = index++;
+        if (isMergeableValueKind(element)) {
+          if (auto tyvar = element->getType()->getAs<TypeVariableType>()) {
+            auto &rep = literalReps[unsigned(element->getKind())];
+            if (!rep)
+              rep = tyvar;
+            else if (mergeRepresentativeEquivalenceClasses(CS, rep, tyvar))
+              continue;
+          }
+        }
+
         CS.addConstraint(ConstraintKind::Conversion,
                          element->getType(),
                          arrayElementTy,
                          CS.getConstraintLocator(
                            expr,
-                           LocatorPathElt::getTupleElement(index++)));
+                           LocatorPathElt::getTupleElement(elementIndex)));
       }
 
       // The array element type defaults to 'Any'.
@@ -1798,52 +1888,41 @@ namespace {
       llvm::DenseSet<Expr *> mergedElements;
 
       // If no contextual type is present, Merge equivalence classes of key 
-      // and value types as necessary.
+      // and value types as necessary. Each literal key or value is merged with
+      // the first one of the same literal kind, which gives the same classes
+      // as merging every pair while staying linear in the number of elements.
       if (!CS.getContextualType(expr)) {
-        for (auto element1 : expr->getElements()) {
-          for (auto element2 : expr->getElements()) {
-            if (element1 == element2)
-              continue;
-
-            auto tty1 = element1->getType()->getAs<TupleType>();
-            auto tty2 = element2->getType()->getAs<TupleType>();
-
-            if (tty1 && tty2) {
-              auto mergedKey = false;
-              auto mergedValue = false;
-
-              auto keyTyvar1 = tty1->getElementTypes()[0]->
-                                getAs<TypeVariableType>();
-              auto keyTyvar2 = tty2->getElementTypes()[0]->
-                                getAs<TypeVariableType>();
-
-              auto keyExpr1 = cast<TupleExpr>(element1)->getElements()[0];
-              auto keyExpr2 = cast<TupleExpr>(element2)->getElements()[0];
-
-              if (keyExpr1->getKind() == keyExpr2->getKind() &&
-                  isMergeableValueKind(keyExpr1)) {
-                mergedKey = mergeRepresentativeEquivalenceClasses(CS,
-                            keyTyvar1, keyTyvar2);
-              }
+        llvm::SmallDenseMap<unsigned, TypeVariableType *, 4> keyReps;
+        llvm::SmallDenseMap<unsigned, TypeVariableType *, 4> valueReps;
+        auto mergeWithRep =
+            [&](llvm::SmallDenseMap<unsigned, TypeVariableType *, 4> &reps,
+                Expr *literal, Type type) -> bool {
+          if (!isMergeableValueKind(literal))
+            return false;
+          auto tyvar = type->getAs<TypeVariableType>();
+          auto &rep = reps[unsigned(literal->getKind())];
+          if (!rep) {
+            rep = tyvar;
+            return false;
+          }
+          return mergeRepresentativeEquivalenceClasses(CS, rep, tyvar);
+        };
 
-              auto valueTyvar1 = tty1->getElementTypes()[1]->
-                                  getAs<TypeVariableType>();
-              auto valueTyvar2 = tty2->getElementTypes()[1]->
-                                  getAs<TypeVariableType>();
+        for (auto element : expr->getElements()) {
+          auto tty = element->getType()->getAs<TupleType>();
+          if (!tty)
+            continue;
 
-              auto elemExpr1 = cast<TupleExpr>(element1)->getElements()[1];
-              auto elemExpr2 = cast<TupleExpr>(element2)->getElements()[1];
+          auto keyExpr = cast<TupleExpr>(element)->getElements()[0];
+          auto valueExpr = cast<TupleExpr>(element)->getElements()[1];
 
-              if (elemExpr1->getKind() == elemExpr2->getKind() &&
-                isMergeableValueKind(elemExpr1)) {
-                mergedValue = mergeRepresentativeEquivalenceClasses(CS, 
-                                valueTyvar1, valueTyvar2);
-              }
+          auto mergedKey = mergeWithRep(keyReps, keyExpr,
+                                        tty->getElementTypes()[0]);
+          auto mergedValue = mergeWithRep(valueReps, valueExpr,
+                                          tty->getElementTypes()[1]);
 
-              if (mergedKey && mergedValue)
-                mergedElements.insert(element2);
-            }
-          }
+          if (mergedKey && mergedValue)
+            mergedElements.insert(element);
         }
       }      
 
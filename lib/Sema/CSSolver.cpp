@@ -422,8 +422,11 @@ ConstraintSystem::SolverState::~SolverState() {
   LangOptions &langOpts = CS.getTypeChecker().Context.LangOpts;
   langOpts.DebugConstraintSolver = OldDebugConstraintSolver;
 
-  // Write our local statistics back to the overall statistics.
-  #define CS_STATISTIC(Name, Description) JOIN2(Overall,Name) += Name;
+  // Write our local statistics back to the overall statistics and to the
+  // statistics of the expression.
+  #define CS_STATISTIC(Name, Description) \
+    JOIN2(Overall,Name) += Name; \
+    CS.ExpressionStats.Name += Name;
   #include "ConstraintSolverStats.def"
 
   // Update the "largest" statistics if this system is larger than the
@@ -1099,11 +1102,12 @@ static bool tryTypeVariableBindings(
   auto &tc = cs.getTypeChecker();
   ++cs.solverState->NumTypeVariablesBound;
   
-  // If the solver has allocated an excessive amount of memory when solving for
-  // this expression, short-circuit the binding operation and mark the parent
-  // expression as "too complex".
+  // If the solver has allocated an excessive amount of memory or spent too
+  // much time when solving for this expression, short-circuit the binding
+  // operation and mark the parent expression as "too complex".
   if (cs.TC.Context.getSolverMemory() >
-        cs.TC.Context.LangOpts.SolverMemoryThreshold) {
+        cs.TC.Context.LangOpts.SolverMemoryThreshold ||
+      (cs.Timer && cs.Timer->isExpired())) {
     cs.setExpressionTooComplex(true);
     return true;
   }
@@ -1335,6 +1339,32 @@ bool ConstraintSystem::solve(SmallVectorImpl<Solution> &solutions,
   return solutions.empty();
 }
 
+/// Compute a key which identifies the connected component whose constraints
+/// are in \p constraints.
+///
+/// A component is identified by its constraints together with the
+/// representatives and fixed types of the type variables they refer to. Two
+/// components with the same key have the same solutions.
+///
+/// \returns false if the component can't be identified, because a type
+/// variable is bound to a type which still contains type variables.
+static bool getComponentKey(ConstraintSystem &cs, ConstraintList &constraints,
+                            SmallVectorImpl<const void *> &key) {
+  for (auto &constraint : constraints) {
+    key.push_back(&constraint);
+    for (auto typeVar : constraint.getTypeVariables()) {
+      auto rep = cs.getRepresentative(typeVar);
+      auto fixed = cs.getFixedType(rep);
+      if (fixed && fixed->hasTypeVariable())
+        return false;
+      key.push_back(typeVar);
+      key.push_back(rep);
+      key.push_back(fixed.getPointer());
+    }
+  }
+  return true;
+}
+
 bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
                                 FreeTypeVariableBinding allowFreeTypeVariables){
   // If we already failed, or simplification fails, we're done.
@@ -1458,6 +1488,16 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
       TypeVariables.push_back(typeVar);
     }
     
+    // Failures are only remembered when no best score could have pruned the
+    // search for this component.
+    SmallVector<const void *, 32> componentKey;
+    bool canRememberFailure =
+        !PreviousBestScore &&
+        getComponentKey(*this, InactiveConstraints, componentKey);
+    StringRef componentKeyRef(
+        reinterpret_cast<const char *>(componentKey.data()),
+        componentKey.size() * sizeof(const void *));
+
     // Solve for this component. If it fails, we're done.
     bool failed;
     if (TC.getLangOpts().DebugConstraintSolver) {
@@ -1465,7 +1505,18 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
       log.indent(solverState->depth * 2) << "(solving component #" 
                                          << component << "\n";
     }
-    {
+    if (canRememberFailure &&
+        solverState->FailedComponents.count(componentKeyRef)) {
+      // An identical component already failed in another branch of the
+      // search.
+      if (TC.getLangOpts().DebugConstraintSolver) {
+        auto &log = getASTContext().TypeCheckerDebug->getStream();
+        log.indent(solverState->depth * 2 + 2)
+          << "(component is known to fail)\n";
+      }
+      ++solverState->NumFailedComponentsReused;
+      failed = true;
+    } else {
       // Introduce a scope for this partial solution.
       SolverScope scope(*this);
       llvm::SaveAndRestore<SolverScope *> 
@@ -1473,6 +1524,10 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
 
       failed = solveSimplified(partialSolutions[component], 
                                allowFreeTypeVariables);
+
+      // Don't remember failures caused by the memory or time thresholds.
+      if (failed && canRememberFailure && !getExpressionTooComplex())
+        solverState->FailedComponents.insert(componentKeyRef);
     }
 
     // Put the constraints back into their original bucket.
@@ -19,6 +19,7 @@
 #include "ConstraintGraph.h"
 #include "swift/AST/ArchetypeBuilder.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
 
 using namespace swift;
 using namespace constraints;
@@ -41,6 +42,62 @@ ConstraintSystem::~ConstraintSystem() {
   delete &CG;
 }
 
+ExpressionTimer::ExpressionTimer(Expr *E, ConstraintSystem &CS)
+  : E(E), CS(CS) {
+  CS.Timer = this;
+}
+
+ExpressionTimer::~ExpressionTimer() {
+  CS.Timer = nullptr;
+
+  unsigned elapsedMS = getElapsedMS();
+  ASTContext &ctx = CS.getASTContext();
+  const LangOptions &langOpts = ctx.LangOpts;
+
+  unsigned warnLimit = langOpts.WarnLongExpressionTypeChecking;
+  if (warnLimit != 0 && elapsedMS >= warnLimit)
+    ctx.Diags.diagnose(E->getLoc(), diag::debug_long_expression,
+                       elapsedMS, warnLimit)
+      .highlight(E->getSourceRange());
+
+  if (langOpts.ExpressionTypeCheckingStatsPath.empty())
+    return;
+
+  std::error_code EC;
+  llvm::raw_fd_ostream out(langOpts.ExpressionTypeCheckingStatsPath, EC,
+                           llvm::sys::fs::F_Append | llvm::sys::fs::F_Text);
+  if (EC)
+    return;
+
+  // Write one JSON object per expression.
+  StringRef file;
+  unsigned line = 0, column = 0;
+  SourceLoc loc = E->getLoc();
+  if (loc.isValid()) {
+    file = ctx.SourceMgr.getBufferIdentifierForLoc(loc);
+    std::tie(line, column) = ctx.SourceMgr.getLineAndColumn(loc);
+  }
+  out << "{\"file\": \"";
+  out.write_escaped(file);
+  out << "\", \"line\": " << line << ", \"column\": " << column
+      << ", \"ms\": " << elapsedMS;
+  #define CS_STATISTIC(Name, Description) \
+    out << ", \"" #Name "\": " << CS.ExpressionStats.Name;
+  #include "ConstraintSolverStats.def"
+  out << "}\n";
+}
+
+unsigned ExpressionTimer::getElapsedMS() const {
+  llvm::TimeRecord endTime = llvm::TimeRecord::getCurrentTime(false);
+  auto elapsed = endTime.getWallTime() - StartTime.getWallTime();
+  return static_cast<unsigned>(elapsed * 1000);
+}
+
+bool ExpressionTimer::isExpired() const {
+  unsigned threshold = CS.getASTContext().LangOpts.SolverExpressionTimeThreshold;
+  return threshold != 0 && getElapsedMS() >= threshold;
+}
+
 bool ConstraintSystem::hasFreeTypeVariables() {
   // Look for any free type variables.
   for (auto tv : TypeVariables) {
@@ -33,7 +33,9 @@
 #include "llvm/ADT/ilist.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstddef>
 #include <functional>
@@ -881,6 +883,30 @@ struct MemberLookupResult {
 };
   
   
+/// Measures the time it takes to type-check a single expression.
+///
+/// When the timer is destroyed it warns if the expression took longer than
+/// the -warn-long-expression-type-checking limit, and appends the solver
+/// statistics of the expression to the -expression-type-checking-stats-path
+/// file.
+class ExpressionTimer {
+  Expr *E;
+  ConstraintSystem &CS;
+  llvm::TimeRecord StartTime = llvm::TimeRecord::getCurrentTime();
+
+public:
+  ExpressionTimer(Expr *E, ConstraintSystem &CS);
+  ~ExpressionTimer();
+
+  /// Return the wall-clock time spent on the expression so far, in
+  /// milliseconds.
+  unsigned getElapsedMS() const;
+
+  /// Return true if the expression has been solved for longer than the
+  /// -solver-expression-time-threshold limit.
+  bool isExpired() const;
+};
+
 /// \brief Describes a system of constraints on type variables, the
 /// solution of which assigns concrete types to each of the type variables.
 /// Constraint systems are typically generated given an (untyped) expression.
@@ -905,6 +931,16 @@ public:
   /// The original CS if this CS was created as a simplification of another CS
   ConstraintSystem *baseCS = nullptr;
 
+  /// The timer of the expression being solved, if expression timing is
+  /// enabled.
+  ExpressionTimer *Timer = nullptr;
+
+  /// Statistics accumulated over all solver states of this system.
+  struct {
+    #define CS_STATISTIC(Name, Description) unsigned Name = 0;
+    #include "ConstraintSolverStats.def"
+  } ExpressionStats;
+
 private:
 
   /// \brief Allocator used for all of the related constraint systems.
@@ -1056,6 +1092,10 @@ private:
     /// Refers to the innermost partial solution scope.
     SolverScope *PartialSolutionScope = nullptr;
 
+    /// The keys of the connected components which are known to have no
+    /// solution, so that other branches of the search don't solve them again.
+    llvm::StringSet<> FailedComponents;
+
     // Statistics
     #define CS_STATISTIC(Name, Description) unsigned Name = 0;
     #include "ConstraintSolverStats.def"
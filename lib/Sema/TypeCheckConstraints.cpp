@@ -1353,6 +1353,14 @@ solveForExpression(Expr *&expr, DeclContext *dc, Type convertType,
   if (preCheckExpression(*this, expr, dc))
     return true;
 
+  // Time the expression if any of the expression timing options are set.
+  Optional<ExpressionTimer> timer;
+  const LangOptions &langOpts = getLangOpts();
+  if (langOpts.WarnLongExpressionTypeChecking != 0 ||
+      langOpts.SolverExpressionTimeThreshold != 0 ||
+      !langOpts.ExpressionTypeCheckingStatsPath.empty())
+    timer.emplace(expr, cs);
+
   if (auto generatedExpr = cs.generateConstraints(expr))
     expr = generatedExpr;
   else {
@@ -19,6 +19,8 @@
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/Parse/Parser.h"
 #include "swift/Serialization/BCReadingExtras.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace swift;
@@ -225,6 +227,39 @@ namespace {
   };
 } // end anonymous namespace
 
+/// Records one decl, type or conformance read in the module's deserialization
+/// statistics.
+///
+/// Must be created after the cursor has jumped to the record, and destroyed
+/// before the cursor's position is restored.
+class ModuleFile::StatsRAII {
+  ModuleFile &MF;
+  uint64_t StartBit;
+  bool TrackTime;
+  llvm::TimeRecord StartTime;
+
+public:
+  StatsRAII(ModuleFile &MF, unsigned &counter)
+    : MF(MF), StartBit(MF.DeclTypeCursor.GetCurrentBitNo()),
+      TrackTime(MF.StatsDepth++ == 0 && llvm::AreStatisticsEnabled()) {
+    ++counter;
+    if (TrackTime)
+      StartTime = llvm::TimeRecord::getCurrentTime(/*Start=*/true);
+  }
+
+  ~StatsRAII() {
+    --MF.StatsDepth;
+    uint64_t endBit = MF.DeclTypeCursor.GetCurrentBitNo();
+    if (endBit > StartBit)
+      MF.Stats.NumBitsRead += endBit - StartBit;
+    if (TrackTime) {
+      llvm::TimeRecord elapsed = llvm::TimeRecord::getCurrentTime(false);
+      elapsed -= StartTime;
+      MF.Stats.WallTime += elapsed.getWallTime();
+    }
+  }
+};
+
 
 /// Skips a single record in the bitstream.
 ///
@@ -536,6 +571,7 @@ NormalProtocolConformance *ModuleFile::readNormalConformance(
   // Find the conformance record.
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(conformanceEntry);
+  StatsRAII stats(*this, Stats.NumNormalConformances);
   auto entry = DeclTypeCursor.advance();
   if (entry.Kind != llvm::BitstreamEntry::Record) {
     error();
@@ -1833,6 +1869,7 @@ Decl *ModuleFile::getDecl(DeclID DID, Optional<DeclContext *> ForcedContext) {
 
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(declOrOffset);
+  StatsRAII stats(*this, Stats.NumDecls);
   auto entry = DeclTypeCursor.advance();
 
   if (entry.Kind != llvm::BitstreamEntry::Record) {
@@ -3411,6 +3448,7 @@ Type ModuleFile::getType(TypeID TID) {
 
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(typeOrOffset);
+  StatsRAII stats(*this, Stats.NumTypes);
   auto entry = DeclTypeCursor.advance();
 
   if (entry.Kind != llvm::BitstreamEntry::Record) {
@@ -4152,6 +4190,29 @@ void ModuleFile::loadAllMembers(Decl *D, uint64_t contextData) {
   }
 }
 
+Optional<TinyPtrVector<ValueDecl *>>
+ModuleFile::loadNamedMembers(const Decl *D, Identifier N,
+                             uint64_t contextData) {
+  if (!DeclMemberNames)
+    return None;
+
+  PrettyStackTraceDecl trace("loading named members for", D);
+
+  TinyPtrVector<ValueDecl *> results;
+  auto known = DeclMemberNames->find(N);
+  if (known == DeclMemberNames->end())
+    return results;
+
+  // The table is keyed by base name alone; keep only the entries listed in
+  // this context's MEMBERS record.
+  for (auto entry : *known) {
+    if (entry.first != contextData)
+      continue;
+    results.push_back(cast<ValueDecl>(getDecl(entry.second)));
+  }
+  return results;
+}
+
 void
 ModuleFile::loadAllConformances(const Decl *D, uint64_t contextData,
                           SmallVectorImpl<ProtocolConformance*> &conformances) {
@@ -684,7 +684,8 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
   Builder.setInsertionPoint(BB);
   Builder.setCurrentDebugScope(Fn->getDebugScope());
   unsigned OpCode = 0, TyCategory = 0, TyCategory2 = 0, TyCategory3 = 0,
-           Attr = 0, NumSubs = 0, NumConformances = 0, IsNonThrowingApply = 0;
+           Attr = 0, NumSubs = 0, NumConformances = 0, IsNonThrowingApply = 0,
+           IsPartialApplyOnStack = 0;
   ValueID ValID, ValID2, ValID3;
   TypeID TyID, TyID2, TyID3;
   TypeID ConcreteTyID;
@@ -748,6 +749,10 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
     case SIL_PARTIAL_APPLY:
       OpCode = (unsigned)ValueKind::PartialApplyInst;
       break;
+    case SIL_PARTIAL_APPLY_ON_STACK:
+      OpCode = (unsigned)ValueKind::PartialApplyInst;
+      IsPartialApplyOnStack = true;
+      break;
     case SIL_BUILTIN:
       OpCode = (unsigned)ValueKind::BuiltinInst;
       break;
@@ -1062,9 +1067,12 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
     }
 
     // FIXME: Why the arbitrary order difference in IRBuilder type argument?
-    ResultVal = Builder.createPartialApply(Loc, FnVal, SubstFnTy,
+    auto *PAI = Builder.createPartialApply(Loc, FnVal, SubstFnTy,
                                            Substitutions, Args,
                                            closureTy);
+    if (IsPartialApplyOnStack)
+      PAI->setStackAllocatable();
+    ResultVal = PAI;
     break;
   }
   case ValueKind::BuiltinInst: {
@@ -330,7 +330,8 @@ namespace sil_block {
     SIL_PARTIAL_APPLY,
     SIL_BUILTIN,
     SIL_TRY_APPLY,
-    SIL_NON_THROWING_APPLY
+    SIL_NON_THROWING_APPLY,
+    SIL_PARTIAL_APPLY_ON_STACK
   };
   
   using SILInstApplyLayout = BCRecordLayout<
@@ -123,12 +123,27 @@ public:
   // hash table of all defined Objective-C methods.
   using ObjCMethodTable = llvm::DenseMap<ObjCSelector, ObjCMethodTableData>;
 
+  /// The offset of the MEMBERS record listing a member, paired with the
+  /// member's ID.
+  using DeclMemberNamesData = SmallVector<std::pair<BitOffset, DeclID>, 2>;
+
+  // In-memory representation of what will eventually be an on-disk hash
+  // table of the members of every nominal type and extension, by base name.
+  using DeclMemberNamesTable = llvm::MapVector<Identifier,
+                                               DeclMemberNamesData>;
+
 private:
   /// A map from identifiers to methods and properties with the given name.
   ///
   /// This is used for id-style lookup.
   DeclTable ClassMembersByName;
 
+  /// A map from identifiers to the members of nominal types and extensions
+  /// with the given base name.
+  ///
+  /// This is used to deserialize only the members a lookup asks for.
+  DeclMemberNamesTable DeclMemberNames;
+
   /// The queue of types and decls that need to be serialized.
   ///
   /// This is a queue and not simply a vector because serializing one
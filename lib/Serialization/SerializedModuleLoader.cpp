@@ -19,6 +19,7 @@
 #include "swift/Basic/SourceManager.h"
 #include "swift/Basic/Version.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Debug.h"
@@ -42,12 +43,20 @@ openModuleFiles(StringRef DirName, StringRef ModuleFilename,
                 std::unique_ptr<llvm::MemoryBuffer> &ModuleBuffer,
                 std::unique_ptr<llvm::MemoryBuffer> &ModuleDocBuffer,
                 llvm::SmallVectorImpl<char> &Scratch) {
+  // Module files are only ever read through a bitstream cursor, which
+  // doesn't need a null terminator. Not asking for one lets MemoryBuffer map
+  // the file read-only even when its size is a multiple of the page size,
+  // so concurrent frontend jobs share the same pages instead of each reading
+  // a private copy. Blobs read out of the module refer into this buffer.
+
   // Try to open the module file first.  If we fail, don't even look for the
   // module documentation file.
   Scratch.clear();
   llvm::sys::path::append(Scratch, DirName, ModuleFilename);
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> ModuleOrErr =
-    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()));
+    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()),
+                                /*FileSize=*/-1,
+                                /*RequiresNullTerminator=*/false);
   if (!ModuleOrErr)
     return ModuleOrErr.getError();
 
@@ -56,7 +65,9 @@ openModuleFiles(StringRef DirName, StringRef ModuleFilename,
   Scratch.clear();
   llvm::sys::path::append(Scratch, DirName, ModuleDocFilename);
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> ModuleDocOrErr =
-    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()));
+    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()),
+                                /*FileSize=*/-1,
+                                /*RequiresNullTerminator=*/false);
   if (!ModuleDocOrErr &&
       ModuleDocOrErr.getError() != std::errc::no_such_file_or_directory) {
     return ModuleDocOrErr.getError();
@@ -435,6 +446,62 @@ void SerializedModuleLoader::verifyAllModules() {
 #endif
 }
 
+void SerializedModuleLoader::printStatistics(ASTContext &Ctx,
+                                             raw_ostream &OS) {
+  OS << "*** Module deserialization statistics ***\n";
+  for (auto &entry : Ctx.LoadedModules) {
+    for (auto file : entry.second->getFiles()) {
+      auto serialized = dyn_cast<SerializedASTFile>(file);
+      if (!serialized)
+        continue;
+
+      auto &stats = serialized->File.getStats();
+      OS << entry.first << ": "
+         << stats.NumDecls << " decls, "
+         << stats.NumTypes << " types, "
+         << stats.NumNormalConformances << " conformances, "
+         << (stats.NumBitsRead + 7) / 8 << " bytes read";
+      if (stats.WallTime > 0)
+        OS << llvm::format(", %.3f ms", stats.WallTime * 1000);
+      OS << "\n";
+    }
+  }
+}
+
+void SerializedModuleLoader::getTotalStatistics(ASTContext &Ctx,
+                                                uint64_t &NumDecls,
+                                                uint64_t &NumTypes,
+                                                uint64_t &NumConformances) {
+  NumDecls = NumTypes = NumConformances = 0;
+  for (auto &entry : Ctx.LoadedModules) {
+    for (auto file : entry.second->getFiles()) {
+      auto serialized = dyn_cast<SerializedASTFile>(file);
+      if (!serialized)
+        continue;
+
+      auto &stats = serialized->File.getStats();
+      NumDecls += stats.NumDecls;
+      NumTypes += stats.NumTypes;
+      NumConformances += stats.NumNormalConformances;
+    }
+  }
+}
+
+void SerializedModuleLoader::printMemoryStatistics(ASTContext &Ctx,
+                                                   raw_ostream &OS) {
+  for (auto &entry : Ctx.LoadedModules) {
+    for (auto file : entry.second->getFiles()) {
+      auto serialized = dyn_cast<SerializedASTFile>(file);
+      if (!serialized)
+        continue;
+
+      OS << "  module " << entry.first << ": "
+         << serialized->File.getInputBufferSize()
+         << " bytes of serialized data\n";
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 // SerializedASTFile implementation
 //-----------------------------------------------------------------------------
@@ -28,26 +28,60 @@ using namespace reflection;
 
 TypeRefBuilder::TypeRefBuilder() : TC(*this) {}
 
+void TypeRefBuilder::updateReflectionInfoIndexes() {
+  for (; NumIndexedReflectionInfos < ReflectionInfos.size();
+       ++NumIndexedReflectionInfos) {
+    auto &Info = ReflectionInfos[NumIndexedReflectionInfos];
+
+    for (auto &FD : Info.fieldmd) {
+      if (!FD.hasMangledTypeName())
+        continue;
+      FieldTypeInfoIndex.insert({FD.getMangledTypeName(), &FD});
+    }
+
+    for (const auto &AssocTyDescriptor : Info.assocty) {
+      std::string ConformingTypeName(AssocTyDescriptor.ConformingTypeName);
+      AssociatedTypeIndex[ConformingTypeName].push_back(&AssocTyDescriptor);
+    }
+
+    for (auto &BuiltinTypeDescriptor : Info.builtin) {
+      assert(BuiltinTypeDescriptor.Size > 0);
+      assert(BuiltinTypeDescriptor.Alignment > 0);
+      assert(BuiltinTypeDescriptor.Stride > 0);
+      if (!BuiltinTypeDescriptor.hasMangledTypeName())
+        continue;
+      BuiltinTypeInfoIndex.insert({BuiltinTypeDescriptor.getMangledTypeName(),
+                                   &BuiltinTypeDescriptor});
+    }
+
+    for (auto &CD : Info.capture) {
+      auto RemoteAddress = ((uintptr_t) &CD -
+                            Info.LocalStartAddress +
+                            Info.RemoteStartAddress);
+      CaptureIndex.insert({RemoteAddress, &CD});
+    }
+  }
+}
+
 const AssociatedTypeDescriptor * TypeRefBuilder::
 lookupAssociatedTypes(const std::string &MangledTypeName,
                       const DependentMemberTypeRef *DependentMember) {
-  // Cache missed - we need to look through all of the assocty sections
-  // for all images that we've been notified about.
-  for (auto &Info : ReflectionInfos) {
-    for (const auto &AssocTyDescriptor : Info.assocty) {
-      std::string ConformingTypeName(AssocTyDescriptor.ConformingTypeName);
-      if (ConformingTypeName.compare(MangledTypeName) != 0)
+  updateReflectionInfoIndexes();
+
+  auto Found = AssociatedTypeIndex.find(MangledTypeName);
+  if (Found == AssociatedTypeIndex.end())
+    return nullptr;
+
+  for (auto AssocTyDescriptor : Found->second) {
+    std::string ProtocolMangledName(AssocTyDescriptor->ProtocolTypeName);
+    auto DemangledProto = Demangle::demangleTypeAsNode(ProtocolMangledName);
+    auto TR = swift::remote::decodeMangledType(*this, DemangledProto);
+
+    auto &Conformance = *DependentMember->getProtocol();
+    if (auto Protocol = dyn_cast<ProtocolTypeRef>(TR)) {
+      if (*Protocol != Conformance)
         continue;
-      std::string ProtocolMangledName(AssocTyDescriptor.ProtocolTypeName);
-      auto DemangledProto = Demangle::demangleTypeAsNode(ProtocolMangledName);
-      auto TR = swift::remote::decodeMangledType(*this, DemangledProto);
-
-      auto &Conformance = *DependentMember->getProtocol();
-      if (auto Protocol = dyn_cast<ProtocolTypeRef>(TR)) {
-        if (*Protocol != Conformance)
-          continue;
-        return &AssocTyDescriptor;
-      }
+      return AssocTyDescriptor;
     }
   }
   return nullptr;
@@ -82,19 +116,12 @@ TypeRefBuilder::getFieldTypeInfo(const TypeRef *TR) {
   else
     return {};
 
-  std::vector<std::pair<std::string, const TypeRef *>> Fields;
-  for (auto Info : ReflectionInfos) {
-    for (auto &FD : Info.fieldmd) {
-      if (!FD.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = FD.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &FD;
-    }
-  }
+  updateReflectionInfoIndexes();
 
-  return nullptr;
+  auto Found = FieldTypeInfoIndex.find(MangledName);
+  if (Found == FieldTypeInfoIndex.end())
+    return nullptr;
+  return Found->second;
 }
 
 std::vector<FieldTypeInfo>
@@ -142,36 +169,22 @@ TypeRefBuilder::getBuiltinTypeInfo(const TypeRef *TR) {
   else
     return nullptr;
 
-  for (auto Info : ReflectionInfos) {
-    for (auto &BuiltinTypeDescriptor : Info.builtin) {
-      assert(BuiltinTypeDescriptor.Size > 0);
-      assert(BuiltinTypeDescriptor.Alignment > 0);
-      assert(BuiltinTypeDescriptor.Stride > 0);
-      if (!BuiltinTypeDescriptor.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = BuiltinTypeDescriptor.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &BuiltinTypeDescriptor;
-    }
-  }
+  updateReflectionInfoIndexes();
 
-  return nullptr;
+  auto Found = BuiltinTypeInfoIndex.find(MangledName);
+  if (Found == BuiltinTypeInfoIndex.end())
+    return nullptr;
+  return Found->second;
 }
 
 const CaptureDescriptor *
 TypeRefBuilder::getCaptureDescriptor(uintptr_t RemoteAddress) {
-  for (auto Info : ReflectionInfos) {
-    for (auto &CD : Info.capture) {
-      auto OtherAddr = ((uintptr_t) &CD -
-                        Info.LocalStartAddress +
-                        Info.RemoteStartAddress);
-      if (OtherAddr == RemoteAddress)
-        return &CD;
-    }
-  }
+  updateReflectionInfoIndexes();
 
-  return nullptr;
+  auto Found = CaptureIndex.find(RemoteAddress);
+  if (Found == CaptureIndex.end())
+    return nullptr;
+  return Found->second;
 }
 
 /// Get the unsubstituted capture types for a closure context.
@@ -237,13 +237,48 @@ class StrongRefCount {
     return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_DEALLOCATING_FLAG;
   }
 
+  // Set the RC_DEALLOCATING_FLAG flag without changing the count, so that
+  // no later release starts deallocation. Returns false if the object was
+  // already deallocating.
+  //
+  // This also performs the before-deinit acquire barrier if we set the flag.
+  bool markDeallocating() {
+    uint32_t oldval = __atomic_fetch_or(&refCount, RC_DEALLOCATING_FLAG,
+                                        __ATOMIC_ACQUIRE);
+    return !(oldval & RC_DEALLOCATING_FLAG);
+  }
+
 private:
+  // Try to go straight from a reference count of exactly \p quantum to
+  // deallocating with a single atomic operation.
+  //
+  // Most objects are only ever referenced by the thread that created them,
+  // and their final release would otherwise pay for both the decrement and
+  // the compare-exchange that sets the deallocating flag. If the caller
+  // holds the last strong reference, the only legal concurrent change is a
+  // tryIncrement from an unowned reference, which makes the compare-exchange
+  // fail; the caller then falls back to the general path.
+  //
+  // On success this performs both the release barrier of the decrement and
+  // the before-deinit acquire barrier.
+  bool tryDecrementFromQuantumToDeallocating(uint32_t quantum) {
+    uint32_t oldval = __atomic_load_n(&refCount, __ATOMIC_RELAXED);
+    if (oldval != quantum)
+      return false;
+    uint32_t newval = RC_DEALLOCATING_FLAG;
+    return __atomic_compare_exchange(&refCount, &oldval, &newval, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+  }
+
   template <bool ClearPinnedFlag>
   bool doDecrementShouldDeallocate() {
     // If we're being asked to clear the pinned flag, we can assume
     // it's already set.
     constexpr uint32_t quantum =
       (ClearPinnedFlag ? RC_ONE + RC_PINNED_FLAG : RC_ONE);
+    if (tryDecrementFromQuantumToDeallocating(quantum))
+      return true;
+
     uint32_t newval = __atomic_sub_fetch(&refCount, quantum, __ATOMIC_RELEASE);
 
     assert((!ClearPinnedFlag || !(newval & RC_PINNED_FLAG)) &&
@@ -320,6 +355,9 @@ private:
     // If we're being asked to clear the pinned flag, we can assume
     // it's already set.
     uint32_t delta = (n << RC_FLAGS_COUNT) + (ClearPinnedFlag ? RC_PINNED_FLAG : 0);
+    if (tryDecrementFromQuantumToDeallocating(delta))
+      return true;
+
     uint32_t newval = __atomic_sub_fetch(&refCount, delta, __ATOMIC_RELEASE);
 
     assert((!ClearPinnedFlag || !(newval & RC_PINNED_FLAG)) &&
@@ -398,8 +436,9 @@ class WeakRefCount {
   uint32_t refCount;
 
   enum : uint32_t {
-    // There isn't really a flag here.
-    RC_UNUSED_FLAG = 1,
+    // Set once weak references to the object go through a side table
+    // entry. Only used when the runtime is built with weak side tables.
+    RC_SIDE_TABLE_FLAG = 1,
 
     RC_FLAGS_COUNT = 1,
     RC_FLAGS_MASK = 1,
@@ -471,6 +510,16 @@ class WeakRefCount {
     return (oldval & RC_COUNT_MASK) == subval;
   }
 
+  // Record that the object has a weak reference side table entry.
+  void setHasSideTable() {
+    __atomic_fetch_or(&refCount, RC_SIDE_TABLE_FLAG, __ATOMIC_RELAXED);
+  }
+
+  // Return true if the object has a weak reference side table entry.
+  bool hasSideTable() const {
+    return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_SIDE_TABLE_FLAG;
+  }
+
   // Return weak reference count.
   // Note that this is not equal to the number of outstanding weak pointers.
   uint32_t getCount() const {
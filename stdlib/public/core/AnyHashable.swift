@@ -132,6 +132,14 @@ public struct AnyHashable {
       return
     }
 
+    // Only class instances can need upcasting to the class that introduced
+    // their `Hashable` conformance. Box everything else directly, without
+    // calling into the runtime.
+    if !_isClassOrObjCExistential(H.self) {
+      self._box = _ConcreteHashableBox(base)
+      return
+    }
+
     self._box = _ConcreteHashableBox(0 as Int)
     _stdlib_makeAnyHashableUpcastingToHashableBaseType(
       base,
@@ -186,6 +186,13 @@ func _decodeCString<Encoding : UnicodeCodec>(
   repairingInvalidCodeUnits isRepairing: Bool = true)
 -> (result: String, repairsMade: Bool)? {
 
+  // ASCII is valid UTF-8 that needs no transcoding, so copy it directly.
+  if Encoding.self == UTF8.self,
+    let ascii = _StringBuffer._fromASCII(
+      UnsafeRawPointer(cString), count: length) {
+    return (result: String(_storage: ascii), repairsMade: false)
+  }
+
   let buffer = UnsafeBufferPointer<Encoding.CodeUnit>(
     start: cString, count: length)
 
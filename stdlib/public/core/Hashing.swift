@@ -126,6 +126,52 @@ func _mixInt(_ value: Int) -> Int {
 #endif
 }
 
+/// A streaming hash function that feeds any number of values through the
+/// seeded mixing function above and produces a single hash value.
+///
+/// Combining the hash values of a type's parts by appending them to a
+/// `_Hasher`, rather than with `^`, produces different hash values for the
+/// same parts in a different order, and for equal parts that would cancel
+/// each other out.
+public // @testable
+struct _Hasher {
+  internal var _state: UInt64
+  internal var _count: UInt64 = 0
+
+  public init() {
+    _state = _HashingDetail.getExecutionSeed()
+  }
+
+  @_transparent
+  public mutating func append(_ value: UInt64) {
+    _state = _HashingDetail.hash16Bytes(_state &+ (_count << 3), value)
+    _count = _count &+ 1
+  }
+
+  @_transparent
+  public mutating func append(_ value: Int) {
+    append(UInt64(UInt(bitPattern: value)))
+  }
+
+  public mutating func append<H : Hashable>(_ value: H) {
+    append(value.hashValue)
+  }
+
+  /// Returns the hash value of everything appended so far.
+  ///
+  /// The number of appended values is mixed in, so that a trailing value
+  /// that happens to leave the state unchanged still makes a difference.
+  public func finalize() -> Int {
+    let result = _HashingDetail.hash16Bytes(_state, _count)
+#if arch(i386) || arch(arm)
+    return Int(truncatingBitPattern: result) ^
+      Int(truncatingBitPattern: result >> 32)
+#elseif arch(x86_64) || arch(arm64) || arch(powerpc64) || arch(powerpc64le) || arch(s390x)
+    return Int(truncatingBitPattern: result)
+#endif
+  }
+}
+
 /// Given a hash value, returns an integer value within the given range that
 /// corresponds to a hash value.
 ///
@@ -78,6 +78,10 @@ public func _getTypeName(_ type: Any.Type, qualified: Bool)
 public // @testable
 func _typeName(_ type: Any.Type, qualified: Bool = true) -> String {
   let (stringPtr, count) = _getTypeName(type, qualified: qualified)
+  if let ascii = _StringBuffer._fromASCII(
+    UnsafeRawPointer(stringPtr), count: count) {
+    return String(_storage: ascii)
+  }
   return ._fromWellFormedCodeUnitSequence(UTF8.self,
     input: UnsafeBufferPointer(start: stringPtr, count: count))
 }
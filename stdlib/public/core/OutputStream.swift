@@ -500,8 +500,23 @@ internal struct _Stdout : TextOutputStream {
       return
     }
 
-    for c in string.utf8 {
-      _swift_stdlib_putchar_unlocked(Int32(c))
+    // Transcode into a small buffer and write it out in chunks rather than
+    // handing stdio one byte at a time.
+    var buffer = _Buffer72()
+    let capacity = MemoryLayout<_Buffer72>.size
+    buffer.withBytes { bytes in
+      var used = 0
+      for c in string.utf8 {
+        bytes[used] = c
+        used += 1
+        if used == capacity {
+          _swift_stdlib_fwrite_stdout(bytes, used, 1)
+          used = 0
+        }
+      }
+      if used != 0 {
+        _swift_stdlib_fwrite_stdout(bytes, used, 1)
+      }
     }
   }
 }
@@ -725,20 +725,27 @@ extension Sequence {
     _ transform: (Iterator.Element) throws -> T
   ) rethrows -> [T] {
     let initialCapacity = underestimatedCount
-    var result = ContiguousArray<T>()
-    result.reserveCapacity(initialCapacity)
+    var builder = _UnsafePartiallyInitializedContiguousArrayBuffer<T>(
+      initialCapacity: initialCapacity)
 
     var iterator = self.makeIterator()
 
-    // Add elements up to the initial capacity without checking for regrowth.
-    for _ in 0..<initialCapacity {
-      result.append(try transform(iterator.next()!))
-    }
-    // Add remaining elements, if any.
-    while let element = iterator.next() {
-      result.append(try transform(element))
+    do {
+      // Add elements up to the initial capacity without checking for
+      // regrowth.
+      for _ in 0..<initialCapacity {
+        builder.addWithExistingCapacity(try transform(iterator.next()!))
+      }
+      // Add remaining elements, if any.
+      while let element = iterator.next() {
+        builder.add(try transform(element))
+      }
+    } catch {
+      // Release the elements added so far.
+      _ = builder.finish()
+      throw error
     }
-    return Array(result)
+    return Array(builder.finish())
   }
 
   /// Returns an array containing, in order, the elements of the sequence
@@ -760,17 +767,25 @@ extension Sequence {
     _ isIncluded: (Iterator.Element) throws -> Bool
   ) rethrows -> [Iterator.Element] {
 
-    var result = ContiguousArray<Iterator.Element>()
+    var builder =
+      _UnsafePartiallyInitializedContiguousArrayBuffer<Iterator.Element>(
+        initialCapacity: 0)
 
     var iterator = self.makeIterator()
 
-    while let element = iterator.next() {
-      if try isIncluded(element) {
-        result.append(element)
+    do {
+      while let element = iterator.next() {
+        if try isIncluded(element) {
+          builder.add(element)
+        }
       }
+    } catch {
+      // Release the elements added so far.
+      _ = builder.finish()
+      throw error
     }
 
-    return Array(result)
+    return Array(builder.finish())
   }
 
   /// Returns a subsequence, up to the given maximum length, containing the
@@ -91,6 +91,34 @@ public struct _StringBuffer {
       = ((_storage._capacity() - capacityBump) << 1) + elementShift
   }
 
+  /// Returns a buffer holding a copy of the `count` bytes at `start` if they
+  /// are all ASCII, or `nil` otherwise.
+  static func _fromASCII(
+    _ start: UnsafeRawPointer, count: Int
+  ) -> _StringBuffer? {
+    let bytes = start.assumingMemoryBound(to: UTF8.CodeUnit.self)
+    // Check fixed-size chunks without early exits inside them, so that the
+    // inner loop can be vectorized.
+    let chunkSize = 64
+    var chunkStart = 0
+    while chunkStart < count {
+      let chunkEnd = min(chunkStart + chunkSize, count)
+      var bits: UTF8.CodeUnit = 0
+      for i in chunkStart..<chunkEnd {
+        bits |= bytes[i]
+      }
+      if bits & 0x80 != 0 {
+        return nil
+      }
+      chunkStart = chunkEnd
+    }
+
+    let result = _StringBuffer(
+      capacity: count, initialSize: count, elementWidth: 1)
+    result.start.copyBytes(from: start, count: count)
+    return result
+  }
+
   static func fromCodeUnits<Input, Encoding>(
     _ input: Input, encoding: Encoding.Type, repairIllFormedSequences: Bool,
     minimumCapacity: Int = 0
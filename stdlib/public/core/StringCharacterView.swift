@@ -249,6 +249,20 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let startIndexUTF16 = start._position
+
+    // Fast path: An ASCII scalar other than CR followed by another ASCII
+    // scalar forms a grapheme cluster on its own, since no ASCII scalar
+    // extends the cluster before it.
+    if _fastPath(_core.hasContiguousStorage) {
+      let cu0 = _core[startIndexUTF16]
+      if cu0 < 0x80 && cu0 != 0x0d /* CR */ {
+        if startIndexUTF16 + 1 == end._position ||
+           _core[startIndexUTF16 + 1] < 0x80 {
+          return 1
+        }
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
@@ -288,6 +302,22 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let endIndexUTF16 = end._position
+
+    // Fast path: An ASCII scalar preceded by another ASCII scalar is a
+    // grapheme cluster on its own, unless the two are CR LF.
+    if _fastPath(_core.hasContiguousStorage) {
+      let cu1 = _core[endIndexUTF16 - 1]
+      if cu1 < 0x80 {
+        if endIndexUTF16 == 1 {
+          return 1
+        }
+        let cu0 = _core[endIndexUTF16 - 2]
+        if cu0 < 0x80 && (cu0 != 0x0d /* CR */ || cu1 != 0x0a /* LF */) {
+          return 1
+        }
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
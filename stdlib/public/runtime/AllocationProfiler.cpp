@@ -0,0 +1,488 @@
+//===--- AllocationProfiler.cpp - Sampling allocation profiler ------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// See AllocationProfiler.h for a description of the profiler.
+//
+// Samples are aggregated by (type, backtrace) as they are taken, so memory
+// use is bounded by the number of distinct allocation sites. The profile is
+// written as an uncompressed profile.proto message, which pprof reads
+// directly. Each sample's leaf frame is a pseudo-function named after the
+// allocated type, so "pprof -top" ranks types and the call graph shows where
+// each type is allocated.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(__CYGWIN__) || defined(__ANDROID__) || defined(_MSC_VER)
+#  define SWIFT_ALLOCATION_PROFILER_BACKTRACES 0
+#else
+#  define SWIFT_ALLOCATION_PROFILER_BACKTRACES 1
+#endif
+
+#include "AllocationProfiler.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/Basic/LLVM.h"
+#include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Debug.h"
+#include "swift/Runtime/HeapObject.h"
+#include "swift/Runtime/Metadata.h"
+#include "swift/Runtime/Mutex.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringRef.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_MSC_VER)
+#include <pthread.h>
+#endif
+
+#if SWIFT_ALLOCATION_PROFILER_BACKTRACES
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+using namespace swift;
+
+std::atomic<unsigned char> swift::_swift_allocationProfilerState;
+
+namespace {
+
+/// The number of frames recorded for each sample.
+constexpr unsigned MaxSampleFrames = 16;
+
+/// The default number of allocations per sample.
+constexpr unsigned DefaultSampleRate = 512;
+
+struct SampleKey {
+  /// The allocated type, or null for raw memory.
+  const Metadata *Type;
+  unsigned NumFrames;
+  void *Frames[MaxSampleFrames];
+
+  bool operator==(const SampleKey &other) const {
+    return Type == other.Type && NumFrames == other.NumFrames &&
+           std::equal(Frames, Frames + NumFrames, other.Frames);
+  }
+};
+
+struct SampleKeyHash {
+  size_t operator()(const SampleKey &key) const {
+    return llvm::hash_combine(
+        key.Type, llvm::hash_combine_range(key.Frames,
+                                           key.Frames + key.NumFrames));
+  }
+};
+
+struct SampleCounts {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+};
+
+/// The sampling state of one thread.
+struct ThreadSampleState {
+  /// The number of allocations the thread makes before its next sample.
+  /// Zero means the thread hasn't allocated yet.
+  unsigned AllocationsUntilSample;
+
+  /// Set while the thread is taking a sample, so that allocations made by
+  /// the profiler itself aren't sampled.
+  bool IsTakingSample;
+};
+
+struct AllocationProfile {
+  /// The number of allocations on a thread between samples.
+  unsigned SampleRate = DefaultSampleRate;
+
+  /// Where to write the profile at exit. Empty if profiling is disabled.
+  std::string OutputPath;
+
+  Mutex Lock;
+  std::unordered_map<SampleKey, SampleCounts, SampleKeyHash> Samples;
+
+#if !defined(_MSC_VER)
+  /// The key of each thread's ThreadSampleState. This uses a pthread key
+  /// rather than C++11 thread_local, which not every deployment target
+  /// supports, and it's only created when profiling is enabled.
+  pthread_key_t ThreadStateKey;
+#endif
+
+  AllocationProfile() {
+#if !defined(_MSC_VER)
+    const char *path = getenv("SWIFT_ALLOCATION_PROFILE");
+    if (!path || pthread_key_create(&ThreadStateKey, free) != 0)
+      return;
+    OutputPath = path;
+    if (const char *rate = getenv("SWIFT_ALLOCATION_PROFILE_RATE")) {
+      unsigned long value = strtoul(rate, nullptr, 10);
+      if (value > 0)
+        SampleRate = value;
+    }
+#endif
+  }
+
+  /// Return the current thread's sampling state, creating it if needed.
+  /// Only valid when profiling is enabled.
+  ThreadSampleState &getThreadState() {
+#if !defined(_MSC_VER)
+    auto state = static_cast<ThreadSampleState *>(
+        pthread_getspecific(ThreadStateKey));
+    if (!state) {
+      // This uses calloc rather than new so that it doesn't go through
+      // the runtime's allocation hooks.
+      state = static_cast<ThreadSampleState *>(
+          calloc(1, sizeof(ThreadSampleState)));
+      if (!state) swift::crash("Could not allocate memory.");
+      pthread_setspecific(ThreadStateKey, state);
+    }
+    return *state;
+#else
+    swift::crash("allocation profiling is not supported");
+#endif
+  }
+};
+
+} // end anonymous namespace
+
+static Lazy<AllocationProfile> Profile;
+
+static void writeAllocationProfileAtExit() {
+  auto &profile = Profile.get();
+  if (!swift_writeAllocationProfile(profile.OutputPath.c_str()))
+    fprintf(stderr, "swift runtime: unable to write allocation profile to "
+                    "%s\n", profile.OutputPath.c_str());
+}
+
+bool swift::_swift_initializeAllocationProfiler() {
+  bool enabled = !Profile.get().OutputPath.empty();
+
+  // Only the thread that publishes the setting registers the exit hook.
+  unsigned char expected = 0;
+  if (_swift_allocationProfilerState.compare_exchange_strong(
+          expected, enabled ? 2 : 1, std::memory_order_relaxed)) {
+    if (enabled)
+      atexit(writeAllocationProfileAtExit);
+    return enabled;
+  }
+  return expected == 2;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static unsigned captureBacktrace(void **frames) {
+#if SWIFT_ALLOCATION_PROFILER_BACKTRACES
+  // Leave out the frame of _swift_sampleAllocation itself.
+  void *buffer[MaxSampleFrames + 1];
+  int count = backtrace(buffer, MaxSampleFrames + 1);
+  if (count <= 1)
+    return 0;
+  std::copy(buffer + 1, buffer + count, frames);
+  return count - 1;
+#else
+  return 0;
+#endif
+}
+
+void swift::_swift_sampleAllocation(const Metadata *type, size_t size) {
+  auto &profile = Profile.get();
+  auto &thread = profile.getThreadState();
+  if (thread.AllocationsUntilSample > 1) {
+    --thread.AllocationsUntilSample;
+    return;
+  }
+  if (thread.IsTakingSample)
+    return;
+  thread.IsTakingSample = true;
+  thread.AllocationsUntilSample = profile.SampleRate;
+
+  SampleKey key;
+  key.Type = type;
+  key.NumFrames = captureBacktrace(key.Frames);
+
+  {
+    ScopedLock guard(profile.Lock);
+    auto &counts = profile.Samples[key];
+    counts.Count += 1;
+    counts.Bytes += size;
+  }
+
+  thread.IsTakingSample = false;
+}
+
+//===----------------------------------------------------------------------===//
+//                           pprof profile writing
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// A minimal encoder for the protocol buffer wire format.
+class ProtobufWriter {
+  std::string Buffer;
+
+  enum WireType : unsigned { Varint = 0, LengthDelimited = 2 };
+
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      Buffer.push_back(char(value | 0x80));
+      value >>= 7;
+    }
+    Buffer.push_back(char(value));
+  }
+
+  void writeKey(unsigned field, WireType type) {
+    writeVarint((uint64_t(field) << 3) | type);
+  }
+
+public:
+  const std::string &str() const { return Buffer; }
+
+  void writeInt(unsigned field, uint64_t value) {
+    writeKey(field, Varint);
+    writeVarint(value);
+  }
+
+  void writeBytes(unsigned field, StringRef bytes) {
+    writeKey(field, LengthDelimited);
+    writeVarint(bytes.size());
+    Buffer.append(bytes.data(), bytes.size());
+  }
+
+  void writeMessage(unsigned field, const ProtobufWriter &message) {
+    writeBytes(field, message.str());
+  }
+
+  void writePacked(unsigned field, ArrayRef<uint64_t> values) {
+    ProtobufWriter packed;
+    for (auto value : values)
+      packed.writeVarint(value);
+    writeMessage(field, packed);
+  }
+};
+
+/// Builds a perftools.profiles.Profile message.
+class PprofBuilder {
+  // Field numbers from profile.proto.
+  enum : unsigned {
+    Profile_SampleType = 1,
+    Profile_Sample = 2,
+    Profile_Location = 4,
+    Profile_Function = 5,
+    Profile_StringTable = 6,
+    Profile_PeriodType = 11,
+    Profile_Period = 12,
+
+    ValueType_Type = 1,
+    ValueType_Unit = 2,
+
+    Sample_LocationId = 1,
+    Sample_Value = 2,
+    Sample_Label = 3,
+
+    Label_Key = 1,
+    Label_Str = 2,
+
+    Location_Id = 1,
+    Location_Address = 3,
+    Location_Line = 4,
+
+    Line_FunctionId = 1,
+
+    Function_Id = 1,
+    Function_Name = 2,
+    Function_SystemName = 3,
+  };
+
+  ProtobufWriter Profile;
+  std::vector<std::string> Strings;
+  std::unordered_map<std::string, uint64_t> StringIndices;
+  std::unordered_map<std::string, uint64_t> FunctionIds;
+  llvm::DenseMap<void *, uint64_t> FrameLocationIds;
+  llvm::DenseMap<const Metadata *, uint64_t> TypeLocationIds;
+  uint64_t NextFunctionId = 1;
+  uint64_t NextLocationId = 1;
+
+  uint64_t getString(const std::string &string) {
+    auto inserted = StringIndices.insert({string, Strings.size()});
+    if (inserted.second)
+      Strings.push_back(string);
+    return inserted.first->second;
+  }
+
+  void writeValueType(unsigned field, const char *type, const char *unit) {
+    ProtobufWriter valueType;
+    valueType.writeInt(ValueType_Type, getString(type));
+    valueType.writeInt(ValueType_Unit, getString(unit));
+    Profile.writeMessage(field, valueType);
+  }
+
+  uint64_t getFunction(const std::string &name,
+                       const std::string &systemName) {
+    auto inserted = FunctionIds.insert({systemName, NextFunctionId});
+    if (!inserted.second)
+      return inserted.first->second;
+
+    ProtobufWriter function;
+    function.writeInt(Function_Id, NextFunctionId);
+    function.writeInt(Function_Name, getString(name));
+    function.writeInt(Function_SystemName, getString(systemName));
+    Profile.writeMessage(Profile_Function, function);
+    return NextFunctionId++;
+  }
+
+  uint64_t writeLocation(uint64_t address, uint64_t functionId) {
+    ProtobufWriter line;
+    line.writeInt(Line_FunctionId, functionId);
+
+    ProtobufWriter location;
+    location.writeInt(Location_Id, NextLocationId);
+    if (address)
+      location.writeInt(Location_Address, address);
+    location.writeMessage(Location_Line, line);
+    Profile.writeMessage(Profile_Location, location);
+    return NextLocationId++;
+  }
+
+  uint64_t getFrameLocation(void *pc) {
+    auto found = FrameLocationIds.find(pc);
+    if (found != FrameLocationIds.end())
+      return found->second;
+
+    std::string name = symbolicate(pc);
+    auto id = writeLocation(uintptr_t(pc), getFunction(name, name));
+    FrameLocationIds[pc] = id;
+    return id;
+  }
+
+  uint64_t getTypeLocation(const Metadata *type) {
+    auto found = TypeLocationIds.find(type);
+    if (found != TypeLocationIds.end())
+      return found->second;
+
+    std::string name = getTypeName(type);
+    auto id = writeLocation(0, getFunction(name, "type " + name));
+    TypeLocationIds[type] = id;
+    return id;
+  }
+
+  static std::string symbolicate(void *pc) {
+#if SWIFT_ALLOCATION_PROFILER_BACKTRACES
+    Dl_info info;
+    if (dladdr(pc, &info) && info.dli_sname) {
+      int status;
+      char *demangled = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+      if (status == 0) {
+        std::string result = demangled;
+        free(demangled);
+        return result;
+      }
+      return Demangle::demangleSymbolAsString(
+          info.dli_sname, strlen(info.dli_sname),
+          Demangle::DemangleOptions::SimplifiedUIDemangleOptions());
+    }
+#endif
+    char buffer[2 + 16 + 1];
+    snprintf(buffer, sizeof(buffer), "0x%lx", (unsigned long) uintptr_t(pc));
+    return buffer;
+  }
+
+public:
+  PprofBuilder(unsigned sampleRate) {
+    getString("");
+    writeValueType(Profile_SampleType, "alloc_objects", "count");
+    writeValueType(Profile_SampleType, "alloc_space", "bytes");
+    writeValueType(Profile_PeriodType, "alloc_objects", "count");
+    Profile.writeInt(Profile_Period, sampleRate);
+  }
+
+  static std::string getTypeName(const Metadata *type) {
+    if (!type)
+      return "<raw memory>";
+    switch (type->getKind()) {
+    case MetadataKind::HeapGenericLocalVariable: {
+      auto box = static_cast<const GenericBoxHeapMetadata *>(type);
+      return "Box<" + nameForMetadata(box->BoxedType) + ">";
+    }
+    case MetadataKind::HeapLocalVariable:
+      return "<closure context>";
+    case MetadataKind::ErrorObject:
+      return "<error box>";
+    default:
+      return nameForMetadata(type);
+    }
+  }
+
+  /// Add a sample, scaling the counts by the sample rate to estimate the
+  /// total allocations it represents.
+  void addSample(const SampleKey &key, const SampleCounts &counts,
+                 unsigned sampleRate) {
+    std::vector<uint64_t> locations;
+    locations.push_back(getTypeLocation(key.Type));
+    for (unsigned i = 0; i < key.NumFrames; ++i)
+      locations.push_back(getFrameLocation(key.Frames[i]));
+
+    uint64_t values[] = { counts.Count * sampleRate,
+                          counts.Bytes * sampleRate };
+
+    ProtobufWriter label;
+    label.writeInt(Label_Key, getString("type"));
+    label.writeInt(Label_Str, getString(getTypeName(key.Type)));
+
+    ProtobufWriter sample;
+    sample.writePacked(Sample_LocationId, locations);
+    sample.writePacked(Sample_Value, values);
+    sample.writeMessage(Sample_Label, label);
+    Profile.writeMessage(Profile_Sample, sample);
+  }
+
+  std::string finish() {
+    for (auto &string : Strings)
+      Profile.writeBytes(Profile_StringTable, string);
+    return Profile.str();
+  }
+};
+
+} // end anonymous namespace
+
+bool swift::swift_writeAllocationProfile(const char *path) {
+  if (!_swift_isAllocationProfilerEnabled())
+    return false;
+
+  auto &profile = Profile.get();
+
+  // Copy the samples so that symbolication and demangling happen without
+  // blocking allocating threads.
+  std::vector<std::pair<SampleKey, SampleCounts>> samples;
+  auto &thread = profile.getThreadState();
+  thread.IsTakingSample = true;
+  {
+    ScopedLock guard(profile.Lock);
+    samples.assign(profile.Samples.begin(), profile.Samples.end());
+  }
+
+  PprofBuilder builder(profile.SampleRate);
+  for (auto &sample : samples)
+    builder.addSample(sample.first, sample.second, profile.SampleRate);
+  std::string contents = builder.finish();
+  thread.IsTakingSample = false;
+
+  FILE *file = fopen(path, "wb");
+  if (!file)
+    return false;
+  bool written =
+    fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+  return fclose(file) == 0 && written;
+}
@@ -0,0 +1,63 @@
+//===--- AllocationProfiler.h - Sampling allocation profiler ----*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A low-overhead sampling profiler for heap allocations made through the
+// runtime.
+//
+// Setting SWIFT_ALLOCATION_PROFILE to a file path makes the runtime record
+// one of every SWIFT_ALLOCATION_PROFILE_RATE (default 512) allocations on
+// each thread, together with its type and a short backtrace, and write them
+// to that path in pprof format when the process exits. When the variable is
+// unset, each allocation pays for a single load and branch.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_RUNTIME_ALLOCATIONPROFILER_H
+#define SWIFT_RUNTIME_ALLOCATIONPROFILER_H
+
+#include "swift/Runtime/Metadata.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <cstddef>
+
+namespace swift {
+
+/// Zero until the environment has been checked, then one if the profiler
+/// is disabled and two if it is enabled.
+extern std::atomic<unsigned char> _swift_allocationProfilerState;
+
+/// Check the environment and initialize _swift_allocationProfilerState.
+bool _swift_initializeAllocationProfiler();
+
+/// Is the allocation profiler enabled for this process?
+inline bool _swift_isAllocationProfilerEnabled() {
+  auto state = _swift_allocationProfilerState.load(std::memory_order_relaxed);
+  if (LLVM_LIKELY(state != 0))
+    return state == 2;
+  return _swift_initializeAllocationProfiler();
+}
+
+/// Count an allocation of \p size bytes towards the current thread's next
+/// sample. \p type is the allocated object's metadata, or null for raw
+/// memory.
+LLVM_ATTRIBUTE_NOINLINE
+void _swift_sampleAllocation(const Metadata *type, size_t size);
+
+/// Report an allocation to the profiler, if it is enabled.
+inline void profileAllocation(const Metadata *type, size_t size) {
+  if (LLVM_UNLIKELY(_swift_isAllocationProfilerEnabled()))
+    _swift_sampleAllocation(type, size);
+}
+
+} // end namespace swift
+
+#endif // SWIFT_RUNTIME_ALLOCATIONPROFILER_H
@@ -0,0 +1,224 @@
+//===--- AllocationRegion.cpp - Thread-local allocation regions -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Allocation regions let a thread bump-allocate objects out of a private
+// arena and free them all at once.
+//
+// An object allocated under a region is initialized like a stack object:
+// it carries an extra weak retain on behalf of the region, so its memory is
+// never freed by the normal release path. Objects that die before the
+// region is popped are destroyed as usual; anything still alive when the
+// region is popped is destroyed then, and finally the region's memory is
+// returned to the system in one go.
+//
+// An object that still has unowned or weak references when the region is
+// popped keeps the region's weak retain forever, and the chunk it lives in
+// is not freed, so that those references can still see that the object is
+// deallocated.
+//
+// Tail-allocated buffers are never allocated in a region. Their capacity is
+// computed from malloc_size of their memory, so swift_bufferAllocate always
+// takes them from malloc.
+//
+// This is only built when the runtime is configured with
+// SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS, so swift_allocObject doesn't
+// have to look for a current region otherwise.
+//
+//===----------------------------------------------------------------------===//
+
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+
+#include "swift/Runtime/Debug.h"
+#include "swift/Runtime/HeapObject.h"
+#include "swift/Runtime/Metadata.h"
+#include "AllocationProfiler.h"
+#include "Leaks.h"
+#include "Private.h"
+#include <algorithm>
+#include <cstdlib>
+#include <pthread.h>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+
+/// The size of the chunks a region bump-allocates from.
+constexpr size_t RegionChunkSize = 64 * 1024;
+
+/// Objects larger than this get a chunk of their own, so that they don't
+/// waste the tail of the current chunk.
+constexpr size_t RegionLargeObjectSize = RegionChunkSize / 4;
+
+struct RegionChunk {
+  RegionChunk *Next;
+
+  /// The number of bytes following this header.
+  size_t Size;
+
+  bool contains(const HeapObject *object) const {
+    auto start = reinterpret_cast<const char *>(this + 1);
+    auto address = reinterpret_cast<const char *>(object);
+    return address >= start && address < start + Size;
+  }
+};
+
+} // end anonymous namespace
+
+struct swift::AllocationRegion {
+  /// The enclosing region on the same thread, if any.
+  AllocationRegion *Parent;
+
+  /// The chunks owned by this region, most recent first.
+  RegionChunk *Chunks = nullptr;
+
+  /// Unused space in the most recent regular chunk.
+  char *Cursor = nullptr;
+  char *End = nullptr;
+
+  /// Every object allocated in this region, in allocation order.
+  std::vector<HeapObject *> Objects;
+
+  explicit AllocationRegion(AllocationRegion *parent) : Parent(parent) {}
+
+  char *allocateChunk(size_t size) {
+    auto chunk = static_cast<RegionChunk *>(malloc(sizeof(RegionChunk) + size));
+    if (!chunk) swift::crash("Could not allocate memory.");
+    chunk->Next = Chunks;
+    chunk->Size = size;
+    Chunks = chunk;
+    return reinterpret_cast<char *>(chunk + 1);
+  }
+
+  void *allocate(size_t size, size_t alignMask) {
+    if (size + alignMask > RegionLargeObjectSize) {
+      auto start = reinterpret_cast<uintptr_t>(
+          allocateChunk(size + alignMask));
+      return reinterpret_cast<void *>((start + alignMask) & ~alignMask);
+    }
+
+    uintptr_t start = (reinterpret_cast<uintptr_t>(Cursor) + alignMask)
+                        & ~alignMask;
+    if (!Cursor || start + size > reinterpret_cast<uintptr_t>(End)) {
+      Cursor = allocateChunk(RegionChunkSize);
+      End = Cursor + RegionChunkSize;
+      start = (reinterpret_cast<uintptr_t>(Cursor) + alignMask) & ~alignMask;
+    }
+    Cursor = reinterpret_cast<char *>(start + size);
+    return reinterpret_cast<void *>(start);
+  }
+
+  /// Destroy the objects that are still alive and free the region's memory,
+  /// except for memory that is still referenced.
+  void release() {
+    // Mark every live object as deallocating before destroying any of them,
+    // so that releases made by one object's destructor can't start the
+    // deallocation of another object that is already on the list.
+    std::vector<HeapObject *> live;
+    for (auto object : Objects)
+      if (object->refCount.markDeallocating())
+        live.push_back(object);
+
+    // Destroy in reverse allocation order, like the stack.
+    while (!live.empty()) {
+      auto object = live.back();
+      live.pop_back();
+      asFullMetadata(object->metadata)->destroy(object);
+    }
+
+    // Every object has now dropped its own weak retain, so any count above
+    // the region's one comes from an unowned or weak reference. Those
+    // objects keep the region's retain, which stops swift_unownedRelease
+    // from ever freeing them, and their chunks are leaked.
+    std::vector<HeapObject *> referenced;
+    for (auto object : Objects)
+      if (object->weakRefCount.getCount() != 1)
+        referenced.push_back(object);
+
+    while (Chunks) {
+      auto chunk = Chunks;
+      Chunks = chunk->Next;
+      bool isReferenced = std::any_of(referenced.begin(), referenced.end(),
+                                      [&](HeapObject *object) {
+        return chunk->contains(object);
+      });
+      if (!isReferenced)
+        free(chunk);
+    }
+  }
+};
+
+/// The key of the innermost region pushed on each thread. This uses a
+/// pthread key rather than C++11 thread_local, which not every deployment
+/// target supports.
+static pthread_key_t CurrentRegionKey;
+
+static bool haveCurrentRegionKey() {
+  static const bool haveKey =
+    pthread_key_create(&CurrentRegionKey, nullptr) == 0;
+  return haveKey;
+}
+
+AllocationRegion *swift::_swift_getCurrentAllocationRegion() {
+  if (!haveCurrentRegionKey())
+    return nullptr;
+  return static_cast<AllocationRegion *>(
+      pthread_getspecific(CurrentRegionKey));
+}
+
+static void setCurrentAllocationRegion(AllocationRegion *region) {
+  pthread_setspecific(CurrentRegionKey, region);
+}
+
+HeapObject *swift::_swift_allocObjectInRegion(AllocationRegion *region,
+                                              HeapMetadata const *metadata,
+                                              size_t requiredSize,
+                                              size_t requiredAlignmentMask) {
+  auto object = reinterpret_cast<HeapObject *>(
+      region->allocate(requiredSize, requiredAlignmentMask));
+  object->metadata = metadata;
+  object->refCount.init();
+  // The region holds a weak retain, so the object's memory stays valid until
+  // the region is popped.
+  object->weakRefCount.initForNotDeallocating();
+  region->Objects.push_back(object);
+
+  // If leak tracking is enabled, start tracking this object.
+  SWIFT_LEAKS_START_TRACKING_OBJECT(object);
+
+  profileAllocation(metadata, requiredSize);
+
+  return object;
+}
+
+AllocationRegion *swift::swift_pushAllocationRegion() {
+  if (!haveCurrentRegionKey())
+    swift::fatalError(/* flags = */ 0,
+                      "allocation regions are not available\n");
+  auto region = new AllocationRegion(_swift_getCurrentAllocationRegion());
+  setCurrentAllocationRegion(region);
+  return region;
+}
+
+void swift::swift_popAllocationRegion(AllocationRegion *region) {
+  if (region != _swift_getCurrentAllocationRegion())
+    swift::fatalError(/* flags = */ 0,
+                      "allocation region %p is not the current thread's "
+                      "innermost region\n", (void *) region);
+
+  // Objects allocated by destructors below go to the enclosing region.
+  setCurrentAllocationRegion(region->Parent);
+  region->release();
+  delete region;
+}
+
+#endif // SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
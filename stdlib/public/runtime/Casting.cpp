@@ -18,17 +18,19 @@
 #include "swift/Basic/Demangle.h"
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Config.h"
 #include "swift/Runtime/Enum.h"
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Mutex.h"
-#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "ExistentialMetadataImpl.h"
 #include "Private.h"
+#include "Probes.h"
 #include "../SwiftShims/RuntimeShims.h"
 #include "stddef.h"
 #if SWIFT_OBJC_INTEROP
@@ -313,54 +315,53 @@ std::string swift::nameForMetadata(const Metadata *type,
   return result;
 }
 
-SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
-extern "C"
-TwoWordPair<const char *, uintptr_t>::Return
-swift_getTypeName(const Metadata *type, bool qualified) {
-  using Pair = TwoWordPair<const char *, uintptr_t>;
-  using Key = llvm::PointerIntPair<const Metadata *, 1, bool>;
+namespace {
+  /// A cached result of swift_getTypeName.
+  struct TypeNameCacheEntry {
+    using Key = llvm::PointerIntPair<const Metadata *, 1, bool>;
 
-  static StaticReadWriteLock TypeNameCacheLock;
-  static Lazy<llvm::DenseMap<Key, std::pair<const char *, size_t>>>
-    TypeNameCache;
-  
-  Key key(type, qualified);
-  auto &cache = TypeNameCache.get();
+  private:
+    Key TypeAndQualified;
+    // Never modified after construction, so its data stays valid for as long
+    // as the entry does.
+    std::string Name;
+
+  public:
+    TypeNameCacheEntry(Key key)
+      : TypeAndQualified(key),
+        Name(nameForMetadata(key.getPointer(), key.getInt())) {}
 
-  // Attempt read-only lookup of cache entry.
-  {
-    StaticScopedReadLock guard(TypeNameCacheLock);
+    const std::string &getName() const { return Name; }
 
-    auto found = cache.find(key);
-    if (found != cache.end()) {
-      auto result = found->second;
-      return Pair{result.first, result.second};
+    int compareWithKey(Key key) const {
+      auto lhs = uintptr_t(key.getOpaqueValue());
+      auto rhs = uintptr_t(TypeAndQualified.getOpaqueValue());
+      return lhs < rhs ? -1 : lhs > rhs ? 1 : 0;
     }
-  }
 
-  // Read-only lookup failed to find item, we may need to create it.
-  {
-    StaticScopedWriteLock guard(TypeNameCacheLock);
+    static size_t getKeyHash(Key key) {
+      return llvm::hash_value(key.getOpaqueValue());
+    }
 
-    // Do lookup again just to make sure it wasn't created by another
-    // thread before we acquired the write lock.
-    auto found = cache.find(key);
-    if (found != cache.end()) {
-      auto result = found->second;
-      return Pair{result.first, result.second};
+    static size_t getExtraAllocationSize(Key key) {
+      return 0;
     }
+  };
+} // end anonymous namespace
+
+SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
+extern "C"
+TwoWordPair<const char *, uintptr_t>::Return
+swift_getTypeName(const Metadata *type, bool qualified) {
+  using Pair = TwoWordPair<const char *, uintptr_t>;
 
-    // Build the metadata name.
-    auto name = nameForMetadata(type, qualified);
-    // Copy it to memory we can reference forever.
-    auto size = name.size();
-    auto result = (char *)malloc(size + 1);
-    memcpy(result, name.data(), size);
-    result[size] = 0;
+  // Lookups of names that have already been built don't take a lock.
+  static Lazy<ConcurrentHashMap<TypeNameCacheEntry>> TypeNameCache;
 
-    cache.insert({key, {result, size}});
-    return Pair{result, size};
-  }
+  auto entry = TypeNameCache.get()
+    .getOrInsert(TypeNameCacheEntry::Key(type, qualified)).first;
+  auto &name = entry->getName();
+  return Pair{name.c_str(), name.size()};
 }
 
 /// Report a dynamic cast failure.
@@ -432,6 +433,8 @@ static bool _dynamicCastClassToValueViaObjCBridgeable(
 static bool _fail(OpaqueValue *srcValue, const Metadata *srcType,
                   const Metadata *targetType, DynamicCastFlags flags,
                   const Metadata *srcDynamicType = nullptr) {
+  SWIFT_RUNTIME_PROBE2(cast__fail, srcDynamicType ? srcDynamicType : srcType,
+                       targetType);
   if (flags & DynamicCastFlags::Unconditional) {
     const Metadata *srcTypeToReport =
         srcDynamicType ? srcDynamicType
@@ -650,6 +653,25 @@ static void _maybeDeallocateOpaqueExistential(OpaqueValue *srcExistential,
   }
 }
 
+/// Does a cast with the given flags take or destroy its source value?
+static bool mayConsumeSource(DynamicCastFlags flags) {
+  return flags & (DynamicCastFlags::TakeOnSuccess |
+                  DynamicCastFlags::DestroyOnFailure);
+}
+
+/// Project the value out of an opaque existential.
+///
+/// Only a caller that may take or destroy the value needs a buffer of its
+/// own; one that only reads it must not copy a box that other existentials
+/// share.
+static OpaqueValue *
+projectOpaqueExistential(OpaqueExistentialContainer *container,
+                         bool mayConsume) {
+  if (mayConsume)
+    return container->Type->vw_projectBuffer(&container->Buffer);
+  return swift_projectBufferForRead(&container->Buffer, container->Type);
+}
+
 static bool
 isAnyObjectExistentialType(const ExistentialTypeMetadata *targetType) {
   unsigned numProtos =  targetType->Protocols.NumProtocols;
@@ -1676,7 +1698,7 @@ static bool _dynamicCastToUnknownClassFromExistential(OpaqueValue *dest,
       reinterpret_cast<OpaqueExistentialContainer*>(src);
     auto srcCapturedType = opaqueContainer->Type;
     OpaqueValue *srcValue =
-      srcCapturedType->vw_projectBuffer(&opaqueContainer->Buffer);
+      projectOpaqueExistential(opaqueContainer, mayConsumeSource(flags));
     bool result = swift_dynamicCast(dest,
                                     srcValue,
                                     srcCapturedType,
@@ -1717,7 +1739,8 @@ static void unwrapExistential(OpaqueValue *src,
                               OpaqueValue *&srcValue,
                               const Metadata *&srcCapturedType,
                               bool &isOutOfLine,
-                              bool &canTake) {
+                              bool &canTake,
+                              bool mayConsume) {
   switch (srcType->getRepresentation()) {
     case ExistentialTypeRepresentation::Class: {
       auto classContainer =
@@ -1732,7 +1755,7 @@ static void unwrapExistential(OpaqueValue *src,
     case ExistentialTypeRepresentation::Opaque: {
       auto opaqueContainer = reinterpret_cast<OpaqueExistentialContainer*>(src);
       srcCapturedType = opaqueContainer->Type;
-      srcValue = srcCapturedType->vw_projectBuffer(&opaqueContainer->Buffer);
+      srcValue = projectOpaqueExistential(opaqueContainer, mayConsume);
       isOutOfLine = (src != srcValue);
       canTake = true;
       break;
@@ -1769,7 +1792,8 @@ static bool _dynamicCastFromExistential(OpaqueValue *dest,
   bool canTake;
 
   unwrapExistential(src, srcType,
-                    srcValue, srcCapturedType, isOutOfLine, canTake);
+                    srcValue, srcCapturedType, isOutOfLine, canTake,
+                    mayConsumeSource(flags));
   
   auto subFlags = flags;
   if (!canTake)
@@ -1888,7 +1912,8 @@ static bool _dynamicCastToMetatype(OpaqueValue *dest,
     case ExistentialTypeRepresentation::Opaque: {
       auto srcExistential = (OpaqueExistentialContainer*) src;
       auto srcValueType = srcExistential->Type;
-      auto srcValue = srcValueType->vw_projectBuffer(&srcExistential->Buffer);
+      auto srcValue =
+        projectOpaqueExistential(srcExistential, mayConsumeSource(flags));
       bool result = _dynamicCastToMetatype(dest, srcValue, srcValueType,
                                            targetType, flags);
       if (src != srcValue)
@@ -2058,7 +2083,8 @@ static bool _dynamicCastToExistentialMetatype(OpaqueValue *dest,
     case ExistentialTypeRepresentation::Opaque: {
       auto srcExistential = (OpaqueExistentialContainer*) src;
       auto srcValueType = srcExistential->Type;
-      auto srcValue = srcValueType->vw_projectBuffer(&srcExistential->Buffer);
+      auto srcValue =
+        projectOpaqueExistential(srcExistential, mayConsumeSource(flags));
       bool result = _dynamicCastToExistentialMetatype(dest, srcValue, srcValueType,
                                                       targetType, flags);
       if (src != srcValue)
@@ -2484,6 +2510,72 @@ static bool _dynamicCastStructToStruct(OpaqueValue *destination,
 /****************************** Main Entrypoint *******************************/
 /******************************************************************************/
 
+/// The ways in which swift_dynamicCast can shortcut a cast whose outcome
+/// is decided by the source and target metadata alone, without looking
+/// at the value.
+enum class DynamicCastFastPath {
+  /// No shortcut; take the general path.
+  None,
+  /// The types are the same value type; copy or take the value.
+  Exact,
+  /// Open the opaque existential source and cast its contents.
+  OpenExistential,
+  /// The cast can never succeed.
+  Fail,
+};
+
+/// Is this the kind of a non-optional value type that swift_dynamicCast
+/// never bridges or unwraps?
+static bool isPlainValueKind(MetadataKind kind) {
+  switch (kind) {
+  case MetadataKind::Struct:
+  case MetadataKind::Enum:
+  case MetadataKind::Tuple:
+  case MetadataKind::Opaque:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Classify a cast from \p srcType to \p targetType, following the
+/// decisions the general path in swift_dynamicCast would make for these
+/// kinds. This must stay cheaper than the dispatch it replaces, so it only
+/// looks at metadata kinds and, for structs, nominal type descriptors.
+static DynamicCastFastPath
+classifyDynamicCast(const Metadata *srcType, const Metadata *targetType) {
+  auto targetKind = targetType->getKind();
+  if (!isPlainValueKind(targetKind))
+    return DynamicCastFastPath::None;
+  // AnyHashable can be cast to and from any Hashable type.
+  if (isAnyHashableType(targetType))
+    return DynamicCastFastPath::None;
+
+  auto srcKind = srcType->getKind();
+  if (srcKind == MetadataKind::Existential) {
+    // Class existentials may hold bridged or boxed values.
+    if (cast<ExistentialTypeMetadata>(srcType)->getRepresentation()
+          == ExistentialTypeRepresentation::Opaque)
+      return DynamicCastFastPath::OpenExistential;
+    return DynamicCastFastPath::None;
+  }
+
+  if (!isPlainValueKind(srcKind))
+    return DynamicCastFastPath::None;
+  if (srcType == targetType)
+    return DynamicCastFastPath::Exact;
+  if (isAnyHashableType(srcType))
+    return DynamicCastFastPath::None;
+
+  // Instantiations of the same generic struct may be collection casts.
+  if (srcKind == MetadataKind::Struct && targetKind == MetadataKind::Struct &&
+      cast<StructMetadata>(srcType)->Description.get() ==
+        cast<StructMetadata>(targetType)->Description.get())
+    return DynamicCastFastPath::None;
+
+  return DynamicCastFastPath::Fail;
+}
+
 /// Perform a dynamic cast to an arbitrary type.
 SWIFT_RT_ENTRY_VISIBILITY
 bool swift::swift_dynamicCast(OpaqueValue *dest,
@@ -2492,6 +2584,22 @@ bool swift::swift_dynamicCast(OpaqueValue *dest,
                               const Metadata *targetType,
                               DynamicCastFlags flags)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  // Casts between plain value types and out of opaque existentials, such
+  // as 'Any' to 'Int', need none of the optional, bridging and boxing
+  // checks below.
+  switch (classifyDynamicCast(srcType, targetType)) {
+  case DynamicCastFastPath::None:
+    break;
+  case DynamicCastFastPath::Exact:
+    return _succeed(dest, src, srcType, flags);
+  case DynamicCastFastPath::OpenExistential:
+    return _dynamicCastFromExistential(dest, src,
+                                       cast<ExistentialTypeMetadata>(srcType),
+                                       targetType, flags);
+  case DynamicCastFastPath::Fail:
+    return _fail(src, srcType, targetType, flags);
+  }
+
   auto unwrapResult = checkDynamicCastFromOptional(dest, src, srcType,
                                                    targetType, flags);
   srcType = unwrapResult.payloadType;
@@ -2959,7 +3067,8 @@ static id bridgeAnythingNonVerbatimToObjectiveC(OpaqueValue *src,
     bool canTake;
     
     unwrapExistential(src, srcExistentialTy,
-                      srcInnerValue, srcInnerType, isOutOfLine, canTake);
+                      srcInnerValue, srcInnerType, isOutOfLine, canTake,
+                      consume);
     auto result = bridgeAnythingNonVerbatimToObjectiveC(srcInnerValue,
                                                         srcInnerType,
                                                         consume && canTake);
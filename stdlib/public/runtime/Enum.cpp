@@ -139,14 +139,35 @@ swift::swift_initEnumValueWitnessTableSinglePayload(ValueWitnessTable *vwtable,
   }
 }
 
-SWIFT_RT_ENTRY_VISIBILITY
-int
-swift::swift_getEnumCaseSinglePayload(const OpaqueValue *value,
-                                      const Metadata *payload,
-                                      unsigned emptyCases)
-  SWIFT_CC(RegisterPreservingCC_IMPL) {
+namespace {
+
+/// A payload size known at compile time.
+///
+/// Instantiating the single-payload enum operations below with a fixed size
+/// lets the compiler turn their variable-length memcpy and memset calls into
+/// a few direct loads and stores. Generic code manipulating Optional<T> goes
+/// through these operations constantly, and nearly all payloads are one of a
+/// handful of sizes.
+template <size_t Size>
+struct FixedPayloadSize {
+  size_t get() const { return Size; }
+};
+
+/// A payload size that is only known at runtime.
+struct DynamicPayloadSize {
+  size_t Size;
+  size_t get() const { return Size; }
+};
+
+} // end anonymous namespace
+
+template <class PayloadSize>
+static int getEnumCaseSinglePayloadImpl(const OpaqueValue *value,
+                                        const Metadata *payload,
+                                        unsigned emptyCases,
+                                        PayloadSize payloadSizeValue) {
   auto *payloadWitnesses = payload->getValueWitnesses();
-  auto payloadSize = payloadWitnesses->getSize();
+  size_t payloadSize = payloadSizeValue.get();
   auto payloadNumExtraInhabitants = payloadWitnesses->getNumExtraInhabitants();
 
   // If there are extra tag bits, check them.
@@ -200,14 +221,41 @@ swift::swift_getEnumCaseSinglePayload(const OpaqueValue *value,
 }
 
 SWIFT_RT_ENTRY_VISIBILITY
-void
-swift::swift_storeEnumTagSinglePayload(OpaqueValue *value,
-                                       const Metadata *payload,
-                                       int whichCase,
-                                       unsigned emptyCases)
+int
+swift::swift_getEnumCaseSinglePayload(const OpaqueValue *value,
+                                      const Metadata *payload,
+                                      unsigned emptyCases)
   SWIFT_CC(RegisterPreservingCC_IMPL) {
+  switch (payload->getValueWitnesses()->getSize()) {
+  case 1:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                                        FixedPayloadSize<1>());
+  case 2:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                                        FixedPayloadSize<2>());
+  case 4:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                                        FixedPayloadSize<4>());
+  case 8:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                                        FixedPayloadSize<8>());
+  case 16:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                                        FixedPayloadSize<16>());
+  default:
+    return getEnumCaseSinglePayloadImpl(value, payload, emptyCases,
+                   DynamicPayloadSize{payload->getValueWitnesses()->getSize()});
+  }
+}
+
+template <class PayloadSize>
+static void storeEnumTagSinglePayloadImpl(OpaqueValue *value,
+                                          const Metadata *payload,
+                                          int whichCase,
+                                          unsigned emptyCases,
+                                          PayloadSize payloadSizeValue) {
   auto *payloadWitnesses = payload->getValueWitnesses();
-  auto payloadSize = payloadWitnesses->getSize();
+  size_t payloadSize = payloadSizeValue.get();
   unsigned payloadNumExtraInhabitants
     = payloadWitnesses->getNumExtraInhabitants();
 
@@ -263,17 +311,47 @@ swift::swift_storeEnumTagSinglePayload(OpaqueValue *value,
          numPayloadTagBytes);
   if (payloadSize > 4)
     memset(valueAddr + 4, 0, payloadSize - 4);
-  memcpy(extraTagBitAddr,
-         reinterpret_cast<uint8_t*>(&extraTagIndex) + 4 - numExtraTagBytes,
-         numExtraTagBytes);
+  small_memcpy(extraTagBitAddr,
+               reinterpret_cast<uint8_t*>(&extraTagIndex) + 4
+                 - numExtraTagBytes,
+               numExtraTagBytes);
 #else
   memcpy(valueAddr, &payloadIndex, std::min(size_t(4), payloadSize));
   if (payloadSize > 4)
     memset(valueAddr + 4, 0, payloadSize - 4);
-  memcpy(extraTagBitAddr, &extraTagIndex, numExtraTagBytes);
+  small_memcpy(extraTagBitAddr, &extraTagIndex, numExtraTagBytes);
 #endif
 }
 
+SWIFT_RT_ENTRY_VISIBILITY
+void
+swift::swift_storeEnumTagSinglePayload(OpaqueValue *value,
+                                       const Metadata *payload,
+                                       int whichCase,
+                                       unsigned emptyCases)
+  SWIFT_CC(RegisterPreservingCC_IMPL) {
+  switch (payload->getValueWitnesses()->getSize()) {
+  case 1:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                                         FixedPayloadSize<1>());
+  case 2:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                                         FixedPayloadSize<2>());
+  case 4:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                                         FixedPayloadSize<4>());
+  case 8:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                                         FixedPayloadSize<8>());
+  case 16:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                                         FixedPayloadSize<16>());
+  default:
+    return storeEnumTagSinglePayloadImpl(value, payload, whichCase, emptyCases,
+                   DynamicPayloadSize{payload->getValueWitnesses()->getSize()});
+  }
+}
+
 void
 swift::swift_initEnumMetadataMultiPayload(ValueWitnessTable *vwtable,
                                      EnumMetadata *enumType,
@@ -345,6 +423,18 @@ static void storeMultiPayloadValue(OpaqueValue *value,
                                    MultiPayloadLayout layout,
                                    unsigned payloadValue) {
   auto bytes = reinterpret_cast<char *>(value);
+
+  // Most payloads are at least as large as the value, so the value can be
+  // stored with a fixed-size copy on either endianness. If the payload is
+  // larger than the value, zero out the rest.
+  if (layout.payloadSize >= sizeof(payloadValue)) {
+    small_memcpy<sizeof(payloadValue)>(bytes, &payloadValue);
+    if (layout.payloadSize > sizeof(payloadValue))
+      memset(bytes + sizeof(payloadValue), 0,
+             layout.payloadSize - sizeof(payloadValue));
+    return;
+  }
+
 #if defined(__BIG_ENDIAN__)
   unsigned numPayloadValueBytes =
       std::min(layout.payloadSize, sizeof(payloadValue));
@@ -355,10 +445,6 @@ static void storeMultiPayloadValue(OpaqueValue *value,
   memcpy(bytes, &payloadValue,
          std::min(layout.payloadSize, sizeof(payloadValue)));
 #endif
-  // If the payload is larger than the value, zero out the rest.
-  if (layout.payloadSize > sizeof(payloadValue))
-    memset(bytes + sizeof(payloadValue), 0,
-           layout.payloadSize - sizeof(payloadValue));
 }
 
 static unsigned loadMultiPayloadTag(const OpaqueValue *value,
@@ -380,6 +466,14 @@ static unsigned loadMultiPayloadValue(const OpaqueValue *value,
                                       MultiPayloadLayout layout) {
   auto bytes = reinterpret_cast<const char *>(value);
   unsigned payloadValue = 0;
+
+  // As in storeMultiPayloadValue, use a fixed-size copy when the payload is at
+  // least as large as the value.
+  if (layout.payloadSize >= sizeof(payloadValue)) {
+    small_memcpy<sizeof(payloadValue)>(&payloadValue, bytes);
+    return payloadValue;
+  }
+
 #if defined(__BIG_ENDIAN__)
   unsigned numPayloadValueBytes =
       std::min(layout.payloadSize, sizeof(payloadValue));
@@ -18,6 +18,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <stdio.h>
+#include <string.h>
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "Private.h"
@@ -47,9 +48,11 @@ _getErrorAllocatedSizeAndAlignmentMask(const Metadata *type) {
 static void _destroyErrorObject(HeapObject *obj) {
   auto error = static_cast<SwiftError *>(obj);
   
-  // Destroy the value inside.
+  // Destroy the value inside. Most error types are simple enums, which are
+  // POD, so skip the indirect call when there is nothing to destroy.
   auto type = error->type;
-  type->vw_destroy(error->getValue());
+  if (!type->getValueWitnesses()->isPOD())
+    type->vw_destroy(error->getValue());
   
   // Deallocate the buffer.
   auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
@@ -82,7 +85,10 @@ swift::swift_allocError(const swift::Metadata *type,
   // If an initial value was given, copy or take it in.
   auto valuePtr = error->getValue();
   if (initialValue) {
-    if (isTake)
+    auto vw = type->getValueWitnesses();
+    if (vw->isPOD() || (isTake && vw->isBitwiseTakable()))
+      memcpy(valuePtr, initialValue, vw->getSize());
+    else if (isTake)
       type->vw_initializeWithTake(valuePtr, initialValue);
     else
       type->vw_initializeWithCopy(valuePtr, initialValue);
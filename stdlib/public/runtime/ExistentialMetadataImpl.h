@@ -116,7 +116,8 @@ struct LLVM_LIBRARY_VISIBILITY OpaqueExistentialBoxBase
     auto srcType = src->getType();
     auto destType = dest->getType();
     if (srcType == destType) {
-      OpaqueValue *srcValue = srcType->vw_projectBuffer(src->getBuffer(args...));
+      OpaqueValue *srcValue =
+        swift_projectBufferForRead(src->getBuffer(args...), srcType);
       OpaqueValue *destValue = srcType->vw_projectBuffer(dest->getBuffer(args...));
       srcType->vw_assignWithCopy(destValue, srcValue);
       return dest;
@@ -16,23 +16,340 @@
 
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Heap.h"
+#include "AllocationProfiler.h"
 #include "Private.h"
 #include "swift/Runtime/Debug.h"
 #include <stdlib.h>
+#include <string.h>
+
+#if SWIFT_RUNTIME_ENABLE_OBJECT_CACHE
+#include "swift/Runtime/Mutex.h"
+#include <atomic>
+#include <cstddef>
+#include <pthread.h>
+#endif
 
 using namespace swift;
 
-SWIFT_RT_ENTRY_VISIBILITY
-void *swift::swift_slowAlloc(size_t size, size_t alignMask)
-    SWIFT_CC(RegisterPreservingCC_IMPL) {
+static void *allocateMemory(size_t size, size_t alignMask) {
   // FIXME: use posix_memalign if alignMask is larger than the system guarantee.
   void *p = malloc(size);
   if (!p) swift::crash("Could not allocate memory.");
   return p;
 }
 
+SWIFT_RT_ENTRY_VISIBILITY
+void *swift::swift_slowAlloc(size_t size, size_t alignMask)
+    SWIFT_CC(RegisterPreservingCC_IMPL) {
+  profileAllocation(nullptr, size);
+  return allocateMemory(size, alignMask);
+}
+
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_slowDealloc(void *ptr, size_t bytes, size_t alignMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
   free(ptr);
 }
+
+#if SWIFT_RUNTIME_ENABLE_OBJECT_CACHE
+
+// A caching allocator for small heap objects.
+//
+// Each thread keeps a free list per size class. Blocks freed by a thread go
+// onto that thread's own lists, regardless of which thread allocated them.
+// When a list grows past a limit, a batch of blocks is handed back to a
+// central, locked pool for its size class; a thread whose list is empty
+// takes a whole batch back from the pool before carving fresh blocks out of
+// a new slab. A thread's lists are flushed to the pool when it exits.
+//
+// Slabs are aligned to their size and are never returned to the system.
+// Each starts with a header recording the size class of its blocks, and
+// every slab is registered in a table, so freeing a block finds its size
+// class from the block's address rather than from the size it is freed
+// with, which for tail-allocated objects is only the class's instance size.
+// Tail-allocated buffers are never served from the cache anyway, because
+// their capacity is computed with malloc_size.
+//
+// The cache can be disabled at launch by setting the environment variable
+// SWIFT_RUNTIME_OBJECT_CACHE=0, which makes it easy to compare against the
+// system allocator.
+
+namespace {
+
+/// The granularity of size classes.
+constexpr size_t ObjectCacheQuantum = 16;
+
+/// The largest allocation served from the cache.
+constexpr size_t ObjectCacheMaxSize = 256;
+
+constexpr size_t NumObjectCacheSizeClasses =
+  ObjectCacheMaxSize / ObjectCacheQuantum;
+
+/// The number of blocks that move between a thread and the central pool
+/// at a time.
+constexpr unsigned ObjectCacheBatchSize = 32;
+
+/// The number of blocks a thread may cache per size class before handing a
+/// batch back to the central pool.
+constexpr unsigned ObjectCacheMaxThreadBlocks = 2 * ObjectCacheBatchSize;
+
+/// The size and alignment of the slabs blocks are carved from.
+constexpr size_t ObjectCacheSlabSize = 64 * 1024;
+
+/// The largest number of slabs the cache creates. Once they are all in
+/// use, small objects come from malloc.
+constexpr size_t ObjectCacheMaxSlabs = 16 * 1024;
+
+/// The number of slots in the table of slabs. This is a power of two and
+/// keeps the table at most half full.
+constexpr size_t SlabTableSize = 2 * ObjectCacheMaxSlabs;
+
+/// The largest alignment mask the cache can satisfy. Slabs are aligned to
+/// their size, and the slab header and block sizes are multiples of the
+/// quantum.
+constexpr size_t ObjectCacheMaxAlignMask = ObjectCacheQuantum - 1;
+
+/// A free block. The second word is only used while the block heads a batch
+/// in the central pool.
+struct FreeBlock {
+  FreeBlock *Next;
+  FreeBlock *NextBatch;
+};
+static_assert(sizeof(FreeBlock) <= ObjectCacheQuantum,
+              "free block header doesn't fit in the smallest size class");
+
+/// The header at the start of each slab. It keeps the blocks after it
+/// aligned to the quantum.
+struct alignas(ObjectCacheQuantum) SlabHeader {
+  unsigned SizeClass;
+};
+
+/// The central pool of free blocks for one size class.
+struct CentralSizeClass {
+  StaticMutex Lock;
+  /// Batches of at most ObjectCacheBatchSize blocks, linked through
+  /// NextBatch.
+  FreeBlock *Batches = nullptr;
+  /// Unused space at the end of the most recent slab.
+  char *SlabCursor = nullptr;
+  char *SlabEnd = nullptr;
+};
+
+static CentralSizeClass CentralPool[NumObjectCacheSizeClasses];
+
+/// The base addresses of all slabs, in an open-addressed table. Entries are
+/// added under SlabTableLock and never removed, so lookups don't lock.
+static std::atomic<uintptr_t> SlabTable[SlabTableSize];
+static StaticMutex SlabTableLock;
+
+/// The number of slabs created or being created.
+static std::atomic<size_t> NumSlabs;
+
+static size_t getSlabTableIndex(uintptr_t base) {
+  uint64_t hash = uint64_t(base / ObjectCacheSlabSize) * 0x9E3779B97F4A7C15ull;
+  return size_t(hash >> 32) & (SlabTableSize - 1);
+}
+
+/// Allocate and register a new slab for the given size class. Returns null
+/// if the cache already has as many slabs as it may.
+static char *createSlab(unsigned sizeClass) {
+  if (NumSlabs.load(std::memory_order_relaxed) >= ObjectCacheMaxSlabs ||
+      NumSlabs.fetch_add(1, std::memory_order_relaxed) >= ObjectCacheMaxSlabs)
+    return nullptr;
+
+  void *memory;
+  if (posix_memalign(&memory, ObjectCacheSlabSize, ObjectCacheSlabSize))
+    swift::crash("Could not allocate memory.");
+  auto slab = static_cast<char *>(memory);
+  reinterpret_cast<SlabHeader *>(slab)->SizeClass = sizeClass;
+
+  StaticScopedLock guard(SlabTableLock);
+  auto base = reinterpret_cast<uintptr_t>(slab);
+  size_t i = getSlabTableIndex(base);
+  while (SlabTable[i].load(std::memory_order_relaxed))
+    i = (i + 1) & (SlabTableSize - 1);
+  SlabTable[i].store(base, std::memory_order_release);
+  return slab;
+}
+
+/// Return the header of the slab containing the given memory, or null if
+/// the memory wasn't carved from a slab.
+static const SlabHeader *findSlab(const void *ptr) {
+  auto base = reinterpret_cast<uintptr_t>(ptr) & ~(ObjectCacheSlabSize - 1);
+  for (size_t i = getSlabTableIndex(base);; i = (i + 1) & (SlabTableSize - 1)) {
+    uintptr_t entry = SlabTable[i].load(std::memory_order_acquire);
+    if (entry == base)
+      return reinterpret_cast<const SlabHeader *>(base);
+    if (!entry)
+      return nullptr;
+  }
+}
+
+/// The per-thread cache of free blocks.
+struct ThreadObjectCache {
+  FreeBlock *FreeLists[NumObjectCacheSizeClasses];
+  unsigned Counts[NumObjectCacheSizeClasses];
+};
+
+/// The key of each thread's ThreadObjectCache. This uses a pthread key
+/// rather than C++11 thread_local, which not every deployment target
+/// supports, and it's only created when the cache is enabled.
+static pthread_key_t ThreadCacheKey;
+
+static size_t getBlockSize(unsigned sizeClass) {
+  return (sizeClass + 1) * ObjectCacheQuantum;
+}
+
+/// Hand a thread's cached blocks for one size class back to the central
+/// pool, in batches.
+static void releaseBlocks(ThreadObjectCache &cache, unsigned sizeClass,
+                          unsigned numToRelease) {
+  auto &central = CentralPool[sizeClass];
+  StaticScopedLock guard(central.Lock);
+  while (numToRelease) {
+    FreeBlock *batch = cache.FreeLists[sizeClass];
+    FreeBlock *last = batch;
+    unsigned n = 1;
+    for (; n < numToRelease && n < ObjectCacheBatchSize; ++n)
+      last = last->Next;
+    cache.FreeLists[sizeClass] = last->Next;
+    cache.Counts[sizeClass] -= n;
+    numToRelease -= n;
+
+    // The last batch released at thread exit may be short; refillBlocks
+    // counts the blocks it takes, so it is linked in like a full one.
+    last->Next = nullptr;
+    batch->NextBatch = central.Batches;
+    central.Batches = batch;
+  }
+}
+
+static void destroyThreadCache(void *value) {
+  auto cache = static_cast<ThreadObjectCache *>(value);
+  for (unsigned i = 0; i != NumObjectCacheSizeClasses; ++i)
+    if (cache->Counts[i])
+      releaseBlocks(*cache, i, cache->Counts[i]);
+  free(cache);
+}
+
+static bool computeObjectCacheEnabled() {
+  const char *setting = getenv("SWIFT_RUNTIME_OBJECT_CACHE");
+  if (setting && strcmp(setting, "0") == 0)
+    return false;
+  if (pthread_key_create(&ThreadCacheKey, destroyThreadCache) != 0)
+    return false;
+  return true;
+}
+
+static bool isObjectCacheEnabled() {
+  static const bool enabled = computeObjectCacheEnabled();
+  return enabled;
+}
+
+static ThreadObjectCache &getThreadCache() {
+  auto cache = static_cast<ThreadObjectCache *>(
+      pthread_getspecific(ThreadCacheKey));
+  if (!cache) {
+    cache = static_cast<ThreadObjectCache *>(
+        calloc(1, sizeof(ThreadObjectCache)));
+    if (!cache) swift::crash("Could not allocate memory.");
+    pthread_setspecific(ThreadCacheKey, cache);
+  }
+  return *cache;
+}
+
+/// Refill an empty thread free list from the central pool, carving new
+/// blocks from a slab if the pool has no batches. Returns false if no
+/// blocks are left and no more slabs may be created.
+static bool refillBlocks(ThreadObjectCache &cache, unsigned sizeClass) {
+  auto &central = CentralPool[sizeClass];
+  StaticScopedLock guard(central.Lock);
+
+  if (FreeBlock *batch = central.Batches) {
+    central.Batches = batch->NextBatch;
+    unsigned n = 0;
+    for (FreeBlock *block = batch; block; block = block->Next)
+      ++n;
+    cache.FreeLists[sizeClass] = batch;
+    cache.Counts[sizeClass] = n;
+    return true;
+  }
+
+  size_t blockSize = getBlockSize(sizeClass);
+  FreeBlock *list = nullptr;
+  unsigned n = 0;
+  for (; n != ObjectCacheBatchSize; ++n) {
+    if (size_t(central.SlabEnd - central.SlabCursor) < blockSize) {
+      char *slab = createSlab(sizeClass);
+      if (!slab)
+        break;
+      central.SlabCursor = slab + sizeof(SlabHeader);
+      central.SlabEnd = slab + ObjectCacheSlabSize;
+    }
+    auto block = reinterpret_cast<FreeBlock *>(central.SlabCursor);
+    central.SlabCursor += blockSize;
+    block->Next = list;
+    list = block;
+  }
+  cache.FreeLists[sizeClass] = list;
+  cache.Counts[sizeClass] = n;
+  return n != 0;
+}
+
+static bool isCacheableObjectSize(size_t size, size_t alignMask) {
+  return size != 0 && size <= ObjectCacheMaxSize &&
+         alignMask <= ObjectCacheMaxAlignMask && isObjectCacheEnabled();
+}
+
+static unsigned getSizeClass(size_t size) {
+  return (size - 1) / ObjectCacheQuantum;
+}
+
+} // end anonymous namespace
+
+void *swift::_swift_allocObjectMemory(size_t size, size_t alignMask) {
+  if (!isCacheableObjectSize(size, alignMask))
+    return allocateMemory(size, alignMask);
+
+  unsigned sizeClass = getSizeClass(size);
+  auto &cache = getThreadCache();
+  if (!cache.FreeLists[sizeClass] && !refillBlocks(cache, sizeClass))
+    return allocateMemory(size, alignMask);
+
+  FreeBlock *block = cache.FreeLists[sizeClass];
+  cache.FreeLists[sizeClass] = block->Next;
+  --cache.Counts[sizeClass];
+  return block;
+}
+
+void swift::_swift_deallocObjectMemory(void *ptr, size_t size,
+                                       size_t alignMask) {
+  const SlabHeader *slab = isObjectCacheEnabled() ? findSlab(ptr) : nullptr;
+  if (!slab)
+    return SWIFT_RT_ENTRY_CALL(swift_slowDealloc)(ptr, size, alignMask);
+
+  unsigned sizeClass = slab->SizeClass;
+  auto &cache = getThreadCache();
+  auto block = static_cast<FreeBlock *>(ptr);
+  block->Next = cache.FreeLists[sizeClass];
+  cache.FreeLists[sizeClass] = block;
+  if (++cache.Counts[sizeClass] > ObjectCacheMaxThreadBlocks)
+    releaseBlocks(cache, sizeClass, ObjectCacheBatchSize);
+}
+
+#else
+
+void *swift::_swift_allocObjectMemory(size_t size, size_t alignMask) {
+  return allocateMemory(size, alignMask);
+}
+
+void swift::_swift_deallocObjectMemory(void *ptr, size_t size,
+                                       size_t alignMask) {
+  SWIFT_RT_ENTRY_CALL(swift_slowDealloc)(ptr, size, alignMask);
+}
+
+#endif // SWIFT_RUNTIME_ENABLE_OBJECT_CACHE
+
+void *swift::_swift_allocBufferMemory(size_t size, size_t alignMask) {
+  return allocateMemory(size, alignMask);
+}
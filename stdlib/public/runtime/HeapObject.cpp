@@ -19,9 +19,12 @@
 #include "swift/Runtime/Heap.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/ABI/System.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/MathExtras.h"
+#include "AllocationProfiler.h"
 #include "MetadataCache.h"
 #include "Private.h"
+#include "Probes.h"
 #include "swift/Runtime/Debug.h"
 #include <algorithm>
 #include <cassert>
@@ -41,6 +44,23 @@
 
 using namespace swift;
 
+/// Initialize the header of a newly allocated heap object.
+static HeapObject *initHeapObject(void *memory, HeapMetadata const *metadata,
+                                  size_t requiredSize) {
+  auto object = reinterpret_cast<HeapObject *>(memory);
+  // FIXME: this should be a placement new but that adds a null check
+  object->metadata = metadata;
+  object->refCount.init();
+  object->weakRefCount.init();
+
+  // If leak tracking is enabled, start tracking this object.
+  SWIFT_LEAKS_START_TRACKING_OBJECT(object);
+
+  profileAllocation(metadata, requiredSize);
+
+  return object;
+}
+
 SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 HeapObject *
@@ -60,18 +80,15 @@ SWIFT_RT_ENTRY_IMPL(swift_allocObject)(HeapMetadata const *metadata,
                                        size_t requiredAlignmentMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
   assert(isAlignmentMask(requiredAlignmentMask));
-  auto object = reinterpret_cast<HeapObject *>(
-      SWIFT_RT_ENTRY_CALL(swift_slowAlloc)(requiredSize,
-                                           requiredAlignmentMask));
-  // FIXME: this should be a placement new but that adds a null check
-  object->metadata = metadata;
-  object->refCount.init();
-  object->weakRefCount.init();
-
-  // If leak tracking is enabled, start tracking this object.
-  SWIFT_LEAKS_START_TRACKING_OBJECT(object);
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+  if (auto region = _swift_getCurrentAllocationRegion())
+    return _swift_allocObjectInRegion(region, metadata, requiredSize,
+                                      requiredAlignmentMask);
+#endif
 
-  return object;
+  return initHeapObject(
+      _swift_allocObjectMemory(requiredSize, requiredAlignmentMask),
+      metadata, requiredSize);
 }
 
 HeapObject *
@@ -103,8 +120,11 @@ SWIFT_RUNTIME_EXPORT
 extern "C" HeapObject* swift_bufferAllocate(
   HeapMetadata const* bufferType, size_t size, size_t alignMask)
 {
-  return swift::SWIFT_RT_ENTRY_CALL(swift_allocObject)(bufferType, size,
-                                                       alignMask);
+  // Buffers compute their capacity with malloc_size, so they bypass the
+  // object cache and allocation regions.
+  assert(isAlignmentMask(alignMask));
+  return initHeapObject(_swift_allocBufferMemory(size, alignMask),
+                        bufferType, size);
 }
 
 /// \brief Another entrypoint for swift_bufferAllocate.
@@ -115,8 +135,7 @@ extern "C" HeapObject* swift_bufferAllocate(
 SWIFT_RUNTIME_EXPORT
 extern "C" HeapObject* swift_bufferAllocateOnStack(
   HeapMetadata const* bufferType, size_t size, size_t alignMask) {
-  return swift::SWIFT_RT_ENTRY_CALL(swift_allocObject)(bufferType, size,
-                                                       alignMask);
+  return swift_bufferAllocate(bufferType, size, alignMask);
 }
 
 /// \brief Called at the end of the lifetime of an object returned by
@@ -225,6 +244,62 @@ OpaqueValue *swift::swift_projectBox(HeapObject *o) {
   return metadata->project(o);
 }
 
+static HeapObject *getBufferBox(ValueBuffer *buffer) {
+  return reinterpret_cast<HeapObject *>(buffer->PrivateData[0]);
+}
+
+OpaqueValue *swift::swift_allocBufferBox(ValueBuffer *buffer,
+                                         const Metadata *type) {
+  BoxPair box = SWIFT_RT_ENTRY_CALL(swift_allocBox)(type);
+  buffer->PrivateData[0] = box.first;
+  return box.second;
+}
+
+OpaqueValue *swift::swift_projectBufferBox(ValueBuffer *buffer,
+                                           const Metadata *type) {
+  HeapObject *box = getBufferBox(buffer);
+  if (box->refCount.isUniquelyReferenced())
+    return swift_projectBox(box);
+
+  // Another buffer shares the box, so give this one its own copy.
+  BoxPair copy = SWIFT_RT_ENTRY_CALL(swift_allocBox)(type);
+  type->vw_initializeWithCopy(copy.second, swift_projectBox(box));
+  SWIFT_RT_ENTRY_CALL(swift_release)(box);
+  buffer->PrivateData[0] = copy.first;
+  return copy.second;
+}
+
+OpaqueValue *swift::swift_projectBufferForRead(ValueBuffer *buffer,
+                                               const Metadata *type) {
+  if (type->getValueWitnesses()->isValueInline())
+    return reinterpret_cast<OpaqueValue *>(buffer);
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  return swift_projectBox(getBufferBox(buffer));
+#else
+  return reinterpret_cast<OpaqueValue *>(buffer->PrivateData[0]);
+#endif
+}
+
+OpaqueValue *swift::swift_copyBufferBox(ValueBuffer *dest, ValueBuffer *src) {
+  HeapObject *box = getBufferBox(src);
+  SWIFT_RT_ENTRY_CALL(swift_retain)(box);
+  dest->PrivateData[0] = box;
+  return swift_projectBox(box);
+}
+
+void swift::swift_deallocBufferBox(ValueBuffer *buffer) {
+  HeapObject *box = getBufferBox(buffer);
+  // The box was made unique when its value was projected for the take.
+  bool shouldDeallocate = box->refCount.decrementShouldDeallocate();
+  assert(shouldDeallocate && "deallocating a shared buffer box");
+  (void) shouldDeallocate;
+  swift_deallocBox(box);
+}
+
+void swift::swift_destroyBufferBox(ValueBuffer *buffer) {
+  SWIFT_RT_ENTRY_CALL(swift_release)(getBufferBox(buffer));
+}
+
 // Forward-declare this, but define it after swift_release.
 extern "C" LLVM_LIBRARY_VISIBILITY void
 _swift_release_dealloc(HeapObject *object) SWIFT_CC(RegisterPreservingCC_IMPL)
@@ -382,9 +457,8 @@ void swift::swift_unownedRelease(HeapObject *object)
     assert(metadata->isClassObject());
     auto classMetadata = static_cast<const ClassMetadata*>(metadata);
     assert(classMetadata->isTypeMetadata());
-    SWIFT_RT_ENTRY_CALL(swift_slowDealloc)
-        (object, classMetadata->getInstanceSize(),
-         classMetadata->getInstanceAlignMask());
+    _swift_deallocObjectMemory(object, classMetadata->getInstanceSize(),
+                               classMetadata->getInstanceAlignMask());
   }
 }
 
@@ -411,9 +485,8 @@ void swift::swift_unownedRelease_n(HeapObject *object, int n)
     assert(metadata->isClassObject());
     auto classMetadata = static_cast<const ClassMetadata*>(metadata);
     assert(classMetadata->isTypeMetadata());
-    SWIFT_RT_ENTRY_CALL(swift_slowDealloc)
-        (object, classMetadata->getInstanceSize(),
-         classMetadata->getInstanceAlignMask());
+    _swift_deallocObjectMemory(object, classMetadata->getInstanceSize(),
+                               classMetadata->getInstanceAlignMask());
   }
 }
 
@@ -636,6 +709,10 @@ static inline void memset_pattern8(void *b, const void *pattern8, size_t len) {
 }
 #endif
 
+#if SWIFT_RUNTIME_ENABLE_WEAK_SIDE_TABLE
+static void detachWeakSideTableEntry(HeapObject *object);
+#endif
+
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_deallocObject(HeapObject *object,
                                 size_t allocatedSize,
@@ -652,10 +729,16 @@ void swift::swift_deallocObject(HeapObject *object,
   // If we are tracking leaks, stop tracking this object.
   SWIFT_LEAKS_STOP_TRACKING_OBJECT(object);
 
+#if SWIFT_RUNTIME_ENABLE_WEAK_SIDE_TABLE
+  // Make weak references to the object see nil before its memory goes away.
+  if (object->weakRefCount.hasSideTable())
+    detachWeakSideTableEntry(object);
+#endif
+
   // Drop the initial weak retain of the object.
   //
   // If the outstanding weak retain count is 1 (i.e. only the initial
-  // weak retain), we can immediately call swift_slowDealloc.  This is
+  // weak retain), we can immediately free the memory.  This is
   // useful both as a way to eliminate an unnecessary atomic
   // operation, and as a way to avoid calling swift_unownedRelease on an
   // object that might be a class object, which simplifies the logic
@@ -718,9 +801,7 @@ void swift::swift_deallocObject(HeapObject *object,
   // atomic decrement (and has the ability to reconstruct
   // allocatedSize and allocatedAlignMask).
   if (object->weakRefCount.getCount() == 1) {
-    SWIFT_RT_ENTRY_CALL(swift_slowDealloc)
-         (object, allocatedSize,
-          allocatedAlignMask);
+    _swift_deallocObjectMemory(object, allocatedSize, allocatedAlignMask);
   } else {
     SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
   }
@@ -744,6 +825,193 @@ bool swift::isNativeSwiftWeakReference(WeakReference *ref) {
   return (ref->Value & WR_NATIVEMASK) == WR_NATIVE;
 }
 
+#if SWIFT_RUNTIME_ENABLE_WEAK_SIDE_TABLE
+
+namespace {
+
+/// The out-of-line entry that native weak references point to.
+///
+/// Weak references keep the entry alive rather than the object, so the
+/// object's memory can be freed as soon as it is deinitialized instead of
+/// lingering until the last weak reference goes away. The entry is
+/// detached from its object in swift_deallocObject.
+struct WeakSideTableEntry {
+  /// The object, or null once it has been deallocated. WR_READING is used
+  /// as a lock bit that keeps the object's memory from being freed while a
+  /// weak load is trying to retain it.
+  uintptr_t Object;
+
+  /// The number of weak references to this entry, plus one while the
+  /// entry is attached to its object.
+  std::atomic<size_t> RefCount;
+
+  explicit WeakSideTableEntry(HeapObject *object)
+    : Object(uintptr_t(object)), RefCount(1) {}
+
+  /// Lock the entry and return the object.
+  HeapObject *lock() {
+    auto ptr = __atomic_fetch_or(&Object, WR_READING, __ATOMIC_ACQUIRE);
+    while (ptr & WR_READING) {
+      short c = 0;
+      while (__atomic_load_n(&Object, __ATOMIC_RELAXED) & WR_READING) {
+        if (++c == WR_SPINLIMIT) {
+          std::this_thread::yield();
+          c -= 1;
+        }
+      }
+      ptr = __atomic_fetch_or(&Object, WR_READING, __ATOMIC_ACQUIRE);
+    }
+    return (HeapObject*) ptr;
+  }
+
+  /// Unlock the entry, leaving it pointing at \p object.
+  void unlock(HeapObject *object) {
+    __atomic_store_n(&Object, uintptr_t(object), __ATOMIC_RELEASE);
+  }
+
+  void retain() { RefCount.fetch_add(1, std::memory_order_relaxed); }
+
+  void release() {
+    if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+};
+
+/// The entries of all objects that have been weakly referenced, sharded
+/// by object address.
+class WeakSideTable {
+  static constexpr unsigned NumShards = 16;
+
+  struct Shard {
+    Mutex Lock;
+    llvm::DenseMap<HeapObject *, WeakSideTableEntry *> Entries;
+  };
+  Shard Shards[NumShards];
+
+  Shard &getShard(HeapObject *object) {
+    return Shards[(uintptr_t(object) >> 4) & (NumShards - 1)];
+  }
+
+public:
+  /// Return the entry for a live object, creating it if necessary, and
+  /// retain it on behalf of a new weak reference.
+  WeakSideTableEntry *getEntryForNewReference(HeapObject *object) {
+    auto &shard = getShard(object);
+    ScopedLock guard(shard.Lock);
+    auto &entry = shard.Entries[object];
+    if (!entry) {
+      entry = new WeakSideTableEntry(object);
+      object->weakRefCount.setHasSideTable();
+    }
+    entry->retain();
+    return entry;
+  }
+
+  /// Remove and return the entry for an object that is being deallocated.
+  WeakSideTableEntry *takeEntry(HeapObject *object) {
+    auto &shard = getShard(object);
+    ScopedLock guard(shard.Lock);
+    auto found = shard.Entries.find(object);
+    assert(found != shard.Entries.end() && "object has no side table entry");
+    auto entry = found->second;
+    shard.Entries.erase(found);
+    return entry;
+  }
+};
+
+} // end anonymous namespace
+
+static Lazy<WeakSideTable> WeakSideTables;
+
+static void detachWeakSideTableEntry(HeapObject *object) {
+  auto entry = WeakSideTables.get().takeEntry(object);
+  // Wait out any weak load that is in the middle of retaining the object.
+  entry->lock();
+  entry->unlock(nullptr);
+  entry->release();
+}
+
+static WeakSideTableEntry *getWeakSideTableEntry(WeakReference *ref) {
+  return (WeakSideTableEntry*) (ref->Value & ~WR_NATIVE);
+}
+
+static void setWeakSideTableEntry(WeakReference *ref,
+                                  WeakSideTableEntry *entry) {
+  ref->Value = entry ? (uintptr_t)entry | WR_NATIVE : (uintptr_t)nullptr;
+}
+
+static WeakSideTableEntry *getEntryForNewReference(HeapObject *value) {
+  if (!value)
+    return nullptr;
+  return WeakSideTables.get().getEntryForNewReference(value);
+}
+
+void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
+  setWeakSideTableEntry(ref, getEntryForNewReference(value));
+}
+
+void swift::swift_weakAssign(WeakReference *ref, HeapObject *newValue) {
+  auto newEntry = getEntryForNewReference(newValue);
+  auto oldEntry = getWeakSideTableEntry(ref);
+  setWeakSideTableEntry(ref, newEntry);
+  if (oldEntry)
+    oldEntry->release();
+}
+
+HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
+  auto entry = getWeakSideTableEntry(ref);
+  if (!entry)
+    return nullptr;
+
+  auto object = entry->lock();
+  auto result = swift_tryRetain(object);
+  entry->unlock(object);
+  if (object && !result)
+    SWIFT_RUNTIME_PROBE2(weak__zombie, ref, object);
+  return result;
+}
+
+HeapObject *swift::swift_weakTakeStrong(WeakReference *ref) {
+  auto result = swift_weakLoadStrong(ref);
+  swift_weakDestroy(ref);
+  return result;
+}
+
+void swift::swift_weakDestroy(WeakReference *ref) {
+  auto entry = getWeakSideTableEntry(ref);
+  ref->Value = (uintptr_t)nullptr;
+  if (entry)
+    entry->release();
+}
+
+void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
+  auto entry = getWeakSideTableEntry(src);
+  if (entry)
+    entry->retain();
+  setWeakSideTableEntry(dest, entry);
+}
+
+void swift::swift_weakTakeInit(WeakReference *dest, WeakReference *src) {
+  dest->Value = src->Value;
+  src->Value = (uintptr_t)nullptr;
+}
+
+void swift::swift_weakCopyAssign(WeakReference *dest, WeakReference *src) {
+  auto oldEntry = getWeakSideTableEntry(dest);
+  swift_weakCopyInit(dest, src);
+  if (oldEntry)
+    oldEntry->release();
+}
+
+void swift::swift_weakTakeAssign(WeakReference *dest, WeakReference *src) {
+  auto oldEntry = getWeakSideTableEntry(dest);
+  swift_weakTakeInit(dest, src);
+  if (oldEntry)
+    oldEntry->release();
+}
+
+#else
+
 void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
   ref->Value = (uintptr_t)value | WR_NATIVE;
   SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(value);
@@ -780,6 +1048,7 @@ HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
     return nullptr;
   }
   if (object->refCount.isDeallocating()) {
+    SWIFT_RUNTIME_PROBE2(weak__zombie, ref, object);
     __atomic_store_n(&ref->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
     SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
     return nullptr;
@@ -867,6 +1136,8 @@ void swift::swift_weakTakeAssign(WeakReference *dest, WeakReference *src) {
   swift_weakTakeInit(dest, src);
 }
 
+#endif // SWIFT_RUNTIME_ENABLE_WEAK_SIDE_TABLE
+
 void swift::_swift_abortRetainUnowned(const void *object) {
   (void)object;
   swift::crash("attempted to retain deallocated object");
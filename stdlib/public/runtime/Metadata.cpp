@@ -24,6 +24,7 @@
 #include "swift/Runtime/Mutex.h"
 #include "swift/Strings.h"
 #include "MetadataCache.h"
+#include "Probes.h"
 #include <algorithm>
 #include <condition_variable>
 #include <new>
@@ -34,6 +35,7 @@
 #define NOMINMAX
 #include <windows.h>
 #else
+#include <pthread.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
@@ -114,6 +116,9 @@ void *MetadataAllocator::alloc(size_t size) {
     void *mem = swift_allocateMetadataRoundingToPage(size);
     if (!mem)
       crash("unable to allocate memory for metadata cache");
+    if (_swift_areMetadataStatisticsEnabled())
+      _swift_recordMetadataAllocatorBytes((size + PageSize - 1) &
+                                          ~(PageSize - 1));
     return mem;
   }
 
@@ -141,6 +146,8 @@ void *MetadataAllocator::alloc(size_t size) {
     if (LLVM_LIKELY(std::atomic_compare_exchange_weak_explicit(
             &NextValue, &curValue, reinterpret_cast<uintptr_t>(end),
             std::memory_order_relaxed, std::memory_order_relaxed))) {
+      if (allocation && _swift_areMetadataStatisticsEnabled())
+        _swift_recordMetadataAllocatorBytes(PageSize);
       return next;
     }
 
@@ -153,6 +160,38 @@ void *MetadataAllocator::alloc(size_t size) {
   }
 }
 
+/// The allocator shared by threads that can't have their own.
+static MetadataAllocator SharedMetadataAllocator;
+
+#if !defined(_MSC_VER)
+static void destroyThreadMetadataAllocator(void *allocator) {
+  // Metadata is never freed, so everything allocated so far stays valid;
+  // only the unused rest of the allocator's current page is lost.
+  delete static_cast<MetadataAllocator *>(allocator);
+}
+#endif
+
+MetadataAllocator &swift::getThreadMetadataAllocator() {
+#if defined(_MSC_VER)
+  return SharedMetadataAllocator;
+#else
+  // This uses a pthread key rather than C++11 thread_local, which not every
+  // deployment target supports and which is slow to access on Darwin.
+  static pthread_key_t key;
+  static const bool haveKey =
+    pthread_key_create(&key, destroyThreadMetadataAllocator) == 0;
+  if (!haveKey)
+    return SharedMetadataAllocator;
+
+  auto allocator = static_cast<MetadataAllocator *>(pthread_getspecific(key));
+  if (!allocator) {
+    allocator = new MetadataAllocator();
+    pthread_setspecific(key, allocator);
+  }
+  return *allocator;
+#endif
+}
+
 namespace {
   struct GenericCacheEntry;
 
@@ -322,6 +361,7 @@ swift::swift_getGenericMetadata(GenericMetadata *pattern,
     [&]() -> GenericCacheEntry* {
       // Create new metadata to cache.
       auto metadata = pattern->CreateFunction(pattern, arguments);
+      SWIFT_RUNTIME_PROBE2(metadata__instantiate, pattern, metadata);
       auto entry = GenericCacheEntry::getFromMetadata(pattern, metadata);
       entry->Value = metadata;
       return entry;
@@ -587,8 +627,12 @@ static OpaqueValue *tuple_projectBuffer(ValueBuffer *buffer,
 
   if (IsInline)
     return reinterpret_cast<OpaqueValue*>(buffer);
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  return swift_projectBufferBox(buffer, metatype);
+#else
   else
     return *reinterpret_cast<OpaqueValue**>(buffer);
+#endif
 }
 
 /// Generic tuple value witness for 'allocateBuffer'
@@ -601,12 +645,16 @@ static OpaqueValue *tuple_allocateBuffer(ValueBuffer *buffer,
   if (IsInline)
     return reinterpret_cast<OpaqueValue*>(buffer);
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  return swift_allocBufferBox(buffer, metatype);
+#else
   auto wtable = tuple_getValueWitnesses(metatype);
   auto value = (OpaqueValue*) swift_slowAlloc(wtable->size,
                                               wtable->getAlignmentMask());
 
   *reinterpret_cast<OpaqueValue**>(buffer) = value;
   return value;
+#endif
 }
 
 /// Generic tuple value witness for 'deallocateBuffer'.
@@ -619,9 +667,13 @@ static void tuple_deallocateBuffer(ValueBuffer *buffer,
   if (IsInline)
     return;
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  swift_deallocBufferBox(buffer);
+#else
   auto wtable = tuple_getValueWitnesses(metatype);
   auto value = *reinterpret_cast<OpaqueValue**>(buffer);
   swift_slowDealloc(value, wtable->size, wtable->getAlignmentMask());
+#endif
 }
 
 /// Generic tuple value witness for 'destroy'.
@@ -666,6 +718,11 @@ static void tuple_destroyBuffer(ValueBuffer *buffer, const Metadata *metatype) {
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  if (!IsInline)
+    return swift_destroyBufferBox(buffer);
+#endif
+
   auto tuple = tuple_projectBuffer<IsPOD, IsInline>(buffer, metatype);
   tuple_destroy<IsPOD, IsInline>(tuple, metatype);
   tuple_deallocateBuffer<IsPOD, IsInline>(buffer, metatype);
@@ -721,6 +778,25 @@ static OpaqueValue *tuple_memmove_array(OpaqueValue *dest,
     memmove(dest, src, metatype->getValueWitnesses()->stride * n);
 }
 
+/// Perform a naive memcpy of src into dest, leaving src uninitialized.
+static OpaqueValue *tuple_take_memcpy(OpaqueValue *dest,
+                                      OpaqueValue *src,
+                                      const Metadata *metatype) {
+  assert(metatype->getValueWitnesses()->isBitwiseTakable());
+  return (OpaqueValue*)
+    memcpy(dest, src, metatype->getValueWitnesses()->getSize());
+}
+/// Perform a naive memmove of n tuples from src into dest, leaving src
+/// uninitialized.
+static OpaqueValue *tuple_take_memmove_array(OpaqueValue *dest,
+                                             OpaqueValue *src,
+                                             size_t n,
+                                             const Metadata *metatype) {
+  assert(metatype->getValueWitnesses()->isBitwiseTakable());
+  return (OpaqueValue*)
+    memmove(dest, src, metatype->getValueWitnesses()->stride * n);
+}
+
 /// Generic tuple value witness for 'initializeWithCopy'.
 template <bool IsPOD, bool IsInline>
 static OpaqueValue *tuple_initializeWithCopy(OpaqueValue *dest,
@@ -768,6 +844,10 @@ static OpaqueValue *tuple_initializeWithTake(OpaqueValue *dest,
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
   if (IsPOD) return tuple_memcpy(dest, src, metatype);
+  // Tuples of bitwise-takable elements, such as strong references, can be
+  // moved without visiting each element's witnesses.
+  if (tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_take_memcpy(dest, src, metatype);
   return tuple_forEachField(dest, src, metatype,
                             &ValueWitnessTable::initializeWithTake);
 }
@@ -783,6 +863,8 @@ static OpaqueValue *tuple_initializeArrayWithTakeFrontToBack(
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
   if (IsPOD) return tuple_memmove_array(dest, src, n, metatype);
+  if (tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_take_memmove_array(dest, src, n, metatype);
 
   char *destBytes = (char*)dest;
   char *srcBytes = (char*)src;
@@ -809,6 +891,8 @@ static OpaqueValue *tuple_initializeArrayWithTakeBackToFront(
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
   if (IsPOD) return tuple_memmove_array(dest, src, n, metatype);
+  if (tuple_getValueWitnesses(metatype)->isBitwiseTakable())
+    return tuple_take_memmove_array(dest, src, n, metatype);
 
   size_t stride = tuple_getValueWitnesses(metatype)->stride;
   char *destBytes = (char*)dest + n * stride;
@@ -883,6 +967,11 @@ static OpaqueValue *tuple_initializeBufferWithCopyOfBuffer(ValueBuffer *dest,
   assert(IsPOD == tuple_getValueWitnesses(metatype)->isPOD());
   assert(IsInline == tuple_getValueWitnesses(metatype)->isValueInline());
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  if (!IsInline)
+    return swift_copyBufferBox(dest, src);
+#endif
+
   return tuple_initializeBufferWithCopy<IsPOD, IsInline>(
                             dest,
                             tuple_projectBuffer<IsPOD, IsInline>(src, metatype),
@@ -904,7 +993,11 @@ static OpaqueValue *tuple_initializeBufferWithTakeOfBuffer(ValueBuffer *dest,
                       metatype);
   } else {
     dest->PrivateData[0] = src->PrivateData[0];
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+    return swift_projectBox((HeapObject*) dest->PrivateData[0]);
+#else
     return (OpaqueValue*) dest->PrivateData[0];
+#endif
   }
 }
 
@@ -1189,6 +1282,43 @@ static constexpr Out *pointer_function_cast(In *function) {
   return pointer_function_cast_impl<Out>::perform(function);
 }
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+
+// Out-of-line POD values live in shared boxes; see swift_allocBufferBox.
+
+static void pod_indirect_deallocateBuffer(ValueBuffer *buffer,
+                                          const Metadata *self) {
+  swift_deallocBufferBox(buffer);
+}
+
+static void pod_indirect_destroyBuffer(ValueBuffer *buffer,
+                                       const Metadata *self) {
+  swift_destroyBufferBox(buffer);
+}
+
+static OpaqueValue *pod_indirect_initializeBufferWithCopyOfBuffer(
+                    ValueBuffer *dest, ValueBuffer *src, const Metadata *self) {
+  return swift_copyBufferBox(dest, src);
+}
+
+static OpaqueValue *pod_indirect_initializeBufferWithTakeOfBuffer(
+                    ValueBuffer *dest, ValueBuffer *src, const Metadata *self) {
+  memcpy(dest, src, sizeof(ValueBuffer));
+  return swift_projectBox(reinterpret_cast<HeapObject *>(dest->PrivateData[0]));
+}
+
+static OpaqueValue *pod_indirect_projectBuffer(ValueBuffer *buffer,
+                                               const Metadata *self) {
+  return swift_projectBufferBox(buffer, self);
+}
+
+static OpaqueValue *pod_indirect_allocateBuffer(ValueBuffer *buffer,
+                                                const Metadata *self) {
+  return swift_allocBufferBox(buffer, self);
+}
+
+#else
+
 static void pod_indirect_deallocateBuffer(ValueBuffer *buffer,
                                           const Metadata *self) {
   auto value = *reinterpret_cast<OpaqueValue**>(buffer);
@@ -1229,6 +1359,8 @@ static OpaqueValue *pod_indirect_allocateBuffer(ValueBuffer *buffer,
   return destBuf;
 }
 
+#endif
+
 static void pod_noop(void *object, const Metadata *self) {
 }
 #define pod_direct_destroy \
@@ -1251,9 +1383,7 @@ static OpaqueValue *pod_indirect_initializeBufferWithCopy(ValueBuffer *dest,
                                                           OpaqueValue *src,
                                                           const Metadata *self){
   auto wtable = self->getValueWitnesses();
-  auto destBuf = (OpaqueValue*)swift_slowAlloc(wtable->size,
-                                               wtable->getAlignmentMask());
-  *reinterpret_cast<OpaqueValue**>(dest) = destBuf;
+  auto destBuf = pod_indirect_allocateBuffer(dest, self);
   memcpy(destBuf, src, wtable->size);
   return destBuf;
 }
@@ -2245,8 +2375,9 @@ ExistentialTypeMetadata::projectValue(const OpaqueValue *container) const {
   case ExistentialTypeRepresentation::Opaque: {
     auto opaqueContainer =
       reinterpret_cast<const OpaqueExistentialContainer*>(container);
-    return opaqueContainer->Type->vw_projectBuffer(
-                         const_cast<ValueBuffer*>(&opaqueContainer->Buffer));
+    return swift_projectBufferForRead(
+                         const_cast<ValueBuffer*>(&opaqueContainer->Buffer),
+                         opaqueContainer->Type);
   }
   case ExistentialTypeRepresentation::Error: {
     const SwiftError *errorBox
@@ -2327,20 +2458,11 @@ const ExistentialTypeMetadata *
 swift::swift_getExistentialTypeMetadata(size_t numProtocols,
                                         const ProtocolDescriptor **protocols)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
-  // Sort the protocol set.
-  std::sort(protocols, protocols + numProtocols);
-
-  // Calculate the class constraint and number of witness tables for the
-  // protocol set.
-  unsigned numWitnessTables = 0;
-  ProtocolClassConstraint classConstraint = ProtocolClassConstraint::Any;
-  for (auto p : make_range(protocols, protocols + numProtocols)) {
-    if (p->Flags.needsWitnessTable()) {
-      ++numWitnessTables;
-    }
-    if (p->Flags.getClassConstraint() == ProtocolClassConstraint::Class)
-      classConstraint = ProtocolClassConstraint::Class;
-  }
+  // Sort the protocol set. A single protocol, or a composition whose
+  // descriptors already happen to be in address order, doesn't need to be
+  // reordered.
+  if (numProtocols > 1 && !std::is_sorted(protocols, protocols + numProtocols))
+    std::sort(protocols, protocols + numProtocols);
 
   // Search the cache.
 
@@ -2354,6 +2476,18 @@ swift::swift_getExistentialTypeMetadata(size_t numProtocols,
                              protocolArgs, numProtocols,
                              sizeof(const ProtocolDescriptor *) * numProtocols);
       auto metadata = entry->getData();
+
+      // Calculate the class constraint and number of witness tables for the
+      // protocol set.
+      unsigned numWitnessTables = 0;
+      ProtocolClassConstraint classConstraint = ProtocolClassConstraint::Any;
+      for (auto p : make_range(protocols, protocols + numProtocols)) {
+        if (p->Flags.needsWitnessTable()) {
+          ++numWitnessTables;
+        }
+        if (p->Flags.getClassConstraint() == ProtocolClassConstraint::Class)
+          classConstraint = ProtocolClassConstraint::Class;
+      }
       
       // Get the special protocol kind for an uncomposed protocol existential.
       // Protocol compositions are currently never special.
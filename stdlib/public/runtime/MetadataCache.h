@@ -17,6 +17,7 @@
 #include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Mutex.h"
+#include "MetadataStatistics.h"
 #include <condition_variable>
 #include <thread>
 
@@ -27,10 +28,11 @@
 namespace swift {
 
 /// A bump pointer for metadata allocations. Since metadata is (currently)
-/// never released, it does not support deallocation. This allocator by itself
-/// is not thread-safe; in concurrent uses, allocations must be guarded by
-/// a lock, such as the per-metadata-cache lock used to guard metadata
-/// instantiations. All allocations are pointer-aligned.
+/// never released, it does not support deallocation. Allocations are
+/// lock-free, but every allocation from the same allocator contends on a
+/// single atomic; metadata caches therefore allocate from a per-thread
+/// allocator (see getThreadMetadataAllocator). All allocations are
+/// pointer-aligned.
 class MetadataAllocator {
   /// Address of the next available space. The allocator grabs a page at a time,
   /// so the need for a new page can be determined by page alignment.
@@ -51,6 +53,12 @@ public:
   void *alloc(size_t size);
 };
 
+/// Return the metadata allocator for the current thread.
+///
+/// Metadata is never freed, so memory from this allocator may safely
+/// outlive the thread that allocated it.
+MetadataAllocator &getThreadMetadataAllocator();
+
 // A wrapper around a pointer to a metadata cache entry that provides
 // DenseMap semantics that compare values in the key vector for the metadata
 // instance.
@@ -150,9 +158,11 @@ public:
   static Impl *allocate(MetadataAllocator &allocator,
                         const void * const *arguments,
                         size_t numArguments, size_t payloadSize) {
-    void *buffer = allocator.alloc(sizeof(Impl)  +
-                                   numArguments * sizeof(void*) +
-                                   payloadSize);
+    size_t size = sizeof(Impl) + numArguments * sizeof(void*) + payloadSize;
+    if (_swift_areMetadataStatisticsEnabled())
+      getMetadataCacheStatistics<Impl>().recordBytes(size);
+
+    void *buffer = allocator.alloc(size);
     void *resultPtr = (char*)buffer + numArguments * sizeof(void*);
     auto result = new (resultPtr) Impl(numArguments);
 
@@ -188,6 +198,11 @@ public:
 
 /// The implementation of a metadata cache.  Note that all-zero must
 /// be a valid state for the cache.
+///
+/// Entries are spread across a fixed number of shards by the hash of
+/// their arguments, so that threads instantiating metadata for different
+/// arguments of the same pattern don't serialize on a single map or
+/// lock.
 template <class ValueTy> class MetadataCache {
   /// A key value as provided to the concurrent map.
   struct Key {
@@ -244,6 +259,10 @@ template <class ValueTy> class MetadataCache {
       return key.KeyData.size() * sizeof(void*);
     }
 
+    static size_t getKeyHash(const Key &key) {
+      return key.Hash;
+    }
+
     int compareWithKey(const Key &key) const {
       // Order by hash first, then by the actual key data.
       if (key.Hash != Hash) {
@@ -266,28 +285,55 @@ template <class ValueTy> class MetadataCache {
     }
   };
 
-  /// The concurrent map.
-  ConcurrentMap<Entry> Map;
+  /// The number of shards. Must be a power of two.
+  static constexpr unsigned NumShards = 8;
+
+  /// The hash bits below this are used by the map within a shard, so the
+  /// shard is chosen from the bits above it.
+  static constexpr unsigned ShardHashShift = 16;
+
+  /// A partition of the cache: a concurrent map together with the lock
+  /// and condition variable used to wait for entries in that map to be
+  /// initialized.
+  struct Shard {
+    ConcurrentHashMap<Entry> Map;
+    Mutex Lock;
+    ConditionVariable Queue;
+  };
+  std::unique_ptr<Shard[]> Shards;
+
+  /// Unused. LLDB reads Head two pointers into the cache, so this keeps it
+  /// there now that the shards only take up one.
+  void *Reserved;
 
-  static_assert(sizeof(Map) == 2 * sizeof(void*),
+  static_assert(sizeof(Shards) + sizeof(Reserved) == 2 * sizeof(void*),
                 "offset of Head is not at proper offset");
 
   /// The head of a linked list connecting all the metadata cache entries.
   /// TODO: Remove this when LLDB is able to understand the final data
   /// structure for the metadata cache.
-  const ValueTy *Head;
+  std::atomic<const ValueTy *> Head;
 
-  struct ConcurrencyControl {
-    Mutex Lock;
-    ConditionVariable Queue;
-  };
-  std::unique_ptr<ConcurrencyControl> Concurrency;
+  static_assert(sizeof(Head) == sizeof(void*),
+                "LLDB reads Head as a plain pointer");
+
+  Shard &getShard(const Key &key) {
+    return Shards[(key.Hash >> ShardHashShift) & (NumShards - 1)];
+  }
+
+  /// Push a newly-created value onto the linked list of all values.
+  void addToList(ValueTy *value) {
+    auto head = Head.load(std::memory_order_relaxed);
+    do {
+      value->Next = head;
+    } while (!Head.compare_exchange_weak(head, value,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+  }
 
-  /// Allocator for entries of this cache.
-  MetadataAllocator Allocator;
-  
 public:
-  MetadataCache() : Concurrency(new ConcurrencyControl()) {}
+  MetadataCache()
+    : Shards(new Shard[NumShards]), Reserved(nullptr), Head(nullptr) {}
   ~MetadataCache() {}
 
   /// Caches are not copyable.
@@ -295,9 +341,9 @@ public:
   MetadataCache &operator=(const MetadataCache &other) = delete;
 
   /// Get the allocator for metadata in this cache.
-  /// The allocator can only be safely used while the cache is locked during
-  /// an addMetadataEntry call.
-  MetadataAllocator &getAllocator() { return Allocator; }
+  /// This is the calling thread's allocator, so the result must not be
+  /// cached and used from another thread.
+  MetadataAllocator &getAllocator() { return getThreadMetadataAllocator(); }
 
   /// Look up a cached metadata entry. If a cache match exists, return it.
   /// Otherwise, call entryBuilder() and add that to the cache.
@@ -319,10 +365,23 @@ public:
            ValueTy::getName(), this, key.Hash);
 #endif
 
+    Shard &shard = getShard(key);
+
+    MetadataCacheStatistics *statistics = nullptr;
+    if (_swift_areMetadataStatisticsEnabled())
+      statistics = &getMetadataCacheStatistics<ValueTy>();
+
     // Ensure the existence of a map entry.
-    auto insertResult = Map.getOrInsert(key);
+    auto insertResult = shard.Map.getOrInsert(key);
     Entry *entry = insertResult.first;
 
+    if (statistics) {
+      if (insertResult.second)
+        statistics->recordMiss();
+      else
+        statistics->recordHit();
+    }
+
     // If we didn't insert the entry, then we just need to get the
     // initialized value from the entry.
     if (!insertResult.second) {
@@ -336,8 +395,7 @@ public:
       // Otherwise, we have to grab the lock and wait for the value to
       // appear there.  Note that we have to check again immediately
       // after acquiring the lock to prevent a race.
-      auto concurrency = Concurrency.get();
-      concurrency->Lock.withLockOrWait(concurrency->Queue, [&, this] {
+      shard.Lock.withLockOrWait(shard.Queue, [&, this] {
         if ((value = entry->getValue())) {
           return true; // found a value, done waiting
         }
@@ -360,11 +418,14 @@ public:
 
     // Otherwise, we created the entry and are responsible for
     // creating the metadata.
-    auto value = builder();
+    ValueTy *value;
+    {
+      MetadataStatisticsTimer timer(statistics);
+      value = builder();
+    }
 
     // Update the linked list.
-    value->Next = Head;
-    Head = value;
+    addToList(value);
 
 #if SWIFT_DEBUG_RUNTIME
         printf("%s(%p): created %p\n",
@@ -372,9 +433,8 @@ public:
 #endif
 
     // Acquire the lock, set the value, and notify any waiters.
-    auto concurrency = Concurrency.get();
-    concurrency->Lock.withLockThenNotifyAll(
-        concurrency->Queue, [&entry, &value] { entry->setValue(value); });
+    shard.Lock.withLockThenNotifyAll(
+        shard.Queue, [&entry, &value] { entry->setValue(value); });
 
     return value;
   }
@@ -808,6 +808,25 @@ struct BufferValueWitnesses<Impl, Size, Alignment, FixedPacking::Allocate>
     : BufferValueWitnessesBase<Impl> {
   static constexpr bool isInline = false;
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  static OpaqueValue *allocateBuffer(ValueBuffer *buffer, const Metadata *self) {
+    return swift_allocBufferBox(buffer, self);
+  }
+  static OpaqueValue *projectBuffer(ValueBuffer *buffer, const Metadata *self) {
+    return swift_projectBufferBox(buffer, self);
+  }
+  static void deallocateBuffer(ValueBuffer *buffer, const Metadata *self) {
+    swift_deallocBufferBox(buffer);
+  }
+  static void destroyBuffer(ValueBuffer *buffer, const Metadata *self) {
+    swift_destroyBufferBox(buffer);
+  }
+  static OpaqueValue *initializeBufferWithCopyOfBuffer(ValueBuffer *dest,
+                                                       ValueBuffer *src,
+                                                       const Metadata *self) {
+    return swift_copyBufferBox(dest, src);
+  }
+#else
   static OpaqueValue *allocateBuffer(ValueBuffer *buffer, const Metadata *self) {
     OpaqueValue *value =
       static_cast<OpaqueValue*>(SwiftAllocator<Size, Alignment>::alloc());
@@ -820,11 +839,16 @@ struct BufferValueWitnesses<Impl, Size, Alignment, FixedPacking::Allocate>
   static void deallocateBuffer(ValueBuffer *buffer, const Metadata *self) {
     SwiftAllocator<Size, Alignment>::dealloc(buffer->PrivateData[0]);
   }
+#endif
   static OpaqueValue *initializeBufferWithTakeOfBuffer(ValueBuffer *dest,
                                                        ValueBuffer *src,
                                                        const Metadata *self) {
     dest->PrivateData[0] = src->PrivateData[0];
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+    return swift_projectBox((HeapObject*) dest->PrivateData[0]);
+#else
     return (OpaqueValue*) dest->PrivateData[0];
+#endif
   }
 };
 
@@ -837,11 +861,15 @@ struct NonFixedBufferValueWitnesses : BufferValueWitnessesBase<Impl> {
     if (!IsKnownAllocated && vwtable->isValueInline()) {
       return reinterpret_cast<OpaqueValue*>(buffer);
     } else {
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+      return swift_allocBufferBox(buffer, self);
+#else
       OpaqueValue *value =
         static_cast<OpaqueValue*>(swift_slowAlloc(vwtable->size,
                                                   vwtable->getAlignmentMask()));
       buffer->PrivateData[0] = value;
       return value;
+#endif
     }
   }
 
@@ -850,18 +878,43 @@ struct NonFixedBufferValueWitnesses : BufferValueWitnessesBase<Impl> {
     if (!IsKnownAllocated && vwtable->isValueInline()) {
       return reinterpret_cast<OpaqueValue*>(buffer);
     } else {
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+      return swift_projectBufferBox(buffer, self);
+#else
       return reinterpret_cast<OpaqueValue*>(buffer->PrivateData[0]);
+#endif
     }
   }
 
   static void deallocateBuffer(ValueBuffer *buffer, const Metadata *self) {
     auto vwtable = self->getValueWitnesses();
     if (IsKnownAllocated || !vwtable->isValueInline()) {
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+      swift_deallocBufferBox(buffer);
+#else
       swift_slowDealloc(buffer->PrivateData[0], vwtable->size,
                         vwtable->getAlignmentMask());
+#endif
     }
   }
 
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+  static void destroyBuffer(ValueBuffer *buffer, const Metadata *self) {
+    if (!IsKnownAllocated && self->getValueWitnesses()->isValueInline())
+      return BufferValueWitnessesBase<Impl>::destroyBuffer(buffer, self);
+    swift_destroyBufferBox(buffer);
+  }
+
+  static OpaqueValue *initializeBufferWithCopyOfBuffer(ValueBuffer *dest,
+                                                       ValueBuffer *src,
+                                                       const Metadata *self) {
+    if (!IsKnownAllocated && self->getValueWitnesses()->isValueInline())
+      return BufferValueWitnessesBase<Impl>::initializeBufferWithCopyOfBuffer(
+                                                              dest, src, self);
+    return swift_copyBufferBox(dest, src);
+  }
+#endif
+
   static OpaqueValue *initializeBufferWithTakeOfBuffer(ValueBuffer *dest,
                                                        ValueBuffer *src,
                                                        const Metadata *self) {
@@ -872,7 +925,11 @@ struct NonFixedBufferValueWitnesses : BufferValueWitnessesBase<Impl> {
                                       self);
     } else {
       dest->PrivateData[0] = src->PrivateData[0];
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+      return swift_projectBox((HeapObject*) dest->PrivateData[0]);
+#else
       return (OpaqueValue*) dest->PrivateData[0];
+#endif
     }
   }
 };
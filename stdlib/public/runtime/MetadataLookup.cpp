@@ -21,6 +21,7 @@
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Mutex.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/StringExtras.h"
@@ -82,6 +83,12 @@ namespace {
       return aName.compare(Name);
     }
 
+    static size_t getKeyHash(llvm::StringRef aName) {
+      // llvm::hash_value(StringRef) is defined out of line in a library we
+      // don't link.
+      return llvm::hash_combine_range(aName.begin(), aName.end());
+    }
+
     template <class... T>
     static size_t getExtraAllocationSize(T &&... ignored) {
       return 0;
@@ -103,9 +110,11 @@ static void _addImageTypeMetadataRecordsBlock(const uint8_t *records,
 #endif
 
 struct TypeMetadataState {
-  ConcurrentMap<TypeMetadataCacheEntry> Cache;
+  ConcurrentHashMap<TypeMetadataCacheEntry> Cache;
   std::vector<TypeMetadataSection> SectionsToScan;
-  Mutex SectionsToScanLock;
+  /// Sections are only added when an image is loaded, while every uncached
+  /// lookup scans them, so lookups on different threads share a read lock.
+  ReadWriteLock SectionsToScanLock;
 
   TypeMetadataState() {
     SectionsToScan.reserve(16);
@@ -126,7 +135,7 @@ static void
 _registerTypeMetadataRecords(TypeMetadataState &T,
                              const TypeMetadataRecord *begin,
                              const TypeMetadataRecord *end) {
-  ScopedLock guard(T.SectionsToScanLock);
+  ScopedWriteLock guard(T.SectionsToScanLock);
   T.SectionsToScan.push_back(TypeMetadataSection{begin, end});
 }
 
@@ -261,7 +270,7 @@ _typeByMangledName(const llvm::StringRef typeName) {
     return Value->getMetadata();
 
   // Check type metadata records
-  T.SectionsToScanLock.withLock([&] {
+  T.SectionsToScanLock.withReadLock([&] {
     foundMetadata = _searchTypeMetadataRecords(T, typeName);
   });
 
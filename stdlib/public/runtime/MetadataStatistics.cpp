@@ -0,0 +1,102 @@
+//===--- MetadataStatistics.cpp - Metadata cache statistics ---------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Registration and reporting of the opt-in metadata cache statistics.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MetadataStatistics.h"
+#include "swift/Runtime/Metadata.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace swift;
+
+std::atomic<unsigned char> swift::_swift_metadataStatisticsState;
+
+/// The list of registered counters, most recently registered first.
+static std::atomic<MetadataCacheStatistics *> RegisteredStatistics;
+
+/// The bytes obtained from the system by all metadata allocators.
+static std::atomic<uint64_t> MetadataAllocatorBytes;
+
+static void dumpMetadataStatisticsAtExit() {
+  swift_dumpMetadataStatistics();
+}
+
+bool swift::_swift_initializeMetadataStatistics() {
+  const char *setting = getenv("SWIFT_DEBUG_METADATA_STATISTICS");
+  bool enabled = setting && *setting && strcmp(setting, "0") != 0;
+
+  // Only the thread that publishes the setting registers the exit hook.
+  unsigned char expected = 0;
+  if (_swift_metadataStatisticsState.compare_exchange_strong(
+          expected, enabled ? 2 : 1, std::memory_order_relaxed)) {
+    if (enabled)
+      atexit(dumpMetadataStatisticsAtExit);
+    return enabled;
+  }
+  return expected == 2;
+}
+
+MetadataCacheStatistics::MetadataCacheStatistics(const char *name)
+  : Name(name), Hits(0), Misses(0), Instantiations(0), Bytes(0),
+    Nanoseconds(0) {
+  auto head = RegisteredStatistics.load(std::memory_order_relaxed);
+  do {
+    Next = head;
+  } while (!RegisteredStatistics.compare_exchange_weak(
+               head, this, std::memory_order_release,
+               std::memory_order_relaxed));
+}
+
+void swift::_swift_recordMetadataAllocatorBytes(size_t bytes) {
+  MetadataAllocatorBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void swift::swift_enumerateMetadataStatistics(
+    void (*callback)(const SwiftMetadataStatistics *statistics, void *context),
+    void *context) {
+  SwiftMetadataStatistics record = {};
+  record.Name = "MetadataAllocator";
+  record.Bytes = MetadataAllocatorBytes.load(std::memory_order_relaxed);
+  callback(&record, context);
+
+  for (auto statistics = RegisteredStatistics.load(std::memory_order_acquire);
+       statistics; statistics = statistics->Next) {
+    record.Name = statistics->Name;
+    record.Hits = statistics->Hits.load(std::memory_order_relaxed);
+    record.Misses = statistics->Misses.load(std::memory_order_relaxed);
+    record.Instantiations =
+      statistics->Instantiations.load(std::memory_order_relaxed);
+    record.Bytes = statistics->Bytes.load(std::memory_order_relaxed);
+    record.Nanoseconds =
+      statistics->Nanoseconds.load(std::memory_order_relaxed);
+    callback(&record, context);
+  }
+}
+
+void swift::swift_dumpMetadataStatistics() {
+  fprintf(stderr, "%-26s %12s %12s %12s %12s %12s\n", "cache", "hits",
+          "misses", "instantiated", "bytes", "time (us)");
+  swift_enumerateMetadataStatistics(
+      [](const SwiftMetadataStatistics *statistics, void *) {
+        fprintf(stderr, "%-26s %12llu %12llu %12llu %12llu %12llu\n",
+                statistics->Name,
+                (unsigned long long) statistics->Hits,
+                (unsigned long long) statistics->Misses,
+                (unsigned long long) statistics->Instantiations,
+                (unsigned long long) statistics->Bytes,
+                (unsigned long long) (statistics->Nanoseconds / 1000));
+      }, nullptr);
+}
@@ -0,0 +1,125 @@
+//===--- MetadataStatistics.h - Metadata cache statistics -------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Opt-in counters for the runtime's metadata and conformance caches.
+//
+// Collection is enabled by setting SWIFT_DEBUG_METADATA_STATISTICS in the
+// environment, which also prints a summary to stderr when the process
+// exits. When collection is disabled, each instrumentation point costs a
+// single load and branch.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_RUNTIME_METADATASTATISTICS_H
+#define SWIFT_RUNTIME_METADATASTATISTICS_H
+
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace swift {
+
+/// The counters for one cache.
+///
+/// Counter objects are registered on first use and are never destroyed.
+struct MetadataCacheStatistics {
+  const char *Name;
+
+  /// Lookups that found an existing entry.
+  std::atomic<uint64_t> Hits;
+
+  /// Lookups that found no existing entry.
+  std::atomic<uint64_t> Misses;
+
+  /// Entries that were built and added to the cache.
+  std::atomic<uint64_t> Instantiations;
+
+  /// Bytes allocated for entries of this cache.
+  std::atomic<uint64_t> Bytes;
+
+  /// Time spent building entries, in nanoseconds. Building one entry
+  /// may build others, so this is inclusive.
+  std::atomic<uint64_t> Nanoseconds;
+
+  /// The next registered counters object.
+  MetadataCacheStatistics *Next;
+
+  explicit MetadataCacheStatistics(const char *name);
+
+  void recordHit() { Hits.fetch_add(1, std::memory_order_relaxed); }
+  void recordMiss() { Misses.fetch_add(1, std::memory_order_relaxed); }
+  void recordBytes(size_t bytes) {
+    Bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  void recordInstantiation() {
+    Instantiations.fetch_add(1, std::memory_order_relaxed);
+  }
+  void recordTime(std::chrono::steady_clock::duration elapsed) {
+    Nanoseconds.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+      std::memory_order_relaxed);
+  }
+};
+
+/// Zero until the environment has been checked, then one if statistics
+/// are disabled and two if they are enabled.
+extern std::atomic<unsigned char> _swift_metadataStatisticsState;
+
+/// Check the environment and initialize _swift_metadataStatisticsState.
+bool _swift_initializeMetadataStatistics();
+
+/// Is statistics collection enabled for this process?
+inline bool _swift_areMetadataStatisticsEnabled() {
+  auto state = _swift_metadataStatisticsState.load(std::memory_order_relaxed);
+  if (LLVM_LIKELY(state != 0))
+    return state == 2;
+  return _swift_initializeMetadataStatistics();
+}
+
+/// Record bytes that a MetadataAllocator obtained from the system.
+void _swift_recordMetadataAllocatorBytes(size_t bytes);
+
+/// Return the counters for the metadata cache whose entries are of type
+/// \p EntryTy, registering them on first use.
+template <class EntryTy>
+MetadataCacheStatistics &getMetadataCacheStatistics() {
+  static MetadataCacheStatistics statistics(EntryTy::getName());
+  return statistics;
+}
+
+/// Records an instantiation and the time spent on it, if given counters.
+class MetadataStatisticsTimer {
+  MetadataCacheStatistics *Statistics;
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  explicit MetadataStatisticsTimer(MetadataCacheStatistics *statistics)
+    : Statistics(statistics) {
+    if (Statistics)
+      Start = std::chrono::steady_clock::now();
+  }
+
+  MetadataStatisticsTimer(const MetadataStatisticsTimer &) = delete;
+  MetadataStatisticsTimer &operator=(const MetadataStatisticsTimer &) = delete;
+
+  ~MetadataStatisticsTimer() {
+    if (!Statistics)
+      return;
+    Statistics->recordInstantiation();
+    Statistics->recordTime(std::chrono::steady_clock::now() - Start);
+  }
+};
+
+} // end namespace swift
+
+#endif // SWIFT_RUNTIME_METADATASTATISTICS_H
@@ -15,8 +15,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "Private.h"
+#include "Probes.h"
 #include "swift/Runtime/Once.h"
 #include "swift/Runtime/Debug.h"
+#include "swift/Runtime/Mutex.h"
+#include "llvm/Support/Compiler.h"
 #include <type_traits>
 
 using namespace swift;
@@ -28,6 +31,48 @@ using namespace swift;
 #include <dispatch/dispatch.h>
 static_assert(std::is_same<swift_once_t, dispatch_once_t>::value,
               "swift_once_t and dispatch_once_t must stay in sync");
+
+#else
+
+// On other platforms, the predicate goes from "not started" to "running" to
+// "done". "Done" has the same value as for dispatch_once, which lets IRGen
+// emit the same inline check before calling swift_once on every platform.
+// The store of "done" is a release, which pairs with the acquire load of
+// the inline check.
+enum : swift_once_t {
+  OnceNotStarted = 0,
+  OnceRunning = 1,
+  OnceDone = ~swift_once_t(0),
+};
+
+// Threads that lose the race to run an initializer wait here. Contention
+// only happens during initialization, so one lock for all predicates is
+// enough.
+static StaticMutex OnceMutex;
+static StaticConditionVariable OnceCondition;
+
+LLVM_ATTRIBUTE_NOINLINE
+static void swift_once_slow(swift_once_t *predicate, void (*fn)(void *)) {
+  swift_once_t expected = OnceNotStarted;
+  if (__atomic_compare_exchange_n(predicate, &expected, OnceRunning,
+                                  /*weak*/ false, __ATOMIC_ACQUIRE,
+                                  __ATOMIC_ACQUIRE)) {
+    SWIFT_RUNTIME_PROBE2(once__init, predicate, fn);
+    fn(nullptr);
+    OnceMutex.withLockThenNotifyAll(OnceCondition, [&] {
+      __atomic_store_n(predicate, OnceDone, __ATOMIC_RELEASE);
+    });
+    return;
+  }
+
+  if (expected == OnceDone)
+    return;
+
+  OnceMutex.withLockOrWait(OnceCondition, [&] {
+    return __atomic_load_n(predicate, __ATOMIC_ACQUIRE) == OnceDone;
+  });
+}
+
 #endif
 // The compiler generates the swift_once_t values as word-sized zero-initialized
 // variables, so we want to make sure swift_once_t isn't larger than the
@@ -41,17 +86,9 @@ static_assert(sizeof(swift_once_t) <= sizeof(void*),
 void swift::swift_once(swift_once_t *predicate, void (*fn)(void *)) {
 #if defined(__APPLE__)
   dispatch_once_f(predicate, nullptr, fn);
-#elif defined(__CYGWIN__)
-  _swift_once_f(predicate, nullptr, fn);
 #else
-  // FIXME: We're relying here on the coincidence that libstdc++ uses pthread's
-  // pthread_once, and that on glibc pthread_once follows a compatible init
-  // process (the token is a word that is atomically incremented from 0 to
-  // 1 to 2 during initialization) to work. We should implement our own version
-  // that we can rely on to continue to work that way.
-  // The MSVC port also relies on this, because the std::call_once on MSVC
-  // follows the compatible init process.
-  // For more information, see rdar://problem/18499385
-  std::call_once(*predicate, [fn]() { fn(nullptr); });
+  if (LLVM_LIKELY(__atomic_load_n(predicate, __ATOMIC_ACQUIRE) == OnceDone))
+    return;
+  swift_once_slow(predicate, fn);
 #endif
 }
@@ -45,6 +45,36 @@ namespace swift {
   extern "C" LLVM_LIBRARY_VISIBILITY LLVM_ATTRIBUTE_NORETURN
   void _swift_abortRetainUnowned(const void *object);
 
+  /// Allocate the memory for a heap object. Small objects may be served
+  /// from a per-thread cache when the runtime is built with
+  /// SWIFT_RUNTIME_ENABLE_OBJECT_CACHE; otherwise they come from malloc.
+  /// Unlike swift_slowAlloc, this does not report to the allocation
+  /// profiler; swift_allocObject does so with the object's metadata.
+  void *_swift_allocObjectMemory(size_t size, size_t alignMask);
+
+  /// Allocate the memory for a tail-allocated buffer. This never comes from
+  /// the object cache, because a buffer's capacity is computed from
+  /// malloc_size of its memory.
+  void *_swift_allocBufferMemory(size_t size, size_t alignMask);
+
+  /// Free memory allocated by _swift_allocObjectMemory or
+  /// _swift_allocBufferMemory. The size may be the instance size of the
+  /// object's class rather than the size the memory was allocated with.
+  void _swift_deallocObjectMemory(void *ptr, size_t size, size_t alignMask);
+
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+  struct AllocationRegion;
+
+  /// The innermost allocation region pushed on the current thread, if any.
+  AllocationRegion *_swift_getCurrentAllocationRegion();
+
+  /// Allocate and initialize an object in the given allocation region.
+  HeapObject *_swift_allocObjectInRegion(AllocationRegion *region,
+                                         HeapMetadata const *metadata,
+                                         size_t requiredSize,
+                                         size_t requiredAlignmentMask);
+#endif
+
   /// Is the given value a valid alignment mask?
   static inline bool isAlignmentMask(size_t mask) {
     // mask          == xyz01111...
@@ -0,0 +1,50 @@
+//===--- Probes.h - Static tracing probes in the runtime --------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Statically-defined tracing (USDT) probes on the runtime's slow paths.
+//
+// The probes belong to the "swift" provider and can be attached to with
+// DTrace, SystemTap or bpftrace, e.g.
+//
+//   bpftrace -e 'usdt:libswiftCore.so:swift:conformance__miss { @[pid] = count(); }'
+//
+// An unattached probe compiles to a single nop, so the probes are built in
+// whenever <sys/sdt.h> is available and SWIFT_RUNTIME_ENABLE_PROBES is set.
+//
+// Probes:
+//   metadata__instantiate(GenericMetadata *pattern, const Metadata *result)
+//   conformance__miss(const Metadata *type, const ProtocolDescriptor *proto)
+//   cast__fail(const Metadata *srcType, const Metadata *targetType)
+//   once__init(swift_once_t *predicate, void (*fn)(void *))
+//   weak__zombie(WeakReference *ref, HeapObject *object)
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_RUNTIME_PROBES_H
+#define SWIFT_RUNTIME_PROBES_H
+
+#if SWIFT_RUNTIME_ENABLE_PROBES && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SWIFT_RUNTIME_HAS_PROBES 1
+#endif
+#endif
+
+#if SWIFT_RUNTIME_HAS_PROBES
+#define SWIFT_RUNTIME_PROBE2(NAME, ARG1, ARG2) \
+  DTRACE_PROBE2(swift, NAME, ARG1, ARG2)
+#else
+#define SWIFT_RUNTIME_PROBE2(NAME, ARG1, ARG2) \
+  do { (void)(ARG1); (void)(ARG2); } while (false)
+#endif
+
+#endif // SWIFT_RUNTIME_PROBES_H
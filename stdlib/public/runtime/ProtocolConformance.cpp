@@ -19,7 +19,11 @@
 #include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Mutex.h"
+#include "llvm/ADT/DenseMap.h"
+#include "MetadataStatistics.h"
 #include "Private.h"
+#include "Probes.h"
+#include <algorithm>
 
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach-o/dyld.h>
@@ -172,6 +176,13 @@ namespace {
 
     ConformanceCacheKey(const void *type, const ProtocolDescriptor *proto)
       : Type(type), Proto(proto) {}
+
+    size_t hash() const {
+      // Metadata and protocol descriptors are pointer-aligned, so the low
+      // bits carry no information.
+      uintptr_t hash = (uintptr_t(Type) >> 3) ^ (uintptr_t(Proto) >> 3) * 31;
+      return hash ^ (hash >> 9);
+    }
   };
 
   struct ConformanceCacheEntry {
@@ -189,6 +200,8 @@ namespace {
         FailureGeneration(failureGeneration) {
     }
 
+    static const char *getName() { return "ConformanceCache"; }
+
     int compareWithKey(const ConformanceCacheKey &key) const {
       if (key.Type != Type) {
         return (uintptr_t(key.Type) < uintptr_t(Type) ? -1 : 1);
@@ -199,6 +212,10 @@ namespace {
       }
     }
 
+    static size_t getKeyHash(const ConformanceCacheKey &key) {
+      return key.hash();
+    }
+
     template <class... Args>
     static size_t getExtraAllocationSize(Args &&... ignored) {
       return 0;
@@ -246,12 +263,52 @@ static void _addImageProtocolConformancesBlock(const uint8_t *conformances,
 #endif
 
 struct ConformanceState {
-  ConcurrentMap<ConformanceCacheEntry> Cache;
+  /// A run of consecutive conformance records for the same protocol, along
+  /// with the index in SectionsToScan of the section it was registered with.
+  /// The compiler groups the records in each object file by protocol, so a
+  /// section usually contains one run per protocol per object file.
+  struct IndexedConformanceRecords {
+    unsigned SectionIndex;
+    const ProtocolConformanceRecord *Begin, *End;
+    const ProtocolConformanceRecord *begin() const {
+      return Begin;
+    }
+    const ProtocolConformanceRecord *end() const {
+      return End;
+    }
+  };
+
+  ConcurrentHashMap<ConformanceCacheEntry> Cache;
   std::vector<ConformanceSection> SectionsToScan;
-  Mutex SectionsToScanLock;
-  
+  /// Held for writing while sections are registered or while a cache miss
+  /// scans them and publishes a new generation; held for reading by scans
+  /// that only inspect the sections.
+  ReadWriteLock SectionsToScanLock;
+
+  /// The records of every registered section, grouped by protocol in
+  /// registration order. A cache miss only needs to scan the records for
+  /// the protocol it is looking for. Guarded by SectionsToScanLock.
+  llvm::DenseMap<const ProtocolDescriptor *,
+                 std::vector<IndexedConformanceRecords>> RecordsByProtocol;
+
+  /// The number of slots in the direct-mapped lookup cache. Must be a power
+  /// of two.
+  static constexpr size_t FastCacheSize = 512;
+
+  /// A direct-mapped cache of entries that were recently found for an exact
+  /// (type, protocol) pair. It is consulted before the concurrent map so that
+  /// repeated casts only need a couple of loads.
+  ///
+  /// Slots point at entries owned by Cache. Those entries are never moved or
+  /// deallocated, and their keys are immutable, so a reader only needs to
+  /// load the slot and compare the key. Writers simply overwrite the slot;
+  /// losing a race only costs a later trip through the concurrent map.
+  std::atomic<ConformanceCacheEntry *> FastCache[FastCacheSize];
+
   ConformanceState() {
     SectionsToScan.reserve(16);
+    for (auto &slot : FastCache)
+      slot.store(nullptr, std::memory_order_relaxed);
 #if defined(__APPLE__) && defined(__MACH__)
     _initializeCallbacksToInspectDylib();
 #else
@@ -261,15 +318,19 @@ struct ConformanceState {
 #endif
   }
 
-  void cacheSuccess(const void *type, const ProtocolDescriptor *proto,
-                    const WitnessTable *witness) {
+  ConformanceCacheEntry *cacheSuccess(const void *type,
+                                      const ProtocolDescriptor *proto,
+                                      const WitnessTable *witness) {
     auto result = Cache.getOrInsert(ConformanceCacheKey(type, proto),
                                     witness, uintptr_t(0));
 
     // If the entry was already present, we may need to update it.
     if (!result.second) {
       result.first->makeSuccessful(witness);
+    } else {
+      recordInsertion();
     }
+    return result.first;
   }
 
   void cacheFailure(const void *type, const ProtocolDescriptor *proto) {
@@ -281,13 +342,47 @@ struct ConformanceState {
     // If the entry was already present, we may need to update it.
     if (!result.second) {
       result.first->updateFailureGeneration(failureGeneration);
+    } else {
+      recordInsertion();
     }
   }
 
+  void recordInsertion() {
+    if (!_swift_areMetadataStatisticsEnabled())
+      return;
+    auto &statistics = getMetadataCacheStatistics<ConformanceCacheEntry>();
+    statistics.recordInstantiation();
+    statistics.recordBytes(sizeof(ConformanceCacheEntry));
+  }
+
   ConformanceCacheEntry *findCached(const void *type,
                                     const ProtocolDescriptor *proto) {
     return Cache.find(ConformanceCacheKey(type, proto));
   }
+
+  static size_t getFastCacheIndex(const void *type,
+                                  const ProtocolDescriptor *proto) {
+    return ConformanceCacheKey(type, proto).hash() & (FastCacheSize - 1);
+  }
+
+  /// Look up an exact (type, protocol) pair in the direct-mapped cache.
+  ConformanceCacheEntry *findFastCached(const void *type,
+                                        const ProtocolDescriptor *proto) {
+    auto &slot = FastCache[getFastCacheIndex(type, proto)];
+    auto *entry = slot.load(std::memory_order_acquire);
+    if (entry && entry->compareWithKey(ConformanceCacheKey(type, proto)) == 0)
+      return entry;
+    return nullptr;
+  }
+
+  /// Remember an entry for an exact (type, protocol) pair in the
+  /// direct-mapped cache.
+  void recordFastCached(const void *type, const ProtocolDescriptor *proto,
+                        ConformanceCacheEntry *entry) {
+    assert(entry->compareWithKey(ConformanceCacheKey(type, proto)) == 0);
+    FastCache[getFastCacheIndex(type, proto)]
+      .store(entry, std::memory_order_release);
+  }
 };
 
 static Lazy<ConformanceState> Conformances;
@@ -296,8 +391,22 @@ static void
 _registerProtocolConformances(ConformanceState &C,
                               const ProtocolConformanceRecord *begin,
                               const ProtocolConformanceRecord *end) {
-  ScopedLock guard(C.SectionsToScanLock);
+  ScopedWriteLock guard(C.SectionsToScanLock);
+  unsigned sectionIndex = C.SectionsToScan.size();
   C.SectionsToScan.push_back(ConformanceSection{begin, end});
+
+  // Index the new records by protocol, one entry per run of records for
+  // the same protocol. Runs are appended in section order, so each
+  // protocol's list stays sorted by section index.
+  const ProtocolConformanceRecord *runBegin = begin;
+  for (auto record = begin; record != end; ++record) {
+    auto protocol = record->getProtocol();
+    if (record + 1 != end && (record + 1)->getProtocol() == protocol)
+      continue;
+    C.RecordsByProtocol[protocol].push_back({sectionIndex, runBegin,
+                                             record + 1});
+    runBegin = record + 1;
+  }
 }
 
 static void _addImageProtocolConformancesBlock(const uint8_t *conformances,
@@ -460,6 +569,22 @@ swift::swift_registerProtocolConformances(const ProtocolConformanceRecord *begin
   _registerProtocolConformances(C, begin, end);
 }
 
+/// Record a successful cache entry found while searching for \p origType in
+/// the direct-mapped cache. If the entry was found for a superclass or a
+/// nominal type descriptor, first add an exact entry for \p origType so the
+/// next lookup doesn't have to walk the class hierarchy again. A successful
+/// conformance never becomes unsuccessful, so this is always safe.
+static void
+cacheSuccessForOriginalType(ConformanceState &C, const Metadata *origType,
+                            const void *foundKey,
+                            const ProtocolDescriptor *protocol,
+                            ConformanceCacheEntry *foundEntry) {
+  if (foundKey != origType)
+    foundEntry = C.cacheSuccess(origType, protocol,
+                                foundEntry->getWitnessTable());
+  C.recordFastCached(origType, protocol, foundEntry);
+}
+
 /// Search the witness table in the ConformanceCache. \returns a pair of the
 /// WitnessTable pointer and a boolean value True if a definitive value is
 /// found. \returns false if the type or its superclasses were not found in
@@ -481,13 +606,18 @@ recur_inside_cache_lock:
   {
     // Check if the type-protocol entry exists in the cache entry that we found.
     if (auto *Value = C.findCached(type, protocol)) {
-      if (Value->isSuccessful())
-        return std::make_pair(Value->getWitnessTable(), true);
+      if (Value->isSuccessful()) {
+        auto *witness = Value->getWitnessTable();
+        cacheSuccessForOriginalType(C, origType, type, protocol, Value);
+        return std::make_pair(witness, true);
+      }
 
       // If we're still looking up for the original type, remember that
       // we found an exact match.
-      if (type == origType)
+      if (type == origType) {
         foundEntry = Value;
+        C.recordFastCached(origType, protocol, Value);
+      }
 
       // If we got a cached negative response, check the generation number.
       if (Value->getFailureGeneration() == C.SectionsToScan.size()) {
@@ -505,8 +635,11 @@ recur_inside_cache_lock:
 
     // Hash and lookup the type-protocol pair in the cache.
     if (auto *Value = C.findCached(description, protocol)) {
-      if (Value->isSuccessful())
-        return std::make_pair(Value->getWitnessTable(), true);
+      if (Value->isSuccessful()) {
+        auto *witness = Value->getWitnessTable();
+        cacheSuccessForOriginalType(C, origType, description, protocol, Value);
+        return std::make_pair(witness, true);
+      }
 
       // We don't try to cache negative responses for generic
       // patterns.
@@ -569,8 +702,39 @@ swift::swift_conformsToProtocol(const Metadata *type,
   unsigned numSections = 0;
   ConformanceCacheEntry *foundEntry;
 
+  MetadataCacheStatistics *statistics = nullptr;
+  if (_swift_areMetadataStatisticsEnabled())
+    statistics = &getMetadataCacheStatistics<ConformanceCacheEntry>();
+
+  // Fast path: an exact (type, protocol) pair we've already resolved.
+  if (auto *entry = C.findFastCached(type, protocol)) {
+    if (entry->isSuccessful()) {
+      if (statistics)
+        statistics->recordHit();
+      return entry->getWitnessTable();
+    }
+    if (entry->getFailureGeneration() == C.SectionsToScan.size()) {
+      if (statistics)
+        statistics->recordHit();
+      return nullptr;
+    }
+  }
+
+  // The start of the first scan, if statistics are enabled and this lookup
+  // has missed the cache.
+  std::chrono::steady_clock::time_point missStart;
+  bool missed = false;
+  auto recordLookup = [&] {
+    if (!statistics)
+      return;
+    if (!missed)
+      statistics->recordHit();
+    else
+      statistics->recordTime(std::chrono::steady_clock::now() - missStart);
+  };
+
 recur:
-  // See if we have a cached conformance. The ConcurrentMap data structure
+  // See if we have a cached conformance. The ConcurrentHashMap data structure
   // allows us to insert and search the map concurrently without locking.
   // We do lock the slow path because the SectionsToScan data structure is not
   // concurrent.
@@ -580,12 +744,23 @@ recur:
   // it may mean that all of the superclasses do not have this conformance,
   // but the actual type may still have this conformance.
   if (FoundConformance.second) {
-    if (FoundConformance.first || foundEntry)
+    if (FoundConformance.first || foundEntry) {
+      recordLookup();
       return FoundConformance.first;
+    }
+  }
+
+  if (!missed) {
+    SWIFT_RUNTIME_PROBE2(conformance__miss, origType, protocol);
+    if (statistics) {
+      statistics->recordMiss();
+      missStart = std::chrono::steady_clock::now();
+    }
+    missed = true;
   }
 
   // If we didn't have an up-to-date cache entry, scan the conformance records.
-  C.SectionsToScanLock.lock();
+  C.SectionsToScanLock.writeLock();
   unsigned failedGeneration = ConformanceCacheGeneration;
 
   // If we have no new information to pull in (and nobody else pulled in
@@ -594,7 +769,7 @@ recur:
     if (failedGeneration != ConformanceCacheGeneration) {
       // Someone else pulled in new conformances while we were waiting.
       // Start over with our newly-populated cache.
-      C.SectionsToScanLock.unlock();
+      C.SectionsToScanLock.writeUnlock();
       type = origType;
       goto recur;
     }
@@ -603,7 +778,8 @@ recur:
     // Save the failure for this type-protocol pair in the cache.
     C.cacheFailure(type, protocol);
 
-    C.SectionsToScanLock.unlock();
+    C.SectionsToScanLock.writeUnlock();
+    recordLookup();
     return nullptr;
   }
 
@@ -612,59 +788,67 @@ recur:
 
   // Scan only sections that were not scanned yet.
   unsigned sectionIdx = foundEntry ? foundEntry->getFailureGeneration() : 0;
-  unsigned endSectionIdx = C.SectionsToScan.size();
 
-  for (; sectionIdx < endSectionIdx; ++sectionIdx) {
-    auto &section = C.SectionsToScan[sectionIdx];
-    // Eagerly pull records for nondependent witnesses into our cache.
-    for (const auto &record : section) {
-      // If the record applies to a specific type, cache it.
-      if (auto metadata = record.getCanonicalTypeMetadata()) {
-        auto P = record.getProtocol();
-
-        // Look for an exact match.
-        if (protocol != P)
-          continue;
-
-        if (!isRelatedType(type, metadata, /*isMetadata=*/true))
-          continue;
-
-        // Store the type-protocol pair in the cache.
-        auto witness = record.getWitnessTable(metadata);
-        if (witness) {
-          C.cacheSuccess(metadata, P, witness);
-        } else {
-          C.cacheFailure(metadata, P);
-        }
-
-      // If the record provides a nondependent witness table for all instances
-      // of a generic type, cache it for the generic pattern.
-      // TODO: "Nondependent witness table" probably deserves its own flag.
-      // An accessor function might still be necessary even if the witness table
-      // can be shared.
-      } else if (record.getTypeKind()
-                   == TypeMetadataRecordKind::UniqueNominalTypeDescriptor
-                 && record.getConformanceKind()
-                   == ProtocolConformanceReferenceKind::WitnessTable) {
-
-        auto R = record.getNominalTypeDescriptor();
-        auto P = record.getProtocol();
+  // Only the records for this protocol can provide the conformance.
+  auto indexedRecords = C.RecordsByProtocol.find(protocol);
+  if (indexedRecords != C.RecordsByProtocol.end()) {
+    auto &runs = indexedRecords->second;
 
-        // Look for an exact match.
-        if (protocol != P)
-          continue;
+    // Skip the records from sections that were already scanned.
+    auto firstRun =
+      std::lower_bound(runs.begin(), runs.end(), sectionIdx,
+                       [](const ConformanceState::IndexedConformanceRecords &r,
+                          unsigned sectionIdx) {
+                         return r.SectionIndex < sectionIdx;
+                       });
 
-        if (!isRelatedType(type, R, /*isMetadata=*/false))
-          continue;
-
-        // Store the type-protocol pair in the cache.
-        C.cacheSuccess(R, P, record.getStaticWitnessTable());
+    // Eagerly pull records for nondependent witnesses into our cache.
+    for (auto run = firstRun, re = runs.end(); run != re; ++run) {
+      for (const auto &record : *run) {
+        assert(record.getProtocol() == protocol && "misindexed record");
+        assert(run->SectionIndex < numSections &&
+               "record from unknown section");
+
+        // If the record applies to a specific type, cache it.
+        if (auto metadata = record.getCanonicalTypeMetadata()) {
+          auto P = protocol;
+
+          if (!isRelatedType(type, metadata, /*isMetadata=*/true))
+            continue;
+
+          // Store the type-protocol pair in the cache.
+          auto witness = record.getWitnessTable(metadata);
+          if (witness) {
+            C.cacheSuccess(metadata, P, witness);
+          } else {
+            C.cacheFailure(metadata, P);
+          }
+
+        // If the record provides a nondependent witness table for all
+        // instances of a generic type, cache it for the generic pattern.
+        // TODO: "Nondependent witness table" probably deserves its own flag.
+        // An accessor function might still be necessary even if the witness
+        // table can be shared.
+        } else if (record.getTypeKind()
+                     == TypeMetadataRecordKind::UniqueNominalTypeDescriptor
+                   && record.getConformanceKind()
+                     == ProtocolConformanceReferenceKind::WitnessTable) {
+
+          auto R = record.getNominalTypeDescriptor();
+          auto P = protocol;
+
+          if (!isRelatedType(type, R, /*isMetadata=*/false))
+            continue;
+
+          // Store the type-protocol pair in the cache.
+          C.cacheSuccess(R, P, record.getStaticWitnessTable());
+        }
       }
     }
   }
   ++ConformanceCacheGeneration;
 
-  C.SectionsToScanLock.unlock();
+  C.SectionsToScanLock.writeUnlock();
   // Start over with our newly-populated cache.
   type = origType;
   goto recur;
@@ -675,7 +859,7 @@ swift::_searchConformancesByMangledTypeName(const llvm::StringRef typeName) {
   auto &C = Conformances.get();
   const Metadata *foundMetadata = nullptr;
 
-  ScopedLock guard(C.SectionsToScanLock);
+  ScopedReadLock guard(C.SectionsToScanLock);
 
   unsigned sectionIdx = 0;
   unsigned endSectionIdx = C.SectionsToScan.size();
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/Basic/Fallthrough.h"
+#include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Reflection.h"
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
@@ -18,6 +20,7 @@
 #include "swift/Basic/Demangle.h"
 #include "swift/Runtime/Debug.h"
 #include "swift/Runtime/Portability.h"
+#include "llvm/ADT/Hashing.h"
 #include "Private.h"
 #include <cassert>
 #include <cstdio>
@@ -25,6 +28,7 @@
 #include <new>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #if SWIFT_OBJC_INTEROP
 #include "swift/Runtime/ObjCBridge.h"
@@ -386,16 +390,59 @@ void swift_TupleMirror_subscript(String *outString,
   new (outMirror) Mirror(reflect(owner, eltData, elt.Type));
 }
   
-// Get a field name from a doubly-null-terminated list.
-static const char *getFieldName(const char *fieldNames, size_t i) {
-  const char *fieldName = fieldNames;
-  for (size_t j = 0; j < i; ++j) {
-    size_t len = strlen(fieldName);
-    assert(len != 0);
-    fieldName += len + 1;
-  }
+namespace {
+  /// The start of each name in a doubly-null-terminated list of field or
+  /// case names, so that mirrors can look up the nth name without walking
+  /// the first n.
+  struct FieldNameCacheEntry {
+  private:
+    const char *FieldNames;
+    std::vector<const char *> Names;
+
+  public:
+    FieldNameCacheEntry(const char *fieldNames, size_t count)
+      : FieldNames(fieldNames) {
+      Names.reserve(count);
+      const char *fieldName = fieldNames;
+      for (size_t j = 0; j < count; ++j) {
+        Names.push_back(fieldName);
+        size_t len = strlen(fieldName);
+        assert(len != 0);
+        fieldName += len + 1;
+      }
+    }
+
+    const char *getName(size_t i) const {
+      assert(i < Names.size());
+      return Names[i];
+    }
+
+    int compareWithKey(const char *fieldNames) const {
+      auto lhs = uintptr_t(fieldNames);
+      auto rhs = uintptr_t(FieldNames);
+      return lhs < rhs ? -1 : lhs > rhs ? 1 : 0;
+    }
+
+    static size_t getKeyHash(const char *fieldNames) {
+      return llvm::hash_value(fieldNames);
+    }
+
+    static size_t getExtraAllocationSize(const char *fieldNames,
+                                         size_t count) {
+      return 0;
+    }
+  };
+} // end anonymous namespace
+
+// Get a field name from a doubly-null-terminated list of \p count names.
+static const char *getFieldName(const char *fieldNames, size_t count,
+                                size_t i) {
+  // Mirrors usually visit every child in turn, so index the list once
+  // rather than rescanning it for each child.
+  static Lazy<ConcurrentHashMap<FieldNameCacheEntry>> FieldNameCache;
 
-  return fieldName;
+  auto entry = FieldNameCache.get().getOrInsert(fieldNames, count).first;
+  return entry->getName(i);
 }
 
 // -- Struct destructuring.
@@ -430,7 +477,9 @@ void swift_StructMirror_subscript(String *outString,
   auto bytes = reinterpret_cast<const char*>(value);
   auto fieldData = reinterpret_cast<const OpaqueValue *>(bytes + fieldOffset);
 
-  new (outString) String(getFieldName(Struct->Description->Struct.FieldNames, i));
+  new (outString) String(getFieldName(Struct->Description->Struct.FieldNames,
+                                         Struct->Description->Struct.NumFields,
+                                         i));
 
   // 'owner' is consumed by this call.
   assert(!fieldType.isIndirect() && "indirect struct fields not implemented");
@@ -501,7 +550,7 @@ const char *swift_EnumMirror_caseName(HeapObject *owner,
 
   swift_release(owner);
 
-  return getFieldName(Description.CaseNames, tag);
+  return getFieldName(Description.CaseNames, Description.getNumCases(), tag);
 }
 
 SWIFT_CC(swift) SWIFT_RUNTIME_STDLIB_INTERFACE
@@ -579,7 +628,8 @@ void swift_EnumMirror_subscript(String *outString,
     swift_release(pair.first);
   }
 
-  new (outString) String(getFieldName(Description.CaseNames, tag));
+  new (outString) String(getFieldName(Description.CaseNames,
+                                      Description.getNumCases(), tag));
   new (outMirror) Mirror(reflect(owner, value, payloadType));
 }
   
@@ -658,7 +708,9 @@ void swift_ClassMirror_subscript(String *outString,
   auto bytes = *reinterpret_cast<const char * const*>(value);
   auto fieldData = reinterpret_cast<const OpaqueValue *>(bytes + fieldOffset);
   
-  new (outString) String(getFieldName(Clas->getDescription()->Class.FieldNames, i));
+  new (outString) String(getFieldName(Clas->getDescription()->Class.FieldNames,
+                                         Clas->getDescription()->Class.NumFields,
+                                         i));
   // 'owner' is consumed by this call.
   new (outMirror) Mirror(reflect(owner, fieldData, fieldType.getType()));
 }
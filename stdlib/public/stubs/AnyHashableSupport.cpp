@@ -51,6 +51,11 @@ struct HashableConformanceEntry {
     }
   }
 
+  static size_t getKeyHash(const HashableConformanceKey &key) {
+    // Metadata is pointer-aligned, so the low bits carry no information.
+    return uintptr_t(key.derivedType) >> 3;
+  }
+
   static size_t
   getExtraAllocationSize(HashableConformanceKey key,
                          const Metadata *baseTypeThatConformsToHashable) {
@@ -59,7 +64,7 @@ struct HashableConformanceEntry {
 };
 } // end unnamed namesapce
 
-static Lazy<ConcurrentMap<HashableConformanceEntry>> HashableConformances;
+static Lazy<ConcurrentHashMap<HashableConformanceEntry>> HashableConformances;
 
 /// Find the base type that introduces the `Hashable` conformance.
 ///
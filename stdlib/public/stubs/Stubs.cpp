@@ -30,15 +30,16 @@
 #include <sys/errno.h>
 #include <unistd.h>
 #endif
+#include <cfloat>
 #include <climits>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
 #if defined(__CYGWIN__) || defined(_MSC_VER)
 #include <sstream>
-#include <cmath>
 #define fmodl(lhs, rhs) std::fmod(lhs, rhs)
 #elif defined(__ANDROID__)
 // Android's libc implementation Bionic currently only supports the "C" locale
@@ -71,19 +72,53 @@ static long double swift_strtold_l(const char *nptr,
 #include "../SwiftShims/RuntimeShims.h"
 #include "../SwiftShims/RuntimeStubs.h"
 
+/// Writes the decimal digits of \p Value forward into \p Buffer, two at a
+/// time, and returns a pointer past the last one.
+static char *uint64ToDecimalString(char *Buffer, uint64_t Value) {
+  static const char DigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+  unsigned NumDigits = 1;
+  for (uint64_t Threshold = 10; NumDigits < 20 && Value >= Threshold;
+       Threshold *= 10)
+    ++NumDigits;
+
+  char *End = Buffer + NumDigits;
+  char *P = End;
+  while (Value >= 100) {
+    unsigned Pair = unsigned(Value % 100) * 2;
+    Value /= 100;
+    *--P = DigitPairs[Pair + 1];
+    *--P = DigitPairs[Pair];
+  }
+  if (Value >= 10) {
+    unsigned Pair = unsigned(Value) * 2;
+    *--P = DigitPairs[Pair + 1];
+    *--P = DigitPairs[Pair];
+  } else {
+    *--P = '0' + char(Value);
+  }
+  return End;
+}
+
 static uint64_t uint64ToStringImpl(char *Buffer, uint64_t Value,
                                    int64_t Radix, bool Uppercase,
                                    bool Negative) {
   char *P = Buffer;
   uint64_t Y = Value;
 
+  if (Radix == 10) {
+    if (Negative)
+      *P++ = '-';
+    return size_t(uint64ToDecimalString(P, Y) - Buffer);
+  }
+
   if (Y == 0) {
     *P++ = '0';
-  } else if (Radix == 10) {
-    while (Y) {
-      *P++ = '0' + char(Y % 10);
-      Y /= 10;
-    }
   } else {
     unsigned Radix32 = Radix;
     while (Y) {
@@ -181,6 +216,46 @@ static int swift_snprintf_l(char *Str, size_t StrSize, locale_t Locale,
 }
 #endif
 
+/// Formats an integral value below 10^Precision in magnitude the way "%0.*g"
+/// followed by the ".0" suffix would, without going through snprintf.
+/// Returns false if the value isn't of that form.
+template <typename T>
+static bool swift_integralFloatingPointToString(char *Buffer, T Value,
+                                                int Precision,
+                                                uint64_t &Length) {
+  // Stay within the range where every integer is exactly representable in
+  // uint64_t. This also rejects NaNs and infinities.
+  T Limit = 1;
+  for (int i = 0; i < Precision && i < 18; ++i)
+    Limit *= 10;
+  if (!(Value > -Limit && Value < Limit))
+    return false;
+
+  bool Negative = std::signbit(Value);
+  T Magnitude = Negative ? -Value : Value;
+  uint64_t Integer = static_cast<uint64_t>(Magnitude);
+  if (static_cast<T>(Integer) != Magnitude)
+    return false;
+
+  char Digits[20];
+  int NumDigits = 0;
+  do {
+    Digits[NumDigits++] = '0' + Integer % 10;
+    Integer /= 10;
+  } while (Integer != 0);
+
+  char *Out = Buffer;
+  if (Negative)
+    *Out++ = '-';
+  while (NumDigits > 0)
+    *Out++ = Digits[--NumDigits];
+  *Out++ = '.';
+  *Out++ = '0';
+  *Out = '\0';
+  Length = Out - Buffer;
+  return true;
+}
+
 template <typename T>
 static uint64_t swift_floatingPointToString(char *Buffer, size_t BufferLength,
                                             T Value, const char *Format, 
@@ -193,6 +268,10 @@ static uint64_t swift_floatingPointToString(char *Buffer, size_t BufferLength,
     Precision = std::numeric_limits<T>::max_digits10;
   }
 
+  uint64_t Length;
+  if (swift_integralFloatingPointToString(Buffer, Value, Precision, Length))
+    return Length;
+
 #if defined(__CYGWIN__) || defined(_MSC_VER)
   // Cygwin does not support uselocale(), but we can use the locale feature 
   // in stringstream object.
@@ -438,6 +517,101 @@ __mulodi4(di_int a, di_int b, int* overflow)
 }
 #endif
 
+/// Parses a plain decimal number whose value is computed exactly by a single
+/// multiplication or division by a power of ten (Clinger's fast path). This
+/// covers most numbers written by people or by printf, and is correctly
+/// rounded without any bignum arithmetic.
+///
+/// Returns null without touching \p outResult for anything else, including
+/// leading whitespace, hexadecimal floats, infinities and NaNs, so that the
+/// caller can fall back to the C library.
+template <typename T>
+static const char *_swift_stdlib_strtoX_fast_path(const char *nptr,
+                                                   T *outResult) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  static_assert(std::numeric_limits<T>::digits == 24 ||
+                std::numeric_limits<T>::digits == 53,
+                "only IEEE single and double precision are supported");
+  // The largest integer and power of ten that are exactly representable.
+  constexpr uint64_t MaxMantissa =
+    uint64_t(1) << std::numeric_limits<T>::digits;
+  constexpr int MaxExponent = std::numeric_limits<T>::digits == 24 ? 10 : 22;
+  static const double PowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+  const char *Ptr = nptr;
+  bool Negative = false;
+  if (*Ptr == '-' || *Ptr == '+')
+    Negative = *Ptr++ == '-';
+  if (Ptr[0] == '0' && (Ptr[1] == 'x' || Ptr[1] == 'X'))
+    return nullptr;
+
+  uint64_t Mantissa = 0;
+  int Exponent = 0;
+  int NumSignificantDigits = 0;
+  bool SawDigit = false;
+  auto addDigit = [&](char c) -> bool {
+    SawDigit = true;
+    if (Mantissa == 0 && c == '0')
+      return true;
+    // Nineteen decimal digits always fit in 64 bits.
+    if (++NumSignificantDigits > 19)
+      return false;
+    Mantissa = Mantissa * 10 + (c - '0');
+    return true;
+  };
+
+  for (; isDigit(*Ptr); ++Ptr)
+    if (!addDigit(*Ptr))
+      return nullptr;
+  if (*Ptr == '.') {
+    for (++Ptr; isDigit(*Ptr); ++Ptr, --Exponent)
+      if (!addDigit(*Ptr))
+        return nullptr;
+  }
+  if (!SawDigit)
+    return nullptr;
+
+  // An exponent marker only belongs to the number if digits follow it.
+  if (*Ptr == 'e' || *Ptr == 'E') {
+    const char *ExpPtr = Ptr + 1;
+    bool NegativeExponent = false;
+    if (*ExpPtr == '-' || *ExpPtr == '+')
+      NegativeExponent = *ExpPtr++ == '-';
+    if (isDigit(*ExpPtr)) {
+      int ExplicitExponent = 0;
+      for (; isDigit(*ExpPtr); ++ExpPtr) {
+        if (ExplicitExponent > 1000)
+          return nullptr;
+        ExplicitExponent = ExplicitExponent * 10 + (*ExpPtr - '0');
+      }
+      Exponent += NegativeExponent ? -ExplicitExponent : ExplicitExponent;
+      Ptr = ExpPtr;
+    }
+  }
+
+  if (Mantissa > MaxMantissa ||
+      Exponent < -MaxExponent || Exponent > MaxExponent)
+    return nullptr;
+
+  T Value = T(Mantissa);
+  if (Exponent < 0)
+    Value /= T(PowersOfTen[-Exponent]);
+  else
+    Value *= T(PowersOfTen[Exponent]);
+  *outResult = Negative ? -Value : Value;
+  return Ptr;
+#else
+  // Without strict evaluation in the nominal type, the single operation above
+  // could be rounded twice.
+  return nullptr;
+#endif
+}
+
 #if defined(__CYGWIN__) || defined(_MSC_VER)
 // Cygwin does not support uselocale(), but we can use the locale feature 
 // in stringstream object.
@@ -465,11 +639,15 @@ const char *swift::_swift_stdlib_strtold_clocale(
 
 const char *swift::_swift_stdlib_strtod_clocale(
     const char * nptr, double *outResult) {
+  if (const char *EndPtr = _swift_stdlib_strtoX_fast_path(nptr, outResult))
+    return EndPtr;
   return _swift_stdlib_strtoX_clocale_impl(nptr, outResult);
 }
 
 const char *swift::_swift_stdlib_strtof_clocale(
     const char * nptr, float *outResult) {
+  if (const char *EndPtr = _swift_stdlib_strtoX_fast_path(nptr, outResult))
+    return EndPtr;
   return _swift_stdlib_strtoX_clocale_impl(nptr, outResult);
 }
 #else
@@ -500,12 +678,16 @@ const char *swift::_swift_stdlib_strtold_clocale(
 
 const char *swift::_swift_stdlib_strtod_clocale(
     const char * nptr, double *outResult) {
+  if (const char *EndPtr = _swift_stdlib_strtoX_fast_path(nptr, outResult))
+    return EndPtr;
   return _swift_stdlib_strtoX_clocale_impl(
     nptr, outResult, HUGE_VAL, strtod_l);
 }
 
 const char *swift::_swift_stdlib_strtof_clocale(
     const char * nptr, float *outResult) {
+  if (const char *EndPtr = _swift_stdlib_strtoX_fast_path(nptr, outResult))
+    return EndPtr;
   return _swift_stdlib_strtoX_clocale_impl(
     nptr, outResult, HUGE_VALF, strtof_l);
 }
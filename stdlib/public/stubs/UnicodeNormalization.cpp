@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <mutex>
 #include <assert.h>
+#include <string.h>
 
 #include <unicode/ustring.h>
 #include <unicode/ucol.h>
@@ -67,10 +68,25 @@ static const UCollator *GetRootCollator() {
   return SWIFT_LAZY_CONSTANT(MakeRootCollator());
 }
 
+// These functions use murmurhash2 in its 32 and 64bit forms, which are
+// differentiated by the constants defined below. This seems like a good choice
+// for now because it operates efficiently in blocks rather than bytes, and 
+// the data returned from the collation iterator comes in 4byte chunks.
+#if __arm__ || __i386__
+#define HASH_SEED 0x88ddcc21
+#define HASH_M 0x5bd1e995
+#define HASH_R 24
+#else
+#define HASH_SEED 0x429b126688ddcc21
+#define HASH_M 0xc6a4a7935bd1e995
+#define HASH_R 47
+#endif
+
 /// This class caches the collation element results for the ASCII subset of
 /// unicode.
 class ASCIICollation {
   int32_t CollationTable[128];
+  intptr_t HashTable[128];
 public:
   friend class swift::Lazy<ASCIICollation>;
 
@@ -85,6 +101,12 @@ public:
     return CollationTable[c];
   }
 
+  /// Maps an ASCII character to its collation element already mixed for
+  /// hashing, or zero if the character's collation element is ignorable.
+  intptr_t mapForHashing(unsigned char c) const {
+    return HashTable[c];
+  }
+
 private:
   /// Construct the ASCII collation table.
   ASCIICollation() {
@@ -116,6 +138,14 @@ private:
       if (U_FAILURE(ErrorCode) || NumCollationElts != 1) {
         swift::crash("Error setting up the ASCII collation table");
       }
+
+      intptr_t Elem = CollationTable[c];
+      if (Elem != 0) {
+        Elem *= HASH_M;
+        Elem ^= Elem >> HASH_R;
+        Elem *= HASH_M;
+      }
+      HashTable[c] = Elem;
     }
   }
 
@@ -123,6 +153,61 @@ private:
   ASCIICollation(const ASCIICollation &) = delete;
 };
 
+/// Returns the number of leading code units, up to \p Length, that are ASCII
+/// and equal in both strings, comparing a word at a time.
+template <typename CodeUnit>
+static int32_t countEqualASCIIWords(const CodeUnit *Left,
+                                    const CodeUnit *Right, int32_t Length) {
+  constexpr uint64_t NonASCIIMask = sizeof(CodeUnit) == 1
+    ? 0x8080808080808080ULL : 0xFF80FF80FF80FF80ULL;
+  constexpr int32_t UnitsPerWord = sizeof(uint64_t) / sizeof(CodeUnit);
+
+  int32_t Count = 0;
+  for (; Count + UnitsPerWord <= Length; Count += UnitsPerWord) {
+    uint64_t LeftWord, RightWord;
+    memcpy(&LeftWord, Left + Count, sizeof(LeftWord));
+    memcpy(&RightWord, Right + Count, sizeof(RightWord));
+    if (LeftWord != RightWord || (LeftWord & NonASCIIMask))
+      break;
+  }
+  return Count;
+}
+
+template <typename LeftUnit, typename RightUnit>
+static int32_t countEqualASCIIWords(const LeftUnit *Left,
+                                    const RightUnit *Right, int32_t Length) {
+  return 0;
+}
+
+/// Returns the length of the common ASCII prefix of two strings that can be
+/// dropped without changing how they collate, or -1 if the strings are equal
+/// ASCII strings.
+///
+/// In the root locale ASCII characters are never part of a contraction, so
+/// identical ASCII prefixes contribute identical weights to both sides. The
+/// exception is the last ASCII character before a non-ASCII one, which may
+/// compose with a following combining mark, so it is left in place.
+template <typename LeftUnit, typename RightUnit>
+static int32_t getSkippableASCIIPrefix(const LeftUnit *Left,
+                                       int32_t LeftLength,
+                                       const RightUnit *Right,
+                                       int32_t RightLength) {
+  int32_t Length = std::min(LeftLength, RightLength);
+  int32_t Prefix = countEqualASCIIWords(Left, Right, Length);
+  while (Prefix < Length && Left[Prefix] == Right[Prefix] &&
+         Left[Prefix] < 0x80)
+    ++Prefix;
+
+  if (Prefix == LeftLength && Prefix == RightLength)
+    return -1;
+
+  if (Prefix > 0 &&
+      ((Prefix < LeftLength && Left[Prefix] >= 0x80) ||
+       (Prefix < RightLength && Right[Prefix] >= 0x80)))
+    --Prefix;
+  return Prefix;
+}
+
 /// Compares the strings via the Unicode Collation Algorithm on the root locale.
 /// Results are the usual string comparison results:
 ///  <0 the left string is less than the right string.
@@ -133,6 +218,15 @@ swift::_swift_stdlib_unicode_compare_utf16_utf16(const uint16_t *LeftString,
                                                  int32_t LeftLength,
                                                  const uint16_t *RightString,
                                                  int32_t RightLength) {
+  int32_t Prefix = getSkippableASCIIPrefix(LeftString, LeftLength,
+                                           RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
 #if defined(__CYGWIN__) || defined(_MSC_VER)
   // ICU UChar type is platform dependent. In Cygwin, it is defined
   // as wchar_t which size is 2. It seems that the underlying binary
@@ -157,6 +251,15 @@ swift::_swift_stdlib_unicode_compare_utf8_utf16(const unsigned char *LeftString,
                                                 int32_t LeftLength,
                                                 const uint16_t *RightString,
                                                 int32_t RightLength) {
+  int32_t Prefix = getSkippableASCIIPrefix(LeftString, LeftLength,
+                                           RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
   UCharIterator LeftIterator;
   UCharIterator RightIterator;
   UErrorCode ErrorCode = U_ZERO_ERROR;
@@ -187,6 +290,15 @@ swift::_swift_stdlib_unicode_compare_utf8_utf8(const unsigned char *LeftString,
                                                int32_t LeftLength,
                                                const unsigned char *RightString,
                                                int32_t RightLength) {
+  int32_t Prefix = getSkippableASCIIPrefix(LeftString, LeftLength,
+                                           RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
   UCharIterator LeftIterator;
   UCharIterator RightIterator;
   UErrorCode ErrorCode = U_ZERO_ERROR;
@@ -202,20 +314,6 @@ swift::_swift_stdlib_unicode_compare_utf8_utf8(const unsigned char *LeftString,
   return Diff;
 }
 
-// These functions use murmurhash2 in its 32 and 64bit forms, which are
-// differentiated by the constants defined below. This seems like a good choice
-// for now because it operates efficiently in blocks rather than bytes, and 
-// the data returned from the collation iterator comes in 4byte chunks.
-#if __arm__ || __i386__
-#define HASH_SEED 0x88ddcc21
-#define HASH_M 0x5bd1e995
-#define HASH_R 24
-#else
-#define HASH_SEED 0x429b126688ddcc21
-#define HASH_M 0xc6a4a7935bd1e995
-#define HASH_R 47
-#endif
-
 static intptr_t hashChunk(const UCollator *Collator, intptr_t HashState,
                           const uint16_t *Str, uint32_t Length,
                           UErrorCode *ErrorCode) {
@@ -254,11 +352,43 @@ static intptr_t hashFinish(intptr_t HashState) {
   return HashState;
 }
 
+/// Mixes the collation elements of \p Length ASCII code units into the hash.
+template <typename CodeUnit>
+static intptr_t hashASCIIChunk(const ASCIICollation *Table, intptr_t HashState,
+                               const CodeUnit *Str, int32_t Length) {
+  for (int32_t Pos = 0; Pos < Length; ++Pos) {
+    assert(Str[Pos] < 0x80 && "This table only exists for the ASCII subset");
+    intptr_t Elem = Table->mapForHashing(Str[Pos]);
+    // Ignore zero valued collation elements. They don't participate in the
+    // ordering relation.
+    if (Elem == 0)
+      continue;
+    HashState *= HASH_M;
+    HashState ^= Elem;
+  }
+  return HashState;
+}
+
 intptr_t
 swift::_swift_stdlib_unicode_hash(const uint16_t *Str, int32_t Length) {
+  // Hash the leading ASCII code units from the table. The last one before a
+  // non-ASCII code unit may compose with what follows, so it is left to ICU,
+  // which then starts on a character boundary and produces the same
+  // collation elements it would have for the whole string.
+  int32_t Prefix = 0;
+  while (Prefix < Length && Str[Prefix] < 0x80)
+    ++Prefix;
+  if (Prefix > 0 && Prefix < Length)
+    --Prefix;
+
+  intptr_t HashState = hashASCIIChunk(ASCIICollation::getTable(), HASH_SEED,
+                                      Str, Prefix);
+  if (Prefix == Length)
+    return hashFinish(HashState);
+
   UErrorCode ErrorCode = U_ZERO_ERROR;
-  intptr_t HashState = HASH_SEED;
-  HashState = hashChunk(GetRootCollator(), HashState, Str, Length, &ErrorCode);
+  HashState = hashChunk(GetRootCollator(), HashState, Str + Prefix,
+                        Length - Prefix, &ErrorCode);
 
   if (U_FAILURE(ErrorCode)) {
     swift::crash("hashChunk: Unexpected error hashing unicode string.");
@@ -268,25 +398,8 @@ swift::_swift_stdlib_unicode_hash(const uint16_t *Str, int32_t Length) {
 
 intptr_t swift::_swift_stdlib_unicode_hash_ascii(const unsigned char *Str,
                                                  int32_t Length) {
-  const ASCIICollation *Table = ASCIICollation::getTable();
-  intptr_t HashState = HASH_SEED;
-  int32_t Pos = 0;
-  while (Pos < Length) {
-    const unsigned char c = Str[Pos++];
-    assert((c & 0x80) == 0 && "This table only exists for the ASCII subset");
-    intptr_t Elem = Table->map(c);
-    // Ignore zero valued collation elements. They don't participate in the
-    // ordering relation.
-    if (Elem == 0)
-      continue;
-    Elem *= HASH_M;
-    Elem ^= Elem >> HASH_R;
-    Elem *= HASH_M;
-
-    HashState *= HASH_M;
-    HashState ^= Elem;
-  }
-  return hashFinish(HashState);
+  return hashFinish(hashASCIIChunk(ASCIICollation::getTable(), HASH_SEED,
+                                   Str, Length));
 }
 
 /// Convert the unicode string to uppercase. This function will return the
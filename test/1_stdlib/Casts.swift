@@ -46,4 +46,22 @@ CastsTests.test("No overrelease of existential boxes in failed casts") {
     bar(err)
 }
 
+CastsTests.test("Casts out of Any between value types") {
+    let values: [Any] = [1, "one", (1, "one"), [1], ["one": 1], Optional(1)]
+    expectEqual(1, values[0] as? Int)
+    expectNil(values[0] as? String)
+    expectEqual("one", values[1] as? String)
+    expectNil(values[1] as? Int)
+    expectNil(values[2] as? Int)
+    expectEqual(1, (values[2] as? (Int, String))?.0)
+    expectEqual([1], values[3] as? [Int])
+    expectNil(values[3] as? [String])
+    expectEqual(["one": 1], values[4] as? [String: Int])
+    expectEqual(1, values[5] as? Int)
+
+    // Failed casts that take the value must destroy it.
+    let tracked: Any = LifetimeTracked(0)
+    expectNil(tracked as? Int)
+}
+
 runAllTests()
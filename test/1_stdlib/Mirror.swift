@@ -220,6 +220,25 @@ mirrors.test("Legacy") {
   }
 }
 
+mirrors.test("Legacy/FieldNames") {
+  struct S { var a = 1, bb = 2, ccc = 3 }
+  enum E { case first, second, third }
+
+  // Reflect each value more than once so names come from the runtime's
+  // cached index of the field name list as well as from a fresh one.
+  for _ in 0..<2 {
+    let ms = Mirror(reflecting: S())
+    expectEqual(["a", "bb", "ccc"], ms.children.map { $0.label! })
+    expectEqual([1, 2, 3], ms.children.map { $0.value as! Int })
+  }
+
+  var caseNames: [String] = []
+  for value in [E.third, .first, .second, .third] {
+    caseNames.append(String(describing: value))
+  }
+  expectEqual(["third", "first", "second", "third"], caseNames)
+}
+
 //===----------------------------------------------------------------------===//
 //===--- Class Support ----------------------------------------------------===//
 
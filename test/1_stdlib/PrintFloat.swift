@@ -71,6 +71,7 @@ PrintTests.test("Printable") {
   expectPrinted("nan", Double.signalingNaN)
   expectPrinted("nan", -Double.signalingNaN)
   expectPrinted("0.0", asFloat64(0.0))
+  expectPrinted("-0.0", asFloat64(-0.0))
   expectPrinted("1.0", asFloat64(1.0))
   expectPrinted("-1.0", asFloat64(-1.0))
   expectPrinted("100.125", asFloat64(100.125))
@@ -230,6 +231,7 @@ PrintTests.test("Printable") {
 
   expectDebugPrinted("1.1000000000000001", asFloat64(1.1))
   expectDebugPrinted("1.25e+17", asFloat64(125000000000000000.0))
+  expectDebugPrinted("12345678901234568.0", asFloat64(12345678901234567.0))
   expectDebugPrinted("1.25", asFloat64(1.25))
   expectDebugPrinted("1.2500000000000001e-05", asFloat64(0.0000125))
   expectDebugPrinted("inf", Double.infinity)
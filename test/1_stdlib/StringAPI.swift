@@ -72,6 +72,11 @@ let comparisonTests = [
   ComparisonTest(.eq, "a\u{301}", "\u{e1}"),
   ComparisonTest(.lt, "a", "a\u{301}"),
   ComparisonTest(.lt, "a", "\u{e1}"),
+  ComparisonTest(.eq, "abcdefghijklmnopqrsta\u{301}",
+                      "abcdefghijklmnopqrst\u{e1}"),
+  ComparisonTest(.lt, "abcdefghijklmnopqrsta", "abcdefghijklmnopqrst\u{e1}"),
+  ComparisonTest(.lt, "abcdefghijklmnopqrst", "abcdefghijklmnopqrstu"),
+  ComparisonTest(.eq, "abcdefghijklmnopqrst", "abcdefghijklmnopqrst"),
 
   // U+304B HIRAGANA LETTER KA
   // U+304C HIRAGANA LETTER GA
@@ -323,6 +328,19 @@ StringTests.test("CompareStringsWithUnpairedSurrogates")
   )
 }
 
+StringTests.test("CharacterView/ASCIIGraphemeClusters") {
+  // ASCII scalars mixed with CR LF pairs and combining marks, which must not
+  // be split off from the ASCII scalars before them.
+  let s = "ab\r\ncd\re\u{301}\nf\r\n\r\ng"
+  let expected: [String] =
+    ["a", "b", "\r\n", "c", "d", "\r", "e\u{301}", "\n", "f", "\r\n",
+     "\r\n", "g"]
+  expectEqual(expected, s.characters.map { String($0) })
+  expectEqual(Array(expected.reversed()),
+    s.characters.reversed().map { String($0) })
+  expectEqual(expected.count, s.characters.count)
+}
+
 var CStringTests = TestSuite("CStringTests")
 
 func getNullUTF8() -> UnsafeMutablePointer<UInt8>? {
@@ -0,0 +1,37 @@
+// Note: this test intentionally uses a private module cache.
+//
+// A module's Swift lookup table is part of its PCM, so a PCM built with a
+// different lookup table configuration, including a different compiler
+// version, must not be reused. The configuration is part of the module hash,
+// so such a PCM ends up in a different directory of the module cache and the
+// module is rebuilt next to it. The compiler version can't change between
+// RUN lines, so -enable-infer-import-as-member, which feeds the same hash,
+// stands in for it.
+//
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -parse -module-cache-path %t/clang-module-cache -I %S/Inputs %s
+// RUN: find %t/clang-module-cache -name 'cfuncs-*.pcm' | FileCheck -check-prefix=FIRST %s
+
+// The PCM records the compiler that wrote its lookup table.
+// RUN: %swiftc_driver_plain -version | head -n1 > %t/version.txt
+// RUN: grep -a -F -f %t/version.txt %t/clang-module-cache/*/cfuncs-*.pcm > /dev/null
+
+// The same configuration reuses the PCM.
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -parse -module-cache-path %t/clang-module-cache -I %S/Inputs %s
+// RUN: find %t/clang-module-cache -name 'cfuncs-*.pcm' | FileCheck -check-prefix=FIRST %s
+
+// A different configuration rebuilds it.
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk) -parse -module-cache-path %t/clang-module-cache -I %S/Inputs -enable-infer-import-as-member %s
+// RUN: find %t/clang-module-cache -name 'cfuncs-*.pcm' | FileCheck -check-prefix=SECOND %s
+
+// XFAIL: linux
+
+// FIRST: cfuncs-{{.*}}.pcm
+// FIRST-NOT: cfuncs-{{.*}}.pcm
+
+// SECOND: cfuncs-{{.*}}.pcm
+// SECOND: cfuncs-{{.*}}.pcm
+// SECOND-NOT: cfuncs-{{.*}}.pcm
+
+import cfuncs
@@ -142,4 +142,14 @@ func defaultToAny(i: Int, s: String) {
 
   let a4 = [B(), C()]
   let _: Int = a4 // expected-error{{value of type '[A]'}}
+
+  let a5 = [1, 2, 3, 4, 5, 6, 7, 8]
+  let _: Int = a5 // expected-error{{value of type '[Int]'}}
+
+  let a6 = [1, 2, 3.5, 4, 5.5]
+  let _: Int = a6 // expected-error{{value of type '[Double]'}}
+
+  let a7 = ["a", "b", 1, "c", 2]
+  // expected-error@-1{{heterogenous collection literal could only be inferred to '[Any]'; add explicit type annotation if this is intentional}}
+  let _: Int = a7 // expected-error{{value of type '[Any]'}}
 }
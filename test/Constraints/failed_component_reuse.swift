@@ -0,0 +1,18 @@
+// RUN: not %target-swift-frontend -parse -debug-constraints %s 2>&1 | FileCheck %s
+
+// Both overloads of g() produce an Int, so the call to h() that remains after
+// choosing either of them is the same connected component. It fails for the
+// first choice and isn't solved again for the second.
+
+func g(_ x: Int) -> Int { return x }
+func g(_ x: Double) -> Int { return 0 }
+
+func h(_ x: String) {}
+func h(_ x: Bool) {}
+func h(_ x: [Int]) {}
+
+// CHECK: (solving component #
+// CHECK: failed component #
+// CHECK: (component is known to fail)
+// CHECK-NEXT: failed component #
+h(g(1))
@@ -161,3 +161,13 @@ struct X2 {
 
 let x2 = X2(Int.self)
 let x2check: X2 = x2 // expected-error{{value of optional type 'X2?' not unwrapped; did you mean to use '!' or '?'?}}
+
+// Overloads which only differ in their argument labels.
+func labeled(x: Int, y: Int) -> Int { return x }
+func labeled(x: Int, z: Int) -> String { return "" }
+func labeled(_ x: Int, _ y: Int) -> Double { return 0 }
+
+let labeledInt: Int = labeled(x: 1, y: 2)
+let labeledString: String = labeled(x: 1, z: 2)
+let labeledDouble: Double = labeled(1, 2)
+let labeledMismatch: Int = labeled(x: 1, z: 2) // expected-error{{cannot convert value of type 'String' to specified type 'Int'}}
@@ -0,0 +1,19 @@
+// RUN: %target-swift-frontend %s -emit-ir -gline-tables-only -o - | FileCheck %s
+
+// Methods are scoped to the module with -gline-tables-only, so none of the
+// types they are nested in are described.
+// CHECK-NOT: DW_TAG_structure_type
+// CHECK-NOT: DW_TAG_class_type
+// CHECK: !DISubprogram(name: "method"
+// CHECK-NOT: DW_TAG_structure_type
+// CHECK-NOT: DW_TAG_class_type
+
+public struct S {
+  public var x: Int
+  public func method() -> Int { return x }
+}
+
+public class C {
+  public var s = S(x: 1)
+  public func method() -> Int { return s.method() }
+}
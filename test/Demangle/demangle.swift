@@ -12,3 +12,7 @@ RUN: diff %t.check %t.output
 ; RUN: swift-demangle __TtSi | FileCheck %s -check-prefix=DOUBLE
 ; DOUBLE: _TtSi ---> Swift.Int
 
+
+; Symbols embedded in other text are demangled in place.
+; RUN: echo 'foo _TtSi, _T x__TtSi _TtSS' | swift-demangle | FileCheck %s -check-prefix=EMBEDDED
+; EMBEDDED: foo Swift.Int, _T x_Swift.Int Swift.String
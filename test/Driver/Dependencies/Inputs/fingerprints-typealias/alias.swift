@@ -0,0 +1,2 @@
+typealias T = Int
+func f(_ x: T) {}
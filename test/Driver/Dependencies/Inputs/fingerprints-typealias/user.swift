@@ -0,0 +1 @@
+let h = f
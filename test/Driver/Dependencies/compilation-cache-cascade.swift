@@ -0,0 +1,33 @@
+// other ==> main ==> yet-another
+
+// A job that runs makes a cached job out of date, and the outputs copied from
+// the cache make a job that was waiting on its dependencies out of date too.
+
+// RUN: rm -rf %t && cp -r %S/Inputs/chained/ %t
+// RUN: touch -t 201401240005 %t/*
+
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift ./yet-another.swift -module-name main -compilation-cache-path %t/cache -j1 -v 2>&1 | FileCheck -check-prefix=CHECK-FIRST %s
+
+// CHECK-FIRST-NOT: warning
+// CHECK-FIRST: Handled main.swift
+// CHECK-FIRST: Handled other.swift
+// CHECK-FIRST: Handled yet-another.swift
+
+// Drop other.swift's cache entry so that it runs, and make the recorded
+// dependencies of other.swift and main.swift stale, so that what other.swift
+// provides changes when it runs and what main.swift provides changes when it
+// comes from the cache.
+// RUN: grep -l "Handled other.swift" %t/cache/*.out | xargs rm
+// RUN: echo "provides-top-level: []" > %t/other.swiftdeps
+// RUN: echo "depends-top-level: [a]" > %t/main.swiftdeps
+// RUN: touch -t 201401240006 %t/other.swift
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift ./yet-another.swift -module-name main -compilation-cache-path %t/cache -j1 -v -driver-show-incremental 2>&1 | FileCheck -check-prefix=CHECK-SECOND %s
+// RUN: grep "provides-nominal: \[z\]" %t/main.swiftdeps
+
+// CHECK-SECOND: Queuing other.swift (initial)
+// CHECK-SECOND: update-dependencies.py
+// CHECK-SECOND: Handled other.swift
+// CHECK-SECOND-DAG: Queuing main.swift because of dependencies discovered later
+// CHECK-SECOND-DAG: Queuing yet-another.swift because of dependencies discovered later
+// CHECK-SECOND-DAG: Handled main.swift
+// CHECK-SECOND-DAG: Handled yet-another.swift
@@ -0,0 +1,27 @@
+/// other ==> main
+
+// RUN: rm -rf %t && cp -r %S/Inputs/one-way/ %t
+// RUN: touch -t 201401240005 %t/*
+
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -compilation-cache-path %t/cache -j1 -v 2>&1 | FileCheck -check-prefix=CHECK-FIRST %s
+
+// CHECK-FIRST-NOT: warning
+// CHECK-FIRST: update-dependencies.py
+// CHECK-FIRST: Handled main.swift
+// CHECK-FIRST: update-dependencies.py
+// CHECK-FIRST: Handled other.swift
+
+// Start over from a clean build directory; everything comes from the cache.
+// RUN: rm %t/main.o %t/other.o %t/main.swiftdeps %t/other.swiftdeps %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -compilation-cache-path %t/cache -j1 -v 2>&1 | FileCheck -check-prefix=CHECK-SECOND %s
+// RUN: ls %t/main.o %t/other.o %t/main.swiftdeps %t/other.swiftdeps
+
+// CHECK-SECOND-NOT: update-dependencies.py
+// CHECK-SECOND: Handled main.swift
+// CHECK-SECOND: Handled other.swift
+// CHECK-SECOND-NOT: update-dependencies.py
+
+// Every source file is part of every job's key.
+// RUN: rm %t/main.o %t/other.o %t/main.swiftdeps %t/other.swiftdeps %t/main~buildrecord.swiftdeps
+// RUN: echo "# changed" >> %t/other.swift
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -compilation-cache-path %t/cache -j1 -v 2>&1 | FileCheck -check-prefix=CHECK-FIRST %s
@@ -0,0 +1,19 @@
+// alias ==> user
+
+// Changing what a type alias stands for doesn't change the tokens of a
+// function that uses it in its signature, but the function's dependents
+// still have to be rebuilt.
+
+// RUN: rm -rf %t && cp -r %S/Inputs/fingerprints-typealias/ %t
+// RUN: %S/Inputs/touch.py 443865900 %t/*
+// RUN: cd %t && %target-swiftc_driver -c -incremental -output-file-map %t/output.json ./alias.swift ./user.swift -module-name main -j1 2>&1 | FileCheck -check-prefix=CHECK-FIRST %s
+
+// CHECK-FIRST-NOT: warning
+// CHECK-FIRST-NOT: error
+
+// RUN: sed -e 's/= Int/= String/' %S/Inputs/fingerprints-typealias/alias.swift > %t/alias.swift
+// RUN: cd %t && %target-swiftc_driver -c -incremental -output-file-map %t/output.json ./alias.swift ./user.swift -module-name main -j1 -driver-show-incremental 2>&1 | FileCheck %s
+
+// CHECK-NOT: warning
+// CHECK: Queuing alias.swift (initial)
+// CHECK: Queuing user.swift because of dependencies discovered later
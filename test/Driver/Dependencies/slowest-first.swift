@@ -0,0 +1,29 @@
+// main | other
+
+// RUN: rm -rf %t && cp -r %S/Inputs/independent/ %t
+// RUN: %S/Inputs/touch.py 443865900 %t/*
+
+// RUN: echo '{version: "'$(%swiftc_driver_plain -version | head -n1)'", inputs: {"./main.swift": !dirty [443865900, 0], "./other.swift": !dirty [443865900, 0]}, build_time: [443865901, 0], durations: {"./main.swift": 10, "./other.swift": 500}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2 -parseable-output 2>&1 | FileCheck -check-prefix=CHECK-OTHER-FIRST %s
+
+// CHECK-OTHER-FIRST-NOT: warning
+// CHECK-OTHER-FIRST: "kind": "began"
+// CHECK-OTHER-FIRST: "inputs": [
+// CHECK-OTHER-FIRST-NEXT: ".\/other.swift"
+// CHECK-OTHER-FIRST: "kind": "began"
+// CHECK-OTHER-FIRST: "inputs": [
+// CHECK-OTHER-FIRST-NEXT: ".\/main.swift"
+
+// RUN: echo '{version: "'$(%swiftc_driver_plain -version | head -n1)'", inputs: {"./main.swift": !dirty [443865900, 0], "./other.swift": !dirty [443865900, 0]}, build_time: [443865901, 0], durations: {"./main.swift": 500, "./other.swift": 10}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2 -parseable-output 2>&1 | FileCheck -check-prefix=CHECK-MAIN-FIRST %s
+
+// CHECK-MAIN-FIRST: "kind": "began"
+// CHECK-MAIN-FIRST: "inputs": [
+// CHECK-MAIN-FIRST-NEXT: ".\/main.swift"
+// CHECK-MAIN-FIRST: "kind": "began"
+// CHECK-MAIN-FIRST: "inputs": [
+// CHECK-MAIN-FIRST-NEXT: ".\/other.swift"
+
+// Running one job at a time keeps the command line order.
+// RUN: echo '{version: "'$(%swiftc_driver_plain -version | head -n1)'", inputs: {"./main.swift": !dirty [443865900, 0], "./other.swift": !dirty [443865900, 0]}, build_time: [443865901, 0], durations: {"./main.swift": 10, "./other.swift": 500}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j1 -parseable-output 2>&1 | FileCheck -check-prefix=CHECK-MAIN-FIRST %s
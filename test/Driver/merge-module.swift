@@ -97,3 +97,22 @@
 // MERGE_1: -module-name merge
 // MERGE_1: -o /tmp/modules
 
+
+// RUN: %swiftc_driver -driver-print-jobs -emit-module -fast-emit-module %S/Inputs/main.swift %S/Inputs/lib.swift -module-name merge -o /tmp/modules > %t.fast.txt
+// RUN: FileCheck -check-prefix FAST %s < %t.fast.txt
+
+// FAST: bin/swift{{c?}} -frontend -emit-module -primary-file {{[^ ]+}}/Inputs/main.swift {{[^ ]+}}/Inputs/lib.swift
+// FAST-SAME: -skip-secondary-function-bodies -disable-sil-perf-optzns
+// FAST: bin/swift{{c?}} -frontend -emit-module {{[^ ]+}}/Inputs/main.swift -primary-file {{[^ ]+}}/Inputs/lib.swift
+// FAST-SAME: -skip-secondary-function-bodies -disable-sil-perf-optzns
+// FAST: bin/swift{{c?}} -frontend -emit-module {{[^ ]+}}.swiftmodule {{[^ ]+}}.swiftmodule
+// FAST-SAME: -disable-sil-perf-optzns -o /tmp/modules
+
+// RUN: %swiftc_driver -driver-print-jobs -c -emit-module -fast-emit-module %S/Inputs/main.swift %S/Inputs/lib.swift -module-name merge > %t.fast-objects.txt
+// RUN: FileCheck -check-prefix FAST-OBJECTS %s < %t.fast-objects.txt
+
+// FAST-OBJECTS: bin/swift{{c?}} -frontend -c
+// FAST-OBJECTS-NOT: -skip-secondary-function-bodies
+// FAST-OBJECTS-NOT: -disable-sil-perf-optzns
+// FAST-OBJECTS: bin/swift{{c?}} -frontend -emit-module {{[^ ]+}}.swiftmodule {{[^ ]+}}.swiftmodule
+// FAST-OBJECTS-SAME: -disable-sil-perf-optzns
@@ -0,0 +1,26 @@
+// RUN: %swiftc_driver -driver-print-jobs -emit-module %s %S/Inputs/lib.swift -module-name main -driver-time-trace %t.trace.json 2>&1 | FileCheck -check-prefix=JOBS %s
+
+// JOBS: bin/swift{{c?}} -frontend -emit-module {{.*}}-primary-file {{.*}}/time-trace.swift {{.*}}-emit-phase-timings-path {{[^ ]+}}.timings
+// JOBS: bin/swift{{c?}} -frontend -emit-module {{.*}}-primary-file {{.*}}/lib.swift {{.*}}-emit-phase-timings-path {{[^ ]+}}.timings
+// JOBS: bin/swift{{c?}} -frontend -emit-module {{.*}}-parse-as-library {{.*}}-emit-phase-timings-path {{[^ ]+}}.timings
+
+// RUN: %swiftc_driver -driver-print-jobs -emit-module %s -module-name main 2>&1 | FileCheck -check-prefix=NO-TRACE %s
+// NO-TRACE-NOT: -emit-phase-timings-path
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -parse %s -emit-phase-timings-path %t/phases.timings
+// RUN: FileCheck -check-prefix=PHASES %s < %t/phases.timings
+
+// PHASES: - ["Parsing", {{[0-9]+}}, {{[0-9]+}}]
+
+// RUN: %target-swiftc_driver -parse %s %S/Inputs/lib.swift -module-name main -j2 -driver-time-trace %t/trace.json
+// RUN: FileCheck -check-prefix=TRACE %s < %t/trace.json
+
+// TRACE: "traceEvents": [
+// TRACE-DAG: "name": "compile time-trace.swift",
+// TRACE-DAG: "name": "compile lib.swift",
+// TRACE-DAG: "cat": "job",
+// TRACE-DAG: "name": "Parsing",
+// TRACE-DAG: "cat": "phase",
+// TRACE-DAG: "ph": "X",
+// TRACE-DAG: "tid": 0,
@@ -0,0 +1,15 @@
+// RUN: %target-swift-frontend -emit-ir -print-memory-stats %s -o /dev/null 2>&1 | FileCheck %s
+
+// CHECK: *** Memory use after type checking ***
+// CHECK-NEXT: {{^}}  ASTContext: {{[1-9][0-9]*}} bytes ({{[0-9]+}} in the constraint solver arena)
+// CHECK: {{^}}  module Swift: {{[1-9][0-9]*}} bytes of serialized data
+// CHECK-NOT: SILModule
+// CHECK: *** Memory use after SIL optimization ***
+// CHECK: {{^}}  SILModule: {{[1-9][0-9]*}} bytes
+// CHECK: *** Memory use after IRGen ***
+// CHECK-NEXT: {{^}}  ASTContext: {{[1-9][0-9]*}} bytes
+// CHECK-NOT: SILModule
+
+func add(_ x: Int, _ y: Int) -> Int {
+  return x + y
+}
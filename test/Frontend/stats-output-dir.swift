@@ -0,0 +1,28 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -c -module-name stats %s -o %t/stats.o -stats-output-dir %t/stats
+// RUN: cat %t/stats/frontend-stats-*.json | FileCheck %s
+
+// Multi-threaded IRGen doesn't return a module, so there's nothing to count.
+// RUN: %target-swift-frontend -c -module-name stats_mt %s -o %t/stats_mt.o -num-threads 2 -stats-output-dir %t/stats
+// RUN: cat %t/stats/frontend-stats_mt-*.json | FileCheck -check-prefix=THREADED %s
+
+// RUN: %swiftc_driver -driver-print-jobs -c %s -stats-output-dir %t/stats | FileCheck -check-prefix=DRIVER %s
+// DRIVER: -frontend {{.*}}-stats-output-dir {{[^ ]*}}/stats
+
+// CHECK: "module": "stats",
+// CHECK: "counters": {
+// CHECK-DAG: "Deserialization.NumDecls": {{[1-9][0-9]*}},
+// CHECK-DAG: "SILGen.NumInstructions": {{[1-9][0-9]*}},
+// CHECK-DAG: "SILOptimizer.NumInstructions": {{[1-9][0-9]*}},
+// CHECK-DAG: "LLVM.NumInstructions": {{[1-9][0-9]*}}
+// CHECK: "phases": {
+// CHECK: "Type checking / Semantic analysis": {{[0-9]+\.[0-9]+}}
+
+// THREADED: "counters": {
+// THREADED: "SILOptimizer.NumInstructions": {{[1-9][0-9]*}}
+// THREADED-NOT: "LLVM.
+// THREADED: },
+
+func add(_ x: Int, _ y: Int) -> Int {
+  return x + y
+}
@@ -0,0 +1,34 @@
+// RUN: %target-swift-frontend -parse -warning-limit 2 %s 2>&1 | FileCheck %s
+// RUN: %target-swift-frontend -parse -warning-limit 0 %s 2>&1 | FileCheck -check-prefix=NOLIMIT %s
+// RUN: not %target-swift-frontend -parse -warning-limit many %s 2>&1 | FileCheck -check-prefix=INVALID %s
+
+// CHECK: warning: variable 'a' was never mutated
+// CHECK: warning: variable 'b' was never mutated
+// CHECK-NOT: variable 'c' was never mutated
+// CHECK-NOT: variable 'd' was never mutated
+// CHECK: warning: 2 more warnings were not shown because of -warning-limit
+
+// NOLIMIT: warning: variable 'd' was never mutated
+// NOLIMIT-NOT: -warning-limit
+
+// INVALID: error: invalid value 'many' in '-warning-limit many'
+
+func a() -> Int {
+  var a = 1
+  return a
+}
+
+func b() -> Int {
+  var b = 2
+  return b
+}
+
+func c() -> Int {
+  var c = 3
+  return c
+}
+
+func d() -> Int {
+  var d = 4
+  return d
+}
@@ -0,0 +1,11 @@
+// RUN: %target-swift-frontend %s -Osize -emit-ir | FileCheck %s
+// RUN: %target-swift-frontend %s -O -emit-ir | FileCheck %s --check-prefix=SPEED
+
+// Check that -Osize asks LLVM to optimize functions for size.
+
+// CHECK: define {{.*}} @_TF5osize3addFTSiSi_Si({{.*}}) [[ATTRS:#[0-9]+]]
+// CHECK: attributes [[ATTRS]] = { {{.*}}optsize
+// SPEED-NOT: optsize
+public func add(_ x: Int, _ y: Int) -> Int {
+  return x &+ y
+}
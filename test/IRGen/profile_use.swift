@@ -0,0 +1,22 @@
+// RUN: rm -rf %t && mkdir %t
+// RUN: %llvm-profdata merge %S/Inputs/profile_use.proftext -o %t/profile_use.profdata
+// RUN: %target-swift-frontend -parse-as-library -module-name pgo -emit-ir -profile-use=%t/profile_use.profdata %s | FileCheck %s
+// RUN: not %target-swift-frontend -parse-as-library -module-name pgo -emit-ir -profile-use=%t/missing.profdata %s 2>&1 | FileCheck -check-prefix=MISSING %s
+
+// MISSING: error: failed to load profile data '{{.*}}missing.profdata'
+
+// CHECK: define{{.*}} void @_TF3pgo3hotFT_T_() {{.*}}!prof ![[HOT:[0-9]+]]
+public func hot() {}
+
+// CHECK: define{{.*}} void @_TF3pgo4coldFT_T_() {{.*}}!prof ![[COLD:[0-9]+]]
+public func cold() {}
+
+// The profile has no counts for this function.
+// CHECK: define{{.*}} void @_TF3pgo10unprofiledFT_T_() {{[^!]*}}{
+public func unprofiled() {}
+
+// The profile was only read, so no counters are incremented.
+// CHECK-NOT: llvm.instrprof.increment
+
+// CHECK-DAG: ![[HOT]] = !{!"function_entry_count", i64 100}
+// CHECK-DAG: ![[COLD]] = !{!"function_entry_count", i64 0}
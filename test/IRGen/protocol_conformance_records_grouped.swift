@@ -0,0 +1,37 @@
+// RUN: %target-swift-frontend -primary-file %s -emit-ir | FileCheck %s
+
+// Conformance records are grouped by protocol, in the order each protocol
+// is first seen, so the runtime can index them as runs.
+
+protocol Runcible {
+  func runce()
+}
+
+protocol Spoon {
+  func spoon()
+}
+
+// CHECK-LABEL: @"\01l_protocol_conformances" = private constant [
+
+// CHECK:         %swift.protocol_conformance {
+// CHECK:           @_TMp36protocol_conformance_records_grouped8Runcible
+// CHECK:           @_TWPV36protocol_conformance_records_grouped5FirstS_8Runcible
+// CHECK:         %swift.protocol_conformance {
+// CHECK:           @_TMp36protocol_conformance_records_grouped8Runcible
+// CHECK:           @_TWPV36protocol_conformance_records_grouped6SecondS_8Runcible
+// CHECK:         %swift.protocol_conformance {
+// CHECK:           @_TMp36protocol_conformance_records_grouped5Spoon
+// CHECK:           @_TWPV36protocol_conformance_records_grouped5FirstS_5Spoon
+// CHECK:         %swift.protocol_conformance {
+// CHECK:           @_TMp36protocol_conformance_records_grouped5Spoon
+// CHECK:           @_TWPV36protocol_conformance_records_grouped6SecondS_5Spoon
+
+struct First: Runcible, Spoon {
+  func runce() {}
+  func spoon() {}
+}
+
+struct Second: Runcible, Spoon {
+  func runce() {}
+  func spoon() {}
+}
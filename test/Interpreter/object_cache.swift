@@ -0,0 +1,10 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-jit-run %s -immediate-object-cache-path %t/cache | FileCheck %s
+// RUN: ls %t/cache | FileCheck %s --check-prefix=CACHE
+// RUN: %target-jit-run %s -immediate-object-cache-path %t/cache | FileCheck %s
+// REQUIRES: swift_interpreter
+
+// CACHE: {{^[0-9a-f]+}}.o
+
+// CHECK: hello from a cached script
+print("hello from a cached script")
@@ -0,0 +1,20 @@
+// RUN: %target-run-simple-swift | FileCheck %s
+// REQUIRES: executable_test
+
+// Non-ASCII strings are written to stdout in chunks; check lengths on both
+// sides of the chunk size.
+
+// CHECK: µ
+print("\u{00B5}")
+
+// CHECK-NEXT: {{^}}µµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµ{{$}}
+print(String(repeating: "\u{00B5}", count: 36))
+
+// CHECK-NEXT: {{^}}aµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµµb{{$}}
+print("a" + String(repeating: "\u{00B5}", count: 36) + "b")
+
+// CHECK-NEXT: {{^}}€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€€{{$}}
+print(String(repeating: "\u{20AC}", count: 60))
+
+// CHECK-NEXT: 🐶 x 🐱
+print("\u{1F436}", "x", "\u{1F431}")
@@ -22,6 +22,8 @@ declare void @swift_retainUnowned(%swift.refcounted*)
 declare void @user(%swift.refcounted *) nounwind
 declare void @user_objc(%objc_object*) nounwind
 declare void @unknown_func()
+declare i32 @readonly_func(%swift.refcounted*) nounwind readonly
+declare i32 @readonly_argmem_func(i32*) nounwind readonly argmemonly
 
 define private void @__swift_fixLifetime(%swift.refcounted*) noinline nounwind {
 entry:
@@ -102,6 +104,41 @@ define void @retain_motion1(%swift.refcounted* %A) {
   ret void
 }
 
+; retain_motion2 - A call that only reads local memory can't release the object
+; or observe its reference count, so the retain can be moved down to the release
+; and both removed.
+
+; CHECK-LABEL: @retain_motion2(
+; CHECK-NEXT: alloca
+; CHECK-NEXT: store
+; CHECK-NEXT: call i32 @readonly_argmem_func
+; CHECK-NEXT: ret i32
+
+define i32 @retain_motion2(%swift.refcounted* %A) {
+  %x = alloca i32
+  store i32 0, i32* %x
+  tail call void @swift_retain(%swift.refcounted* %A)
+  %r = call i32 @readonly_argmem_func(i32* %x)
+  tail call void @swift_release(%swift.refcounted* %A) nounwind
+  ret i32 %r
+}
+
+; retain_motion3 - A readonly call that may read the object could observe its
+; reference count, like isUniquelyReferenced, so the retain must stay before it.
+
+; CHECK-LABEL: @retain_motion3(
+; CHECK-NEXT: call void @swift_retain
+; CHECK-NEXT: call i32 @readonly_func
+; CHECK-NEXT: call void @swift_release
+; CHECK-NEXT: ret i32
+
+define i32 @retain_motion3(%swift.refcounted* %A) {
+  tail call void @swift_retain(%swift.refcounted* %A)
+  %r = call i32 @readonly_func(%swift.refcounted* %A)
+  tail call void @swift_release(%swift.refcounted* %A) nounwind
+  ret i32 %r
+}
+
 ; rdar://11583269 - Optimize out objc_retain/release(null)
 
 ; CHECK-LABEL: @objc_retain_release_null(
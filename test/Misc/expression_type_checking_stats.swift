@@ -0,0 +1,9 @@
+// RUN: rm -f %t.stats
+// RUN: %target-swift-frontend -parse %s -expression-type-checking-stats-path %t.stats
+// RUN: FileCheck %s < %t.stats
+
+var x = [1, 2, 3, 4.5]
+// CHECK: {"file": "{{.*}}expression_type_checking_stats.swift", "line": 5, "column": 9, "ms": {{[0-9]+}}, "NumTypeVariablesBound": {{[0-9]+}}, {{.*}}, "NumComponentsSplit": {{[0-9]+}}}
+
+var y = 10 + 10
+// CHECK: {"file": "{{.*}}expression_type_checking_stats.swift", "line": 8, "column": {{[0-9]+}}, "ms":
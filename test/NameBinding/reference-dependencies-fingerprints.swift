@@ -0,0 +1,81 @@
+// RUN: rm -rf %t && mkdir %t
+// RUN: cp %s %t/main.swift
+// RUN: %target-swift-frontend -parse -primary-file %t/main.swift -emit-reference-dependencies-path - > %t/before.swiftdeps
+// RUN: FileCheck %s < %t/before.swiftdeps
+// RUN: FileCheck -check-prefix=NEGATIVE %s < %t/before.swiftdeps
+
+// RUN: sed -e 's/1 \/\/ CHANGE-BODY/2/' -e 's/Int { \/\/ CHANGE-SIGNATURE/Int? {/' %s > %t/main.swift
+// RUN: %target-swift-frontend -parse -primary-file %t/main.swift -emit-reference-dependencies-path - > %t/after.swiftdeps
+// RUN: cat %t/before.swiftdeps %t/after.swiftdeps | FileCheck -check-prefix=COMPARE %s
+
+// RUN: sed -e 's/Int \/\/ CHANGE-ALIAS/String/' %s > %t/main.swift
+// RUN: %target-swift-frontend -parse -primary-file %t/main.swift -emit-reference-dependencies-path - > %t/alias.swiftdeps
+// RUN: cat %t/before.swiftdeps %t/alias.swiftdeps | FileCheck -check-prefix=ALIAS %s
+
+// CHECK-LABEL: {{^fingerprints-top-level:$}}
+// CHECK-NEXT: - ["Explicit", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: - ["explicitFunc", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: - ["explicitGlobal", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: - ["<*>", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: - ["Alias", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: - ["aliasFunc", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: {{^fingerprints-nominal:$}}
+// CHECK-NEXT: - ["V4main8Explicit", "{{[0-9a-f]+}}"]
+// CHECK-NEXT: {{^interface-hash:}}
+
+// Declarations whose types are inferred from expressions don't get
+// fingerprints.
+// NEGATIVE-LABEL: {{^fingerprints-top-level:$}}
+// NEGATIVE-NOT: "Inferred"
+// NEGATIVE-NOT: "inferredGlobal"
+// NEGATIVE-NOT: "V4main8Inferred"
+// NEGATIVE: {{^interface-hash:}}
+
+// Changing a function body doesn't change the fingerprint of the type that
+// contains it; changing a signature does.
+// COMPARE-LABEL: {{^fingerprints-top-level:$}}
+// COMPARE-NEXT: - ["Explicit", "[[EXPLICIT:[0-9a-f]+]]"]
+// COMPARE-NEXT: - ["explicitFunc", "[[FUNC:[0-9a-f]+]]"]
+// COMPARE-NEXT: - ["explicitGlobal", "[[GLOBAL:[0-9a-f]+]]"]
+// COMPARE: {{^fingerprints-nominal:$}}
+// COMPARE-NEXT: - ["V4main8Explicit", "[[EXPLICIT_NOMINAL:[0-9a-f]+]]"]
+// COMPARE: {{^fingerprints-top-level:$}}
+// COMPARE-NEXT: - ["Explicit", "[[EXPLICIT]]"]
+// COMPARE-NOT: "[[FUNC]]"
+// COMPARE: - ["explicitGlobal", "[[GLOBAL]]"]
+// COMPARE: {{^fingerprints-nominal:$}}
+// COMPARE-NEXT: - ["V4main8Explicit", "[[EXPLICIT_NOMINAL]]"]
+
+// Changing what a type alias stands for changes the fingerprints of the
+// declarations that use it, even though their own tokens stay the same.
+// ALIAS-LABEL: {{^fingerprints-top-level:$}}
+// ALIAS: - ["aliasFunc", "[[ALIAS_FUNC:[0-9a-f]+]]"]
+// ALIAS: {{^fingerprints-top-level:$}}
+// ALIAS-NOT: "[[ALIAS_FUNC]]"
+// ALIAS: {{^interface-hash:}}
+
+struct Explicit {
+  func f() -> Int {
+    return 1 // CHANGE-BODY
+  }
+}
+
+extension Explicit {
+  var g: Int { return f() }
+}
+
+struct Inferred {
+  var x = 0
+}
+
+func explicitFunc(_ x: Int) -> Int { // CHANGE-SIGNATURE
+  return x
+}
+
+var explicitGlobal: Int = 0
+let inferredGlobal = explicitFunc(1)
+
+infix operator <*>
+
+typealias Alias = Int // CHANGE-ALIAS
+func aliasFunc(_ x: Alias) {}
@@ -0,0 +1,35 @@
+// RUN: %target-swift-frontend -emit-silgen %s | FileCheck %s
+
+// Mutating a collection stored in a class must address the class's storage
+// directly, or through materializeForSet, so that the buffer stays uniquely
+// referenced and can be mutated in place. Going through the getter and
+// setter would hold a second reference during the mutation and force a copy.
+
+class Container {
+  final var finalItems: [Int] = []
+  var items: [Int] = []
+}
+
+// CHECK-LABEL: sil hidden @_TF{{.*}}14incrementFinal
+// CHECK: ref_element_addr {{%.*}} : $Container, #Container.finalItems
+// CHECK-NOT: #Container.finalItems!getter
+// CHECK: return
+func incrementFinal(_ c: Container, _ i: Int) {
+  c.finalItems[i] += 1
+}
+
+// CHECK-LABEL: sil hidden @_TF{{.*}}9increment
+// CHECK: class_method {{%.*}} : $Container, #Container.items!materializeForSet.1
+// CHECK-NOT: #Container.items!getter.1
+// CHECK: return
+func increment(_ c: Container, _ i: Int) {
+  c.items[i] += 1
+}
+
+// CHECK-LABEL: sil hidden @_TF{{.*}}6append
+// CHECK: class_method {{%.*}} : $Container, #Container.items!materializeForSet.1
+// CHECK-NOT: #Container.items!getter.1
+// CHECK: return
+func append(_ c: Container, _ x: Int) {
+  c.items.append(x)
+}
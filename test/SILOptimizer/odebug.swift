@@ -0,0 +1,20 @@
+// RUN: %target-swift-frontend %s -Odebug -emit-sil | FileCheck %s
+
+// Check that -Odebug specializes generic calls but keeps the debug info of
+// local variables.
+
+@inline(never)
+func identity<T>(_ x: T) -> T {
+  return x
+}
+
+// CHECK-LABEL: sil hidden @_TF6odebug6callerFSiSi
+// CHECK: debug_value %0 : $Int, let, name "x"
+// CHECK: [[F:%[0-9]+]] = function_ref @_TTSg5Si___TF6odebug8identityurFxx
+// CHECK: apply [[F]]
+// CHECK: debug_value {{.*}} : $Int, let, name "y"
+// CHECK: return
+func caller(_ x: Int) -> Int {
+  let y = identity(x)
+  return y
+}
@@ -0,0 +1,17 @@
+func secondaryFn() -> Int {
+  return = 1
+}
+
+struct SecondaryType {
+  var computed: Int {
+    return = 2
+  }
+
+  init() {
+    return = 3
+  }
+}
+
+@_transparent func transparentFn() -> Int {
+  return = 4
+}
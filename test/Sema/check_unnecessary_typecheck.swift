@@ -1,6 +1,7 @@
 // This test will crash if we end up doing unnecessary typechecking from the secondary file.
 
 // RUN: %target-swift-frontend -Xllvm -sil-full-demangle -emit-sil -primary-file %s %S/Inputs/forbid_typecheck_2.swift -debug-forbid-typecheck-prefix NOTYPECHECK | FileCheck %s
+// RUN: %target-swift-frontend -Xllvm -sil-full-demangle -emit-sil -primary-file %s %S/Inputs/forbid_typecheck_2.swift -debug-forbid-typecheck-prefix NOTYPECHECK -skip-secondary-function-bodies | FileCheck %s
 
 // CHECK: check_unnecessary_typecheck.globalPrim
 let globalPrim = globalSec
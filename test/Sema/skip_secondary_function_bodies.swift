@@ -0,0 +1,19 @@
+// RUN: not %target-swift-frontend -parse -primary-file %s %S/Inputs/skip_secondary_function_bodies_other.swift 2>&1 | FileCheck -check-prefix=ALL %s
+// RUN: not %target-swift-frontend -parse -primary-file %s %S/Inputs/skip_secondary_function_bodies_other.swift -skip-secondary-function-bodies 2>&1 | FileCheck -check-prefix=SKIP %s
+
+// The bodies in the secondary file are only parsed without
+// -skip-secondary-function-bodies, except for the transparent one.
+
+// ALL-DAG: skip_secondary_function_bodies_other.swift:2:{{[0-9]+}}: error:
+// ALL-DAG: skip_secondary_function_bodies_other.swift:7:{{[0-9]+}}: error:
+// ALL-DAG: skip_secondary_function_bodies_other.swift:11:{{[0-9]+}}: error:
+// ALL-DAG: skip_secondary_function_bodies_other.swift:16:{{[0-9]+}}: error:
+
+// SKIP-NOT: skip_secondary_function_bodies_other.swift:{{2|7|11}}:
+// SKIP: skip_secondary_function_bodies_other.swift:16:{{[0-9]+}}: error:
+// SKIP-NOT: skip_secondary_function_bodies_other.swift:{{2|7|11}}:
+// SKIP-NOT: skip_secondary_function_bodies.swift:{{[0-9]+}}:{{[0-9]+}}: error:
+
+func useSecondaryDecls() -> Int {
+  return secondaryFn() + SecondaryType().computed + transparentFn()
+}
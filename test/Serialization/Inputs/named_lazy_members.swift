@@ -0,0 +1,27 @@
+public struct Counter {
+  public var value: Int
+
+  public init(value: Int) {
+    self.value = value
+  }
+
+  public func unrelated() -> Int { return value }
+  public func increment(by amount: Int) -> Counter {
+    return Counter(value: value + amount)
+  }
+  public func increment() -> Counter { return increment(by: 1) }
+}
+
+extension Counter {
+  public var isZero: Bool { return value == 0 }
+  public func reset() -> Counter { return Counter(value: 0) }
+}
+
+public class Base {
+  public init() {}
+  public func describe() -> String { return "Base" }
+}
+
+public class Derived : Base {
+  public override func describe() -> String { return "Derived" }
+}
@@ -0,0 +1,31 @@
+// RUN: rm -rf %t
+// RUN: mkdir %t
+// RUN: %target-swift-frontend -emit-module -o %t %S/Inputs/named_lazy_members.swift
+// RUN: llvm-bcanalyzer %t/named_lazy_members.swiftmodule | FileCheck -check-prefix=BCANALYZER %s
+// RUN: llvm-bcanalyzer -dump %t/named_lazy_members.swiftmodule | FileCheck -check-prefix=DUMP %s
+// RUN: %target-swift-frontend -parse -I %t %s -verify
+// RUN: %target-swift-frontend -parse -I %t %s -verify -enable-named-lazy-member-loading
+// RUN: %target-swift-frontend -emit-silgen -I %t %s -enable-named-lazy-member-loading -o /dev/null
+
+// BCANALYZER-NOT: UnknownCode
+// DUMP: <DECL_MEMBER_NAMES
+
+import named_lazy_members
+
+var c = Counter(value: 1)
+c = c.increment()
+c = c.increment(by: 2)
+_ = c.isZero
+c = c.reset()
+_ = c.value
+_ = c.missing // expected-error {{value of type 'Counter' has no member 'missing'}}
+
+// Members added by an extension in this file are found alongside the
+// serialized ones.
+extension Counter {
+  func decrement() -> Counter { return increment(by: -1) }
+}
+c = c.decrement()
+
+let d: Base = Derived()
+_ = d.describe()
@@ -0,0 +1,13 @@
+// RUN: rm -rf %t
+// RUN: mkdir %t
+// RUN: %target-swift-frontend -emit-module -o %t %S/Inputs/def_struct.swift
+// RUN: %target-swift-frontend -parse -print-stats -I %t %s 2>&1 | FileCheck %s
+
+// CHECK: *** Module deserialization statistics ***
+// CHECK-DAG: {{^}}def_struct: {{[1-9][0-9]*}} decls, {{[0-9]+}} types, {{[0-9]+}} conformances, {{[1-9][0-9]*}} bytes read
+// CHECK-DAG: {{^}}Swift: {{[1-9][0-9]*}} decls,
+
+import def_struct
+
+var b = TwoInts(x: 1, y: 2)
+var sum = b.x + b.y
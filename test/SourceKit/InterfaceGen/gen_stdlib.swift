@@ -6,6 +6,10 @@ var x: Int
 // RUN: FileCheck -check-prefix=CHECK-MUTATING-ATTR -input-file %t.response %s
 // RUN: FileCheck -check-prefix=CHECK-HIDE-ATTR -input-file %t.response %s
 
+// Generating the same interface again reuses the one that is already open.
+// RUN: %sourcekitd-test -req=interface-gen -module Swift == -req=interface-gen -module Swift > %t.twice.response
+// RUN: cat %t.response %t.response | diff -u - %t.twice.response
+
 // Just check a small part, mainly to make sure we can print the interface of the stdlib.
 // CHECK-STDLIB-NOT: extension _SwiftNSOperatingSystemVersion
 // CHECK-STDLIB: struct Int : SignedInteger, Comparable, Equatable {
@@ -47,6 +51,10 @@ var x: Int
 
 // RUN: %sourcekitd-test -req=interface-gen -module Swift -group-name Bool > %t.Bool.response
 // RUN: FileCheck -check-prefix=CHECK-BOOL -input-file %t.Bool.response %s
+
+// An open interface of the whole module isn't reused for a single group.
+// RUN: %sourcekitd-test -req=interface-gen -module Swift == -req=interface-gen -module Swift -group-name Bool > %t.mixed.response
+// RUN: cat %t.response %t.Bool.response | diff -u - %t.mixed.response
 // CHECK-BOOL-DAG: extension Bool : ExpressibleByBooleanLiteral {
 
 // These are not in the bool group:
@@ -29,6 +29,7 @@ namespace SourceKit {
 class FuzzyStringMatcher {
   std::string pattern;
   std::string lowercasePattern;
+  std::string uppercasePattern;
   double maxScore; ///< The maximum possible raw score for this pattern.
   /// If (and only if) c is in pattern, charactersInPattern[c] == 1
   llvm::BitVector charactersInPattern;
@@ -21,6 +21,8 @@
 #include "llvm/Support/Mutex.h"
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace llvm {
   class MemoryBuffer;
@@ -73,6 +75,11 @@ class ImmutableTextBuffer : public ImmutableTextUpdate {
   std::unique_ptr<llvm::SourceMgr> SrcMgr;
   unsigned BufId;
 
+  /// The byte offset at which each line starts, computed on the first call
+  /// to getLineAndColumn().
+  mutable std::vector<unsigned> LineStarts;
+  mutable std::once_flag LineStartsOnce;
+
 public:
   explicit ImmutableTextBuffer(std::unique_ptr<llvm::MemoryBuffer> MemBuf,
                                uint64_t Stamp);
@@ -24,15 +24,19 @@ using clang::isLowercase;
 FuzzyStringMatcher::FuzzyStringMatcher(StringRef pattern_)
     : pattern(pattern_), charactersInPattern(1 << (sizeof(char) * 8)) {
   lowercasePattern.reserve(pattern.size());
+  uppercasePattern.reserve(pattern.size());
   unsigned upperCharCount = 0;
   for (char c : pattern) {
     char lower = toLowercase(c);
+    char upper = toUppercase(c);
     upperCharCount += (c == lower) ? 0 : 1;
     lowercasePattern.push_back(lower);
+    uppercasePattern.push_back(upper);
     charactersInPattern.set(static_cast<unsigned char>(lower));
-    charactersInPattern.set(static_cast<unsigned char>(toUppercase(c)));
+    charactersInPattern.set(static_cast<unsigned char>(upper));
   }
   assert(pattern.size() == lowercasePattern.size());
+  assert(pattern.size() == uppercasePattern.size());
 
   // FIXME: pull out the magic constants.
   // This depends on the inner details of the matching algorithm and will need
@@ -56,17 +60,19 @@ bool FuzzyStringMatcher::matchesCandidate(StringRef candidate) const {
   if (patternLength > candidateLength)
     return false;
 
-  // Do all of the pattern characters match the candidate in order?
+  // Do all of the pattern characters match the candidate in order?  Give up
+  // as soon as fewer candidate characters remain than pattern characters.
   unsigned pidx = 0, cidx = 0;
-  while (pidx < patternLength && cidx < candidateLength) {
+  while (pidx < patternLength) {
+    if (candidateLength - cidx < patternLength - pidx)
+      return false;
     char c = candidate[cidx];
-    char p = lowercasePattern[pidx];
-    if (p == c || p == toLowercase(c))
+    if (c == lowercasePattern[pidx] || c == uppercasePattern[pidx])
       ++pidx;
     ++cidx;
   }
 
-  return pidx == patternLength;
+  return true;
 }
 
 static bool isTokenizingChar(char c) {
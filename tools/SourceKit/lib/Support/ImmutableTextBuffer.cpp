@@ -14,6 +14,7 @@
 #include "clang/Rewrite/Core/RewriteRope.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
+#include <algorithm>
 
 using namespace SourceKit;
 using namespace llvm;
@@ -51,12 +52,30 @@ const llvm::MemoryBuffer *ImmutableTextBuffer::getInternalBuffer() const {
 
 std::pair<unsigned, unsigned>
 ImmutableTextBuffer::getLineAndColumn(unsigned ByteOffset) const {
-  auto Buf = SrcMgr->getMemoryBuffer(BufId);
-  if (ByteOffset > Buf->getBufferSize())
+  StringRef Text = getText();
+  if (ByteOffset > Text.size())
     return std::make_pair(0, 0);
 
-  SMLoc Loc = SMLoc::getFromPointer(Buf->getBufferStart() + ByteOffset);
-  return SrcMgr->getLineAndColumn(Loc, 0);
+  // Callers usually ask for many locations in the same buffer (for example,
+  // every diagnostic), so index the line starts once instead of scanning the
+  // buffer from the start on every query.
+  std::call_once(LineStartsOnce, [&] {
+    LineStarts.push_back(0);
+    for (size_t I = 0, E = Text.size(); I != E; ++I)
+      if (Text[I] == '\n')
+        LineStarts.push_back(I + 1);
+  });
+
+  auto LineStart = std::upper_bound(LineStarts.begin(), LineStarts.end(),
+                                    ByteOffset) - 1;
+  unsigned Line = LineStart - LineStarts.begin() + 1;
+
+  // Like SourceMgr, measure the column from the last '\n' or '\r'.
+  unsigned ColumnStart = *LineStart;
+  size_t CR = Text.slice(ColumnStart, ByteOffset).find_last_of('\r');
+  if (CR != StringRef::npos)
+    ColumnStart += CR + 1;
+  return std::make_pair(Line, ByteOffset - ColumnStart + 1);
 }
 
 ReplaceImmutableTextUpdate::ReplaceImmutableTextUpdate(
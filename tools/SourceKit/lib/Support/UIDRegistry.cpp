@@ -11,8 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "SourceKit/Support/UIdent.h"
-#include "SourceKit/Support/Concurrency.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/raw_ostream.h"
 #include <mutex>
 #include <vector>
@@ -25,7 +25,9 @@ class UIDRegistryImpl {
   typedef llvm::StringMap<void *, llvm::BumpPtrAllocator> HashTableTy;
   typedef llvm::StringMapEntry<void *> EntryTy;
   HashTableTy HashTable;
-  WorkQueue Queue{ WorkQueue::Dequeuing::Concurrent, "UIDRegistryImpl" };
+  /// Almost every lookup finds an existing entry, so lookups share a reader
+  /// lock and only the insertion of a new UID takes the writer lock.
+  llvm::sys::RWMutex Mtx;
 
 public:
 
@@ -85,21 +87,15 @@ void UIdent::print(llvm::raw_ostream &OS) const {
 void *UIDRegistryImpl::get(StringRef Str) {
   assert(!Str.empty());
   assert(Str.find(' ') == StringRef::npos);
-  EntryTy *Ptr = 0;
-  Queue.dispatchSync([&]{
+  {
+    llvm::sys::ScopedReader L(Mtx);
     HashTableTy::iterator It = HashTable.find(Str);
     if (It != HashTable.end())
-      Ptr = &(*It);
-  });
-
-  if (Ptr == 0) {
-    Queue.dispatchBarrierSync([&]{
-      EntryTy &Entry = *HashTable.insert(std::make_pair(Str, nullptr)).first;
-      Ptr = &Entry;
-    });
+      return &(*It);
   }
 
-  return Ptr;
+  llvm::sys::ScopedWriter L(Mtx);
+  return &*HashTable.insert(std::make_pair(Str, nullptr)).first;
 }
 
 StringRef UIDRegistryImpl::getName(void *Ptr) {
@@ -20,6 +20,7 @@
 #include "SourceKit/Support/Logging.h"
 #include "SourceKit/Support/Tracing.h"
 
+#include "swift/AST/ClangModuleLoader.h"
 #include "swift/Basic/Cache.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
@@ -29,6 +30,7 @@
 // This is included only for createLazyResolver(). Move to different header ?
 #include "swift/Sema/IDETypeChecking.h"
 
+#include "clang/AST/ASTContext.h"
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -258,11 +260,22 @@ public:
 
   void enqueueConsumer(SwiftASTConsumerRef Consumer, const void *OncePerASTToken);
   std::vector<SwiftASTConsumerRef> popQueuedConsumers();
+  bool hasQueuedConsumers();
 
   size_t getMemoryCost() const {
     // FIXME: Report the memory cost of the overall CompilerInstance.
-    if (AST && AST->getCompilerInstance().hasASTContext())
-      return AST->Impl.CompInst.getASTContext().getTotalMemory();
+    if (AST && AST->getCompilerInstance().hasASTContext()) {
+      auto &Ctx = AST->Impl.CompInst.getASTContext();
+      size_t Cost = Ctx.getTotalMemory();
+      // Imported Clang modules are usually most of a unit's footprint, so
+      // count them too, letting the cache evict by what a unit really holds.
+      if (auto *ClangLoader = Ctx.getClangModuleLoader()) {
+        auto &ClangCtx = ClangLoader->getClangASTContext();
+        Cost += ClangCtx.getASTAllocatedMemory() +
+                ClangCtx.getSideTableAllocatedMemory();
+      }
+      return Cost;
+    }
     return sizeof(*this) + sizeof(*AST);
   }
 
@@ -569,6 +582,12 @@ void ASTProducer::getASTUnitAsync(SwiftASTManager::Implementation &MgrImpl,
   Snapshots.append(Snaps.begin(), Snaps.end());
 
   MgrImpl.ASTBuildQueue.dispatch([ThisProducer, &MgrImpl, Snapshots, Receiver] {
+    // The consumers queued along with this build may have been handed an AST
+    // by an earlier build already, or cancelled by a newer request for the
+    // same document. Don't spend the build queue on an AST nobody wants.
+    if (!ThisProducer->hasQueuedConsumers())
+      return;
+
     std::string Error;
     ASTUnitRef Unit = ThisProducer->getASTUnitImpl(MgrImpl, Snapshots, Error);
     Receiver(Unit, Error);
@@ -636,6 +655,11 @@ std::vector<SwiftASTConsumerRef> ASTProducer::popQueuedConsumers() {
   return Consumers;
 }
 
+bool ASTProducer::hasQueuedConsumers() {
+  llvm::sys::ScopedLock L(Mtx);
+  return !QueuedConsumers.empty();
+}
+
 bool ASTProducer::shouldRebuild(SwiftASTManager::Implementation &MgrImpl,
                                 ArrayRef<ImmutableTextSnapshotRef> Snapshots) {
   const SwiftInvocation::Implementation &Invok = InvokRef->Impl;
@@ -1263,6 +1263,11 @@ void SwiftLangSupport::codeCompleteCacheOnDisk(StringRef path) {
   newCache->inMemory =
       llvm::make_unique<ide::CodeCompletionCache>(newCache->onDisk.get());
 
+  // FIXME(performance): the first completion after the cache is replaced
+  // still pays to load the results of every imported module from disk. We
+  // could prewarm the in-memory cache on a background queue once we know the
+  // modules a document imports, but the cache keys need the resolved module
+  // filename, which we only learn from a type-checked AST.
   CCCache = newCache; // replace the old cache.
 }
 
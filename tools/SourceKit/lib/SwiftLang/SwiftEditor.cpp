@@ -1239,13 +1239,22 @@ public:
 
     ++NestingLevel;
     SourceLoc StartLoc = Node.Range.getStart();
+    unsigned Offset = SrcManager.getByteDistance(
+                           SrcManager.getLocForBufferStart(BufferID), StartLoc);
+
+    // Once the syntax map has synced up after the edit, nothing after the
+    // affected range changes. Bail out before computing line and column
+    // information, which would otherwise be done for every remaining token
+    // in the buffer on each edit.
+    if (EditedLineRange.isValid() &&
+        Offset > AffectedRange.first + AffectedRange.second)
+      return true;
+
     auto StartLineAndColumn = SrcManager.getLineAndColumn(StartLoc);
     auto EndLineAndColumn = SrcManager.getLineAndColumn(Node.Range.getEnd());
     unsigned StartLine = StartLineAndColumn.first;
     unsigned EndLine = EndLineAndColumn.second > 1 ? EndLineAndColumn.first
                                                    : EndLineAndColumn.first - 1;
-    unsigned Offset = SrcManager.getByteDistance(
-                           SrcManager.getLocForBufferStart(BufferID), StartLoc);
     // Note that the length can span multiple lines.
     unsigned Length = Node.Range.getByteLength();
 
@@ -1271,10 +1280,6 @@ public:
         AffectedRange.first -= AdjCharCount;
         AffectedRange.second += AdjCharCount;
       }
-      else if (Offset > AffectedRange.first + AffectedRange.second) {
-        // We're passed the affected range and already synced up, just return.
-        return true;
-      }
       else if (StartLine > EditedLineRange.endLine()) {
         // We're after the edited line range, let's test if we're synced up.
         if (SyntaxMap.matchesFirstTokenOnLine(StartLine, Token)) {
@@ -1751,6 +1756,12 @@ void SwiftEditorDocument::readSyntaxInfo(EditorConsumer &Consumer) {
                                        Consumer,
                                        Impl.SyntaxInfo->getBufferID());
 
+  // FIXME: The buffer is still re-lexed and re-parsed from scratch on every
+  // edit (see parse()), and the document structure is reported in full,
+  // which is what clients of editor.replacetext expect. Only the syntax map
+  // is limited to the lines that changed. Restricting the parse to the
+  // top-level decl around the edit needs the parser to be able to resume
+  // from a saved state in the middle of a file.
   ModelContext.walk(SyntaxWalker);
 
   Consumer.recordAffectedRange(Impl.AffectedRange.first,
@@ -72,6 +72,13 @@ public:
   std::string DocumentName;
   bool IsModule = false;
   std::string ModuleOrHeaderName;
+  // The printing options a module interface was generated with.
+  Optional<std::string> Group;
+  bool SynthesizedExtensions = false;
+  // If set, this context reports the interface that was generated by
+  // Original under another document name, and everything that touches the
+  // AST is forwarded to it.
+  SwiftInterfaceGenContextRef Original;
   CompilerInvocation Invocation;
   PrintingDiagnosticConsumer DiagConsumer;
   CompilerInstance Instance;
@@ -391,6 +398,9 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
   IFaceGenCtx->Impl.DocumentName = DocumentName;
   IFaceGenCtx->Impl.IsModule = IsModule;
   IFaceGenCtx->Impl.ModuleOrHeaderName = ModuleOrHeaderName;
+  if (Group)
+    IFaceGenCtx->Impl.Group = Group->str();
+  IFaceGenCtx->Impl.SynthesizedExtensions = SynthesizedExtensions;
   IFaceGenCtx->Impl.Invocation = Invocation;
   CompilerInstance &CI = IFaceGenCtx->Impl.Instance;
 
@@ -489,6 +499,26 @@ SwiftInterfaceGenContext::createForTypeInterface(CompilerInvocation Invocation,
   return IFaceGenCtx;
 }
 
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenContext::createForReuse(StringRef DocumentName,
+                                         SwiftInterfaceGenContextRef Original) {
+  if (Original->Impl.Original)
+    Original = Original->Impl.Original;
+  assert(Original->Impl.IsModule && "only module interfaces are reused");
+
+  SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
+  IFaceGenCtx->Impl.DocumentName = DocumentName;
+  IFaceGenCtx->Impl.IsModule = true;
+  IFaceGenCtx->Impl.ModuleOrHeaderName = Original->Impl.ModuleOrHeaderName;
+  IFaceGenCtx->Impl.Group = Original->Impl.Group;
+  IFaceGenCtx->Impl.SynthesizedExtensions =
+    Original->Impl.SynthesizedExtensions;
+  IFaceGenCtx->Impl.Invocation = Original->Impl.Invocation;
+  IFaceGenCtx->Impl.Mod = Original->Impl.Mod;
+  IFaceGenCtx->Impl.Original = Original;
+  return IFaceGenCtx;
+}
+
 SwiftInterfaceGenContext::SwiftInterfaceGenContext()
   : Impl(*new Implementation) {
 }
@@ -541,7 +571,34 @@ bool SwiftInterfaceGenContext::matches(StringRef ModuleName,
   return true;
 }
 
+bool SwiftInterfaceGenContext::canReuseFor(StringRef ModuleName,
+                                           Optional<StringRef> Group,
+                                           bool SynthesizedExtensions,
+                                      const swift::CompilerInvocation &Invok) {
+  if (!matches(ModuleName, Invok))
+    return false;
+
+  // Nothing notices when a module file is rebuilt, so only reuse interfaces
+  // of modules that don't change under the user.
+  if (ModuleName != STDLIB_NAME && !Impl.Mod->isSystemModule())
+    return false;
+
+  if (SynthesizedExtensions != Impl.SynthesizedExtensions)
+    return false;
+  if (Group.hasValue() != Impl.Group.hasValue())
+    return false;
+  return !Group || *Group == *Impl.Group;
+}
+
 void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const {
+  if (auto &Original = Impl.Original) {
+    // The original context may be in use by other requests.
+    Original->Impl.Queue.dispatchSync([&] {
+      Original->reportEditorInfo(Consumer);
+    });
+    return;
+  }
+
   Consumer.handleSourceText(Impl.Info.Text);
   reportSyntacticAnnotations(Impl.TextCI, Consumer);
   reportDocumentStructure(Impl.TextCI, Consumer);
@@ -550,7 +607,9 @@ void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const
 }
 
 void SwiftInterfaceGenContext::accessASTAsync(std::function<void()> Fn) {
-  if (Impl.AstUnit) {
+  if (Impl.Original) {
+    Impl.Original->accessASTAsync(std::move(Fn));
+  } else if (Impl.AstUnit) {
     Impl.AstUnit->performAsync(std::move(Fn));
   } else {
     Impl.Queue.dispatch(std::move(Fn));
@@ -559,6 +618,9 @@ void SwiftInterfaceGenContext::accessASTAsync(std::function<void()> Fn) {
 
 SwiftInterfaceGenContext::ResolvedEntity
 SwiftInterfaceGenContext::resolveEntityForOffset(unsigned Offset) const {
+  if (Impl.Original)
+    return Impl.Original->resolveEntityForOffset(Offset);
+
   // Search among the references.
   {
     auto Pos = std::upper_bound(Impl.Info.References.begin(),
@@ -598,6 +660,9 @@ SwiftInterfaceGenContext::resolveEntityForOffset(unsigned Offset) const {
 
 llvm::Optional<std::pair<unsigned, unsigned>>
 SwiftInterfaceGenContext::findUSRRange(StringRef USR) const {
+  if (Impl.Original)
+    return Impl.Original->findUSRRange(USR);
+
   auto Pos = Impl.Info.USRMap.find(USR);
   if (Pos == Impl.Info.USRMap.end())
     return None;
@@ -640,6 +705,20 @@ SwiftInterfaceGenMap::find(StringRef ModuleName,
   }
   return nullptr;
 }
+
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenMap::findReusable(StringRef ModuleName,
+                                   Optional<StringRef> Group,
+                                   bool SynthesizedExtensions,
+                                   const CompilerInvocation &Invok) {
+  llvm::sys::ScopedLock L(Mtx);
+  for (auto &Entry : IFaceGens) {
+    if (Entry.getValue()->canReuseFor(ModuleName, Group, SynthesizedExtensions,
+                                      Invok))
+      return Entry.getValue();
+  }
+  return nullptr;
+}
 //===----------------------------------------------------------------------===//
 // EditorOpenTypeInterface
 //===----------------------------------------------------------------------===//
@@ -712,15 +791,27 @@ void SwiftLangSupport::editorOpenInterface(EditorConsumer &Consumer,
 
   Invocation.getClangImporterOptions().ImportForwardDeclarations = true;
 
-  std::string ErrMsg;
-  auto IFaceGenRef = SwiftInterfaceGenContext::create(Name,
-                                                      /*IsModule=*/true,
-                                                      ModuleName,
-                                                      Group,
-                                                      Invocation,
-                                                      ErrMsg,
+  // Printing a large SDK module takes seconds, so reuse an interface that is
+  // already open for the same module and options. With only an InterestedUSR
+  // the group isn't known until the module has been loaded.
+  SwiftInterfaceGenContextRef IFaceGenRef;
+  if (Group || !InterestedUSR) {
+    if (auto Existing = IFaceGenContexts.findReusable(ModuleName, Group,
                                                       SynthesizedExtensions,
-                                                      InterestedUSR);
+                                                      Invocation))
+      IFaceGenRef = SwiftInterfaceGenContext::createForReuse(Name, Existing);
+  }
+
+  std::string ErrMsg;
+  if (!IFaceGenRef)
+    IFaceGenRef = SwiftInterfaceGenContext::create(Name,
+                                                   /*IsModule=*/true,
+                                                   ModuleName,
+                                                   Group,
+                                                   Invocation,
+                                                   ErrMsg,
+                                                   SynthesizedExtensions,
+                                                   InterestedUSR);
   if (!IFaceGenRef) {
     Consumer.handleRequestError(ErrMsg.c_str());
     return;
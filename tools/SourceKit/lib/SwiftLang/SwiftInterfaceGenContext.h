@@ -52,6 +52,12 @@ public:
                                                           ASTUnitRef AstUnit,
                                                           std::string &ErrMsg);
 
+  /// Creates a context for \p DocumentName that reports the module interface
+  /// already generated by \p Original, without printing it again.
+  static SwiftInterfaceGenContextRef
+    createForReuse(StringRef DocumentName,
+                   SwiftInterfaceGenContextRef Original);
+
   ~SwiftInterfaceGenContext();
 
   StringRef getDocumentName() const;
@@ -60,6 +66,12 @@ public:
 
   bool matches(StringRef ModuleName, const swift::CompilerInvocation &Invok);
 
+  /// Returns true if this is an interface of an SDK module that was printed
+  /// with the given options, so that createForReuse can share it.
+  bool canReuseFor(StringRef ModuleName, Optional<StringRef> Group,
+                   bool SynthesizedExtensions,
+                   const swift::CompilerInvocation &Invok);
+
   /// Note: requires exclusive access to the underlying AST.
   void reportEditorInfo(EditorConsumer &Consumer) const;
 
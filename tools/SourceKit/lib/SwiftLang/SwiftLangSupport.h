@@ -185,6 +185,10 @@ public:
   bool remove(StringRef Name);
   SwiftInterfaceGenContextRef find(StringRef ModuleName,
                                    const swift::CompilerInvocation &Invok);
+  SwiftInterfaceGenContextRef
+  findReusable(StringRef ModuleName, Optional<StringRef> Group,
+               bool SynthesizedExtensions,
+               const swift::CompilerInvocation &Invok);
 };
 
 struct SwiftCompletionCache
@@ -25,6 +25,7 @@
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/Serialization/SerializedModuleLoader.h"
 #include "swift/Serialization/SerializedSILLoader.h"
+#include "swift/Serialization/SerializationOptions.h"
 #include "swift/SILOptimizer/Analysis/Analysis.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/PassManager.h"
@@ -51,6 +52,9 @@ static llvm::cl::opt<bool>
 EmitVerboseSIL("emit-verbose-sil",
                llvm::cl::desc("Emit locations during sil emission."));
 
+static llvm::cl::opt<bool>
+EmitSIB("emit-sib", llvm::cl::desc("Emit serialized AST + SIL file(s)"));
+
 static llvm::cl::opt<std::string>
 FunctionName("func", llvm::cl::desc("Function name to extract."));
 
@@ -225,6 +229,18 @@ int main(int argc, char **argv) {
   if (!FunctionName.empty())
     removeUnwantedFunctions(CI.getSILModule(), FunctionName);
 
+  if (EmitSIB) {
+    // Writing and reloading a .sib file is much faster than printing and
+    // parsing textual SIL for large modules.
+    SerializationOptions serializationOpts;
+    serializationOpts.OutputPath = OutputFilename.c_str();
+    serializationOpts.SerializeAllSIL = true;
+    serializationOpts.IsSIB = true;
+
+    serialize(CI.getMainModule(), serializationOpts, CI.getSILModule());
+    return CI.getASTContext().hadError();
+  }
+
   std::error_code EC;
   llvm::raw_fd_ostream OS(OutputFilename, EC, llvm::sys::fs::F_None);
   if (EC) {
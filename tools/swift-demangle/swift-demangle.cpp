@@ -18,7 +18,6 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
-#include "llvm/Support/Regex.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -86,14 +85,25 @@ static void demangle(llvm::raw_ostream &os, llvm::StringRef name,
   }
 }
 
-static llvm::StringRef substrBefore(llvm::StringRef whole,
-                                    llvm::StringRef part) {
-  return whole.slice(0, part.data() - whole.data());
+static bool isSymbolChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '$';
 }
 
-static llvm::StringRef substrAfter(llvm::StringRef whole,
-                                   llvm::StringRef part) {
-  return whole.substr((part.data() - whole.data()) + part.size());
+/// Finds the next run of the form "_T[_a-zA-Z0-9$]+" in \p text.
+///
+/// Returns an empty StringRef pointing at the end of \p text if there is none.
+static llvm::StringRef findMaybeSymbol(llvm::StringRef text) {
+  size_t start = 0;
+  while ((start = text.find("_T", start)) != llvm::StringRef::npos) {
+    size_t end = start + 2;
+    while (end < text.size() && isSymbolChar(text[end]))
+      ++end;
+    if (end != start + 2)
+      return text.slice(start, end);
+    start = end;
+  }
+  return text.substr(text.size());
 }
 
 int main(int argc, char **argv) {
@@ -119,12 +129,17 @@ int main(int argc, char **argv) {
     llvm::StringRef inputContents = input.get()->getBuffer();
 
     // This doesn't handle Unicode symbols, but maybe that's okay.
-    llvm::Regex maybeSymbol("_T[_a-zA-Z0-9$]+");
-    llvm::SmallVector<llvm::StringRef, 1> matches;
-    while (maybeSymbol.match(inputContents, &matches)) {
-      llvm::outs() << substrBefore(inputContents, matches.front());
-      demangle(llvm::outs(), matches.front(), options);
-      inputContents = substrAfter(inputContents, matches.front());
+    // Scanning by hand rather than with llvm::Regex keeps large inputs, such
+    // as whole crash logs, from spending most of their time in the regex
+    // engine.
+    while (true) {
+      llvm::StringRef symbol = findMaybeSymbol(inputContents);
+      if (symbol.empty())
+        break;
+      size_t symbolStart = symbol.data() - inputContents.data();
+      llvm::outs() << inputContents.substr(0, symbolStart);
+      demangle(llvm::outs(), symbol, options);
+      inputContents = inputContents.substr(symbolStart + symbol.size());
     }
     llvm::outs() << inputContents;
 
@@ -1,4 +1,5 @@
 #include "swift/Basic/ClusteredBitVector.h"
+#include "llvm/ADT/APInt.h"
 #include "gtest/gtest.h"
 
 using namespace swift;
@@ -208,3 +209,23 @@ TEST(ClusteredBitVector, FlipAllBig) {
   EXPECT_EQ(true, vec[7]);
   EXPECT_EQ(1u, vec.count());
 }
+
+TEST(ClusteredBitVector, FromAPInt) {
+  llvm::APInt bits(130, 0);
+  bits.setBit(0);
+  bits.setBit(64);
+  bits.setBit(129);
+  ClusteredBitVector vec = ClusteredBitVector::fromAPInt(bits);
+  EXPECT_EQ(130u, vec.size());
+  EXPECT_EQ(3u, vec.count());
+  EXPECT_EQ(true, vec[0]);
+  EXPECT_EQ(false, vec[63]);
+  EXPECT_EQ(true, vec[64]);
+  EXPECT_EQ(true, vec[129]);
+  EXPECT_EQ(bits, vec.asAPInt());
+
+  ClusteredBitVector clear =
+      ClusteredBitVector::fromAPInt(llvm::APInt(200, 0));
+  EXPECT_EQ(200u, clear.size());
+  EXPECT_EQ(false, clear.any());
+}
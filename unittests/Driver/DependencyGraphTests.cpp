@@ -1,4 +1,7 @@
 #include "swift/Driver/DependencyGraph.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace swift;
@@ -790,3 +793,280 @@ TEST(DependencyGraph, ChainedExternalPreMarked) {
   EXPECT_TRUE(graph.isMarked(0));
   EXPECT_FALSE(graph.isMarked(1));
 }
+
+TEST(DependencyGraph, FingerprintsLimitTraversal) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 1], [b, 1]]\n"
+                                 "interface-hash: x"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1, "depends-top-level: [a]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-top-level: [b]"),
+            LoadResult::UpToDate);
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 2], [b, 1]]\n"
+                                 "interface-hash: y"),
+            LoadResult::AffectsDownstream);
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 0, nullptr, /*onlyChangedDecls=*/true);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(1u, marked.front());
+  EXPECT_TRUE(graph.isMarked(0));
+  EXPECT_TRUE(graph.isMarked(1));
+  EXPECT_FALSE(graph.isMarked(2));
+
+  // Without fingerprints, everything downstream is affected.
+  marked.clear();
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+  EXPECT_TRUE(graph.isMarked(2));
+}
+
+TEST(DependencyGraph, FingerprintsMissing) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a, b, c]\n"
+                                 "fingerprints-top-level: [[a, 1], [b, 1]]\n"
+                                 "interface-hash: x"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1, "depends-top-level: [a]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-top-level: [b]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(3, "depends-top-level: [c]"),
+            LoadResult::UpToDate);
+
+  // 'b' lost its fingerprint, and 'c' never had one.
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a, b, c]\n"
+                                 "fingerprints-top-level: [[a, 1]]\n"
+                                 "interface-hash: y"),
+            LoadResult::AffectsDownstream);
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 0, nullptr, /*onlyChangedDecls=*/true);
+  EXPECT_EQ(2u, marked.size());
+  EXPECT_FALSE(graph.isMarked(1));
+  EXPECT_TRUE(graph.isMarked(2));
+  EXPECT_TRUE(graph.isMarked(3));
+}
+
+TEST(DependencyGraph, FingerprintsNominalMembers) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-nominal: [a, b]\n"
+                                 "provides-member: [[a, aa], [b, bb]]\n"
+                                 "fingerprints-nominal: [[a, 1], [b, 1]]\n"
+                                 "interface-hash: x"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1, "depends-member: [[a, aa]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-member: [[b, bb]]"),
+            LoadResult::UpToDate);
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-nominal: [a, b]\n"
+                                 "provides-member: [[a, aa], [b, bb]]\n"
+                                 "fingerprints-nominal: [[a, 1], [b, 2]]\n"
+                                 "interface-hash: y"),
+            LoadResult::AffectsDownstream);
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 0, nullptr, /*onlyChangedDecls=*/true);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+  EXPECT_FALSE(graph.isMarked(1));
+  EXPECT_TRUE(graph.isMarked(2));
+}
+
+TEST(DependencyGraph, FingerprintsIgnoredWhenDependingOnDirty) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0, "provides-top-level: [z]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 1], [b, 1]]\n"
+                                 "interface-hash: x"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-top-level: [b]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(3, "depends-top-level: [z]"),
+            LoadResult::UpToDate);
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(3u, marked.front());
+
+  // Node 1 now depends on something dirty, so its fingerprints can't be
+  // trusted.
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-top-level: [z]\n"
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 2], [b, 1]]\n"
+                                 "interface-hash: y"),
+            LoadResult::AffectsDownstream);
+
+  marked.clear();
+  graph.markTransitive(marked, 1, nullptr, /*onlyChangedDecls=*/true);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+  EXPECT_TRUE(graph.isMarked(2));
+}
+
+TEST(DependencyGraph, FingerprintsPartiallyMarkedThenCascading) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0, "provides-top-level: [z]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-top-level: [z]\n"
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 1], [b, 1]]\n"
+                                 "interface-hash: x"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-top-level: [a]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(3, "depends-top-level: [b]"),
+            LoadResult::UpToDate);
+
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-top-level: [z]\n"
+                                 "provides-top-level: [a, b]\n"
+                                 "fingerprints-top-level: [[a, 2], [b, 1]]\n"
+                                 "interface-hash: y"),
+            LoadResult::AffectsDownstream);
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 1, nullptr, /*onlyChangedDecls=*/true);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+  EXPECT_TRUE(graph.isMarked(1));
+  EXPECT_FALSE(graph.isMarked(3));
+
+  // Reaching node 1 through a cascading dependency means everything it
+  // provides may have changed after all.
+  marked.clear();
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(2u, marked.size());
+  EXPECT_EQ(1u, marked.front());
+  EXPECT_TRUE(graph.isMarked(3));
+}
+
+namespace {
+/// A temporary file that is removed when it goes out of scope.
+class TempFile {
+  llvm::SmallString<64> Path;
+public:
+  TempFile(StringRef suffix, StringRef contents = "") {
+    int fd;
+    std::error_code EC =
+        llvm::sys::fs::createTemporaryFile("dependency-graph", suffix, fd,
+                                           Path);
+    assert(!EC && "failed to create temporary file");
+    (void)EC;
+    llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+    out << contents;
+  }
+  ~TempFile() { llvm::sys::fs::remove(Path); }
+
+  StringRef path() const { return Path; }
+
+  void overwrite(StringRef contents) {
+    std::error_code EC;
+    llvm::raw_fd_ostream out(Path, EC, llvm::sys::fs::F_None);
+    out << contents;
+  }
+};
+} // end anonymous namespace
+
+TEST(DependencyGraph, CacheRoundTrip) {
+  TempFile deps1("swiftdeps", "provides-top-level: [a]\n"
+                              "interface-hash: x");
+  TempFile deps2("swiftdeps", "depends-top-level: [a]\n"
+                              "depends-external: [/foo]");
+  TempFile cache("graph");
+
+  {
+    DependencyGraph<uintptr_t> graph;
+    EXPECT_EQ(graph.loadFromPath(1, deps1.path()), LoadResult::UpToDate);
+    EXPECT_EQ(graph.loadFromPath(2, deps2.path()), LoadResult::UpToDate);
+    // Nodes loaded from strings aren't cached.
+    EXPECT_EQ(graph.loadFromString(3, "depends-top-level: [a]"),
+              LoadResult::UpToDate);
+    EXPECT_FALSE(graph.writeCache(cache.path()));
+  }
+
+  DependencyGraph<uintptr_t> graph;
+  SmallVector<uintptr_t, 4> loaded;
+  EXPECT_FALSE(graph.loadFromCache(cache.path(),
+                                   [&](StringRef path) -> Optional<uintptr_t> {
+    if (path == deps1.path())
+      return 1;
+    if (path == deps2.path())
+      return 2;
+    return None;
+  }, loaded));
+  EXPECT_EQ(2u, loaded.size());
+
+  EXPECT_EQ(1, std::distance(graph.getExternalDependencies().begin(),
+                             graph.getExternalDependencies().end()));
+
+  SmallVector<uintptr_t, 4> marked;
+  graph.markTransitive(marked, 1);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+
+  // The interface hash was restored too.
+  EXPECT_EQ(graph.loadFromPath(1, deps1.path()), LoadResult::UpToDate);
+}
+
+TEST(DependencyGraph, CacheIgnoresChangedFiles) {
+  TempFile deps1("swiftdeps", "provides-top-level: [a]");
+  TempFile deps2("swiftdeps", "depends-top-level: [a]");
+  TempFile cache("graph");
+
+  {
+    DependencyGraph<uintptr_t> graph;
+    EXPECT_EQ(graph.loadFromPath(1, deps1.path()), LoadResult::UpToDate);
+    EXPECT_EQ(graph.loadFromPath(2, deps2.path()), LoadResult::UpToDate);
+    EXPECT_FALSE(graph.writeCache(cache.path()));
+  }
+
+  deps2.overwrite("depends-top-level: [b]");
+
+  DependencyGraph<uintptr_t> graph;
+  SmallVector<uintptr_t, 4> loaded;
+  EXPECT_FALSE(graph.loadFromCache(cache.path(),
+                                   [&](StringRef path) -> Optional<uintptr_t> {
+    if (path == deps1.path())
+      return 1;
+    if (path == deps2.path())
+      return 2;
+    return None;
+  }, loaded));
+  EXPECT_EQ(1u, loaded.size());
+  EXPECT_EQ(1u, loaded.front());
+}
+
+TEST(DependencyGraph, CacheCorrupt) {
+  TempFile cache("graph", "SDGC garbage");
+
+  DependencyGraph<uintptr_t> graph;
+  SmallVector<uintptr_t, 4> loaded;
+  EXPECT_TRUE(graph.loadFromCache(cache.path(),
+                                  [](StringRef) -> Optional<uintptr_t> {
+    return 1;
+  }, loaded));
+  EXPECT_EQ(0u, loaded.size());
+}
@@ -72,6 +72,22 @@ TEST_F(LexerTest, TokenizeWithComments) {
             Toks[0].getLoc().getAdvancedLoc(8));
 }
 
+TEST_F(LexerTest, TokenizeLongCommentsAndIdentifiers) {
+  const char *Source =
+      "// A line comment that is longer than a word \xC3\xA9 at a time\n"
+      "/* A block comment /* that nests */ and is long enough to skip */"
+      "    aVeryLongIdentifierName\xC3\xA9AndMore /*****/ x";
+  std::vector<tok> ExpectedTokens{
+    tok::comment, tok::comment, tok::identifier, tok::comment, tok::identifier
+  };
+  std::vector<Token> Toks = checkLex(Source, ExpectedTokens,
+                                     /*KeepComments=*/true);
+  EXPECT_EQ(Toks[0].getLength(), 58U);
+  EXPECT_EQ(Toks[1].getLength(), 65U);
+  EXPECT_EQ(Toks[2].getText(), "aVeryLongIdentifierName\xC3\xA9AndMore");
+  EXPECT_EQ(Toks[3].getLength(), 7U);
+}
+
 TEST_F(LexerTest, EOFTokenLengthIsZero) {
   const char *Source = "meow";
   std::vector<tok> ExpectedTokens{ tok::identifier, tok::eof };
@@ -40,6 +40,17 @@ TEST(FuzzyStringMatcher, BasicMatching) {
   }
 }
 
+TEST(FuzzyStringMatcher, MatchingNearTheEnd) {
+  FuzzyStringMatcher m("aBc");
+  EXPECT_TRUE(m.matchesCandidate("xxabc"));
+  EXPECT_TRUE(m.matchesCandidate("xxAxBxC"));
+  EXPECT_TRUE(m.matchesCandidate("abxxxxc"));
+  EXPECT_FALSE(m.matchesCandidate("xxxab"));
+  EXPECT_FALSE(m.matchesCandidate("abxxxx"));
+  EXPECT_FALSE(m.matchesCandidate("cba"));
+  EXPECT_FALSE(m.matchesCandidate("ab"));
+}
+
 TEST(FuzzyStringMatcher, SingleCharacterMatching) {
   EXPECT_TRUE(FuzzyStringMatcher("A").matchesCandidate("a"));
   EXPECT_TRUE(FuzzyStringMatcher("a").matchesCandidate("a"));
@@ -43,3 +43,19 @@ TEST(EditableTextBuffer, Updates) {
 
   EXPECT_EQ(Buf->getFilename(), "/a/test");
 }
+
+TEST(ImmutableTextBuffer, LineAndColumn) {
+  ImmutableTextBufferRef Buf =
+      new ImmutableTextBuffer("/a/test", "ab\ncd\r\n\nef", /*Stamp=*/0);
+
+  typedef std::pair<unsigned, unsigned> LineAndColumn;
+  EXPECT_EQ(Buf->getLineAndColumn(0), LineAndColumn(1, 1));
+  EXPECT_EQ(Buf->getLineAndColumn(2), LineAndColumn(1, 3));
+  EXPECT_EQ(Buf->getLineAndColumn(3), LineAndColumn(2, 1));
+  EXPECT_EQ(Buf->getLineAndColumn(5), LineAndColumn(2, 3));
+  EXPECT_EQ(Buf->getLineAndColumn(6), LineAndColumn(2, 1));
+  EXPECT_EQ(Buf->getLineAndColumn(7), LineAndColumn(3, 1));
+  EXPECT_EQ(Buf->getLineAndColumn(8), LineAndColumn(4, 1));
+  EXPECT_EQ(Buf->getLineAndColumn(10), LineAndColumn(4, 3));
+  EXPECT_EQ(Buf->getLineAndColumn(11), LineAndColumn(0, 0));
+}
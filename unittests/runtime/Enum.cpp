@@ -170,3 +170,27 @@ TEST(EnumTest, storeEnumTagSinglePayload) {
   ASSERT_TRUE(test_storeEnumTagSinglePayload({1, 1}, {219, 123},
                                               XI_TMBi8_, 3, 4));
 }
+
+TEST(EnumTest, singlePayloadRoundTrip) {
+  // Exercise each of the payload sizes the runtime specializes for, plus an
+  // odd size, with both one and several extra tag bytes.
+  const FullOpaqueMetadata *payloads[] = {
+    &_TMBi8_, &_TMBi16_, &_TMBi32_, &_TMBi64_, &_TMBi128_, &_TMBi256_
+  };
+  for (auto payload : payloads) {
+    size_t payloadSize = payload->base.getValueWitnesses()->getSize();
+    for (unsigned numEmptyCases : {1u, 300u, 128u*1024u}) {
+      std::vector<uint8_t> buf(payloadSize + 4, 0xAB);
+      for (int whichCase : {-1, 0, 1, 255, 256, int(numEmptyCases) - 1}) {
+        if (whichCase >= int(numEmptyCases))
+          continue;
+        swift_storeEnumTagSinglePayload(asOpaque(buf.data()), &payload->base,
+                                         whichCase, numEmptyCases);
+        EXPECT_EQ(whichCase,
+                  swift_getEnumCaseSinglePayload(asOpaque(buf.data()),
+                                                 &payload->base,
+                                                 numEmptyCases));
+      }
+    }
+  }
+}
@@ -16,6 +16,7 @@
 #include <iterator>
 #include <functional>
 #include <sys/mman.h>
+#include <string>
 #include <vector>
 #include <pthread.h>
 
@@ -249,6 +250,52 @@ TEST(Concurrent, ConcurrentMap) {
 }
 
 
+TEST(Concurrent, ConcurrentHashMap) {
+  const int numElem = 1000;
+
+  struct Entry {
+    size_t Key;
+    Entry(size_t key) : Key(key) {}
+    int compareWithKey(size_t key) const {
+      return (key == Key ? 0 : (key < Key ? -1 : 1));
+    }
+    // Use a weak hash so that probe sequences collide.
+    static size_t getKeyHash(size_t key) { return key & 0xF; }
+    static size_t getExtraAllocationSize(size_t key) { return 0; }
+  };
+
+  ConcurrentHashMap<Entry> Map;
+  EXPECT_FALSE(Map.find(size_t(0)));
+
+  // Add a bunch of numbers to the map concurrently, forcing it to grow
+  // while other threads are probing it.
+  std::atomic<int> numInserted(0);
+  auto results = RaceTest<int*>(
+    [&]() -> int* {
+      for (int i = 0; i < numElem; i++) {
+        size_t key = (i * 123512) % 0xFFFF;
+        auto result = Map.getOrInsert(key);
+        EXPECT_EQ(key, result.first->Key);
+        if (result.second)
+          ++numInserted;
+        EXPECT_EQ(result.first, Map.find(key));
+      }
+      return nullptr;
+    }
+  );
+
+  // Check that every key was inserted exactly once and can be found.
+  EXPECT_EQ(numElem, numInserted.load());
+  for (int i = 0; i < numElem; i++) {
+    size_t key = (i * 123512) % 0xFFFF;
+    Entry *entry = Map.find(key);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(key, entry->Key);
+  }
+  EXPECT_FALSE(Map.find(size_t(0xFFFF)));
+}
+
+
 TEST(MetadataTest, getGenericMetadata) {
   auto metadataTemplate = (GenericMetadata*) &MetadataTest1;
 
@@ -980,3 +1027,15 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
       });
   }
 }
+
+TEST(MetadataTest, enumerateMetadataStatistics) {
+  std::vector<std::string> names;
+  swift_enumerateMetadataStatistics(
+      [](const SwiftMetadataStatistics *statistics, void *context) {
+        static_cast<std::vector<std::string> *>(context)
+          ->push_back(statistics->Name);
+      }, &names);
+
+  ASSERT_FALSE(names.empty());
+  EXPECT_EQ("MetadataAllocator", names.front());
+}
@@ -13,6 +13,8 @@
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
 #include "gtest/gtest.h"
+#include <thread>
+#include <vector>
 
 using namespace swift;
 
@@ -153,6 +155,128 @@ TEST(RefcountingTest, unowned_retain_release_n) {
   EXPECT_EQ(1u, value);
 }
 
+TEST(RefcountingTest, concurrent_retain_release) {
+  const unsigned numThreads = 8;
+  const unsigned numIterations = 10000;
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads.emplace_back([object] {
+      for (unsigned j = 0; j < numIterations; ++j) {
+        swift_retain(object);
+        swift_release(object);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0u, value);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+}
+
+TEST(RefcountingTest, release_with_unowned_reference) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  swift_unownedRetain(object);
+  EXPECT_EQ(0u, value);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  swift_unownedRelease(object);
+}
+
+TEST(RefcountingTest, weak_load_after_release) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref, copy;
+  swift_weakInit(&ref, object);
+  swift_weakCopyInit(&copy, &ref);
+
+  auto loaded = swift_weakLoadStrong(&copy);
+  EXPECT_EQ(object, loaded);
+  swift_release(loaded);
+  EXPECT_EQ(0u, value);
+
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  EXPECT_EQ(nullptr, swift_weakTakeStrong(&copy));
+  swift_weakDestroy(&ref);
+}
+
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_REGIONS
+TEST(RefcountingTest, allocation_region) {
+  size_t released = 0, outlived = 0, inner = 0, after = 0;
+  auto region = swift_pushAllocationRegion();
+  auto releasedObject = allocTestObject(&released, 1);
+  auto outlivedObject = allocTestObject(&outlived, 2);
+  swift_retain(outlivedObject);
+
+  auto innerRegion = swift_pushAllocationRegion();
+  allocTestObject(&inner, 3);
+  swift_popAllocationRegion(innerRegion);
+  EXPECT_EQ(3u, inner);
+
+  swift_release(releasedObject);
+  EXPECT_EQ(1u, released);
+  EXPECT_EQ(0u, outlived);
+
+  swift_popAllocationRegion(region);
+  EXPECT_EQ(2u, outlived);
+
+  // Allocation goes back to the heap once the region is gone.
+  auto heapObject = allocTestObject(&after, 4);
+  swift_release(heapObject);
+  EXPECT_EQ(4u, after);
+}
+
+TEST(RefcountingTest, allocation_region_with_unowned_and_weak_references) {
+  size_t value = 0;
+  auto region = swift_pushAllocationRegion();
+  auto object = allocTestObject(&value, 1);
+  swift_unownedRetain(object);
+  WeakReference ref;
+  swift_weakInit(&ref, object);
+
+  swift_popAllocationRegion(region);
+  EXPECT_EQ(1u, value);
+
+  // The references keep the object's memory valid, and they see that the
+  // object has been deallocated.
+  EXPECT_TRUE(object->refCount.isDeallocating());
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  swift_weakDestroy(&ref);
+  swift_unownedRelease(object);
+
+  // The region's own weak retain is never dropped, so the memory isn't
+  // freed from under the region.
+  EXPECT_EQ(1u, object->weakRefCount.getCount());
+}
+
+extern "C" HeapObject *swift_bufferAllocate(HeapMetadata const *bufferType,
+                                            size_t size, size_t alignMask);
+
+TEST(RefcountingTest, allocation_region_skips_buffers) {
+  size_t value = 0;
+  auto region = swift_pushAllocationRegion();
+  auto object = static_cast<TestObject *>(
+      swift_bufferAllocate(&TestClassObjectMetadata, sizeof(TestObject),
+                           alignof(TestObject) - 1));
+  object->Addr = &value;
+  object->Value = 1;
+
+  // The buffer came from the heap, so popping the region leaves it alone.
+  swift_popAllocationRegion(region);
+  EXPECT_EQ(0u, value);
+  EXPECT_EQ(1u, object->weakRefCount.getCount());
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+}
+#endif
+
 /////////////////////////////////////////
 // Non-atomic reference counting tests //
 /////////////////////////////////////////
@@ -246,3 +370,65 @@ TEST(RefcountingTest, nonatomic_unknown_retain_release_n) {
   EXPECT_EQ(1u, swift_retainCount(object));
 }
 
+
+#if SWIFT_RUNTIME_ENABLE_COW_EXISTENTIALS
+TEST(RefcountingTest, buffer_box_read_and_write_projections) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  ValueBuffer original, copy;
+  auto slot = swift_allocBufferBox(&original, &_TMBo);
+  *reinterpret_cast<HeapObject **>(slot) = object;
+  swift_copyBufferBox(&copy, &original);
+  void *box = original.PrivateData[0];
+  ASSERT_EQ(box, copy.PrivateData[0]);
+
+  // Reading leaves the box shared by both buffers.
+  EXPECT_EQ(slot, swift_projectBufferForRead(&copy, &_TMBo));
+  EXPECT_EQ(box, copy.PrivateData[0]);
+  EXPECT_EQ(1u, swift_retainCount(object));
+
+  // Projecting for a write gives the buffer a box of its own holding a copy
+  // of the value, and leaves the other buffer alone.
+  auto writeSlot = swift_projectBufferBox(&copy, &_TMBo);
+  EXPECT_NE(box, copy.PrivateData[0]);
+  EXPECT_EQ(box, original.PrivateData[0]);
+  EXPECT_EQ(object, *reinterpret_cast<HeapObject **>(writeSlot));
+  EXPECT_EQ(2u, swift_retainCount(object));
+
+  // A box that is already unique isn't copied again.
+  EXPECT_EQ(writeSlot, swift_projectBufferBox(&copy, &_TMBo));
+
+  swift_destroyBufferBox(&copy);
+  EXPECT_EQ(0u, value);
+  swift_destroyBufferBox(&original);
+  EXPECT_EQ(1u, value);
+}
+
+TEST(RefcountingTest, concurrent_buffer_box_reads) {
+  const unsigned numThreads = 8;
+  const unsigned numIterations = 10000;
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  ValueBuffer original, copy;
+  auto slot = swift_allocBufferBox(&original, &_TMBo);
+  *reinterpret_cast<HeapObject **>(slot) = object;
+  swift_copyBufferBox(&copy, &original);
+  void *box = original.PrivateData[0];
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&copy, slot] {
+      for (unsigned j = 0; j < numIterations; ++j)
+        EXPECT_EQ(slot, swift_projectBufferForRead(&copy, &_TMBo));
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(box, copy.PrivateData[0]);
+  EXPECT_EQ(1u, swift_retainCount(object));
+  swift_destroyBufferBox(&copy);
+  swift_destroyBufferBox(&original);
+  EXPECT_EQ(1u, value);
+}
+#endif
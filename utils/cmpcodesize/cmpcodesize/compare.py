@@ -48,6 +48,17 @@ infixes = {
 
 generic_function_prefix = "__TTSg"
 
+swift_metadata_sections = [
+    "__swift2_types",
+    "__swift2_proto",
+    "__swift3_fieldmd",
+    "__swift3_assocty",
+    "__swift3_builtin",
+    "__swift3_capture",
+    "__swift3_typeref",
+    "__swift3_reflstr",
+]
+
 sorted_prefixes = sorted(prefixes)
 sorted_infixes = sorted(infixes)
 
@@ -204,17 +215,21 @@ def compare_sizes_of_file(old_files, new_files, all_sections, list_categories):
 
     if all_sections:
         section_title = "    section"
-        compare_sizes(old_sizes, new_sizes, "__textcoal_nt", section_title)
-        compare_sizes(old_sizes, new_sizes, "__stubs", section_title)
-        compare_sizes(old_sizes, new_sizes, "__const", section_title)
-        compare_sizes(old_sizes, new_sizes, "__cstring", section_title)
-        compare_sizes(old_sizes, new_sizes, "__objc_methname", section_title)
-        compare_sizes(old_sizes, new_sizes, "__const", section_title)
-        compare_sizes(old_sizes, new_sizes, "__objc_const", section_title)
-        compare_sizes(old_sizes, new_sizes, "__data", section_title)
-        compare_sizes(old_sizes, new_sizes, "__swift1_proto", section_title)
-        compare_sizes(old_sizes, new_sizes, "__common", section_title)
-        compare_sizes(old_sizes, new_sizes, "__bss", section_title)
+        for section in ["__textcoal_nt", "__stubs", "__const", "__cstring",
+                        "__objc_methname", "__objc_const", "__data",
+                        "__common", "__bss"]:
+            compare_sizes(old_sizes, new_sizes, section, section_title)
+
+        # Swift type metadata records, protocol conformances and reflection
+        # metadata, which grow with the number of types and specializations
+        # rather than with the amount of code.
+        for section in swift_metadata_sections:
+            compare_sizes(old_sizes, new_sizes, section, section_title)
+        old_sizes["Swift metadata"] = sum(
+            old_sizes[section] for section in swift_metadata_sections)
+        new_sizes["Swift metadata"] = sum(
+            new_sizes[section] for section in swift_metadata_sections)
+        compare_sizes(old_sizes, new_sizes, "Swift metadata", section_title)
 
 
 def list_function_sizes(size_array):
@@ -193,8 +193,8 @@ How to specify files:
             if len(old_files) != len(new_files):
                 sys.exit("number of new files must be the same of old files")
 
-            old_files.sort
-            new_files.sort
+            old_files.sort()
+            new_files.sort()
 
             for idx, old_file in enumerate(old_files):
                 new_file = new_files[idx]
@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+# process-stats-dir.py - Summarize a -stats-output-dir directory -*- python -*-
+#
+# This source file is part of the Swift.org open source project
+#
+# Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+# Licensed under Apache License v2.0 with Runtime Library Exception
+#
+# See http://swift.org/LICENSE.txt for license information
+# See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+# ----------------------------------------------------------------------------
+#
+# Sums the counters and phase times written by the frontend jobs of a build
+# that was run with -stats-output-dir, per module or for the whole build.
+#
+# ----------------------------------------------------------------------------
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import sys
+
+
+def load_stats(directory):
+    for name in sorted(os.listdir(directory)):
+        if name.startswith('frontend-') and name.endswith('.json'):
+            with open(os.path.join(directory, name)) as f:
+                yield json.load(f)
+
+
+def merge(total, job):
+    total['jobs'] += 1
+    for kind in ('counters', 'phases'):
+        for (key, value) in job.get(kind, {}).items():
+            total[kind][key] = total[kind].get(key, 0) + value
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Summarize the statistics written by -stats-output-dir.')
+    parser.add_argument('directory',
+                        help='The directory passed to -stats-output-dir')
+    parser.add_argument('--by-module', action='store_true',
+                        help='Report each module separately')
+    parser.add_argument('--json', action='store_true',
+                        help='Print the summary as JSON')
+    args = parser.parse_args()
+
+    totals = {}
+    for job in load_stats(args.directory):
+        key = job.get('module', '') if args.by_module else 'all'
+        total = totals.setdefault(key, {'jobs': 0, 'counters': {},
+                                        'phases': {}})
+        merge(total, job)
+
+    if args.json:
+        json.dump(totals, sys.stdout, indent=2, sort_keys=True)
+        print()
+        return 0
+
+    for (key, total) in sorted(totals.items()):
+        print('%s (%d jobs)' % (key, total['jobs']))
+        for (name, value) in sorted(total['counters'].items()):
+            print('  %-40s %16d' % (name, value))
+        for (name, value) in sorted(total['phases'].items(),
+                                    key=lambda item: -item[1]):
+            print('  %-40s %15.3fs' % (name, value))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
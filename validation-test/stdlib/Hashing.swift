@@ -122,6 +122,41 @@ HashingTestSuite.test("_squeezeHashValue/UInt") {
   checkRange((UInt.max-10)..<(UInt.max-1))
 }
 
+func hashWithHasher(_ values: [Int]) -> Int {
+  var hasher = _Hasher()
+  for v in values {
+    hasher.append(v)
+  }
+  return hasher.finalize()
+}
+
+HashingTestSuite.test("_Hasher") {
+  expectEqual(hashWithHasher([1, 2]), hashWithHasher([1, 2]))
+
+  // Unlike combining with `^`, the order of the values matters, and equal
+  // values don't cancel out.
+  expectNotEqual(hashWithHasher([1, 2]), hashWithHasher([2, 1]))
+  expectNotEqual(hashWithHasher([5, 5]), hashWithHasher([7, 7]))
+
+  // Trailing zeros are not lost.
+  expectNotEqual(hashWithHasher([]), hashWithHasher([0]))
+  expectNotEqual(hashWithHasher([0]), hashWithHasher([0, 0]))
+
+#if arch(x86_64) || arch(arm64) || arch(powerpc64) || arch(powerpc64le) || arch(s390x)
+  expectEqual(Int(bitPattern: 0x1a37_f929_7268_0a47), hashWithHasher([1, 2]))
+#endif
+}
+
+HashingTestSuite.test("_Hasher/Hashable") {
+  var hasher = _Hasher()
+  hasher.append("hello")
+  hasher.append(true)
+  var expected = _Hasher()
+  expected.append("hello".hashValue)
+  expected.append(true.hashValue)
+  expectEqual(expected.finalize(), hasher.finalize())
+}
+
 HashingTestSuite.test("String/hashValue/topBitsSet") {
 #if _runtime(_ObjC)
 #if arch(x86_64) || arch(arm64)